@@ -0,0 +1,108 @@
+/*
+ * Copyright (c) 2015 Ilja Booij (ibooij@gmail.com)
+ *
+ * This file is part of Big Ring Indoor Video Cycling
+ *
+ * Big Ring Indoor Video Cycling is free software: you can redistribute
+ * it and/or modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation, either version 3 of the
+ * License, or (at your option) any later version.
+ *
+ * Big Ring Indoor Video Cycling  is distributed in the hope that it will
+ * be useful, but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+
+ * You should have received a copy of the GNU General Public License
+ * along with Big Ring Indoor Video Cycling.  If not, see
+ * <http://www.gnu.org/licenses/>.
+ */
+
+#include <cstdio>
+#include <cstdlib>
+
+#include <QtCore/QCommandLineParser>
+#include <QtCore/QCoreApplication>
+
+#include "antsoaktestrunner.h"
+
+namespace
+{
+bool verbose = false;
+}
+
+/**
+ * AntCentralDispatch logs every ANT+ message as debug output. Only show this with --verbose, otherwise
+ * the output of a soak test is unreadable.
+ */
+void soakTestLogging(QtMsgType type, const QMessageLogContext &, const QString &msg)
+{
+    if (type == QtDebugMsg && !verbose) {
+        return;
+    }
+    fprintf(stderr, "%s\n", qPrintable(msg));
+    if (type == QtFatalMsg) {
+        abort();
+    }
+}
+
+/**
+ * read command line options in to an AntSoakTestSettings struct.
+ * @param application the application object
+ * @return the settings for the soak test.
+ */
+indoorcycling::AntSoakTestSettings parseCommandLine(QCoreApplication &application)
+{
+    QCommandLineParser parser;
+    parser.setApplicationDescription("Soak test of the ANT+ layer, using simulated ANT+ usb sticks.");
+    parser.addHelpOption();
+    QCommandLineOption durationOption("duration", "Duration of the test in seconds.", "seconds", "3600");
+    QCommandLineOption reportOption("report-interval", "Interval between reports in seconds.", "seconds", "60");
+    QCommandLineOption sticksOption("sticks", "Number of simulated sticks.", "sticks", "1");
+    QCommandLineOption channelsOption("channels", "Number of channels of every simulated stick.", "channels", "8");
+    QCommandLineOption sensorsOption("sensors", "Number of simulated sensors of every type.", "sensors", "1");
+    QCommandLineOption jitterOption("jitter", "Maximum jitter of sensor messages in ms.", "ms", "10");
+    QCommandLineOption dropoutOption("dropout", "Probability of a sensor message dropout.", "probability", "0.01");
+    QCommandLineOption collisionOption("collision", "Probability of a channel collision.", "probability", "0.005");
+    QCommandLineOption maximumDropRateOption("max-drop-rate", "Fraction of dropped samples, including dropouts, that "
+                                             "fails the test.", "fraction", "0.02");
+    QCommandLineOption seedOption("seed", "Random seed.", "seed", "1");
+    QCommandLineOption disconnectOption("disconnect-after", "Disconnect the first stick after this many seconds, "
+                                        "to test failover. 0 means never.", "seconds", "0");
+    QCommandLineOption verboseOption("verbose", "Show debug output.");
+    parser.addOptions({durationOption, reportOption, sticksOption, channelsOption, sensorsOption, jitterOption,
+                       dropoutOption, collisionOption, maximumDropRateOption, seedOption, disconnectOption,
+                       verboseOption});
+
+    parser.process(application);
+
+    verbose = parser.isSet(verboseOption);
+    indoorcycling::AntSoakTestSettings settings;
+    settings.durationSeconds = parser.value(durationOption).toInt();
+    settings.reportIntervalSeconds = qMax(1, parser.value(reportOption).toInt());
+    settings.numberOfSticks = qMax(1, parser.value(sticksOption).toInt());
+    settings.numberOfChannels = parser.value(channelsOption).toInt();
+    settings.sensorsPerType = qMax(1, parser.value(sensorsOption).toInt());
+    settings.jitterMs = parser.value(jitterOption).toInt();
+    settings.dropoutProbability = parser.value(dropoutOption).toDouble();
+    settings.collisionProbability = parser.value(collisionOption).toDouble();
+    settings.maximumDropRate = parser.value(maximumDropRateOption).toDouble();
+    settings.randomSeed = parser.value(seedOption).toUInt();
+    settings.disconnectAfterSeconds = parser.value(disconnectOption).toInt();
+    return settings;
+}
+
+int main(int argc, char *argv[])
+{
+    QCoreApplication a(argc, argv);
+    a.setApplicationName("antsoaktest");
+    qInstallMessageHandler(soakTestLogging);
+
+    indoorcycling::AntSoakTestRunner runner(parseCommandLine(a));
+    QObject::connect(&runner, &indoorcycling::AntSoakTestRunner::finished, &a, [&a](bool success) {
+        a.exit(success ? 0 : 1);
+    });
+    runner.start();
+
+    return a.exec();
+}
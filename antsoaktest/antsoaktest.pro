@@ -0,0 +1,33 @@
+#-------------------------------------------------
+#
+# Headless soak test for the ANT+ layer, running
+# against a simulated ANT+ usb stick.
+#
+#-------------------------------------------------
+
+TARGET = ../bin/antsoaktest
+TEMPLATE = app
+CONFIG += console
+
+include(../config.pri)
+
+
+SOURCES += antsoaktest.cpp \
+    antsoaktestrunner.cpp
+
+HEADERS += \
+    antsoaktestrunner.h
+
+# dependency on mainlib
+win32:CONFIG(release, debug|release): LIBS += -L$$OUT_PWD/../mainlib/release/ -lmainlib
+else:win32:CONFIG(debug, debug|release): LIBS += -L$$OUT_PWD/../mainlib/debug/ -lmainlib
+else:unix: LIBS += -L$$OUT_PWD/../mainlib/ -lmainlib
+
+INCLUDEPATH += $$PWD/../mainlib
+DEPENDPATH += $$PWD/../mainlib
+
+win32-g++:CONFIG(release, debug|release): PRE_TARGETDEPS += $$OUT_PWD/../mainlib/release/libmainlib.a
+else:win32-g++:CONFIG(debug, debug|release): PRE_TARGETDEPS += $$OUT_PWD/../mainlib/debug/libmainlib.a
+else:win32:!win32-g++:CONFIG(release, debug|release): PRE_TARGETDEPS += $$OUT_PWD/../mainlib/release/mainlib.lib
+else:win32:!win32-g++:CONFIG(debug, debug|release): PRE_TARGETDEPS += $$OUT_PWD/../mainlib/debug/mainlib.lib
+else:unix: PRE_TARGETDEPS += $$OUT_PWD/../mainlib/libmainlib.a
@@ -0,0 +1,387 @@
+/*
+ * Copyright (c) 2015 Ilja Booij (ibooij@gmail.com)
+ *
+ * This file is part of Big Ring Indoor Video Cycling
+ *
+ * Big Ring Indoor Video Cycling is free software: you can redistribute
+ * it and/or modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation, either version 3 of the
+ * License, or (at your option) any later version.
+ *
+ * Big Ring Indoor Video Cycling  is distributed in the hope that it will
+ * be useful, but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+
+ * You should have received a copy of the GNU General Public License
+ * along with Big Ring Indoor Video Cycling.  If not, see
+ * <http://www.gnu.org/licenses/>.
+ */
+#include "antsoaktestrunner.h"
+
+#include <cmath>
+
+#include <QtCore/qmath.h>
+#include <QtCore/QtDebug>
+#include <QtCore/QFile>
+#include <QtCore/QTextStream>
+
+#include "ant/antcentraldispatch.h"
+#include "ant/simulatedantdevice.h"
+
+#ifdef Q_OS_LINUX
+#include <unistd.h>
+#endif
+
+namespace
+{
+const int RIDER_UPDATE_INTERVAL = 1000; // ms
+const int SLOPE_UPDATE_INTERVAL = 5; // rider updates.
+
+const qint64 SENSOR_LATENCY_BUCKET_WIDTH = 10000; // ns
+const int SENSOR_LATENCY_BUCKETS = 10000; // 100 ms
+const qint64 SLOPE_LATENCY_BUCKET_WIDTH = 1000000; // ns
+const int SLOPE_LATENCY_BUCKETS = 10000; // 10 s
+const quint8 TRACK_RESISTANCE_PAGE = 0x33;
+
+const QList<indoorcycling::AntSensorType> SENSOR_TYPES({
+    indoorcycling::AntSensorType::HEART_RATE,
+    indoorcycling::AntSensorType::POWER,
+    indoorcycling::AntSensorType::SPEED_AND_CADENCE,
+    indoorcycling::AntSensorType::SMART_TRAINER
+});
+
+/**
+ * Resident memory usage of this process in bytes, or 0 if unknown.
+ */
+qint64 residentMemoryUsage()
+{
+#ifdef Q_OS_LINUX
+    QFile statm("/proc/self/statm");
+    if (statm.open(QFile::ReadOnly)) {
+        const QList<QByteArray> fields = statm.readAll().split(' ');
+        if (fields.size() > 1) {
+            return fields[1].toLongLong() * sysconf(_SC_PAGESIZE);
+        }
+    }
+#endif
+    return 0;
+}
+
+QString millis(qint64 nanos)
+{
+    return QString::number(nanos / 1e6, 'f', 3);
+}
+}
+
+namespace indoorcycling
+{
+
+LatencyHistogram::LatencyHistogram(qint64 bucketWidthNs, int numberOfBuckets):
+    _bucketWidthNs(bucketWidthNs), _buckets(numberOfBuckets, 0u), _count(0u), _maximum(0)
+{
+    // empty
+}
+
+void LatencyHistogram::addValue(qint64 latencyNs)
+{
+    const std::size_t bucket = static_cast<std::size_t>(qMax(Q_INT64_C(0), latencyNs / _bucketWidthNs));
+    _buckets[qMin(bucket, _buckets.size() - 1)] += 1;
+    _count += 1;
+    _maximum = qMax(_maximum, latencyNs);
+}
+
+quint64 LatencyHistogram::count() const
+{
+    return _count;
+}
+
+qint64 LatencyHistogram::maximum() const
+{
+    return _maximum;
+}
+
+qint64 LatencyHistogram::percentile(qreal fraction) const
+{
+    if (_count == 0) {
+        return 0;
+    }
+    const quint64 rank = static_cast<quint64>(std::ceil(fraction * _count));
+    quint64 seen = 0;
+    for (std::size_t bucket = 0; bucket < _buckets.size() - 1; ++bucket) {
+        seen += _buckets[bucket];
+        if (seen >= rank) {
+            return qMin(_maximum, static_cast<qint64>(bucket + 1) * _bucketWidthNs);
+        }
+    }
+    return _maximum;
+}
+
+AntSoakTestRunner::SensorStatistics::SensorStatistics():
+    receiving(false), pending(false), pendingSinceNs(0), events(0), dropped(0), dropouts(0),
+    latencies(SENSOR_LATENCY_BUCKET_WIDTH, SENSOR_LATENCY_BUCKETS)
+{
+    // empty
+}
+
+AntSoakTestRunner::AntSoakTestRunner(const AntSoakTestSettings &settings, QObject *parent) :
+    QObject(parent), _settings(settings),
+    _antCentralDispatch(new AntCentralDispatch([this]() -> std::vector<std::unique_ptr<AntDevice>> {
+        return createDevices();
+    }, this)),
+    _slopeLatencies(SLOPE_LATENCY_BUCKET_WIDTH, SLOPE_LATENCY_BUCKETS), _slopeSentNs(0), _slopesSent(0),
+    _slopesReceived(0), _initialMemoryUsage(0), _riderUpdates(0)
+{
+    for (AntSensorType sensorType: SENSOR_TYPES) {
+        _sensorStatistics[sensorType] = SensorStatistics();
+    }
+
+    connect(_antCentralDispatch, &AntCentralDispatch::initializationFinished, this,
+            &AntSoakTestRunner::initializationFinished);
+    connect(_antCentralDispatch, &AntCentralDispatch::sensorValue, this, &AntSoakTestRunner::handleSensorValue);
+
+    _riderTimer.setInterval(RIDER_UPDATE_INTERVAL);
+    connect(&_riderTimer, &QTimer::timeout, this, &AntSoakTestRunner::updateRider);
+    _reportTimer.setInterval(_settings.reportIntervalSeconds * 1000);
+    connect(&_reportTimer, &QTimer::timeout, this, &AntSoakTestRunner::report);
+}
+
+AntSoakTestRunner::~AntSoakTestRunner()
+{
+    // empty
+}
+
+void AntSoakTestRunner::start()
+{
+    _clock.start();
+    _antCentralDispatch->initialize();
+}
+
+/**
+ * Create the simulated sticks. All sensors are in range of every stick, like they would be with real sticks.
+ * AntCentralDispatch pairs with one sensor of every type, and only paired sensors generate events, so the statistics
+ * are kept by sensor type. The other sensors of a type are only in range, like the sensors of other riders in a
+ * group.
+ */
+std::vector<std::unique_ptr<AntDevice>> AntSoakTestRunner::createDevices()
+{
+    std::vector<std::unique_ptr<AntDevice>> devices;
+    _simulatedDevices.clear();
+    for (int stickNumber = 0; stickNumber < _settings.numberOfSticks; ++stickNumber) {
+        SimulatedAntDevice* device = new SimulatedAntDevice(_settings.numberOfChannels);
+        device->setRandomSeed(_settings.randomSeed + stickNumber);
+        int deviceNumber = 1;
+        for (AntSensorType sensorType: SENSOR_TYPES) {
+            for (int i = 0; i < _settings.sensorsPerType; ++i) {
+                SimulatedAntSensor sensor(sensorType, deviceNumber++);
+                sensor.jitterMs = _settings.jitterMs;
+                sensor.dropoutProbability = _settings.dropoutProbability;
+                sensor.collisionProbability = _settings.collisionProbability;
+                device->addSensor(sensor);
+            }
+        }
+        connect(device, &SimulatedAntDevice::sensorEventGenerated, this, &AntSoakTestRunner::sensorEventGenerated);
+        connect(device, &SimulatedAntDevice::sensorMessageDropped, this, &AntSoakTestRunner::sensorMessageDropped);
+        connect(device, &SimulatedAntDevice::slopeReceived, this, &AntSoakTestRunner::slopeReceived);
+        _simulatedDevices.push_back(device);
+        devices.push_back(std::unique_ptr<AntDevice>(device));
+    }
+    return devices;
+}
+
+SimulatedAntDeviceStatistics AntSoakTestRunner::deviceStatistics() const
+{
+    SimulatedAntDeviceStatistics total;
+    for (const SimulatedAntDevice* device: _simulatedDevices) {
+        const SimulatedAntDeviceStatistics& statistics = device->statistics();
+        total.broadcastsSent += statistics.broadcastsSent;
+        total.dropouts += statistics.dropouts;
+        total.collisions += statistics.collisions;
+        total.acknowledgedMessagesReceived += statistics.acknowledgedMessagesReceived;
+        total.acknowledgedMessagesFailed += statistics.acknowledgedMessagesFailed;
+        total.masterBroadcastsReceived += statistics.masterBroadcastsReceived;
+        total.searchTimeouts += statistics.searchTimeouts;
+    }
+    return total;
+}
+
+void AntSoakTestRunner::initializationFinished(bool success)
+{
+    if (_riderTimer.isActive()) {
+        // all sticks were lost and the ANT+ system is initialized again, it reopens the channels itself.
+        QTextStream(stdout) << (success ? "=== ANT+ system initialized again\n" : "=== All ANT+ sticks lost\n");
+        return;
+    }
+    if (!success) {
+        qWarning("Unable to initialize simulated ANT+ device");
+        emit finished(false);
+        return;
+    }
+    for (AntSensorType sensorType: SENSOR_TYPES) {
+        _antCentralDispatch->searchForSensorType(sensorType);
+    }
+    _antCentralDispatch->openMasterChannel(AntSensorType::HEART_RATE);
+    _antCentralDispatch->openMasterChannel(AntSensorType::POWER);
+    _antCentralDispatch->setWeight(75, 8);
+
+    _riderTimer.start();
+    _reportTimer.start();
+    QTimer::singleShot(_settings.durationSeconds * 1000, this, SLOT(stop()));
+    if (_settings.disconnectAfterSeconds > 0) {
+        QTimer::singleShot(_settings.disconnectAfterSeconds * 1000, this, SLOT(disconnectStick()));
+    }
+}
+
+void AntSoakTestRunner::sensorEventGenerated(AntSensorType sensorType)
+{
+    SensorStatistics& statistics = _sensorStatistics[sensorType];
+    if (!statistics.receiving) {
+        return;
+    }
+    statistics.events += 1;
+    if (statistics.pending) {
+        statistics.dropped += 1;
+    }
+    statistics.pending = true;
+    statistics.pendingSinceNs = _clock.nsecsElapsed();
+}
+
+void AntSoakTestRunner::sensorMessageDropped(AntSensorType sensorType)
+{
+    SensorStatistics& statistics = _sensorStatistics[sensorType];
+    if (statistics.receiving) {
+        statistics.dropouts += 1;
+    }
+}
+
+void AntSoakTestRunner::slopeReceived(qreal)
+{
+    _slopesReceived += 1;
+    if (_slopeSentNs > 0) {
+        _slopeLatencies.addValue(_clock.nsecsElapsed() - _slopeSentNs);
+        _slopeSentNs = 0;
+    }
+}
+
+void AntSoakTestRunner::handleSensorValue(const SensorValueType, const AntSensorType sensorType, const QVariant &)
+{
+    SensorStatistics& statistics = _sensorStatistics[sensorType];
+    if (!statistics.receiving) {
+        // the first values of a sensor are used for pairing, so we'll start measuring from here.
+        statistics.receiving = true;
+        return;
+    }
+    if (statistics.pending) {
+        statistics.latencies.addValue(_clock.nsecsElapsed() - statistics.pendingSinceNs);
+        statistics.pending = false;
+    }
+}
+
+/**
+ * Simulate a rider doing intervals: every value follows a slow sine wave. The values are sent to the simulated
+ * sensors and to the master channels, and every few seconds the slope is changed.
+ */
+void AntSoakTestRunner::updateRider()
+{
+    _riderUpdates += 1;
+    const qreal phase = std::sin(_riderUpdates * 2 * M_PI / 300);
+    const int heartRate = qRound(140 + 25 * phase);
+    const int power = qRound(220 + 100 * phase);
+    const int cadence = qRound(90 + 10 * phase);
+    for (SimulatedAntDevice* device: _simulatedDevices) {
+        device->setHeartRate(heartRate);
+        device->setPower(power);
+        device->setCadence(cadence);
+        device->setWheelSpeed(250 + 60 * phase);
+    }
+
+    _antCentralDispatch->sendSensorValue(SensorValueType::HEARTRATE_BPM, AntSensorType::HEART_RATE,
+                                         QVariant::fromValue(heartRate));
+    _antCentralDispatch->sendSensorValue(SensorValueType::POWER_WATT, AntSensorType::POWER,
+                                         QVariant::fromValue(power));
+    _antCentralDispatch->sendSensorValue(SensorValueType::CADENCE_RPM, AntSensorType::POWER,
+                                         QVariant::fromValue(cadence));
+
+    if (_riderUpdates % SLOPE_UPDATE_INTERVAL == 0) {
+        _slopesSent += 1;
+        _slopeSentNs = _clock.nsecsElapsed();
+        _antCentralDispatch->setSlope(6 * std::sin(_riderUpdates * 2 * M_PI / 600));
+    }
+}
+
+void AntSoakTestRunner::disconnectStick()
+{
+    QTextStream(stdout) << "=== Disconnecting the first ANT+ stick\n";
+    _simulatedDevices.front()->simulateDisconnect();
+}
+
+void AntSoakTestRunner::report()
+{
+    QTextStream out(stdout);
+    const qint64 memoryUsage = residentMemoryUsage();
+    if (_initialMemoryUsage == 0) {
+        // measure memory growth from the first report, when all channels are up and running.
+        _initialMemoryUsage = memoryUsage;
+    }
+    out << QString("=== %1 s, resident memory %2 kB (%3 kB growth)\n")
+           .arg(_clock.elapsed() / 1000).arg(memoryUsage / 1024).arg((memoryUsage - _initialMemoryUsage) / 1024);
+    for (AntSensorType sensorType: SENSOR_TYPES) {
+        const SensorStatistics& statistics = _sensorStatistics[sensorType];
+        out << QString("%1: samples %2, dropped %3, dropouts %4, latency p50 %5 ms, p99 %6 ms, p99.9 %7 ms, "
+                       "max %8 ms\n")
+               .arg(ANT_SENSOR_TYPE_STRINGS[sensorType], -18).arg(statistics.events).arg(statistics.dropped)
+               .arg(statistics.dropouts)
+               .arg(millis(statistics.latencies.percentile(.5))).arg(millis(statistics.latencies.percentile(.99)))
+               .arg(millis(statistics.latencies.percentile(.999))).arg(millis(statistics.latencies.maximum()));
+    }
+    out << QString("Slope: sent %1, received by trainer %2, latency p50 %3 ms, p99 %4 ms, max %5 ms\n")
+           .arg(_slopesSent).arg(_slopesReceived).arg(millis(_slopeLatencies.percentile(.5)))
+           .arg(millis(_slopeLatencies.percentile(.99))).arg(millis(_slopeLatencies.maximum()));
+    const AcknowledgedMessageStatistics trackResistance = _antCentralDispatch->acknowledgedMessageStatistics(
+                AntSensorType::SMART_TRAINER).value(TRACK_RESISTANCE_PAGE);
+    out << QString("Track resistance: queued %1, replaced %2, completed %3, failed transfers %4, dropped %5, "
+                   "latency mean %6 ms, max %7 ms\n")
+           .arg(trackResistance.queued).arg(trackResistance.replaced).arg(trackResistance.completed)
+           .arg(trackResistance.failedTransfers).arg(trackResistance.dropped)
+           .arg(millis(qRound64(trackResistance.meanLatencyNs()))).arg(millis(trackResistance.maximumLatencyNs));
+    const QMap<AntSensorType,AntMasterChannelStatistics> masterStatistics =
+            _antCentralDispatch->masterChannelStatistics();
+    for (auto it = masterStatistics.constBegin(); it != masterStatistics.constEnd(); ++it) {
+        out << QString("%1 master: broadcasts %2, missed %3, lateness mean %4 ms, jitter %5 ms, max %6 ms\n")
+               .arg(ANT_SENSOR_TYPE_STRINGS[it.key()]).arg(it.value().broadcastsSent)
+               .arg(it.value().broadcastsMissed).arg(millis(qRound64(it.value().meanLatenessNs())))
+               .arg(millis(qRound64(it.value().jitterNs()))).arg(millis(it.value().maximumLatenessNs));
+    }
+    const SimulatedAntDeviceStatistics device = deviceStatistics();
+    out << QString("Device: broadcasts %1, dropouts %2, collisions %3, acknowledged %4 (%5 failed), "
+                   "master broadcasts %6, search timeouts %7\n")
+           .arg(device.broadcastsSent).arg(device.dropouts).arg(device.collisions)
+           .arg(device.acknowledgedMessagesReceived).arg(device.acknowledgedMessagesFailed)
+           .arg(device.masterBroadcastsReceived).arg(device.searchTimeouts);
+    out.flush();
+}
+
+void AntSoakTestRunner::stop()
+{
+    _riderTimer.stop();
+    _reportTimer.stop();
+    report();
+
+    const qreal rate = dropRate();
+    QTextStream(stdout) << QString("Drop rate %1 (maximum %2)\n").arg(rate).arg(_settings.maximumDropRate);
+    emit finished(rate <= _settings.maximumDropRate);
+}
+
+qreal AntSoakTestRunner::dropRate() const
+{
+    quint64 events = 0;
+    quint64 dropped = 0;
+    for (const SensorStatistics& statistics: _sensorStatistics) {
+        // a message that dropped out never reached the stick, so it is a sample that was sent and lost.
+        events += statistics.events + statistics.dropouts;
+        dropped += statistics.dropped + statistics.dropouts;
+    }
+    return (events == 0) ? 1.0 : static_cast<qreal>(dropped) / events;
+}
+
+}
@@ -0,0 +1,151 @@
+/*
+ * Copyright (c) 2015 Ilja Booij (ibooij@gmail.com)
+ *
+ * This file is part of Big Ring Indoor Video Cycling
+ *
+ * Big Ring Indoor Video Cycling is free software: you can redistribute
+ * it and/or modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation, either version 3 of the
+ * License, or (at your option) any later version.
+ *
+ * Big Ring Indoor Video Cycling  is distributed in the hope that it will
+ * be useful, but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+
+ * You should have received a copy of the GNU General Public License
+ * along with Big Ring Indoor Video Cycling.  If not, see
+ * <http://www.gnu.org/licenses/>.
+ */
+#ifndef ANTSOAKTESTRUNNER_H
+#define ANTSOAKTESTRUNNER_H
+
+#include <memory>
+#include <vector>
+
+#include <QtCore/QElapsedTimer>
+#include <QtCore/QMap>
+#include <QtCore/QObject>
+#include <QtCore/QTimer>
+#include <QtCore/QVariant>
+
+#include "ant/antsensortype.h"
+
+namespace indoorcycling
+{
+class AntCentralDispatch;
+class AntDevice;
+class SimulatedAntDevice;
+struct SimulatedAntDeviceStatistics;
+
+/**
+ * Histogram of latencies with a fixed number of buckets, so recording latencies for hours does not use more and
+ * more memory.
+ */
+class LatencyHistogram
+{
+public:
+    LatencyHistogram(qint64 bucketWidthNs, int numberOfBuckets);
+
+    void addValue(qint64 latencyNs);
+    quint64 count() const;
+    qint64 maximum() const;
+    /** the latency below which the fraction of the values lie. Values larger than the histogram are reported as
+     * the maximum value. */
+    qint64 percentile(qreal fraction) const;
+private:
+    qint64 _bucketWidthNs;
+    std::vector<quint64> _buckets;
+    quint64 _count;
+    qint64 _maximum;
+};
+
+/**
+ * Settings for an ANT+ soak test run.
+ */
+struct AntSoakTestSettings
+{
+    int durationSeconds = 3600;
+    int reportIntervalSeconds = 60;
+    int numberOfSticks = 1;
+    int numberOfChannels = 8;
+    /** number of simulated sensors of every type. Only one of them is paired, the others are just in range. */
+    int sensorsPerType = 1;
+    int jitterMs = 10;
+    qreal dropoutProbability = 0.01;
+    qreal collisionProbability = 0.005;
+    /** fraction of dropped samples, including simulated dropouts, above which the run fails */
+    qreal maximumDropRate = 0.02;
+    quint32 randomSeed = 1;
+    /** time after which the first stick is disconnected, to test failover to the other sticks. 0 means never. */
+    int disconnectAfterSeconds = 0;
+};
+
+/**
+ * Drives AntCentralDispatch with one or more SimulatedAntDevices for a long time and reports message handling latency,
+ * dropped samples and memory growth.
+ *
+ * The latency of a sample is the time between the simulated sensor sending a message with a new measurement and
+ * AntCentralDispatch emitting the sensor value. A sample is dropped if a new measurement is sent before the previous
+ * one has resulted in a sensor value, or if the message of the sensor does not reach the stick because of a
+ * simulated dropout.
+ */
+class AntSoakTestRunner : public QObject
+{
+    Q_OBJECT
+public:
+    explicit AntSoakTestRunner(const AntSoakTestSettings& settings, QObject *parent = 0);
+    virtual ~AntSoakTestRunner();
+
+    void start();
+signals:
+    /** emitted when the run is finished. success is false if the ANT+ system could not be initialized or too
+     * many samples have been dropped. */
+    void finished(bool success);
+private slots:
+    void initializationFinished(bool success);
+    void sensorEventGenerated(AntSensorType sensorType);
+    void sensorMessageDropped(AntSensorType sensorType);
+    void slopeReceived(qreal slopeInPercent);
+    void handleSensorValue(const SensorValueType sensorValueType, const AntSensorType sensorType,
+                           const QVariant& sensorValue);
+    void updateRider();
+    void disconnectStick();
+    void report();
+    void stop();
+private:
+    struct SensorStatistics
+    {
+        SensorStatistics();
+
+        bool receiving;
+        bool pending;
+        qint64 pendingSinceNs;
+        quint64 events;
+        quint64 dropped;
+        quint64 dropouts;
+        LatencyHistogram latencies;
+    };
+
+    std::vector<std::unique_ptr<AntDevice>> createDevices();
+    SimulatedAntDeviceStatistics deviceStatistics() const;
+    qreal dropRate() const;
+
+    const AntSoakTestSettings _settings;
+    std::vector<SimulatedAntDevice*> _simulatedDevices;
+    AntCentralDispatch* const _antCentralDispatch;
+    QTimer _riderTimer;
+    QTimer _reportTimer;
+    QElapsedTimer _clock;
+
+    QMap<AntSensorType,SensorStatistics> _sensorStatistics;
+    LatencyHistogram _slopeLatencies;
+    qint64 _slopeSentNs;
+    quint64 _slopesSent;
+    quint64 _slopesReceived;
+    qint64 _initialMemoryUsage;
+    int _riderUpdates;
+};
+}
+
+#endif // ANTSOAKTESTRUNNER_H
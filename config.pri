@@ -11,7 +11,7 @@ DEFINES += APP_VERSION=\\\"$$VERSION\\\"
 INCLUDEPATH = $$PWD
 
 linux {
-    PKGCONFIG += libavcodec libavformat libavutil libswscale libusb-1.0
+    PKGCONFIG += libavcodec libavformat libavutil libswscale libusb-1.0 zlib
     CONFIG += link_pkgconfig
 }
 win32 {
@@ -30,6 +30,9 @@ win32 {
     LIBUSB_DLL = $${LIBUSB_PATH}\bin\x86\libusb0_x86.dll
     LIBS += $${LIBUSB_DLL}
 
+    # zlib, for writing compressed ride files, is part of Qt on Windows.
+    INCLUDEPATH += $$[QT_INSTALL_HEADERS]/QtZlib
+
     QT_CREATOR_DIR = C:\Qt-5.5\Tools\QtCreator
 
     CONFIG += openssl-linked
@@ -5,10 +5,12 @@ SUBDIRS += \
     mainlib \
     big-ring \
     anttestapp \
+    antsoaktest \
     test
 
 big-ring.depends = mainlib
 anttestapp.depends = mainlib
+antsoaktest.depends = mainlib
 test.depends = mainlib
 
 RESOURCES += \
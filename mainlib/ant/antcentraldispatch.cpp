@@ -19,6 +19,7 @@
  */
 #include "antcentraldispatch.h"
 
+#include <algorithm>
 #include <memory>
 #include "antchannelhandler.h"
 #include "antdevicefinder.h"
@@ -33,6 +34,8 @@
 
 namespace {
 const int INITIALIZATION_TIMEOUT = 1000; // ms
+// time between attempts to find an ANT+ usb stick.
+const int ANT_USB_STICK_RETRY_INTERVAL = 1000; // ms
 
 // According to the ANT specification, we should wait at least 500ms after sending
 // the System Reset message. To be on the safe side, we'll wait 600ms.
@@ -42,22 +45,66 @@ const int ANT_RESET_SYSTEM_TIMEOUT = 600; // ms.
 const int ANT_PLUS_NETWORK_NUMBER = 1;
 // ANT+ Network Key
 const std::array<quint8,8> ANT_PLUS_NETWORK_KEY = { {0xB9, 0xA5, 0x21, 0xFB, 0xBD, 0x72, 0xC3, 0x45} };
+
+/**
+ * Check whether a message (in bytes) from an ANT+ stick is addressed to a channel. The channel number is the first
+ * content byte of these messages.
+ */
+bool isChannelMessage(const QByteArray& messageBytes)
+{
+    if (messageBytes.size() < 5) {
+        return false;
+    }
+    switch(static_cast<AntMessage2::AntMessageId>(messageBytes[2])) {
+    case AntMessage2::AntMessageId::CHANNEL_EVENT:
+        // the response to setting the network key has the network number instead of the channel number.
+        return (static_cast<AntMessage2::AntMessageId>(messageBytes[4]) !=
+                AntMessage2::AntMessageId::SET_NETWORK_KEY);
+    case AntMessage2::AntMessageId::ACKNOWLEDGED_MESSAGE:
+    case AntMessage2::AntMessageId::BROADCAST_EVENT:
+    case AntMessage2::AntMessageId::SET_CHANNEL_ID:
+        return true;
+    default:
+        return false;
+    }
+}
+
+/**
+ * Change the channel number (first content byte) of a message (in bytes). The checksum, the xor of all bytes, is
+ * updated as well.
+ */
+QByteArray withChannelNumber(const QByteArray& messageBytes, quint8 channelNumber)
+{
+    QByteArray bytes(messageBytes);
+    const quint8 oldChannelNumber = static_cast<quint8>(bytes[3]);
+    const quint8 oldChecksum = static_cast<quint8>(bytes[bytes.size() - 1]);
+    bytes[3] = static_cast<char>(channelNumber);
+    bytes[bytes.size() - 1] = static_cast<char>(oldChecksum ^ oldChannelNumber ^ channelNumber);
+    return bytes;
+}
 }
 namespace indoorcycling {
 
 
 AntCentralDispatch::AntCentralDispatch(QObject *parent) :
-    QObject(parent), _initialized(false), _antMessageGatherer(new AntMessageGatherer(this)),
-    _powerTransmissionChannelHandler(nullptr), _initializationTimer(new QTimer(this)),
+    AntCentralDispatch([]() -> std::vector<std::unique_ptr<AntDevice>> {
+        AntDeviceFinder deviceFinder;
+        return deviceFinder.openAntDevices();
+    }, parent)
+{
+    // empty
+}
+
+AntCentralDispatch::AntCentralDispatch(std::function<std::vector<std::unique_ptr<AntDevice>>()> antDevicesFactory,
+                                       QObject *parent) :
+    QObject(parent), _antDevicesFactory(antDevicesFactory),
+    _masterChannelScheduler(new AntMasterChannelScheduler), _initialized(false),
+    _powerTransmissionChannelHandler(nullptr), _slope(0.0), _initializationTimer(new QTimer(this)),
     _logFile("ant.log")
 {
-    connect(_antMessageGatherer, &AntMessageGatherer::antMessageReceived, this,
-            &AntCentralDispatch::messageFromAntUsbStick);
     _initializationTimer->setInterval(INITIALIZATION_TIMEOUT);
     _initializationTimer->setSingleShot(true);
-    connect(_initializationTimer, &QTimer::timeout, _initializationTimer, [this]() {
-        emit initializationFinished(false);
-    });
+    connect(_initializationTimer, &QTimer::timeout, this, &AntCentralDispatch::finishInitialization);
 
     if (!_logFile.open(QIODevice::WriteOnly | QIODevice::Truncate)) {
         qWarning("Unable to open ant log file.");
@@ -66,7 +113,9 @@ AntCentralDispatch::AntCentralDispatch(QObject *parent) :
 
 bool AntCentralDispatch::antAdapterPresent() const
 {
-    return _antUsbStick.get();
+    return std::any_of(_antUsbSticks.begin(), _antUsbSticks.end(), [](const AntUsbStick& stick) {
+        return stick.connected;
+    });
 }
 
 bool AntCentralDispatch::isInitialized() const
@@ -81,7 +130,10 @@ bool AntCentralDispatch::searchForSensorType(AntSensorType channelType)
 
 bool AntCentralDispatch::searchForSensor(AntSensorType channelType, int deviceNumber)
 {
-    Q_ASSERT_X((_antUsbStick), "AntCentralDispatch::searchForSensor", "usb stick not initialized");
+    if (!antAdapterPresent()) {
+        qDebug() << "No ANT+ usb stick connected, unable to search for" << ANT_SENSOR_TYPE_STRINGS[channelType];
+        return false;
+    }
     if (findChannelForSensorType(channelType)) {
         qDebug() << "There's already a channel open for sensor type" << ANT_SENSOR_TYPE_STRINGS[channelType]
                     << ", not opening a new one";
@@ -89,7 +141,7 @@ bool AntCentralDispatch::searchForSensor(AntSensorType channelType, int deviceNu
     }
 
     int channelNumber = findFreeChannel();
-    if (channelNumber == _antUsbStick->numberOfChannels()) {
+    if (channelNumber < 0) {
         return false;
     }
 
@@ -101,6 +153,7 @@ bool AntCentralDispatch::searchForSensor(AntSensorType channelType, int deviceNu
 
     if (channelType == AntSensorType::SMART_TRAINER) {
         _smartTrainerChannelHandler = dynamic_cast<AntSmartTrainerChannelHandler*>(channel);
+        _smartTrainerChannelHandler->setSlope(_slope);
     }
 
     connect(channel, &AntChannelHandler::sensorFound, this, &AntCentralDispatch::setChannelInfo);
@@ -123,38 +176,68 @@ bool AntCentralDispatch::areAllChannelsClosed() const
     });
 }
 
+QMap<AntSensorType, AntMasterChannelStatistics> AntCentralDispatch::masterChannelStatistics() const
+{
+    const QMap<int,AntMasterChannelStatistics> channelStatistics = _masterChannelScheduler->statistics();
+    QMap<AntSensorType, AntMasterChannelStatistics> statistics;
+    for (auto it = channelStatistics.constBegin(); it != channelStatistics.constEnd(); ++it) {
+        const auto& handler = _channels[it.key()];
+        if (handler) {
+            statistics[handler->sensorType()] = it.value();
+        }
+    }
+    return statistics;
+}
+
+QMap<quint8, AcknowledgedMessageStatistics> AntCentralDispatch::acknowledgedMessageStatistics(
+        AntSensorType sensorType) const
+{
+    for (const auto& handler: _channels) {
+        if (handler && handler->sensorType() == sensorType) {
+            return handler->acknowledgedMessageStatistics();
+        }
+    }
+    return QMap<quint8, AcknowledgedMessageStatistics>();
+}
+
 void AntCentralDispatch::initialize()
 {
     qDebug() << "AntCentralDispatch::initialize()";
-    scanForAntUsbStick();
-    if (!_antUsbStick) {
+    scanForAntUsbSticks();
+    if (_antUsbSticks.empty()) {
         qDebug() << "AntCentralDispatch::initialize() failed";
         emit initializationFinished(false);
 
         // try it again after a second.
-        QTimer::singleShot(1000, this, SLOT(initialize()));
+        QTimer::singleShot(ANT_USB_STICK_RETRY_INTERVAL, this, SLOT(initialize()));
         return;
     }
-    _channels.resize(_antUsbStick->numberOfChannels());
     _initializationTimer->start();
-    if (_antUsbStick->isReady()) {
-        resetAntSystem();
-    } else {
-        connect(_antUsbStick.get(), &indoorcycling::AntDevice::deviceReady,
-                this, &AntCentralDispatch::resetAntSystem);
+    for (int stickNumber = 0; stickNumber < static_cast<int>(_antUsbSticks.size()); ++stickNumber) {
+        AntDevice* device = _antUsbSticks[stickNumber].device.get();
+        if (device->isReady()) {
+            resetAntSystem(stickNumber);
+        } else {
+            connect(device, &indoorcycling::AntDevice::deviceReady, this, [this, stickNumber]() {
+                resetAntSystem(stickNumber);
+            });
+        }
     }
 }
 
 void AntCentralDispatch::closeAllChannels()
 {
     qDebug() << "Closing all channels";
-    for(const auto &handler: _channels) {
-        if (handler) {
-            handler->close();
+    for (std::size_t channelNumber = 0; channelNumber < _channels.size(); ++channelNumber) {
+        if (_channels[channelNumber]) {
+            _masterChannelScheduler->removeChannel(channelNumber);
+            _channels[channelNumber]->close();
         }
     }
     _powerTransmissionChannelHandler = nullptr;
     _smartTrainerChannelHandler = nullptr;
+    _lostMasterChannels.clear();
+    _lostSensors.clear();
 }
 
 bool AntCentralDispatch::openMasterChannel(AntSensorType sensorType)
@@ -164,7 +247,7 @@ bool AntCentralDispatch::openMasterChannel(AntSensorType sensorType)
         return false;
     }
     int channelNumber = findFreeChannel();
-    if (channelNumber == _antUsbStick->numberOfChannels()) {
+    if (channelNumber < 0) {
         qDebug() << "All channels occupied";
         return false;
     }
@@ -184,6 +267,8 @@ bool AntCentralDispatch::openMasterChannel(AntSensorType sensorType)
 
     connect(channel, &AntChannelHandler::antMessageGenerated, this, &AntCentralDispatch::sendAntMessage);
     connect(channel, &AntChannelHandler::unassigned, this, &AntCentralDispatch::handleChannelUnassigned);
+    connect(channel, &AntMasterChannelHandler::broadcastingStarted, this,
+            &AntCentralDispatch::scheduleMasterChannel);
 
     channel->initialize();
 
@@ -210,41 +295,84 @@ void AntCentralDispatch::setWeight(const qreal cyclistWeightInKilograms, const q
 
 void AntCentralDispatch::setSlope(const qreal slopeInPercent)
 {
+    _slope = slopeInPercent;
     if (_smartTrainerChannelHandler) {
         _smartTrainerChannelHandler->setSlope(slopeInPercent);
     }
 }
 
-void AntCentralDispatch::messageFromAntUsbStick(const QByteArray &bytes)
+/**
+ * Messages from a stick are translated to global channel numbers before they're handled.
+ */
+void AntCentralDispatch::bytesFromAntUsbStick(int stickNumber, const QByteArray &bytes)
 {
-    std::unique_ptr<AntMessage2> antMessage = AntMessage2::createMessageFromBytes(bytes);
+    const AntUsbStick& stick = _antUsbSticks[stickNumber];
+    logAntMessage(AntMessageIO::INPUT, stickNumber, bytes);
+    if (!isChannelMessage(bytes)) {
+        messageFromAntUsbStick(stickNumber, *AntMessage2::createMessageFromBytes(bytes));
+        return;
+    }
+    const int stickChannelNumber = static_cast<quint8>(bytes[3]);
+    if (stickChannelNumber >= stick.device->numberOfChannels()) {
+        qWarning("Message for channel %d from ANT+ usb stick %d, which only has %d channels.", stickChannelNumber,
+                 stickNumber, stick.device->numberOfChannels());
+        return;
+    }
+    const quint8 channelNumber = static_cast<quint8>(stick.firstChannel + stickChannelNumber);
+    messageFromAntUsbStick(stickNumber,
+                           *AntMessage2::createMessageFromBytes(withChannelNumber(bytes, channelNumber)));
+}
 
-    logAntMessage(AntMessageIO::INPUT, *antMessage);
-    switch(antMessage->id()) {
+void AntCentralDispatch::messageFromAntUsbStick(int stickNumber, const AntMessage2 &antMessage)
+{
+    switch(antMessage.id()) {
     case AntMessage2::AntMessageId::CHANNEL_EVENT:
-        handleChannelEvent(*antMessage->asChannelEventMessage());
+        handleChannelEvent(stickNumber, *antMessage.asChannelEventMessage());
         break;
     case AntMessage2::AntMessageId::BROADCAST_EVENT:
-        handleBroadCastMessage(BroadCastMessage(*antMessage));
+        handleBroadCastMessage(BroadCastMessage(antMessage));
         break;
     case AntMessage2::AntMessageId::SET_CHANNEL_ID:
-        handleChannelIdMessage(SetChannelIdMessage(*antMessage));
+        handleChannelIdMessage(SetChannelIdMessage(antMessage));
         break;
     default:
-        qDebug() << "unhandled ANT+ message" << antMessage->toString();
+        qDebug() << "unhandled ANT+ message" << antMessage.toString();
     }
 }
 
-void AntCentralDispatch::scanForAntUsbStick()
+void AntCentralDispatch::scanForAntUsbSticks()
 {
-    AntDeviceFinder deviceFinder;
-    _antUsbStick = deviceFinder.openAntDevice();
-    if (_antUsbStick) {
-        connect(_antUsbStick.get(), &indoorcycling::AntDevice::bytesRead, _antMessageGatherer,
+    std::vector<std::unique_ptr<AntDevice>> devices = _antDevicesFactory();
+    // when scanning again after the sticks were lost, the gatherers of the old sticks are no longer used.
+    for (AntUsbStick& stick: _antUsbSticks) {
+        stick.messageGatherer->deleteLater();
+    }
+    _antUsbSticks.clear();
+    int numberOfChannels = 0;
+    for (std::unique_ptr<AntDevice>& device: devices) {
+        if (!device) {
+            continue;
+        }
+        const int stickNumber = static_cast<int>(_antUsbSticks.size());
+        AntUsbStick stick;
+        stick.messageGatherer = new AntMessageGatherer(this);
+        stick.firstChannel = numberOfChannels;
+        connect(device.get(), &indoorcycling::AntDevice::bytesRead, stick.messageGatherer,
                 &AntMessageGatherer::submitBytes);
+        connect(stick.messageGatherer, &AntMessageGatherer::antMessageReceived, this,
+                [this, stickNumber](const QByteArray& bytes) {
+            bytesFromAntUsbStick(stickNumber, bytes);
+        });
+        connect(device.get(), &indoorcycling::AntDevice::connectionLost, this, [this, stickNumber]() {
+            handleAntUsbStickLost(stickNumber);
+        });
+        qDebug() << "ANT+ usb stick" << stickNumber << "has" << device->numberOfChannels() << "channels";
+        numberOfChannels += device->numberOfChannels();
+        stick.device = std::move(device);
+        _antUsbSticks.push_back(std::move(stick));
     }
-    emit antUsbStickScanningFinished(_antUsbStick.get());
-
+    _channels.resize(numberOfChannels);
+    emit antUsbStickScanningFinished(!_antUsbSticks.empty());
 }
 
 AntChannelHandler *AntCentralDispatch::findChannelForSensorType(const AntSensorType &sensorType)
@@ -259,14 +387,41 @@ AntChannelHandler *AntCentralDispatch::findChannelForSensorType(const AntSensorT
 
 int AntCentralDispatch::findFreeChannel()
 {
-    int channelNumber;
-    // search for first non-occupied channel.
-    for (channelNumber = 0; channelNumber < _antUsbStick->numberOfChannels(); ++channelNumber) {
-        if (!_channels[channelNumber]) {
-            break;
+    int freeChannelNumber = -1;
+    int mostFreeChannels = 0;
+    for (const AntUsbStick& stick: _antUsbSticks) {
+        if (!stick.connected) {
+            continue;
+        }
+        int firstFreeChannel = -1;
+        int freeChannels = 0;
+        for (int channelNumber = stick.firstChannel;
+             channelNumber < stick.firstChannel + stick.device->numberOfChannels(); ++channelNumber) {
+            if (!_channels[channelNumber]) {
+                if (firstFreeChannel < 0) {
+                    firstFreeChannel = channelNumber;
+                }
+                freeChannels += 1;
+            }
+        }
+        if (freeChannels > mostFreeChannels) {
+            mostFreeChannels = freeChannels;
+            freeChannelNumber = firstFreeChannel;
+        }
+    }
+    return freeChannelNumber;
+}
+
+int AntCentralDispatch::stickNumberForChannel(int channelNumber) const
+{
+    for (int stickNumber = 0; stickNumber < static_cast<int>(_antUsbSticks.size()); ++stickNumber) {
+        const AntUsbStick& stick = _antUsbSticks[stickNumber];
+        if (channelNumber >= stick.firstChannel &&
+                channelNumber < stick.firstChannel + stick.device->numberOfChannels()) {
+            return stickNumber;
         }
     }
-    return channelNumber;
+    return -1;
 }
 
 AntChannelHandler* AntCentralDispatch::createChannel(int channelNumber, AntSensorType &sensorType)
@@ -291,15 +446,76 @@ AntChannelHandler* AntCentralDispatch::createChannel(int channelNumber, AntSenso
     }
 }
 
-void AntCentralDispatch::resetAntSystem()
+void AntCentralDispatch::resetAntSystem(int stickNumber)
 {
-    sendAntMessage(AntMessage2::systemReset());
-    QTimer::singleShot(ANT_RESET_SYSTEM_TIMEOUT, this, SLOT(sendNetworkKey()));
+    writeToAntUsbStick(stickNumber, AntMessage2::systemReset());
+    QTimer::singleShot(ANT_RESET_SYSTEM_TIMEOUT, this, [this, stickNumber]() {
+        sendNetworkKey(stickNumber);
+    });
 }
 
-void AntCentralDispatch::sendNetworkKey()
+void AntCentralDispatch::sendNetworkKey(int stickNumber)
 {
-    sendAntMessage(AntMessage2::setNetworkKey(ANT_PLUS_NETWORK_NUMBER, ANT_PLUS_NETWORK_KEY));
+    writeToAntUsbStick(stickNumber, AntMessage2::setNetworkKey(ANT_PLUS_NETWORK_NUMBER, ANT_PLUS_NETWORK_KEY));
+}
+
+/**
+ * Initialization is finished when all sticks have responded. It is successful if at least one of the sticks could
+ * be initialized.
+ */
+void AntCentralDispatch::handleNetworkKeySet(int stickNumber, bool success)
+{
+    AntUsbStick& stick = _antUsbSticks[stickNumber];
+    stick.initializationFinished = true;
+    stick.initialized = success;
+    if (!success) {
+        qWarning("Unable to initialize ANT+ usb stick %d", stickNumber);
+    }
+
+    const bool allSticksFinished = std::all_of(_antUsbSticks.begin(), _antUsbSticks.end(),
+                                               [](const AntUsbStick& antUsbStick) {
+        return antUsbStick.initializationFinished || !antUsbStick.connected;
+    });
+    if (_initializationTimer->isActive()) {
+        if (allSticksFinished) {
+            _initializationTimer->stop();
+            finishInitialization();
+        }
+    } else if (success && !_initialized) {
+        // a stick that was late still makes the ANT+ system usable.
+        _initialized = true;
+        emit initializationFinished(_initialized);
+        reopenLostChannels();
+    }
+}
+
+void AntCentralDispatch::finishInitialization()
+{
+    _initialized = std::any_of(_antUsbSticks.begin(), _antUsbSticks.end(), [](const AntUsbStick& stick) {
+        return stick.initialized && stick.connected;
+    });
+    emit initializationFinished(_initialized);
+    if (_initialized) {
+        reopenLostChannels();
+    }
+}
+
+void AntCentralDispatch::reopenLostChannels()
+{
+    const QList<AntSensorType> masterChannelTypes = _lostMasterChannels;
+    const QList<QPair<AntSensorType,int>> sensors = _lostSensors;
+    _lostMasterChannels.clear();
+    _lostSensors.clear();
+    for (const AntSensorType sensorType: masterChannelTypes) {
+        if (!openMasterChannel(sensorType)) {
+            qWarning("Unable to reopen %s master channel.", qPrintable(ANT_SENSOR_TYPE_STRINGS[sensorType]));
+        }
+    }
+    for (const auto& sensor: sensors) {
+        if (!searchForSensor(sensor.first, sensor.second)) {
+            emit sensorNotFound(sensor.first, sensor.second);
+        }
+    }
 }
 
 void AntCentralDispatch::setChannelInfo(int, AntSensorType sensorType, int sensorDeviceNumber)
@@ -327,6 +543,7 @@ void AntCentralDispatch::handleChannelUnassigned(int channelNumber)
 {
     Q_ASSERT_X(_channels[channelNumber] != nullptr, "AntCentralDispatch::handleChannelUnassigned",
                "getting channel unassigned for empty channel number.");
+    _masterChannelScheduler->removeChannel(channelNumber);
     const auto handler = std::move(_channels[channelNumber]);
     _channels[channelNumber] = make_qobject_unique<AntChannelHandler>();
 
@@ -337,31 +554,127 @@ void AntCentralDispatch::handleChannelUnassigned(int channelNumber)
     }
 }
 
-void AntCentralDispatch::logAntMessage(const AntMessageIO io, const AntMessage2 &message)
+void AntCentralDispatch::logAntMessage(const AntMessageIO io, int stickNumber, const QByteArray &messageBytes)
 {
     if (_logFile.isWritable()) {
         const QString inOrOut = (io == AntMessageIO::INPUT) ? "IN" : "OUT";
-        const QString logMessage = QString("%1:\t%2\t%3\n")
+        const QString logMessage = QString("%1:\t%2\t%3\t%4\n")
                 .arg(QDateTime::currentDateTimeUtc().toString(Qt::ISODate))
                 .arg(inOrOut)
-                .arg(QString(message.toHex()));
+                .arg(stickNumber)
+                .arg(QString(messageBytes.toHex()));
 
         _logFile.write(logMessage.toUtf8());
         _logFile.flush();
     }
 }
 
+/**
+ * Messages from channel handlers carry the global channel number, which is translated to the channel number on the
+ * stick that holds the channel.
+ */
 void AntCentralDispatch::sendAntMessage(const AntMessage2 &message)
 {
-    Q_ASSERT_X(_antUsbStick.get(), "AntCentralDispatch::sendAntMessage", "usb stick should be present.");
-    if (_antUsbStick) {
-        if (_logFile.isOpen()) {
-            logAntMessage(AntMessageIO::OUTPUT, message);
+    const int channelNumber = message.contentByte(0);
+    const int stickNumber = stickNumberForChannel(channelNumber);
+    if (stickNumber < 0 || !_antUsbSticks[stickNumber].connected) {
+        qDebug() << "No ANT+ usb stick connected for channel" << channelNumber << ", dropping" << message.toString();
+        return;
+    }
+    const quint8 stickChannelNumber = static_cast<quint8>(channelNumber - _antUsbSticks[stickNumber].firstChannel);
+    writeToAntUsbStick(stickNumber, *AntMessage2::createMessageFromBytes(
+                           withChannelNumber(message.toBytes(), stickChannelNumber)));
+}
+
+/**
+ * Broadcasts of master channels are written to the stick by the scheduler thread, so they don't go through
+ * sendAntMessage() and are not logged.
+ */
+void AntCentralDispatch::scheduleMasterChannel(int channelNumber, AntSportPeriod channelPeriod,
+                                               AntMasterChannelHandler::BroadcastMessageFactory broadcastMessageFactory)
+{
+    const int stickNumber = stickNumberForChannel(channelNumber);
+    if (stickNumber < 0 || !_antUsbSticks[stickNumber].connected) {
+        qDebug() << "No ANT+ usb stick connected for master channel" << channelNumber;
+        return;
+    }
+    const AntUsbStick& stick = _antUsbSticks[stickNumber];
+    _masterChannelScheduler->addChannel(channelNumber, stick.device.get(),
+                                        static_cast<quint8>(channelNumber - stick.firstChannel), channelPeriod,
+                                        broadcastMessageFactory);
+}
+
+void AntCentralDispatch::writeToAntUsbStick(int stickNumber, const AntMessage2 &message)
+{
+    const AntUsbStick& stick = _antUsbSticks[stickNumber];
+    Q_ASSERT_X(stick.device.get(), "AntCentralDispatch::writeToAntUsbStick", "usb stick should be present.");
+    if (_logFile.isOpen()) {
+        logAntMessage(AntMessageIO::OUTPUT, stickNumber, message.toBytes());
+    } else {
+        qDebug() << "Log file is not open";
+    }
+    qDebug() << "Sending ANT Message to stick" << stickNumber << ":" << message.toString();
+    stick.device->writeAntMessage(message);
+}
+
+/**
+ * When a stick is lost, its channel handlers are removed and the sensors are searched for again (or the master
+ * channels are opened again) on the sticks that are still connected. If there's no room for a slave channel, we'll
+ * report that the sensor was not found, so users of this class can retry later.
+ */
+void AntCentralDispatch::handleAntUsbStickLost(int stickNumber)
+{
+    AntUsbStick& stick = _antUsbSticks[stickNumber];
+    if (!stick.connected) {
+        return;
+    }
+    qWarning("Connection to ANT+ usb stick %d lost.", stickNumber);
+    stick.connected = false;
+    stick.initialized = false;
+    stick.device->disconnect(stick.messageGatherer);
+    emit antUsbStickLost(stickNumber);
+
+    QList<AntSensorType> masterChannelTypes;
+    QList<QPair<AntSensorType,int>> sensors;
+    for (int channelNumber = stick.firstChannel;
+         channelNumber < stick.firstChannel + stick.device->numberOfChannels(); ++channelNumber) {
+        _masterChannelScheduler->removeChannel(channelNumber);
+        const auto handler = std::move(_channels[channelNumber]);
+        _channels[channelNumber] = make_qobject_unique<AntChannelHandler>();
+        if (!handler) {
+            continue;
+        }
+        handler->disconnect(this);
+        const AntSensorType sensorType = handler->sensorType();
+        if (dynamic_cast<AntMasterChannelHandler*>(handler.get())) {
+            _masterChannels.remove(sensorType);
+            masterChannelTypes.append(sensorType);
         } else {
-            qDebug() << "Log file is not open";
+            sensors.append(qMakePair(sensorType, handler->sensorDeviceNumber()));
+        }
+        emit channelClosed(channelNumber, sensorType);
+    }
+    if (!antAdapterPresent()) {
+        qWarning("Connection to all ANT+ usb sticks lost, initializing again.");
+        _initialized = false;
+        _lostMasterChannels.append(masterChannelTypes);
+        _lostSensors.append(sensors);
+        emit initializationFinished(false);
+        // the stick that is lost is still sending this signal, so don't delete it by scanning right away.
+        QTimer::singleShot(ANT_USB_STICK_RETRY_INTERVAL, this, SLOT(initialize()));
+        return;
+    }
+
+    for (const AntSensorType sensorType: masterChannelTypes) {
+        if (!openMasterChannel(sensorType)) {
+            qWarning("Unable to move %s master channel to another ANT+ usb stick.",
+                     qPrintable(ANT_SENSOR_TYPE_STRINGS[sensorType]));
+        }
+    }
+    for (const auto& sensor: sensors) {
+        if (!searchForSensor(sensor.first, sensor.second)) {
+            emit sensorNotFound(sensor.first, sensor.second);
         }
-        qDebug() << "Sending ANT Message:" << message.toString();
-        _antUsbStick->writeAntMessage(message);
     }
 }
 
@@ -378,12 +691,11 @@ bool AntCentralDispatch::sendToChannel(const T& message, std::function<void(indo
     }
 }
 
-void AntCentralDispatch::handleChannelEvent(const AntChannelEventMessage &channelEventMessage)
+void AntCentralDispatch::handleChannelEvent(int stickNumber, const AntChannelEventMessage &channelEventMessage)
 {
     if (channelEventMessage.messageId() == AntMessage2::AntMessageId::SET_NETWORK_KEY) {
-        _initializationTimer->stop();
-        _initialized = (channelEventMessage.messageCode() == AntChannelEventMessage::MessageCode::RESPONSE_NO_ERROR);
-        emit initializationFinished(_initialized);
+        handleNetworkKeySet(stickNumber, channelEventMessage.messageCode() ==
+                            AntChannelEventMessage::MessageCode::RESPONSE_NO_ERROR);
     } else {
         bool sent = sendToChannel<AntChannelEventMessage>(channelEventMessage,
                                                           [](indoorcycling::AntChannelHandler& channel,
@@ -25,11 +25,15 @@
 #include <vector>
 
 #include <QtCore/QFile>
+#include <QtCore/QList>
 #include <QtCore/QObject>
+#include <QtCore/QPair>
 #include <QtCore/QPointer>
 #include <QtCore/QTimer>
 #include <QtCore/QVector>
 
+#include "antchannelhandler.h"
+#include "antmasterchannelscheduler.h"
 #include "antsensortype.h"
 #include "util/util.h"
 
@@ -44,24 +48,33 @@ class SetChannelIdMessage;
 #include "antsensortype.h"
 
 namespace indoorcycling {
-class AntChannelHandler;
-class AntMasterChannelHandler;
 class AntHeartRateMasterChannelHandler;
 class AntPowerMasterChannelHandler;
 class AntSmartTrainerChannelHandler;
 
 /**
- * The Main ANT+ class that manages the connection with the ANT+ usb stick and through that stick, to the ANT+
+ * The Main ANT+ class that manages the connection with the ANT+ usb sticks and through those sticks, to the ANT+
  * sensors that are found.
+ *
+ * If more than one ANT+ usb stick is connected, the channels of all sticks are used. Channels are numbered
+ * globally: the channels of the first stick come first, followed by the channels of the second stick and so on.
+ * Channel handlers only see these global channel numbers, the translation to the channel number on the stick itself
+ * is done when messages are sent to or received from a stick.
  */
 class AntCentralDispatch : public QObject
 {
     Q_OBJECT
 public:
     explicit AntCentralDispatch(QObject *parent = 0);
+    /**
+     * Create an AntCentralDispatch that gets its AntDevices from antDevicesFactory instead of scanning for ANT+ usb
+     * sticks. Use this to run against simulated ANT+ devices.
+     */
+    AntCentralDispatch(std::function<std::vector<std::unique_ptr<AntDevice>>()> antDevicesFactory,
+                       QObject *parent = 0);
 
     /**
-     * Check if an ANT+ adapter is present.
+     * Check if an ANT+ adapter is present and connected.
      */
     bool antAdapterPresent() const;
     /**
@@ -82,11 +95,28 @@ public:
      * Check if all ANT+ channels are closed.
      */
     bool areAllChannelsClosed() const;
+    /**
+     * Timing statistics of the broadcasts of the open master channels.
+     */
+    QMap<AntSensorType,AntMasterChannelStatistics> masterChannelStatistics() const;
+    /**
+     * Statistics of the acknowledged messages sent to a sensor, by data page. Returns empty statistics if there is no
+     * channel for the sensor type. For a smart trainer, the statistics of the track resistance page show how long it
+     * takes for a slope change to reach the trainer.
+     */
+    QMap<quint8,AcknowledgedMessageStatistics> acknowledgedMessageStatistics(AntSensorType sensorType) const;
 signals:
-    /** signal emitted when scanning for an usb stick is finished. @param found indicates whether or not an ANT+ usb
+    /** signal emitted when scanning for usb sticks is finished. @param found indicates whether or not an ANT+ usb
      * stick was found.
      */
     void antUsbStickScanningFinished(bool found);
+    /**
+     * emitted when the connection to one of the ANT+ usb sticks is lost. The channels of that stick are moved to the
+     * other sticks, as far as there are free channels. If it was the last stick, initializationFinished(false) is
+     * emitted as well, and the ANT+ system is initialized again until a stick is found. The channels are reopened
+     * when that succeeds.
+     */
+    void antUsbStickLost(int stickNumber);
     /**
      * Signal emitted when the connection to the ANT+ stick and the ANT+ network has been set up. After this, we
      * can try to connect to or search for ANT+ sensors. If success is false, we have not been able to initialize the
@@ -157,15 +187,15 @@ public slots:
      */
     void setSlope(const qreal slopeInPercent);
 private slots:
-    void messageFromAntUsbStick(const QByteArray& bytes);
     /**
-     * Reset ANT+ USB Stick.
+     * Send a message from one of the channel handlers to the USB ANT+ Stick that holds the channel.
      */
-    void resetAntSystem();
+    void sendAntMessage(const AntMessage2& message);
     /**
-     * Set ANT+ Network Key
+     * Let the master channel scheduler send the broadcasts of a master channel.
      */
-    void sendNetworkKey();
+    void scheduleMasterChannel(int channelNumber, AntSportPeriod channelPeriod,
+                               AntMasterChannelHandler::BroadcastMessageFactory broadcastMessageFactory);
     /**
      * This slot is called when an Ant Channel is set to a certain device number.
      */
@@ -185,9 +215,41 @@ private slots:
     void handleChannelUnassigned(int channelNumber);
 private:
     /**
-     * Start scanning for an ANT+ usb stick. When scanning is finished, antUsbStickScanningFinished(AntDeviceType) is emitted.
+     * Start scanning for ANT+ usb sticks. When scanning is finished, antUsbStickScanningFinished(bool) is emitted.
+     */
+    void scanForAntUsbSticks();
+    /**
+     * Reset ANT+ USB Stick.
+     */
+    void resetAntSystem(int stickNumber);
+    /**
+     * Set ANT+ Network Key
      */
-    void scanForAntUsbStick();
+    void sendNetworkKey(int stickNumber);
+    /**
+     * handle the response to setting the network key, which is the last step of initializing a stick.
+     */
+    void handleNetworkKeySet(int stickNumber, bool success);
+    /**
+     * finish initialization, either because all sticks have responded or because the initialization timer ran out.
+     */
+    void finishInitialization();
+    /**
+     * handle the bytes of a single message from an ANT+ usb stick.
+     */
+    void bytesFromAntUsbStick(int stickNumber, const QByteArray& bytes);
+    /**
+     * handle a message from an ANT+ usb stick. Channel numbers in the message are global channel numbers.
+     */
+    void messageFromAntUsbStick(int stickNumber, const AntMessage2& antMessage);
+    /**
+     * handle the loss of an ANT+ usb stick. All channels of the stick are reopened on the other sticks.
+     */
+    void handleAntUsbStickLost(int stickNumber);
+    /**
+     * reopen the channels that were lost with the last ANT+ usb stick, after the ANT+ system is initialized again.
+     */
+    void reopenLostChannels();
 
     /**
      * find a channel for an AntSensorType. If no channel is configured for the type, this returns
@@ -196,23 +258,28 @@ private:
     AntChannelHandler *findChannelForSensorType(const AntSensorType &sensorType);
 
     /**
-     * find free channel
+     * find a free channel on the connected stick with the most free channels, so sensors are spread over all
+     * sticks. Returns -1 if all channels are occupied.
      */
     int findFreeChannel();
+    /**
+     * find the number of the stick that holds a channel, or -1 if there is no such stick.
+     */
+    int stickNumberForChannel(int channelNumber) const;
     /**
       Create a new channel
      */
     AntChannelHandler* createChannel(int channelNumber, AntSensorType& sensorType);
 
     /**
-     * Send a message to the USB ANT+ Stick.
+     * Send a message to a USB ANT+ Stick. Channel numbers in the message should be the channel numbers on the stick.
      */
-    void sendAntMessage(const AntMessage2& message);
+    void writeToAntUsbStick(int stickNumber, const AntMessage2& message);
 
     /**
      * handle a channel event message.
      */
-    void handleChannelEvent(const AntChannelEventMessage& channelEventMessage);
+    void handleChannelEvent(int stickNumber, const AntChannelEventMessage& channelEventMessage);
     /**
      * handle a broad cast message
      */
@@ -229,21 +296,41 @@ private:
     /**
      * Log ANT+ message
      */
-    void logAntMessage(const AntMessageIO io, const AntMessage2& message);
+    void logAntMessage(const AntMessageIO io, int stickNumber, const QByteArray& messageBytes);
 
     /** function template for sending a message to a channel. */
     template <class T>
     bool sendToChannel(const T& message, std::function<void(AntChannelHandler&, const T&)> sendFunction);
 
-    std::unique_ptr<AntDevice> _antUsbStick;
+    /** An ANT+ usb stick, with the channels it holds. */
+    struct AntUsbStick
+    {
+        std::unique_ptr<AntDevice> device;
+        AntMessageGatherer* messageGatherer = nullptr;
+        /** global channel number of the first channel of the stick. */
+        int firstChannel = 0;
+        bool connected = true;
+        /** true if the stick has responded to setting the network key */
+        bool initializationFinished = false;
+        bool initialized = false;
+    };
+
+    const std::function<std::vector<std::unique_ptr<AntDevice>>()> _antDevicesFactory;
+    std::vector<AntUsbStick> _antUsbSticks;
+    /** declared after the sticks, so the scheduler is stopped before the sticks are deleted. */
+    const std::unique_ptr<AntMasterChannelScheduler> _masterChannelScheduler;
     bool _initialized;
-    AntMessageGatherer* const _antMessageGatherer;
 
     std::vector<qobject_unique_ptr<AntChannelHandler>> _channels;
     QMap<AntSensorType,QPointer<AntMasterChannelHandler>> _masterChannels;
     QPointer<AntSmartTrainerChannelHandler> _smartTrainerChannelHandler;
     QPointer<AntPowerMasterChannelHandler> _powerTransmissionChannelHandler;
     QPointer<AntHeartRateMasterChannelHandler> _heartRateMasterChannelhandler;
+    /** master channels and sensors (type and device number) that were open on the last stick when it was lost. */
+    QList<AntSensorType> _lostMasterChannels;
+    QList<QPair<AntSensorType,int>> _lostSensors;
+    /** last slope set, so it can be restored when the smart trainer is moved to another stick. */
+    qreal _slope;
     QTimer* const _initializationTimer;
     QFile _logFile;
 };
@@ -19,6 +19,8 @@
  */
 #include "antchannelhandler.h"
 
+#include <algorithm>
+
 #include <QtCore/QMap>
 #include <QtCore/QtDebug>
 #include <QtCore/QTimer>
@@ -44,11 +46,30 @@ const QMap<AntChannelHandler::ChannelState,QString> CHANNEL_STATE_STRINGS(
 });
 }
 namespace indoorcycling {
+AcknowledgedMessagePolicy::AcknowledgedMessagePolicy(bool replacePending, int priority, int maximumRetries,
+                                                     int retryDelay, int maximumRetryDelay):
+    replacePending(replacePending), priority(priority), maximumRetries(maximumRetries), retryDelay(retryDelay),
+    maximumRetryDelay(maximumRetryDelay)
+{
+    // empty
+}
+
+qreal AcknowledgedMessageStatistics::meanLatencyNs() const
+{
+    return (completed == 0) ? 0 : static_cast<qreal>(totalLatencyNs) / completed;
+}
+
+quint8 AntChannelHandler::PendingAcknowledgedMessage::dataPage() const
+{
+    return message.contentByte(1);
+}
+
 AntChannelHandler::AntChannelHandler(const int channelNumber, const AntSensorType sensorType,
                                      AntSportPeriod channelPeriod, QObject *parent) :
     QObject(parent), _channelNumber(channelNumber), _deviceNumber(0), _sensorType(sensorType),
     _channelPeriod(channelPeriod),_state(ChannelState::CLOSED)
 {
+    _clock.start();
     _acknowledgedMessageTimer.setSingleShot(true);
     _acknowledgedMessageTimer.setInterval(ACKNOWLEDGED_MESSAGE_TIMEOUT);
     connect(&_acknowledgedMessageTimer, &QTimer::timeout, this, &AntChannelHandler::transferTxFailed);
@@ -59,6 +80,11 @@ quint8 AntChannelHandler::channelNumber() const
     return _channelNumber;
 }
 
+AntSportPeriod AntChannelHandler::channelPeriod() const
+{
+    return _channelPeriod;
+}
+
 bool AntChannelHandler::isMasterNode() const
 {
     return false;
@@ -95,6 +121,11 @@ int AntChannelHandler::sensorDeviceNumber() const
     return _deviceNumber;
 }
 
+const QMap<quint8, AcknowledgedMessageStatistics> &AntChannelHandler::acknowledgedMessageStatistics() const
+{
+    return _acknowledgedMessageStatistics;
+}
+
 void AntChannelHandler::setSensorDeviceNumber(int deviceNumber)
 {
     _deviceNumber = deviceNumber;
@@ -111,9 +142,7 @@ void AntChannelHandler::close()
 {
     qDebug() << QString("Closing channel #%1").arg(_channelNumber);
     setState(ChannelState::CLOSED);
-    while (!_acknowledgedMessagesToSend.empty()) {
-        _acknowledgedMessagesToSend.pop();
-    }
+    _acknowledgedMessagesToSend.clear();
     emit antMessageGenerated(AntMessage2::closeChannel(_channelNumber));
 }
 
@@ -202,56 +231,150 @@ void AntChannelHandler::assertMessageId(const AntMessage2::AntMessageId expected
 }
 
 
-void AntChannelHandler::queueAcknowledgedMessage(const AntMessage2 &message)
+/**
+ * A message that replaces a pending message takes over its place in the queue, but keeps the time at which it was
+ * queued itself, so the latency statistics show how long it takes before the latest value reaches the sensor.
+ */
+void AntChannelHandler::queueAcknowledgedMessage(const AntMessage2 &message, const AcknowledgedMessagePolicy &policy)
 {
+    PendingAcknowledgedMessage pendingMessage;
+    pendingMessage.message = message;
+    pendingMessage.policy = policy;
+    pendingMessage.queuedNs = _clock.nsecsElapsed();
+    pendingMessage.notBeforeNs = 0;
+    pendingMessage.failures = 0;
+
+    AcknowledgedMessageStatistics& statistics = _acknowledgedMessageStatistics[pendingMessage.dataPage()];
+    statistics.queued += 1;
+    if (policy.replacePending) {
+        for (PendingAcknowledgedMessage& queuedMessage: _acknowledgedMessagesToSend) {
+            if (queuedMessage.dataPage() == pendingMessage.dataPage()) {
+                queuedMessage = pendingMessage;
+                statistics.replaced += 1;
+                return;
+            }
+        }
+    }
+
     if (_acknowledgedMessagesToSend.size() > ACKNOWLEDGED_MESSAGE_QUEUE_SIZE) {
         qDebug() << channelIdString() << "Queueing Acknowledged message, queue is full. Removing oldest message from queue";
-        _acknowledgedMessagesToSend.pop();
+        auto oldest = std::min_element(_acknowledgedMessagesToSend.begin(), _acknowledgedMessagesToSend.end(),
+                                       [](const PendingAcknowledgedMessage& a, const PendingAcknowledgedMessage& b) {
+            return a.queuedNs < b.queuedNs;
+        });
+        _acknowledgedMessageStatistics[oldest->dataPage()].dropped += 1;
+        _acknowledgedMessagesToSend.erase(oldest);
     }
-    _acknowledgedMessagesToSend.push(message);
+    insertAcknowledgedMessage(pendingMessage);
     if (_acknowledgedMessagesToSend.size() > 1) {
         qDebug() << channelIdString() << "Queued Acknowledged message, queue size" << _acknowledgedMessagesToSend.size();
     }
 }
 
 /**
- * Send thee next Acknowledged message, if there's any to send. This should only be called after a broadcastmessage
- * has been received. When a message is sent, _acknowledgedMessageTimer is started to be able to deal with the fact
+ * Insert a message in the queue, after all messages with the same or a higher priority.
+ */
+void AntChannelHandler::insertAcknowledgedMessage(const PendingAcknowledgedMessage &pendingMessage)
+{
+    auto position = std::find_if(_acknowledgedMessagesToSend.begin(), _acknowledgedMessagesToSend.end(),
+                                 [&pendingMessage](const PendingAcknowledgedMessage& queuedMessage) {
+        return queuedMessage.policy.priority < pendingMessage.policy.priority;
+    });
+    _acknowledgedMessagesToSend.insert(position, pendingMessage);
+}
+
+bool AntChannelHandler::isAcknowledgedMessagePending(quint8 dataPage) const
+{
+    return std::any_of(_acknowledgedMessagesToSend.begin(), _acknowledgedMessagesToSend.end(),
+                       [dataPage](const PendingAcknowledgedMessage& queuedMessage) {
+        return queuedMessage.dataPage() == dataPage;
+    });
+}
+
+/**
+ * Send the next Acknowledged message, if there's any to send. This should only be called after a broadcastmessage
+ * has been received. Messages that are waiting for a retry are skipped until their retry delay has passed.
+ * When a message is sent, _acknowledgedMessageTimer is started to be able to deal with the fact
  * that no acknowledgement (SUCCESS or FAILURE) will be received.
  */
 void AntChannelHandler::sendNextAcknowledgedMessage()
 {
-    if (!_acknowledgedMessageInFlight && !_acknowledgedMessagesToSend.empty()) {
+    if (_acknowledgedMessageInFlight) {
+        return;
+    }
+    const qint64 nowNs = _clock.nsecsElapsed();
+    auto next = std::find_if(_acknowledgedMessagesToSend.begin(), _acknowledgedMessagesToSend.end(),
+                             [nowNs](const PendingAcknowledgedMessage& queuedMessage) {
+        return queuedMessage.notBeforeNs <= nowNs;
+    });
+    if (next != _acknowledgedMessagesToSend.end()) {
         qDebug() << channelIdString() << "sending acknowledged message";
+        _inFlightAcknowledgedMessage = *next;
+        _acknowledgedMessagesToSend.erase(next);
         _acknowledgedMessageInFlight = true;
         _acknowledgedMessageTimer.start();
-        emit antMessageGenerated(_acknowledgedMessagesToSend.front());
+        emit antMessageGenerated(_inFlightAcknowledgedMessage.message);
     }
 }
 
 /**
- * An acknowledged message transfer has been completed. Remove the message from the queue. If there are any more
- * messages on the queue, they will be sent after the next broadcast message has been received.
+ * An acknowledged message transfer has been completed. If there are any more messages on the queue, they will be
+ * sent after the next broadcast message has been received.
  */
 void AntChannelHandler::transferTxCompleted()
 {
     _acknowledgedMessageTimer.stop();
-    _acknowledgedMessageInFlight = false;
-    if (!_acknowledgedMessagesToSend.empty()) {
-        _acknowledgedMessagesToSend.pop();
-        qDebug() << "dequeued Acknowledged message, queue size" << _acknowledgedMessagesToSend.size();
+    if (!_acknowledgedMessageInFlight) {
+        return;
     }
+    _acknowledgedMessageInFlight = false;
+
+    const qint64 latencyNs = _clock.nsecsElapsed() - _inFlightAcknowledgedMessage.queuedNs;
+    AcknowledgedMessageStatistics& statistics =
+            _acknowledgedMessageStatistics[_inFlightAcknowledgedMessage.dataPage()];
+    statistics.completed += 1;
+    statistics.totalLatencyNs += latencyNs;
+    statistics.maximumLatencyNs = qMax(statistics.maximumLatencyNs, latencyNs);
+    qDebug() << "Acknowledged message completed, queue size" << _acknowledgedMessagesToSend.size();
 }
 
 /**
- * An acknowledged message transfer has failed. The last acknowledged message will be sent
- * again.
+ * An acknowledged message transfer has failed. If a newer message for the same data page is waiting, the failed
+ * message is dropped. Otherwise it is sent again after the retry delay of its policy, unless it has failed too often.
  */
 void AntChannelHandler::transferTxFailed()
 {
     _acknowledgedMessageTimer.stop();
-    qDebug() << "An acknowledged message failed. Trying it again";
+    if (!_acknowledgedMessageInFlight) {
+        return;
+    }
     _acknowledgedMessageInFlight = false;
+
+    PendingAcknowledgedMessage& failedMessage = _inFlightAcknowledgedMessage;
+    AcknowledgedMessageStatistics& statistics = _acknowledgedMessageStatistics[failedMessage.dataPage()];
+    statistics.failedTransfers += 1;
+    failedMessage.failures += 1;
+    if (failedMessage.policy.replacePending && isAcknowledgedMessagePending(failedMessage.dataPage())) {
+        qDebug() << channelIdString() << "An acknowledged message failed, but a newer message is waiting.";
+        statistics.replaced += 1;
+    } else if (failedMessage.policy.maximumRetries >= 0 &&
+               failedMessage.failures > failedMessage.policy.maximumRetries) {
+        qWarning("%s Acknowledged message failed %d times, giving up.", qPrintable(channelIdString()),
+                 failedMessage.failures);
+        statistics.dropped += 1;
+    } else {
+        qDebug() << "An acknowledged message failed. Trying it again";
+        const int maximumRetryDelay = qMax(failedMessage.policy.retryDelay, failedMessage.policy.maximumRetryDelay);
+        const int retryDelay = qMin(maximumRetryDelay,
+                                    failedMessage.policy.retryDelay << qMin(failedMessage.failures - 1, 16));
+        failedMessage.notBeforeNs = _clock.nsecsElapsed() + static_cast<qint64>(retryDelay) * 1000000;
+        // the failed message goes before the messages with the same priority, which were queued after it.
+        auto position = std::find_if(_acknowledgedMessagesToSend.begin(), _acknowledgedMessagesToSend.end(),
+                                     [&failedMessage](const PendingAcknowledgedMessage& queuedMessage) {
+            return queuedMessage.policy.priority <= failedMessage.policy.priority;
+        });
+        _acknowledgedMessagesToSend.insert(position, failedMessage);
+    }
     sendNextAcknowledgedMessage();
 }
 
@@ -338,4 +461,10 @@ void AntMasterChannelHandler::handleBroadCastMessage(const BroadCastMessage &)
     qDebug() << channelIdString() << QString("received broadcast message on master channel #%1").arg(channelNumber());
 }
 
+void AntMasterChannelHandler::channelOpened()
+{
+    qDebug() << channelIdString() << "master channel opened, start broadcasting";
+    emit broadcastingStarted(channelNumber(), channelPeriod(), broadcastMessageFactory());
+}
+
 }
@@ -20,8 +20,11 @@
 #ifndef ANTCHANNELHANDLER_H
 #define ANTCHANNELHANDLER_H
 
+#include <deque>
+#include <functional>
 #include <memory>
-#include <queue>
+#include <QtCore/QElapsedTimer>
+#include <QtCore/QMap>
 #include <QtCore/QObject>
 #include <QtCore/QTimer>
 
@@ -29,6 +32,44 @@
 #include "antsensortype.h"
 namespace indoorcycling
 {
+/**
+ * How an acknowledged message is queued and retried.
+ */
+struct AcknowledgedMessagePolicy
+{
+    explicit AcknowledgedMessagePolicy(bool replacePending = false, int priority = 0, int maximumRetries = -1,
+                                       int retryDelay = 0, int maximumRetryDelay = 0);
+
+    /** if true, the message replaces a message for the same data page that is still waiting to be sent. */
+    bool replacePending;
+    /** messages with a higher priority are sent first. */
+    int priority;
+    /** number of times a failed message is retried, or -1 to retry until it succeeds. */
+    int maximumRetries;
+    /** delay before the first retry in ms. The delay is doubled after every failure, up to maximumRetryDelay (ms). */
+    int retryDelay;
+    int maximumRetryDelay;
+};
+
+/**
+ * Statistics of the acknowledged messages for a data page. The latency of a message is the time between queueing the
+ * message and the sensor acknowledging it.
+ */
+struct AcknowledgedMessageStatistics
+{
+    quint64 queued = 0;
+    /** messages that were replaced by a newer message for the same page before they were acknowledged. */
+    quint64 replaced = 0;
+    quint64 completed = 0;
+    quint64 failedTransfers = 0;
+    /** messages that were dropped, because they failed too often or the queue was full. */
+    quint64 dropped = 0;
+    qint64 totalLatencyNs = 0;
+    qint64 maximumLatencyNs = 0;
+
+    qreal meanLatencyNs() const;
+};
+
 class AntChannelHandler : public QObject
 {
     Q_OBJECT
@@ -53,6 +94,8 @@ public:
     ChannelState state() const;
     AntSensorType sensorType() const;
     int sensorDeviceNumber() const;
+    /** statistics of the acknowledged messages sent on this channel, by data page. */
+    const QMap<quint8,AcknowledgedMessageStatistics>& acknowledgedMessageStatistics() const;
 signals:
     void antMessageGenerated(const AntMessage2& message);
     void sensorValue(const SensorValueType sensorValueType, const AntSensorType sensorType,
@@ -82,12 +125,15 @@ protected:
                                AntSportPeriod channelPeriod, QObject* parent);
 
     /**
-     * Queue an Acknowledged message. The message will be sent after all other messages on the queue have been sent.
-     * If the queue is filled up to ACKNOWLEDGED_MESSAGE_QUEUE_CAPACITY, the oldest message will be dropped.
+     * Queue an Acknowledged message. The message will be sent after all messages on the queue with the same or a
+     * higher priority have been sent. If the policy says so, the message replaces a pending message for the same
+     * data page. If the queue is filled up to ACKNOWLEDGED_MESSAGE_QUEUE_SIZE, the oldest message will be dropped.
      */
-    void queueAcknowledgedMessage(const AntMessage2 &message);
+    void queueAcknowledgedMessage(const AntMessage2 &message,
+                                  const AcknowledgedMessagePolicy& policy = AcknowledgedMessagePolicy());
 
     quint8 channelNumber() const;
+    AntSportPeriod channelPeriod() const;
 
     /** This method should be implemented by subclasses for their
      * specific way of handling broadcast messages.
@@ -119,11 +165,26 @@ private slots:
     /** Called when no acknowledgement has been received after sending an acknowledged message */
     void transferTxFailed();
 private:
+    /** An acknowledged message that is waiting to be sent, or is in flight. */
+    struct PendingAcknowledgedMessage
+    {
+        AntMessage2 message;
+        AcknowledgedMessagePolicy policy;
+        qint64 queuedNs;
+        /** after a failure, the message is not sent again before this time. */
+        qint64 notBeforeNs;
+        int failures;
+
+        quint8 dataPage() const;
+    };
+
     void setState(ChannelState state);
     void advanceState(const AntMessage2::AntMessageId messageId);
     void handleFirstBroadCastMessage(const BroadCastMessage&);
     void assertMessageId(const AntMessage2::AntMessageId expected, const AntMessage2::AntMessageId actual);
     void sendNextAcknowledgedMessage();
+    void insertAcknowledgedMessage(const PendingAcknowledgedMessage& pendingMessage);
+    bool isAcknowledgedMessagePending(quint8 dataPage) const;
 
     const int _channelNumber;
     int _deviceNumber;
@@ -131,10 +192,14 @@ private:
     const AntSportPeriod _channelPeriod;
     ChannelState _state;
 
-    /** A queue of acknowledged messages that must be sent. */
-    std::queue<AntMessage2> _acknowledgedMessagesToSend;
+    /** A queue of acknowledged messages that must be sent, ordered by priority. */
+    std::deque<PendingAcknowledgedMessage> _acknowledgedMessagesToSend;
     /** If this is true, there is an acknowledged message in flight and we cannot send a new one. */
     bool _acknowledgedMessageInFlight = false;
+    /** The message in flight, if _acknowledgedMessageInFlight is true. */
+    PendingAcknowledgedMessage _inFlightAcknowledgedMessage;
+    QMap<quint8,AcknowledgedMessageStatistics> _acknowledgedMessageStatistics;
+    QElapsedTimer _clock;
     /** Timer for acknowledged messages. Every time an acknowledged message is sent, this is timer is started every
         time an acknowledged message is sent. The timer is stopped when an acknowledgement is received. If it reaches
         the timeout, this is interpreted as a Failure and the message is sent again. */
@@ -145,12 +210,29 @@ class AntMasterChannelHandler: public AntChannelHandler
 {
     Q_OBJECT
 public:
+    /**
+     * Function that creates the next broadcast message of a master channel, for a channel number on an ANT+ stick.
+     * These functions are called from the scheduler thread, so they must be thread safe.
+     */
+    typedef std::function<AntMessage2(quint8 channelNumber)> BroadcastMessageFactory;
+
     AntMasterChannelHandler(int channelNumber, const AntSensorType sensorType,
                             AntSportPeriod channelPeriod, QObject* parent);
     virtual ~AntMasterChannelHandler() {}
     virtual void sendSensorValue(const SensorValueType valueType, const QVariant& value) = 0;
+signals:
+    /**
+     * emitted when the channel is opened. From then on, a broadcast message created by the broadcastMessageFactory
+     * should be sent every channel period.
+     */
+    void broadcastingStarted(int channelNumber, AntSportPeriod channelPeriod,
+                             BroadcastMessageFactory broadcastMessageFactory);
 protected:
     virtual void handleBroadCastMessage(const BroadCastMessage& message) final;
+    virtual void channelOpened() final;
+
+    /** Subclasses implement this to provide the function that creates their broadcast messages. */
+    virtual BroadcastMessageFactory broadcastMessageFactory() const = 0;
 
     /** these channels are always master */
     virtual bool isMasterNode() const final { return true; }
@@ -20,6 +20,8 @@
 
 #include "antdevice.h"
 #include "antmessage2.h"
+
+#include <QtCore/QThread>
 namespace {
 const QByteArray PADDING(5, '\0');
 }
@@ -38,9 +40,37 @@ bool AntDevice::writeAntMessage(const AntMessage2 &message)
     }
 }
 
+void AntDevice::writeAntMessages(const QVector<AntMessage2> &messages)
+{
+    QByteArray bytes;
+    for (const AntMessage2& message: messages) {
+        bytes += message.toBytes() + PADDING;
+    }
+    if (isThreadSafe() || QThread::currentThread() == thread()) {
+        writeQueuedBytes(bytes);
+    } else {
+        emit bytesQueuedForWriting(bytes);
+    }
+}
+
 AntDevice::AntDevice(QObject *parent) :
     QObject(parent)
 {
+    // the emitting thread differs from the thread of the device, so this is a queued connection.
+    connect(this, &AntDevice::bytesQueuedForWriting, this, &AntDevice::writeQueuedBytes);
+}
+
+bool AntDevice::isThreadSafe() const
+{
+    return false;
+}
+
+void AntDevice::writeQueuedBytes(const QByteArray &bytes)
+{
+    int nrOfBytesWritten = writeBytes(bytes);
+    if (nrOfBytesWritten != bytes.length()) {
+        qWarning("Tried to write %d bytes, but only %d bytes written", bytes.length(), nrOfBytesWritten);
+    }
 }
 
 }
@@ -71,13 +71,33 @@ public:
      * @return true if the message was written completely.
      */
     bool writeAntMessage(const AntMessage2& message);
+    /**
+     * @brief write a number of AntMessages to the device in a single write. Unlike the other write methods, this
+     * method can be called from any thread. If the device can only be written from its own thread, the write is
+     * queued to that thread.
+     * @param messages the messages to write.
+     */
+    void writeAntMessages(const QVector<AntMessage2>& messages);
 
     virtual bool isReady() const = 0;
 signals:
     void deviceReady();
     void bytesRead(const QByteArray& bytes);
+    /**
+     * emitted when the connection to the device is lost, for instance because the device was unplugged.
+     */
+    void connectionLost();
+    /** emitted when bytes are written from another thread than the thread of the device. */
+    void bytesQueuedForWriting(const QByteArray& bytes);
 protected:
     AntDevice(QObject* parent = 0);
+    /**
+     * @brief check if writeBytes() can be called from other threads than the thread of the device.
+     * The default implementation returns false.
+     */
+    virtual bool isThreadSafe() const;
+private slots:
+    void writeQueuedBytes(const QByteArray& bytes);
 };
 
 inline AntDevice::~AntDevice()
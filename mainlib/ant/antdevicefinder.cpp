@@ -56,4 +56,34 @@ std::unique_ptr<AntDevice> AntDeviceFinder::openAntDevice()
         return std::unique_ptr<AntDevice>();
   }
 }
+
+std::vector<std::unique_ptr<AntDevice>> AntDeviceFinder::openAntDevices()
+{
+    std::vector<std::unique_ptr<AntDevice>> antDevices;
+    bool usb1StickOpened = false;
+    const QVector<AntDeviceType> types = findAntDeviceTypes();
+    for (int stickNumber = 0; stickNumber < types.size(); ++stickNumber) {
+        switch(types[stickNumber]) {
+        case AntDeviceType::USB_1:
+#ifdef Q_OS_LINUX
+            if (usb1StickOpened) {
+                qWarning("Only one ANT+ USB1 stick is supported, skipping stick %d", stickNumber);
+            } else {
+                antDevices.push_back(std::unique_ptr<AntDevice>(new UnixSerialUsbAnt));
+                usb1StickOpened = true;
+            }
+#else
+            Q_UNUSED(usb1StickOpened);
+            antDevices.push_back(std::unique_ptr<AntDevice>(new Usb2AntDevice(stickNumber)));
+#endif
+            break;
+        case AntDeviceType::USB_2:
+            antDevices.push_back(std::unique_ptr<AntDevice>(new Usb2AntDevice(stickNumber)));
+            break;
+        default:
+            break;
+        }
+    }
+    return antDevices;
+}
 }
@@ -22,6 +22,7 @@
 #define ANTDEVICEFINDER_H
 
 #include <memory>
+#include <vector>
 
 #include <QObject>
 #include <QSharedPointer>
@@ -30,8 +31,8 @@
 namespace indoorcycling {
 
 /**
- * AntDeviceFinder will find and open an ANT+ USB stick. Use the openAntDevice() method for getting a
- * unique pointer to the AntDevice.
+ * AntDeviceFinder will find and open ANT+ USB sticks. Use the openAntDevice() method for getting a
+ * unique pointer to the AntDevice, or openAntDevices() to open all sticks that are connected.
  */
 class AntDeviceFinder : public QObject
 {
@@ -42,6 +43,12 @@ public:
 
     /** Open an AntDevice. Returns an invalid pointer if no device can be found. */
     std::unique_ptr<AntDevice> openAntDevice();
+
+    /**
+     * Open all connected AntDevices. Returns an empty vector if no device can be found. Only one USB1 stick is
+     * supported, as USB1 sticks are accessed through the first matching serial port.
+     */
+    std::vector<std::unique_ptr<AntDevice>> openAntDevices();
 };
 }
 #endif // ANTDEVICEFINDER_H
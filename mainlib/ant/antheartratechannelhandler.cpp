@@ -94,16 +94,16 @@ void AntHeartRateChannelHandler::handleBroadCastMessage(const BroadCastMessage &
 
 AntHeartRateMasterChannelHandler::AntHeartRateMasterChannelHandler(int channelNumber, QObject *parent):
     AntMasterChannelHandler(channelNumber, AntSensorType::HEART_RATE, AntSportPeriod::HR, parent),
-    _updateTimer(new QTimer(this)), _updateCounter(0), _heartRate(0), _lastEventTime(0), _lastNrOfHeartBeats(0)
+    _transmittedValues(std::make_shared<TransmittedValues>())
 {
-    _updateTimer->setInterval(250);
-    connect(_updateTimer, &QTimer::timeout, this, &AntHeartRateMasterChannelHandler::sendMessage);
+    // empty
 }
 
 void AntHeartRateMasterChannelHandler::sendSensorValue(const SensorValueType valueType, const QVariant &value)
 {
     if (valueType == SensorValueType::HEARTRATE_BPM) {
-        _heartRate = value.toInt();
+        QMutexLocker locker(&_transmittedValues->mutex);
+        _transmittedValues->heartRate = value.toInt();
     }
 }
 
@@ -112,22 +112,28 @@ quint8 AntHeartRateMasterChannelHandler::transmissionType() const
     return HEARTRATE_MASTER_CHANNEL_TRANSMISSION_TYPE;
 }
 
-void AntHeartRateMasterChannelHandler::channelOpened()
-{
-    _updateTimer->start();
-}
-
-void AntHeartRateMasterChannelHandler::sendMessage()
+/**
+ * The factory holds a shared pointer to the transmitted values, so it stays valid if the handler is deleted while
+ * the scheduler is still using it.
+ */
+AntMasterChannelHandler::BroadcastMessageFactory AntHeartRateMasterChannelHandler::broadcastMessageFactory() const
 {
-    int elapsed = _lastSendTime.restart();
-    quint16 elapsedIn1024 = static_cast<quint16>(qRound(elapsed * 1.024));
-    _lastEventTime += elapsedIn1024;
-    _lastNrOfHeartBeats += (_heartRate / 4);
-
-    bool toggle = ((_updateCounter / 4) > 0);
-    _updateCounter = (_updateCounter + 1) % 8;
-    AntMessage2 hrMessage = HeartRateMessage::createHeartRateMessage(channelNumber(), toggle, _lastEventTime, _lastNrOfHeartBeats, _heartRate);
-    emit antMessageGenerated(hrMessage);
+    const std::shared_ptr<TransmittedValues> values = _transmittedValues;
+    return [values](quint8 channelNumber) -> AntMessage2 {
+        QMutexLocker locker(&values->mutex);
+        const qint64 elapsed = (values->lastSendTime.isValid()) ? values->lastSendTime.restart() : 0;
+        if (!values->lastSendTime.isValid()) {
+            values->lastSendTime.start();
+        }
+        quint16 elapsedIn1024 = static_cast<quint16>(qRound(elapsed * 1.024));
+        values->lastEventTime += elapsedIn1024;
+        values->lastNrOfHeartBeats += (values->heartRate / 4);
+
+        bool toggle = ((values->updateCounter / 4) > 0);
+        values->updateCounter = (values->updateCounter + 1) % 8;
+        return HeartRateMessage::createHeartRateMessage(channelNumber, toggle, values->lastEventTime,
+                                                        values->lastNrOfHeartBeats, values->heartRate);
+    };
 }
 
 }
@@ -20,9 +20,11 @@
 #ifndef ANTHEARTRATECHANNELHANDLER_H
 #define ANTHEARTRATECHANNELHANDLER_H
 
+#include <memory>
+
+#include <QtCore/QElapsedTimer>
+#include <QtCore/QMutex>
 #include <QtCore/QObject>
-#include <QtCore/QTime>
-#include <QtCore/QTimer>
 
 #include "antchannelhandler.h"
 namespace indoorcycling {
@@ -104,18 +106,22 @@ public:
     virtual void sendSensorValue(const SensorValueType valueType, const QVariant &value) override;
 protected:
     virtual quint8 transmissionType() const override;
-    virtual void channelOpened() override;
-private slots:
-    void sendMessage();
+    virtual BroadcastMessageFactory broadcastMessageFactory() const override;
 private:
-    QTimer* const _updateTimer;
-    QTime _lastSendTime;
-
-    int _updateCounter;
-    quint8 _heartRate;
-    quint16 _lastEventTime;
-    quint8 _lastNrOfHeartBeats;
-
+    /**
+     * The values that are transmitted. The heart rate is set from the thread of the handler, the rest is updated
+     * from the scheduler thread that sends the broadcasts.
+     */
+    struct TransmittedValues
+    {
+        QMutex mutex;
+        QElapsedTimer lastSendTime;
+        int updateCounter = 0;
+        quint8 heartRate = 0;
+        quint16 lastEventTime = 0;
+        quint8 lastNrOfHeartBeats = 0;
+    };
+    const std::shared_ptr<TransmittedValues> _transmittedValues;
 };
 }
 #endif // ANTHEARTRATECHANNELHANDLER_H
@@ -0,0 +1,168 @@
+/*
+ * Copyright (c) 2015 Ilja Booij (ibooij@gmail.com)
+ *
+ * This file is part of Big Ring Indoor Video Cycling
+ *
+ * Big Ring Indoor Video Cycling is free software: you can redistribute
+ * it and/or modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation, either version 3 of the
+ * License, or (at your option) any later version.
+ *
+ * Big Ring Indoor Video Cycling  is distributed in the hope that it will
+ * be useful, but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+
+ * You should have received a copy of the GNU General Public License
+ * along with Big Ring Indoor Video Cycling.  If not, see
+ * <http://www.gnu.org/licenses/>.
+ */
+
+#include "antmasterchannelscheduler.h"
+
+#include <cmath>
+#include <limits>
+
+#include <QtCore/QtDebug>
+#include <QtCore/QVector>
+
+#include "antdevice.h"
+
+namespace
+{
+const qint64 NS_PER_MS = 1000000;
+const qint64 NS_PER_US = 1000;
+}
+
+namespace indoorcycling
+{
+
+qreal AntMasterChannelStatistics::meanLatenessNs() const
+{
+    return (broadcastsSent == 0) ? 0 : static_cast<qreal>(totalLatenessNs) / broadcastsSent;
+}
+
+qreal AntMasterChannelStatistics::jitterNs() const
+{
+    if (broadcastsSent == 0) {
+        return 0;
+    }
+    const qreal mean = meanLatenessNs();
+    return std::sqrt(qMax(0.0, totalSquaredLatenessNs / broadcastsSent - mean * mean));
+}
+
+qint64 AntMasterChannelScheduler::ScheduledChannel::deadlineNs() const
+{
+    return startNs + broadcastNumber * periodNs;
+}
+
+AntMasterChannelScheduler::AntMasterChannelScheduler(QObject *parent):
+    QThread(parent), _stopping(false)
+{
+    _clock.start();
+    start(QThread::TimeCriticalPriority);
+}
+
+AntMasterChannelScheduler::~AntMasterChannelScheduler()
+{
+    {
+        QMutexLocker locker(&_mutex);
+        _stopping = true;
+        _scheduleChanged.wakeAll();
+    }
+    wait();
+}
+
+void AntMasterChannelScheduler::addChannel(int channelNumber, AntDevice *device, quint8 deviceChannelNumber,
+                                           AntSportPeriod channelPeriod,
+                                           AntMasterChannelHandler::BroadcastMessageFactory broadcastMessageFactory)
+{
+    ScheduledChannel channel;
+    channel.device = device;
+    channel.deviceChannelNumber = deviceChannelNumber;
+    // the period is not a whole number of nanoseconds, so multiply first to keep the rounding error small.
+    channel.periodNs = static_cast<qint64>(channelPeriod) * 1000000000 / 32768;
+    channel.broadcastNumber = 0;
+    channel.broadcastMessageFactory = broadcastMessageFactory;
+
+    QMutexLocker locker(&_mutex);
+    channel.startNs = _clock.nsecsElapsed();
+    _channels[channelNumber] = channel;
+    _scheduleChanged.wakeAll();
+}
+
+void AntMasterChannelScheduler::removeChannel(int channelNumber)
+{
+    QMutexLocker locker(&_mutex);
+    _channels.remove(channelNumber);
+    _scheduleChanged.wakeAll();
+}
+
+QMap<int, AntMasterChannelStatistics> AntMasterChannelScheduler::statistics() const
+{
+    QMap<int, AntMasterChannelStatistics> statistics;
+    QMutexLocker locker(&_mutex);
+    for (auto it = _channels.constBegin(); it != _channels.constEnd(); ++it) {
+        statistics[it.key()] = it.value().statistics;
+    }
+    return statistics;
+}
+
+/**
+ * The wait conditions only have millisecond resolution, so we'll wait for whole milliseconds and sleep for the
+ * rest of the time until the next broadcast is due.
+ */
+void AntMasterChannelScheduler::run()
+{
+    QMutexLocker locker(&_mutex);
+    while (!_stopping) {
+        const qint64 nextDeadlineNs = sendDueBroadcasts();
+        if (_channels.isEmpty()) {
+            _scheduleChanged.wait(&_mutex);
+            continue;
+        }
+        const qint64 waitNs = nextDeadlineNs - _clock.nsecsElapsed();
+        if (waitNs >= NS_PER_MS) {
+            _scheduleChanged.wait(&_mutex, static_cast<unsigned long>(waitNs / NS_PER_MS));
+        } else if (waitNs > 0) {
+            locker.unlock();
+            usleep(static_cast<unsigned long>((waitNs + NS_PER_US - 1) / NS_PER_US));
+            locker.relock();
+        }
+    }
+}
+
+/**
+ * If we're more than a channel period late, for instance because the system was suspended, the missed broadcasts
+ * are skipped instead of being sent in a burst. The broadcasts are written while the mutex is held, so a removed
+ * channel will never be written to.
+ */
+qint64 AntMasterChannelScheduler::sendDueBroadcasts()
+{
+    QMap<AntDevice*,QVector<AntMessage2>> broadcasts;
+    qint64 nextDeadlineNs = std::numeric_limits<qint64>::max();
+    const qint64 nowNs = _clock.nsecsElapsed();
+    for (ScheduledChannel& channel: _channels) {
+        if (channel.deadlineNs() <= nowNs) {
+            const qint64 missed = (nowNs - channel.deadlineNs()) / channel.periodNs;
+            channel.broadcastNumber += missed;
+            channel.statistics.broadcastsMissed += missed;
+
+            const qint64 latenessNs = nowNs - channel.deadlineNs();
+            channel.statistics.broadcastsSent += 1;
+            channel.statistics.totalLatenessNs += latenessNs;
+            channel.statistics.totalSquaredLatenessNs += static_cast<qreal>(latenessNs) * latenessNs;
+            channel.statistics.maximumLatenessNs = qMax(channel.statistics.maximumLatenessNs, latenessNs);
+
+            broadcasts[channel.device].append(channel.broadcastMessageFactory(channel.deviceChannelNumber));
+            channel.broadcastNumber += 1;
+        }
+        nextDeadlineNs = qMin(nextDeadlineNs, channel.deadlineNs());
+    }
+    for (auto it = broadcasts.constBegin(); it != broadcasts.constEnd(); ++it) {
+        it.key()->writeAntMessages(it.value());
+    }
+    return nextDeadlineNs;
+}
+
+}
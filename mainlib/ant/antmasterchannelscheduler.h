@@ -0,0 +1,113 @@
+/*
+ * Copyright (c) 2015 Ilja Booij (ibooij@gmail.com)
+ *
+ * This file is part of Big Ring Indoor Video Cycling
+ *
+ * Big Ring Indoor Video Cycling is free software: you can redistribute
+ * it and/or modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation, either version 3 of the
+ * License, or (at your option) any later version.
+ *
+ * Big Ring Indoor Video Cycling  is distributed in the hope that it will
+ * be useful, but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+
+ * You should have received a copy of the GNU General Public License
+ * along with Big Ring Indoor Video Cycling.  If not, see
+ * <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef ANTMASTERCHANNELSCHEDULER_H
+#define ANTMASTERCHANNELSCHEDULER_H
+
+#include <QtCore/QElapsedTimer>
+#include <QtCore/QMap>
+#include <QtCore/QMutex>
+#include <QtCore/QThread>
+#include <QtCore/QWaitCondition>
+
+#include "antchannelhandler.h"
+
+namespace indoorcycling
+{
+class AntDevice;
+
+/**
+ * Timing statistics of a scheduled master channel. The lateness of a broadcast is the time between the moment it
+ * was due and the moment it was written to the ANT+ stick.
+ */
+struct AntMasterChannelStatistics
+{
+    quint64 broadcastsSent = 0;
+    /** broadcasts that were skipped, because the scheduler was more than a channel period late. */
+    quint64 broadcastsMissed = 0;
+    qint64 maximumLatenessNs = 0;
+    qint64 totalLatenessNs = 0;
+    qreal totalSquaredLatenessNs = 0;
+
+    qreal meanLatenessNs() const;
+    /** standard deviation of the lateness, the jitter of the broadcasts */
+    qreal jitterNs() const;
+};
+
+/**
+ * Sends the broadcasts of ANT+ master channels at their channel period. The scheduler runs in its own high priority
+ * thread, so broadcasts keep their rate when the GUI thread is busy.
+ *
+ * Broadcast n of a channel is due at n channel periods after the channel was added, measured with a monotonic clock.
+ * Deadlines don't depend on the moment the previous broadcast was actually sent, so lateness does not accumulate
+ * into drift. All broadcasts that are due at the same moment for the same stick are written in a single write.
+ */
+class AntMasterChannelScheduler : public QThread
+{
+    Q_OBJECT
+public:
+    explicit AntMasterChannelScheduler(QObject* parent = 0);
+    virtual ~AntMasterChannelScheduler();
+
+    /**
+     * Start sending broadcasts for a channel.
+     * @param channelNumber the (global) channel number, used to identify the channel.
+     * @param device the ANT+ stick the channel is on.
+     * @param deviceChannelNumber the channel number on the stick.
+     * @param channelPeriod the channel period.
+     * @param broadcastMessageFactory function that creates the broadcast messages.
+     */
+    void addChannel(int channelNumber, AntDevice* device, quint8 deviceChannelNumber, AntSportPeriod channelPeriod,
+                    AntMasterChannelHandler::BroadcastMessageFactory broadcastMessageFactory);
+    /**
+     * Stop sending broadcasts for a channel. When this method returns, no more broadcasts will be written for the
+     * channel.
+     */
+    void removeChannel(int channelNumber);
+
+    /** timing statistics of the scheduled channels, by channel number. */
+    QMap<int,AntMasterChannelStatistics> statistics() const;
+protected:
+    virtual void run() override;
+private:
+    struct ScheduledChannel
+    {
+        AntDevice* device;
+        quint8 deviceChannelNumber;
+        qint64 periodNs;
+        qint64 startNs;
+        qint64 broadcastNumber;
+        AntMasterChannelHandler::BroadcastMessageFactory broadcastMessageFactory;
+        AntMasterChannelStatistics statistics;
+
+        qint64 deadlineNs() const;
+    };
+
+    /** write all broadcasts that are due, and return the time at which the next broadcast is due. */
+    qint64 sendDueBroadcasts();
+
+    mutable QMutex _mutex;
+    QWaitCondition _scheduleChanged;
+    bool _stopping;
+    QElapsedTimer _clock;
+    QMap<int,ScheduledChannel> _channels;
+};
+}
+#endif // ANTMASTERCHANNELSCHEDULER_H
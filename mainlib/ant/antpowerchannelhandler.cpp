@@ -87,29 +87,26 @@ void AntPowerSlaveChannelHandler::handleBroadCastMessage(const BroadCastMessage
 
 AntPowerMasterChannelHandler::AntPowerMasterChannelHandler(int channelNumber, QObject *parent):
     AntMasterChannelHandler(channelNumber, AntSensorType::POWER, AntSportPeriod::POWER, parent),
-    _updateTimer(new QTimer(this)), _eventCount(0u), _accumulatedPower(0u), _cadence(0u)
+    _transmittedValues(std::make_shared<TransmittedValues>())
 {
     setSensorDeviceNumber(1);
-    _updateTimer->setTimerType(Qt::PreciseTimer);
-    _updateTimer->setInterval(250);
-    connect(_updateTimer, &QTimer::timeout, this, &AntPowerMasterChannelHandler::sendPowerUpdate);
 }
 
 void AntPowerMasterChannelHandler::setPower(quint16 power)
 {
-    _eventCount += 1;
-    _instantaneousPower = power;
-    _accumulatedPower += power;
+    QMutexLocker locker(&_transmittedValues->mutex);
+    _transmittedValues->eventCount += 1;
+    _transmittedValues->instantaneousPower = power;
+    _transmittedValues->accumulatedPower += power;
 }
 
 void AntPowerMasterChannelHandler::sendSensorValue(const SensorValueType valueType, const QVariant &value)
 {
     if (valueType == SensorValueType::POWER_WATT) {
-        _eventCount += 1;
-        _instantaneousPower = value.toInt();
-        _accumulatedPower += _instantaneousPower;
+        setPower(value.toInt());
     } else if (valueType == SensorValueType::CADENCE_RPM) {
-        _cadence = value.toInt();
+        QMutexLocker locker(&_transmittedValues->mutex);
+        _transmittedValues->cadence = value.toInt();
     }
 }
 
@@ -118,17 +115,18 @@ quint8 AntPowerMasterChannelHandler::transmissionType() const
     return SENDING_POWER_CHANNEL_TRANSMISSION_TYPE;
 }
 
-void AntPowerMasterChannelHandler::channelOpened()
+/**
+ * The factory holds a shared pointer to the transmitted values, so it stays valid if the handler is deleted while
+ * the scheduler is still using it.
+ */
+AntMasterChannelHandler::BroadcastMessageFactory AntPowerMasterChannelHandler::broadcastMessageFactory() const
 {
-    qDebug() << "Power transmission channel opened";
-    _updateTimer->start();
-}
-
-void AntPowerMasterChannelHandler::sendPowerUpdate()
-{
-    qDebug() << "sending power update" << _eventCount << _instantaneousPower << _accumulatedPower;
-    emit antMessageGenerated(PowerMessage::createPowerMessage(channelNumber(), _eventCount, _cadence,
-                                                              _accumulatedPower, _instantaneousPower));
+    const std::shared_ptr<TransmittedValues> values = _transmittedValues;
+    return [values](quint8 channelNumber) -> AntMessage2 {
+        QMutexLocker locker(&values->mutex);
+        return PowerMessage::createPowerMessage(channelNumber, values->eventCount, values->cadence,
+                                                values->accumulatedPower, values->instantaneousPower);
+    };
 }
 
 }
@@ -2,7 +2,10 @@
 #define ANTPOWERCHANNELHANDLER_H
 
 #include "antchannelhandler.h"
-#include <QtCore/QTimer>
+
+#include <memory>
+
+#include <QtCore/QMutex>
 namespace indoorcycling
 {
 /** Power message
@@ -88,16 +91,21 @@ public slots:
     virtual void sendSensorValue(const SensorValueType valueType, const QVariant &value) override;
 protected:
     virtual quint8 transmissionType() const override;
-    virtual void channelOpened() override;
-private slots:
-    void sendPowerUpdate();
+    virtual BroadcastMessageFactory broadcastMessageFactory() const override;
 private:
-    QTimer* const _updateTimer;
-
-    quint8 _eventCount;
-    quint16 _accumulatedPower;
-    quint16 _instantaneousPower;
-    quint8 _cadence;
+    /**
+     * The values that are transmitted. They're set from the thread of the handler and read from the scheduler thread
+     * that sends the broadcasts.
+     */
+    struct TransmittedValues
+    {
+        QMutex mutex;
+        quint8 eventCount = 0u;
+        quint16 accumulatedPower = 0u;
+        quint16 instantaneousPower = 0u;
+        quint8 cadence = 0u;
+    };
+    const std::shared_ptr<TransmittedValues> _transmittedValues;
 };
 }
 #endif // ANTPOWERCHANNELHANDLER_H
@@ -6,6 +6,18 @@ const quint8 TRAINER_EQUIPMENT_TYPE = 25;
 
 const int CONFIGURATION_CHECK_INTERVAL = 5000;
 
+// Acknowledged message policies. Only the latest value of a page is relevant, so new messages replace pending
+// messages for the same page.
+// Slope changes many times per second, so failed track resistance messages are retried right away: a newer slope
+// will usually replace them anyway. As there is almost always a track resistance message waiting during a ride, it
+// has the lowest priority, otherwise the other pages would never be sent.
+const indoorcycling::AcknowledgedMessagePolicy TRACK_RESISTANCE_POLICY(true, 1);
+// the trainer can't be used before we know its capabilities, so the request goes first.
+const indoorcycling::AcknowledgedMessagePolicy CAPABILITIES_REQUEST_POLICY(true, 3, -1, 250, 2000);
+// configuration is only sent once in a while, so it goes before the track resistance. If the trainer does not
+// respond, back off, so the track resistance messages are sent in the meantime.
+const indoorcycling::AcknowledgedMessagePolicy CONFIGURATION_POLICY(true, 2, -1, 250, 4000);
+
 }
 namespace indoorcycling {
 
@@ -370,28 +382,28 @@ void AntSmartTrainerChannelHandler::handleUserConfigurationMessage(const UserCon
 void AntSmartTrainerChannelHandler::requestCapabilities()
 {
     AntMessage2 requestCapabiltiesMessage = createRequestMessage(DataPage::FE_CAPABILITIES);
-    queueAcknowledgedMessage(requestCapabiltiesMessage);
+    queueAcknowledgedMessage(requestCapabiltiesMessage, CAPABILITIES_REQUEST_POLICY);
     setState(State::CAPABILITIES_REQUESTED);
 }
 
 void AntSmartTrainerChannelHandler::sendWindResistanceMessage()
 {
     if (_state == State::INITIALIZED) {
-        queueAcknowledgedMessage(createWindResistenceMessage());
+        queueAcknowledgedMessage(createWindResistenceMessage(), CONFIGURATION_POLICY);
     }
 }
 
 void AntSmartTrainerChannelHandler::sendTrackResistanceMessage()
 {
     if (_state == State::INITIALIZED) {
-        queueAcknowledgedMessage(createTrackResistanceMessage());
+        queueAcknowledgedMessage(createTrackResistanceMessage(), TRACK_RESISTANCE_POLICY);
     }
 }
 
 void AntSmartTrainerChannelHandler::sendUserConfigurationMessage()
 {
     if (_state == State::INITIALIZED) {
-        queueAcknowledgedMessage(createUserConfigurationMessage());
+        queueAcknowledgedMessage(createUserConfigurationMessage(), CONFIGURATION_POLICY);
     }
 }
 
@@ -0,0 +1,613 @@
+/*
+ * Copyright (c) 2015 Ilja Booij (ibooij@gmail.com)
+ *
+ * This file is part of Big Ring Indoor Video Cycling
+ *
+ * Big Ring Indoor Video Cycling is free software: you can redistribute
+ * it and/or modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation, either version 3 of the
+ * License, or (at your option) any later version.
+ *
+ * Big Ring Indoor Video Cycling  is distributed in the hope that it will
+ * be useful, but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+
+ * You should have received a copy of the GNU General Public License
+ * along with Big Ring Indoor Video Cycling.  If not, see
+ * <http://www.gnu.org/licenses/>.
+ */
+#include "simulatedantdevice.h"
+
+#include <cmath>
+
+#include <QtCore/QtDebug>
+
+#include "antheartratechannelhandler.h"
+#include "antmessagegatherer.h"
+#include "antpowerchannelhandler.h"
+#include "antsmarttrainerchannelhandler.h"
+
+namespace
+{
+// ANT message periods are expressed in 1/32768 of a second.
+const qreal MESSAGE_PERIOD_BASE = 32768.0;
+// Message id used in channel events that are not a response to a message from the host.
+const quint8 RF_EVENT_MESSAGE_ID = 0x01;
+// Search timeouts are expressed in units of 2.5 seconds.
+const int SEARCH_TIMEOUT_UNIT = 2500; // ms
+const quint8 INFINITE_SEARCH_TIMEOUT = 0xFF;
+const quint8 MASTER_CHANNEL_TYPE = 0x10;
+const quint8 SENSOR_TRANSMISSION_TYPE = 0x01;
+
+const qreal WHEEL_CIRCUMFERENCE = 2.070; // meters
+const quint8 TRAINER_EQUIPMENT_TYPE = 25;
+const quint8 TRAINER_STATE_IN_USE = 0x30;
+const quint16 TRAINER_MAXIMUM_RESISTANCE = 2000; // Newton
+const quint8 TRAINER_CAPABILITIES = 0x07; // basic resistance, target power and simulation mode.
+
+/**
+ * Add the revolutions made in elapsedSeconds to revolutions. If a revolution has been completed, eventTime is set
+ * to the time of the last completed revolution, in 1/1024 seconds, and true is returned.
+ */
+bool accumulateRevolutions(qreal& revolutions, quint16& eventTime, qreal rpm, qreal elapsedSeconds,
+                           qreal nowSeconds)
+{
+    if (rpm <= 0) {
+        return false;
+    }
+    const qreal revolutionsPerSecond = rpm / 60.0;
+    const qreal previousRevolutions = std::floor(revolutions);
+    revolutions += revolutionsPerSecond * elapsedSeconds;
+    const qreal currentRevolutions = std::floor(revolutions);
+    if (currentRevolutions == previousRevolutions) {
+        return false;
+    }
+    const qreal secondsSinceLastRevolution = (revolutions - currentRevolutions) / revolutionsPerSecond;
+    eventTime = static_cast<quint16>(qRound64((nowSeconds - secondsSinceLastRevolution) * 1024) & 0xFFFF);
+    return true;
+}
+
+quint16 revolutionCount(qreal revolutions)
+{
+    return static_cast<quint16>(static_cast<quint64>(revolutions) & 0xFFFF);
+}
+
+void appendShort(QByteArray& content, quint16 value)
+{
+    content += static_cast<char>(value & 0xFF);
+    content += static_cast<char>((value >> 8) & 0xFF);
+}
+}
+
+namespace indoorcycling
+{
+
+SimulatedAntSensor::SimulatedAntSensor(AntSensorType sensorType, int deviceNumber):
+    sensorType(sensorType), deviceNumber(deviceNumber), messagePeriod(0), jitterMs(0), dropoutProbability(0),
+    collisionProbability(0)
+{
+    // empty
+}
+
+SimulatedAntDevice::SensorState::SensorState(const SimulatedAntSensor &settings):
+    settings(settings), channelNumber(-1), lastUpdateNs(0), messageCounter(0), eventCount(0), accumulatedPower(0),
+    heartBeats(0), pedalRevolutions(0), wheelRevolutions(0), distance(0), heartBeatEventTime(0),
+    cadenceEventTime(0), speedEventTime(0), requestedPage(0), requestedPageCount(0)
+{
+    // empty
+}
+
+SimulatedAntDevice::SimulatedAntDevice(int numberOfChannels, QObject *parent) :
+    AntDevice(parent), _numberOfChannels(numberOfChannels), _connected(true), _hostMessageGatherer(new AntMessageGatherer(this)),
+    _channels(numberOfChannels), _heartRate(120), _power(200), _cadence(90), _wheelSpeedRpm(250)
+{
+    _clock.start();
+    connect(_hostMessageGatherer, &AntMessageGatherer::antMessageReceived, this,
+            &SimulatedAntDevice::handleHostMessage);
+
+    _flushTimer.setSingleShot(true);
+    _flushTimer.setInterval(0);
+    connect(&_flushTimer, &QTimer::timeout, this, &SimulatedAntDevice::flush);
+
+    for (int channelNumber = 0; channelNumber < _numberOfChannels; ++channelNumber) {
+        Channel& channel = _channels[channelNumber];
+        channel.messageTimer = new QTimer(this);
+        channel.messageTimer->setSingleShot(true);
+        channel.messageTimer->setTimerType(Qt::PreciseTimer);
+        connect(channel.messageTimer, &QTimer::timeout, this, [this, channelNumber]() {
+            channelTick(channelNumber);
+        });
+        channel.searchTimer = new QTimer(this);
+        channel.searchTimer->setSingleShot(true);
+        connect(channel.searchTimer, &QTimer::timeout, this, [this, channelNumber]() {
+            searchTimedOut(channelNumber);
+        });
+    }
+}
+
+SimulatedAntDevice::~SimulatedAntDevice()
+{
+    // empty
+}
+
+bool SimulatedAntDevice::isValid() const
+{
+    return _connected;
+}
+
+int SimulatedAntDevice::numberOfChannels() const
+{
+    return _numberOfChannels;
+}
+
+int SimulatedAntDevice::writeBytes(const QByteArray &bytes)
+{
+    if (!_connected) {
+        return -1;
+    }
+    _hostMessageGatherer->submitBytes(bytes);
+    return bytes.size();
+}
+
+bool SimulatedAntDevice::isReady() const
+{
+    return _connected;
+}
+
+void SimulatedAntDevice::addSensor(const SimulatedAntSensor &sensor)
+{
+    _sensors.push_back(SensorState(sensor));
+}
+
+void SimulatedAntDevice::setRandomSeed(quint32 seed)
+{
+    _randomGenerator.seed(seed);
+}
+
+const SimulatedAntDeviceStatistics &SimulatedAntDevice::statistics() const
+{
+    return _statistics;
+}
+
+void SimulatedAntDevice::setHeartRate(int heartRate)
+{
+    _heartRate = qBound(0, heartRate, 255);
+}
+
+void SimulatedAntDevice::setPower(int power)
+{
+    _power = qBound(0, power, 0x0FFF);
+}
+
+void SimulatedAntDevice::setCadence(int cadence)
+{
+    _cadence = qBound(0, cadence, 254);
+}
+
+void SimulatedAntDevice::setWheelSpeed(qreal wheelSpeedRpm)
+{
+    _wheelSpeedRpm = qMax(0.0, wheelSpeedRpm);
+}
+
+void SimulatedAntDevice::simulateDisconnect()
+{
+    if (!_connected) {
+        return;
+    }
+    _connected = false;
+    for (int channelNumber = 0; channelNumber < _numberOfChannels; ++channelNumber) {
+        resetChannel(channelNumber);
+    }
+    _flushTimer.stop();
+    _outputBuffer.clear();
+    emit connectionLost();
+}
+
+void SimulatedAntDevice::handleHostMessage(const QByteArray &bytes)
+{
+    std::unique_ptr<AntMessage2> message = AntMessage2::createMessageFromBytes(bytes);
+    switch (message->id()) {
+    case AntMessage2::AntMessageId::SYSTEM_RESET:
+        for (int channelNumber = 0; channelNumber < _numberOfChannels; ++channelNumber) {
+            resetChannel(channelNumber);
+        }
+        return;
+    case AntMessage2::AntMessageId::SET_NETWORK_KEY:
+        sendResponse(message->contentByte(0), message->id());
+        return;
+    default:
+        break;
+    }
+
+    const quint8 channelNumber = message->contentByte(0);
+    if (channelNumber >= _numberOfChannels) {
+        qWarning("Simulated ANT+ device received message for non-existing channel %d", channelNumber);
+        return;
+    }
+    Channel& channel = _channels[channelNumber];
+    if (!channel.assigned && message->id() != AntMessage2::AntMessageId::ASSIGN_CHANNEL) {
+        sendResponse(channelNumber, message->id(), AntChannelEventMessage::MessageCode::CHANNEL_IN_WRONG_STATE);
+        return;
+    }
+
+    switch (message->id()) {
+    case AntMessage2::AntMessageId::ASSIGN_CHANNEL:
+        resetChannel(channelNumber);
+        channel.assigned = true;
+        channel.master = (message->contentByte(1) & MASTER_CHANNEL_TYPE);
+        sendResponse(channelNumber, message->id());
+        break;
+    case AntMessage2::AntMessageId::SET_CHANNEL_ID:
+        channel.deviceNumber = message->contentShort(1);
+        channel.deviceType = message->contentByte(3);
+        channel.transmissionType = message->contentByte(4);
+        sendResponse(channelNumber, message->id());
+        break;
+    case AntMessage2::AntMessageId::SET_CHANNEL_FREQUENCY:
+        sendResponse(channelNumber, message->id());
+        break;
+    case AntMessage2::AntMessageId::SET_CHANNEL_PERIOD:
+        channel.period = message->contentShort(1);
+        sendResponse(channelNumber, message->id());
+        break;
+    case AntMessage2::AntMessageId::SET_SEARCH_TIMEOUT:
+    {
+        const quint8 timeout = message->contentByte(1);
+        channel.searchTimeout = (timeout == INFINITE_SEARCH_TIMEOUT) ? -1 : timeout * SEARCH_TIMEOUT_UNIT;
+        sendResponse(channelNumber, message->id());
+        break;
+    }
+    case AntMessage2::AntMessageId::OPEN_CHANNEL:
+        sendResponse(channelNumber, message->id());
+        openChannel(channelNumber);
+        break;
+    case AntMessage2::AntMessageId::CLOSE_CHANNEL:
+        sendResponse(channelNumber, message->id());
+        closeChannel(channelNumber);
+        break;
+    case AntMessage2::AntMessageId::UNASSIGN_CHANNEL:
+        resetChannel(channelNumber);
+        sendResponse(channelNumber, message->id());
+        break;
+    case AntMessage2::AntMessageId::REQUEST_MESSAGE:
+        if (static_cast<AntMessage2::AntMessageId>(message->contentByte(1)) == AntMessage2::AntMessageId::SET_CHANNEL_ID
+                && channel.sensorIndex >= 0) {
+            const SimulatedAntSensor& sensor = _sensors[channel.sensorIndex].settings;
+            queueMessage(AntMessage2::setChannelId(channelNumber, static_cast<quint16>(sensor.deviceNumber),
+                                                   sensor.sensorType, SENSOR_TRANSMISSION_TYPE));
+        }
+        break;
+    case AntMessage2::AntMessageId::BROADCAST_EVENT:
+        if (channel.master) {
+            ++_statistics.masterBroadcastsReceived;
+        }
+        break;
+    case AntMessage2::AntMessageId::ACKNOWLEDGED_MESSAGE:
+        handleAcknowledgedMessage(channelNumber, *message);
+        break;
+    default:
+        qDebug() << "Simulated ANT+ device: unhandled message" << message->toString();
+    }
+}
+
+void SimulatedAntDevice::flush()
+{
+    QByteArray bytes;
+    bytes.swap(_outputBuffer);
+    emit bytesRead(bytes);
+}
+
+void SimulatedAntDevice::resetChannel(int channelNumber)
+{
+    Channel& channel = _channels[channelNumber];
+    channel.messageTimer->stop();
+    channel.searchTimer->stop();
+    if (channel.sensorIndex >= 0) {
+        _sensors[channel.sensorIndex].channelNumber = -1;
+    }
+
+    QTimer* messageTimer = channel.messageTimer;
+    QTimer* searchTimer = channel.searchTimer;
+    channel = Channel();
+    channel.messageTimer = messageTimer;
+    channel.searchTimer = searchTimer;
+}
+
+/**
+ * Open a channel. Master channels start transmitting right away. For slave channels, we'll pair with the first
+ * sensor in range that matches the channel id. If there is none, the search will time out.
+ */
+void SimulatedAntDevice::openChannel(int channelNumber)
+{
+    Channel& channel = _channels[channelNumber];
+    channel.open = true;
+    if (channel.master) {
+        scheduleNextMessage(channelNumber);
+        return;
+    }
+    for (std::size_t i = 0; i < _sensors.size(); ++i) {
+        SensorState& sensor = _sensors[i];
+        const bool typeMatches = (static_cast<quint8>(sensor.settings.sensorType) == channel.deviceType);
+        const bool numberMatches = (channel.deviceNumber == 0 || channel.deviceNumber == sensor.settings.deviceNumber);
+        if (sensor.channelNumber < 0 && typeMatches && numberMatches) {
+            sensor.channelNumber = channelNumber;
+            sensor.lastUpdateNs = _clock.nsecsElapsed();
+            channel.sensorIndex = static_cast<int>(i);
+            scheduleNextMessage(channelNumber);
+            return;
+        }
+    }
+    if (channel.searchTimeout >= 0) {
+        channel.searchTimer->start(channel.searchTimeout);
+    }
+}
+
+void SimulatedAntDevice::closeChannel(int channelNumber)
+{
+    Channel& channel = _channels[channelNumber];
+    channel.messageTimer->stop();
+    channel.searchTimer->stop();
+    if (channel.sensorIndex >= 0) {
+        _sensors[channel.sensorIndex].channelNumber = -1;
+        channel.sensorIndex = -1;
+    }
+    channel.acknowledgedMessage = AntMessage2();
+    channel.open = false;
+    sendChannelEvent(channelNumber, AntChannelEventMessage::MessageCode::EVENT_CHANNEL_CLOSED);
+}
+
+void SimulatedAntDevice::scheduleNextMessage(int channelNumber)
+{
+    const Channel& channel = _channels[channelNumber];
+    int period = channel.period;
+    int jitter = 0;
+    if (channel.sensorIndex >= 0) {
+        const SimulatedAntSensor& sensor = _sensors[channel.sensorIndex].settings;
+        if (sensor.messagePeriod > 0) {
+            period = sensor.messagePeriod;
+        }
+        jitter = sensor.jitterMs;
+    }
+    int interval = qRound(period * 1000 / MESSAGE_PERIOD_BASE);
+    if (jitter > 0) {
+        std::uniform_int_distribution<int> jitterDistribution(-jitter, jitter);
+        interval += jitterDistribution(_randomGenerator);
+    }
+    channel.messageTimer->start(qMax(1, interval));
+}
+
+void SimulatedAntDevice::channelTick(int channelNumber)
+{
+    Channel& channel = _channels[channelNumber];
+    if (!channel.open) {
+        return;
+    }
+    scheduleNextMessage(channelNumber);
+
+    if (channel.master) {
+        sendChannelEvent(channelNumber, AntChannelEventMessage::MessageCode::EVENT_TX);
+        return;
+    }
+    if (channel.sensorIndex < 0) {
+        return;
+    }
+
+    SensorState& sensor = _sensors[channel.sensorIndex];
+    if (randomEvent(sensor.settings.dropoutProbability)) {
+        ++_statistics.dropouts;
+        sendChannelEvent(channelNumber, AntChannelEventMessage::MessageCode::EVENT_RX_FAILED);
+        emit sensorMessageDropped(sensor.settings.sensorType);
+        return;
+    }
+    if (randomEvent(sensor.settings.collisionProbability)) {
+        ++_statistics.collisions;
+        sendChannelEvent(channelNumber, AntChannelEventMessage::MessageCode::EVENT_CHANNEL_COLLISION);
+        if (!channel.acknowledgedMessage.isNull()) {
+            ++_statistics.acknowledgedMessagesFailed;
+            channel.acknowledgedMessage = AntMessage2();
+            sendChannelEvent(channelNumber, AntChannelEventMessage::MessageCode::EVENT_TRANSFER_TX_FAILED);
+        }
+        return;
+    }
+
+    queueMessage(createSensorMessage(sensor, static_cast<quint8>(channelNumber)));
+    ++_statistics.broadcastsSent;
+    if (!channel.acknowledgedMessage.isNull()) {
+        completeAcknowledgedMessage(channelNumber);
+    }
+}
+
+void SimulatedAntDevice::searchTimedOut(int channelNumber)
+{
+    Channel& channel = _channels[channelNumber];
+    if (channel.open && channel.sensorIndex < 0) {
+        ++_statistics.searchTimeouts;
+        channel.open = false;
+        sendChannelEvent(channelNumber, AntChannelEventMessage::MessageCode::EVENT_RX_SEARCH_TIMEOUT);
+        sendChannelEvent(channelNumber, AntChannelEventMessage::MessageCode::EVENT_CHANNEL_CLOSED);
+    }
+}
+
+/**
+ * An acknowledged message is sent to the sensor in the next receive slot of the channel. Only one acknowledged
+ * message can be in transit per channel.
+ */
+void SimulatedAntDevice::handleAcknowledgedMessage(int channelNumber, const AntMessage2 &message)
+{
+    ++_statistics.acknowledgedMessagesReceived;
+    Channel& channel = _channels[channelNumber];
+    if (!channel.open || channel.sensorIndex < 0 || !channel.acknowledgedMessage.isNull()) {
+        ++_statistics.acknowledgedMessagesFailed;
+        sendChannelEvent(channelNumber, AntChannelEventMessage::MessageCode::EVENT_TRANSFER_TX_FAILED);
+        return;
+    }
+    channel.acknowledgedMessage = message;
+}
+
+void SimulatedAntDevice::completeAcknowledgedMessage(int channelNumber)
+{
+    Channel& channel = _channels[channelNumber];
+    const AntMessage2 message = channel.acknowledgedMessage;
+    channel.acknowledgedMessage = AntMessage2();
+
+    SensorState& sensor = _sensors[channel.sensorIndex];
+    switch (static_cast<AntSmartTrainerChannelHandler::DataPage>(message.contentByte(1))) {
+    case AntSmartTrainerChannelHandler::DataPage::DATA_PAGE_REQUEST:
+        sensor.requestedPage = message.contentByte(7);
+        sensor.requestedPageCount = message.contentByte(6) & 0x7F;
+        break;
+    case AntSmartTrainerChannelHandler::DataPage::TRACK_RESISTANCE:
+        emit slopeReceived((message.contentShort(6) / 100.0) - 200.0);
+        break;
+    default:
+        break;
+    }
+    sendChannelEvent(channelNumber, AntChannelEventMessage::MessageCode::EVENT_TRANSFER_TX_COMPLETED);
+}
+
+/**
+ * Create the next broadcast message of a sensor. All counters of the sensor are advanced with the time passed since
+ * the previous message, so they stay correct if messages are dropped.
+ */
+AntMessage2 SimulatedAntDevice::createSensorMessage(SensorState &sensor, quint8 channelNumber)
+{
+    const qint64 now = _clock.nsecsElapsed();
+    const qreal nowSeconds = now / 1e9;
+    const qreal elapsedSeconds = (now - sensor.lastUpdateNs) / 1e9;
+    sensor.lastUpdateNs = now;
+    const int messageCounter = sensor.messageCounter++;
+
+    bool newEvent = false;
+    QByteArray content;
+    content += channelNumber;
+    AntMessage2 message;
+    switch (sensor.settings.sensorType) {
+    case AntSensorType::HEART_RATE:
+    {
+        newEvent = accumulateRevolutions(sensor.heartBeats, sensor.heartBeatEventTime, _heartRate,
+                                         elapsedSeconds, nowSeconds);
+        const bool toggle = ((messageCounter / 4) % 2);
+        message = HeartRateMessage::createHeartRateMessage(channelNumber, toggle, sensor.heartBeatEventTime,
+                                                           static_cast<quint8>(revolutionCount(sensor.heartBeats)),
+                                                           static_cast<quint8>(_heartRate));
+        break;
+    }
+    case AntSensorType::POWER:
+        newEvent = true;
+        sensor.eventCount += 1;
+        sensor.accumulatedPower += _power;
+        message = PowerMessage::createPowerMessage(channelNumber, sensor.eventCount, static_cast<quint8>(_cadence),
+                                                   sensor.accumulatedPower, static_cast<quint16>(_power));
+        break;
+    case AntSensorType::SPEED_AND_CADENCE:
+    case AntSensorType::SPEED:
+    case AntSensorType::CADENCE:
+    {
+        const bool newCadenceEvent = accumulateRevolutions(sensor.pedalRevolutions, sensor.cadenceEventTime,
+                                                           _cadence, elapsedSeconds, nowSeconds);
+        const bool newSpeedEvent = accumulateRevolutions(sensor.wheelRevolutions, sensor.speedEventTime,
+                                                         _wheelSpeedRpm, elapsedSeconds, nowSeconds);
+        if (sensor.settings.sensorType == AntSensorType::SPEED_AND_CADENCE) {
+            newEvent = newCadenceEvent || newSpeedEvent;
+            appendShort(content, sensor.cadenceEventTime);
+            appendShort(content, revolutionCount(sensor.pedalRevolutions));
+            appendShort(content, sensor.speedEventTime);
+            appendShort(content, revolutionCount(sensor.wheelRevolutions));
+        } else {
+            const bool speed = (sensor.settings.sensorType == AntSensorType::SPEED);
+            newEvent = (speed) ? newSpeedEvent : newCadenceEvent;
+            content += static_cast<char>(0x0); // data page 0, no other pages are supported.
+            content += static_cast<char>(0xFF); // reserved
+            content += static_cast<char>(0xFF); // reserved
+            content += static_cast<char>(0xFF); // reserved
+            appendShort(content, (speed) ? sensor.speedEventTime : sensor.cadenceEventTime);
+            appendShort(content, revolutionCount((speed) ? sensor.wheelRevolutions : sensor.pedalRevolutions));
+        }
+        message = AntMessage2(AntMessage2::AntMessageId::BROADCAST_EVENT, content);
+        break;
+    }
+    case AntSensorType::SMART_TRAINER:
+    {
+        const qreal speedMps = _wheelSpeedRpm / 60.0 * WHEEL_CIRCUMFERENCE;
+        sensor.distance += speedMps * elapsedSeconds;
+        if (sensor.requestedPageCount > 0 &&
+                sensor.requestedPage == static_cast<quint8>(AntSmartTrainerChannelHandler::DataPage::FE_CAPABILITIES)) {
+            sensor.requestedPageCount -= 1;
+            content += static_cast<quint8>(AntSmartTrainerChannelHandler::DataPage::FE_CAPABILITIES);
+            content += QByteArray(4, static_cast<char>(0xFF)); // reserved
+            appendShort(content, TRAINER_MAXIMUM_RESISTANCE);
+            content += TRAINER_CAPABILITIES;
+        } else if (messageCounter % 4 == 3) {
+            // like real trainers, interleave the general fitness equipment page with the trainer data.
+            content += static_cast<quint8>(AntSmartTrainerChannelHandler::DataPage::GENERAL_FITNESS_EQUIPMENT);
+            content += TRAINER_EQUIPMENT_TYPE;
+            content += static_cast<char>(qRound64(nowSeconds * 4) & 0xFF);
+            content += static_cast<char>(qRound64(sensor.distance) & 0xFF);
+            appendShort(content, static_cast<quint16>(qMin(65534.0, speedMps * 1000)));
+            content += static_cast<char>(0xFF); // no heart rate
+            content += TRAINER_STATE_IN_USE;
+        } else {
+            newEvent = true;
+            sensor.eventCount += 1;
+            sensor.accumulatedPower += _power;
+            content += static_cast<quint8>(AntSmartTrainerChannelHandler::DataPage::SPECIFIC_TRAINER_DATA);
+            content += sensor.eventCount;
+            content += static_cast<quint8>(_cadence);
+            appendShort(content, sensor.accumulatedPower);
+            content += static_cast<char>(_power & 0xFF);
+            content += static_cast<char>((_power >> 8) & 0x0F);
+            content += TRAINER_STATE_IN_USE;
+        }
+        message = AntMessage2(AntMessage2::AntMessageId::BROADCAST_EVENT, content);
+        break;
+    }
+    }
+
+    if (newEvent) {
+        emit sensorEventGenerated(sensor.settings.sensorType);
+    }
+    return message;
+}
+
+void SimulatedAntDevice::sendResponse(quint8 channelNumber, AntMessage2::AntMessageId messageId,
+                                      AntChannelEventMessage::MessageCode messageCode)
+{
+    QByteArray content;
+    content += channelNumber;
+    content += static_cast<quint8>(messageId);
+    content += static_cast<quint8>(messageCode);
+    queueMessage(AntMessage2(AntMessage2::AntMessageId::CHANNEL_EVENT, content));
+}
+
+void SimulatedAntDevice::sendChannelEvent(quint8 channelNumber, AntChannelEventMessage::MessageCode messageCode)
+{
+    QByteArray content;
+    content += channelNumber;
+    content += RF_EVENT_MESSAGE_ID;
+    content += static_cast<quint8>(messageCode);
+    queueMessage(AntMessage2(AntMessage2::AntMessageId::CHANNEL_EVENT, content));
+}
+
+/**
+ * Queue a message for the host. All messages queued in one pass of the event loop are delivered together, the way
+ * a USB read returns all bytes that the stick has buffered.
+ */
+void SimulatedAntDevice::queueMessage(const AntMessage2 &message)
+{
+    _outputBuffer += message.toBytes();
+    if (!_flushTimer.isActive()) {
+        _flushTimer.start();
+    }
+}
+
+bool SimulatedAntDevice::randomEvent(qreal probability)
+{
+    if (probability <= 0) {
+        return false;
+    }
+    std::uniform_real_distribution<qreal> distribution(0.0, 1.0);
+    return distribution(_randomGenerator) < probability;
+}
+
+}
@@ -0,0 +1,203 @@
+/*
+ * Copyright (c) 2015 Ilja Booij (ibooij@gmail.com)
+ *
+ * This file is part of Big Ring Indoor Video Cycling
+ *
+ * Big Ring Indoor Video Cycling is free software: you can redistribute
+ * it and/or modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation, either version 3 of the
+ * License, or (at your option) any later version.
+ *
+ * Big Ring Indoor Video Cycling  is distributed in the hope that it will
+ * be useful, but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+
+ * You should have received a copy of the GNU General Public License
+ * along with Big Ring Indoor Video Cycling.  If not, see
+ * <http://www.gnu.org/licenses/>.
+ */
+#ifndef SIMULATEDANTDEVICE_H
+#define SIMULATEDANTDEVICE_H
+
+#include <random>
+#include <vector>
+
+#include <QtCore/QElapsedTimer>
+#include <QtCore/QTimer>
+
+#include "antdevice.h"
+#include "antmessage2.h"
+#include "antsensortype.h"
+
+class AntMessageGatherer;
+
+namespace indoorcycling
+{
+
+/**
+ * Settings for a single simulated ANT+ sensor.
+ */
+class SimulatedAntSensor
+{
+public:
+    SimulatedAntSensor(AntSensorType sensorType, int deviceNumber);
+
+    AntSensorType sensorType;
+    int deviceNumber;
+    /** message period in 1/32768 of a second. If 0, the period of the channel is used. */
+    int messagePeriod;
+    /** maximum deviation of the interval between two messages, in milliseconds. */
+    int jitterMs;
+    /** probability (0.0 - 1.0) that a message from the sensor does not reach the stick. */
+    qreal dropoutProbability;
+    /** probability (0.0 - 1.0) that a message collides with a transmission on another channel. */
+    qreal collisionProbability;
+};
+
+/**
+ * Counters kept by the SimulatedAntDevice.
+ */
+struct SimulatedAntDeviceStatistics
+{
+    quint64 broadcastsSent = 0;
+    quint64 dropouts = 0;
+    quint64 collisions = 0;
+    quint64 acknowledgedMessagesReceived = 0;
+    quint64 acknowledgedMessagesFailed = 0;
+    quint64 masterBroadcastsReceived = 0;
+    quint64 searchTimeouts = 0;
+};
+
+/**
+ * A virtual ANT+ USB stick. It speaks the ANT serial protocol towards the host, just like a real stick, so it can be
+ * used in place of a real stick by AntCentralDispatch.
+ *
+ * Sensors that are "in range" of the stick are added with addSensor(). When the host opens a slave channel, a
+ * sensor of the requested type is paired to it and will send broadcasts at its message period, optionally with
+ * jitter, dropouts and collisions. Master channels opened by the host are accepted and acknowledged with EVENT_TX
+ * events at the channel period.
+ */
+class SimulatedAntDevice : public AntDevice
+{
+    Q_OBJECT
+public:
+    explicit SimulatedAntDevice(int numberOfChannels = 8, QObject* parent = 0);
+    virtual ~SimulatedAntDevice();
+
+    virtual bool isValid() const override;
+    virtual int numberOfChannels() const override;
+    virtual int writeBytes(const QByteArray& bytes) override;
+    virtual bool isReady() const override;
+
+    /** Add a sensor that is in range of the stick. Add all sensors before the host opens channels. */
+    void addSensor(const SimulatedAntSensor& sensor);
+    /** Seed the random generator used for jitter, dropouts and collisions, for reproducible runs. */
+    void setRandomSeed(quint32 seed);
+
+    const SimulatedAntDeviceStatistics& statistics() const;
+signals:
+    /**
+     * emitted when a simulated sensor sends a message that contains a new measurement, that the host should
+     * translate into a sensor value.
+     */
+    void sensorEventGenerated(AntSensorType sensorType);
+    /** emitted when a message of a simulated sensor does not reach the stick, because of a simulated dropout. */
+    void sensorMessageDropped(AntSensorType sensorType);
+    /** emitted when a track resistance page is received by a simulated smart trainer */
+    void slopeReceived(qreal slopeInPercent);
+public slots:
+    void setHeartRate(int heartRate);
+    void setPower(int power);
+    void setCadence(int cadence);
+    void setWheelSpeed(qreal wheelSpeedRpm);
+    /**
+     * Simulate unplugging the stick: all channels stop, the host can not write to the stick anymore, and
+     * connectionLost() is emitted.
+     */
+    void simulateDisconnect();
+private slots:
+    void handleHostMessage(const QByteArray& bytes);
+    void flush();
+private:
+    /** A simulated sensor, together with the values it has accumulated so far. */
+    struct SensorState
+    {
+        explicit SensorState(const SimulatedAntSensor& settings);
+
+        SimulatedAntSensor settings;
+        /** the channel the sensor is paired with, or -1 if the sensor is not paired. */
+        int channelNumber;
+        qint64 lastUpdateNs;
+        int messageCounter;
+        quint8 eventCount;
+        quint16 accumulatedPower;
+        qreal heartBeats;
+        qreal pedalRevolutions;
+        qreal wheelRevolutions;
+        qreal distance;
+        quint16 heartBeatEventTime;
+        quint16 cadenceEventTime;
+        quint16 speedEventTime;
+        /** data page requested by the host with a data page request, and the number of times it should be sent. */
+        quint8 requestedPage;
+        int requestedPageCount;
+    };
+
+    /** State of one of the channels of the stick. */
+    struct Channel
+    {
+        bool assigned = false;
+        bool master = false;
+        bool open = false;
+        int deviceNumber = 0;
+        quint8 deviceType = 0;
+        quint8 transmissionType = 0;
+        quint16 period = 8192;
+        /** search timeout in milliseconds, or -1 for an infinite search timeout. */
+        int searchTimeout = 10000;
+        int sensorIndex = -1;
+        /** acknowledged message that will be sent in the next receive slot of the channel. */
+        AntMessage2 acknowledgedMessage;
+        QTimer* messageTimer = nullptr;
+        QTimer* searchTimer = nullptr;
+    };
+
+    void resetChannel(int channelNumber);
+    void openChannel(int channelNumber);
+    void closeChannel(int channelNumber);
+    void scheduleNextMessage(int channelNumber);
+    void channelTick(int channelNumber);
+    void searchTimedOut(int channelNumber);
+    void handleAcknowledgedMessage(int channelNumber, const AntMessage2& message);
+    void completeAcknowledgedMessage(int channelNumber);
+
+    AntMessage2 createSensorMessage(SensorState& sensor, quint8 channelNumber);
+
+    void sendResponse(quint8 channelNumber, AntMessage2::AntMessageId messageId,
+                      AntChannelEventMessage::MessageCode messageCode =
+            AntChannelEventMessage::MessageCode::RESPONSE_NO_ERROR);
+    void sendChannelEvent(quint8 channelNumber, AntChannelEventMessage::MessageCode messageCode);
+    void queueMessage(const AntMessage2& message);
+
+    bool randomEvent(qreal probability);
+
+    const int _numberOfChannels;
+    bool _connected;
+    AntMessageGatherer* const _hostMessageGatherer;
+    std::vector<SensorState> _sensors;
+    std::vector<Channel> _channels;
+
+    QElapsedTimer _clock;
+    std::mt19937 _randomGenerator;
+    QByteArray _outputBuffer;
+    QTimer _flushTimer;
+    SimulatedAntDeviceStatistics _statistics;
+
+    int _heartRate;
+    int _power;
+    int _cadence;
+    qreal _wheelSpeedRpm;
+};
+}
+#endif // SIMULATEDANTDEVICE_H
@@ -86,6 +86,16 @@ void UnixSerialUsbAnt::readyRead()
     emit bytesRead(_serialPortConnection->readAll());
 }
 
+void UnixSerialUsbAnt::handleError(QSerialPort::SerialPortError error)
+{
+    // a resource error is reported when the stick is unplugged.
+    if (error == QSerialPort::ResourceError) {
+        qWarning() << "ANT+ USB1 stick lost:" << _serialPortConnection->errorString();
+        _serialPortConnection->close();
+        emit connectionLost();
+    }
+}
+
 QSerialPortInfo UnixSerialUsbAnt::findGarminUsb1Stick()
 {
     for(const QSerialPortInfo& serialPort: QSerialPortInfo::availablePorts()) {
@@ -110,6 +120,9 @@ void UnixSerialUsbAnt::openSerialConnection(const QSerialPortInfo &serialPortInf
         _serialPortConnection->readAll();
         _serialPortConnection->flush();
         connect(_serialPortConnection, &QSerialPort::readyRead, this, &UnixSerialUsbAnt::readyRead);
+        connect(_serialPortConnection,
+                static_cast<void (QSerialPort::*)(QSerialPort::SerialPortError)>(&QSerialPort::error),
+                this, &UnixSerialUsbAnt::handleError);
     } else {
         qDebug() << "unable to open serial port device" << serialPortInfo.description();
     }
@@ -53,6 +53,7 @@ signals:
 
 private slots:
     void readyRead();
+    void handleError(QSerialPort::SerialPortError error);
 private:
     QSerialPortInfo findGarminUsb1Stick();
     void openSerialConnection(const QSerialPortInfo& serialPortInfo);
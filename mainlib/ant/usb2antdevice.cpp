@@ -39,6 +39,8 @@ const QVector<int> VALID_PRODUCT_IDS({ indoorcycling::GARMIN_USB1_PRODUCT_ID,
                                        indoorcycling::GARMIN_USB2_PRODUCT_ID,
                                        indoorcycling::OEM_USB2_PRODUCT_ID });
 bool usbInitialized = false;
+// after this many read errors in a row, we'll assume the stick has been disconnected.
+const int MAX_CONSECUTIVE_READ_ERRORS = 20;
 
 /**
  * @brief initialize the usb library. This function can be called multiple times, but will only "work" once.
@@ -46,9 +48,10 @@ bool usbInitialized = false;
 void initializeUsb();
 /**
  * @brief find an ANT+ Stick on the USB ports.
+ * @param stickNumber the number of the stick, if more than one stick is connected.
  * @return the usb_device found, or nullptr if nothing found.
  */
-static struct usb_device* findAntStick();
+static struct usb_device* findAntStick(int stickNumber);
 /**
  * @brief reset the ant stick. We'll use this before connecting.
  * @param antStick
@@ -56,9 +59,10 @@ static struct usb_device* findAntStick();
 void resetAntStick(struct usb_device* antStick);
 /**
  * @brief open a connection to the ANT+ stick and initialize communication interfaces.
+ * @param stickNumber the number of the stick, if more than one stick is connected.
  * @return the full USB configuration.
  */
-std::unique_ptr<indoorcycling::Usb2DeviceConfiguration> openAntStick();
+std::unique_ptr<indoorcycling::Usb2DeviceConfiguration> openAntStick(int stickNumber);
 /**
  * @brief initialize communication interfaces for the ant stick.
  * @return the USB configuration.
@@ -76,17 +80,28 @@ namespace indoorcycling
 
 AntDeviceType findAntDeviceType()
 {
-    struct usb_device* device = findAntStick();
-    if (device) {
+    const QVector<AntDeviceType> deviceTypes = findAntDeviceTypes();
+    return (deviceTypes.isEmpty()) ? AntDeviceType::NONE : deviceTypes.first();
+}
+
+QVector<AntDeviceType> findAntDeviceTypes()
+{
+    QVector<AntDeviceType> deviceTypes;
+    struct usb_device* device;
+    while ((device = findAntStick(deviceTypes.size()))) {
         switch(device->descriptor.idProduct) {
         case GARMIN_USB1_PRODUCT_ID:
-            return AntDeviceType::USB_1;
+            deviceTypes.append(AntDeviceType::USB_1);
+            break;
         case GARMIN_USB2_PRODUCT_ID:
         case OEM_USB2_PRODUCT_ID:
-            return AntDeviceType::USB_2;
+            deviceTypes.append(AntDeviceType::USB_2);
+            break;
+        default:
+            deviceTypes.append(AntDeviceType::NONE);
         }
     }
-    return AntDeviceType::NONE;
+    return deviceTypes;
 }
 
 /**
@@ -101,8 +116,8 @@ struct Usb2DeviceConfiguration
     int interface;
 };
 
-Usb2AntDevice::Usb2AntDevice(QObject *parent) :
-    AntDevice(parent), _deviceConfiguration(openAntStick()), _workerThread(new QThread(this)),
+Usb2AntDevice::Usb2AntDevice(int stickNumber, QObject *parent) :
+    AntDevice(parent), _deviceConfiguration(openAntStick(stickNumber)), _workerThread(new QThread(this)),
     _workerReady(false)
 {
     if (!_deviceConfiguration) {
@@ -113,6 +128,7 @@ Usb2AntDevice::Usb2AntDevice(QObject *parent) :
 
     connect(_worker, &Usb2AntDeviceWorker::bytesRead, this, &Usb2AntDevice::bytesRead);
     connect(_worker, &Usb2AntDeviceWorker::workerReady, this, &Usb2AntDevice::workerReady);
+    connect(_worker, &Usb2AntDeviceWorker::connectionLost, this, &Usb2AntDevice::connectionLost);
     connect(this, &Usb2AntDevice::doWrite, _worker, &Usb2AntDeviceWorker::write);
     connect(_workerThread, &QThread::started, _worker, &Usb2AntDeviceWorker::initialize);
 
@@ -153,6 +169,11 @@ bool Usb2AntDevice::isReady() const
     return _workerReady;
 }
 
+bool Usb2AntDevice::isThreadSafe() const
+{
+    return true;
+}
+
 void Usb2AntDevice::workerReady()
 {
     _workerReady = true;
@@ -160,7 +181,7 @@ void Usb2AntDevice::workerReady()
 }
 
 Usb2AntDeviceWorker::Usb2AntDeviceWorker(Usb2DeviceConfiguration *deviceConfiguration, QObject* parent):
-    QObject(parent), _deviceConfiguration(deviceConfiguration)
+    QObject(parent), _readTimer(nullptr), _deviceConfiguration(deviceConfiguration), _consecutiveReadErrors(0)
 {
     // empty
 }
@@ -206,9 +227,13 @@ void Usb2AntDeviceWorker::read()
             if (nrOfBytesRead != -ETIMEDOUT) {
 #endif
                 qDebug() << "usb returns" << nrOfBytesRead << usb_strerror();
+                handleReadError();
+            } else {
+                _consecutiveReadErrors = 0;
             }
             bytesAvailable = false;
         } else {
+            _consecutiveReadErrors = 0;
             bytes.append(buffer.left(nrOfBytesRead));
             bytesAvailable = (nrOfBytesRead == buffer.size());
             buffer.clear();
@@ -220,6 +245,22 @@ void Usb2AntDeviceWorker::read()
     }
 }
 
+/**
+ * A single read error can happen, but if reading keeps failing, the stick has most likely been unplugged. In that
+ * case, we'll stop reading and report that the connection is lost.
+ */
+void Usb2AntDeviceWorker::handleReadError()
+{
+    _consecutiveReadErrors += 1;
+    if (_consecutiveReadErrors == MAX_CONSECUTIVE_READ_ERRORS) {
+        qWarning("%d read errors in a row, the ANT+ stick seems to be disconnected.", _consecutiveReadErrors);
+        if (_readTimer) {
+            _readTimer->stop();
+        }
+        emit connectionLost();
+    }
+}
+
 void Usb2AntDeviceWorker::write(const QByteArray &bytes)
 {
     if (!_deviceConfiguration) {
@@ -255,7 +296,7 @@ void initializeUsb()
     }
 }
 
-struct usb_device *findAntStick()
+struct usb_device *findAntStick(int stickNumber)
 {
     initializeUsb();
     usb_find_busses();
@@ -268,8 +309,11 @@ struct usb_device *findAntStick()
         for (device = bus->devices; device; device = device->next) {
             if (device->descriptor.idVendor == indoorcycling::GARMIN_USB_VENDOR_ID &&
                     VALID_PRODUCT_IDS.contains(device->descriptor.idProduct)) {
-                qDebug() << "findAntStick(): returning device";
-                return device;
+                if (stickNumber == 0) {
+                    qDebug() << "findAntStick(): returning device";
+                    return device;
+                }
+                stickNumber -= 1;
             }
         }
     }
@@ -293,11 +337,11 @@ void resetAntStick(struct usb_device *antStick)
 }
 
 
-std::unique_ptr<indoorcycling::Usb2DeviceConfiguration> openAntStick()
+std::unique_ptr<indoorcycling::Usb2DeviceConfiguration> openAntStick(int stickNumber)
 {
     struct usb_dev_handle* deviceHandle;
 
-    struct usb_device* device = findAntStick();
+    struct usb_device* device = findAntStick(stickNumber);
     if (device) {
         resetAntStick(device);
         deviceHandle = usb_open(device);
@@ -37,6 +37,11 @@ struct Usb2DeviceConfiguration;
  * @return the type of USB ANT+ Stick, or ANT_DEVICE_NONE if none found.
  */
 AntDeviceType findAntDeviceType();
+/**
+ * @brief find all ANT+ Usb sticks and report their types.
+ * @return the types of the ANT+ Usb sticks, in the order in which they are found on the usb busses.
+ */
+QVector<AntDeviceType> findAntDeviceTypes();
 
 /**
  * We use a worker which runs on different thread to perform the actual
@@ -60,9 +65,13 @@ signals:
     void workerReady();
     void bytesWritten(int written);
     void bytesRead(const QByteArray& bytes);
+    void connectionLost();
 private:
+    void handleReadError();
+
     QTimer* _readTimer;
     Usb2DeviceConfiguration* _deviceConfiguration;
+    int _consecutiveReadErrors;
 };
 
 /**
@@ -72,7 +81,11 @@ class Usb2AntDevice : public AntDevice
 {
     Q_OBJECT
 public:
-    explicit Usb2AntDevice(QObject *parent = 0);
+    /**
+     * Open an USB2 ANT+ stick.
+     * @param stickNumber the number of the stick to open, the index in the list returned by findAntDeviceTypes().
+     */
+    explicit Usb2AntDevice(int stickNumber = 0, QObject *parent = 0);
     virtual ~Usb2AntDevice();
     virtual bool isValid() const override;
     virtual int numberOfChannels() const override;
@@ -80,6 +93,9 @@ public:
     virtual bool isReady() const override;
 signals:
     void doWrite(const QByteArray& bytes);
+protected:
+    /** writes are always passed to the worker thread, so they can be done from any thread. */
+    virtual bool isThreadSafe() const override;
 private slots:
     void workerReady();
 private:
@@ -30,9 +30,20 @@ const int POWER_AVERAGING_MILLISECONDS_DEFAULT = 3000;
 
 const qreal USER_WEIGHT_KILOGRAMS_DEFAULT = 75.0;
 const qreal BIKE_WEIGHT_KILOGRAMS_DEFAULT = 10.0;
+const int FUNCTIONAL_THRESHOLD_POWER_DEFAULT = 200;
+const int ANAEROBIC_WORK_CAPACITY_JOULES_DEFAULT = 20000;
 
 const qreal DEFAULT_UP_AND_DOWNHILL_CAPS = 25.0;
 const int DEFAULT_DIFFICULTY_SETTING = 100;
+const int DEFAULT_SIMULATION_STEPS_PER_SECOND = 100;
+const int MAXIMUM_SIMULATION_STEPS_PER_SECOND = 1000;
+const int DEFAULT_VIDEO_READ_AHEAD_MEGABYTES = 64;
+const int MAXIMUM_VIDEO_READ_AHEAD_MEGABYTES = 1024;
+const int DEFAULT_RIDE_RECORDING_RATE_HZ = 1;
+const int MAXIMUM_RIDE_RECORDING_RATE_HZ = 10;
+const int DEFAULT_RIDE_SAMPLE_BUFFER_KILOBYTES = 1024;
+const int MINIMUM_RIDE_SAMPLE_BUFFER_KILOBYTES = 64;
+const int MAXIMUM_RIDE_SAMPLE_BUFFER_KILOBYTES = 16 * 1024;
 }
 
 BigRingSettings::BigRingSettings()
@@ -121,6 +132,26 @@ void BigRingSettings::setTcxFolder(const QString &folder)
     _settings.setValue("tcxSaveFolder", QVariant::fromValue(folder));
 }
 
+bool BigRingSettings::compressRideFiles() const
+{
+    return _settings.value("tcxCompress", QVariant::fromValue(false)).toBool();
+}
+
+void BigRingSettings::setCompressRideFiles(const bool compress)
+{
+    _settings.setValue("tcxCompress", QVariant::fromValue(compress));
+}
+
+bool BigRingSettings::writeFitFiles() const
+{
+    return _settings.value("fitExport", QVariant::fromValue(false)).toBool();
+}
+
+void BigRingSettings::setWriteFitFiles(const bool writeFitFiles)
+{
+    _settings.setValue("fitExport", QVariant::fromValue(writeFitFiles));
+}
+
 qreal BigRingSettings::userWeight() const
 {
     return _settings.value("user.weight", QVariant::fromValue(USER_WEIGHT_KILOGRAMS_DEFAULT)).toDouble();
@@ -141,6 +172,26 @@ void BigRingSettings::setBikeWeight(const qreal bikeWeight)
     _settings.setValue("bike.weight", QVariant::fromValue(bikeWeight));
 }
 
+int BigRingSettings::functionalThresholdPower() const
+{
+    return _settings.value("user.ftp", QVariant::fromValue(FUNCTIONAL_THRESHOLD_POWER_DEFAULT)).toInt();
+}
+
+void BigRingSettings::setFunctionalThresholdPower(const int watts)
+{
+    _settings.setValue("user.ftp", QVariant::fromValue(watts));
+}
+
+int BigRingSettings::anaerobicWorkCapacity() const
+{
+    return _settings.value("user.wPrime", QVariant::fromValue(ANAEROBIC_WORK_CAPACITY_JOULES_DEFAULT)).toInt();
+}
+
+void BigRingSettings::setAnaerobicWorkCapacity(const int joules)
+{
+    _settings.setValue("user.wPrime", QVariant::fromValue(joules));
+}
+
 int BigRingSettings::powerAveragingForDisplayMilliseconds() const
 {
     QSettings settings;
@@ -224,6 +275,36 @@ void BigRingSettings::setDifficultySetting(const int percent)
     _settings.endGroup();
 }
 
+int BigRingSettings::simulationStepsPerSecond() const
+{
+    QSettings settings;
+    settings.beginGroup("simulation");
+    const int stepsPerSecond = settings.value("stepsPerSecond", QVariant::fromValue(DEFAULT_SIMULATION_STEPS_PER_SECOND)).toInt();
+    return qBound(1, stepsPerSecond, MAXIMUM_SIMULATION_STEPS_PER_SECOND);
+}
+
+void BigRingSettings::setSimulationStepsPerSecond(const int stepsPerSecond)
+{
+    _settings.beginGroup("simulation");
+    _settings.setValue("stepsPerSecond", QVariant::fromValue(qBound(1, stepsPerSecond, MAXIMUM_SIMULATION_STEPS_PER_SECOND)));
+    _settings.endGroup();
+}
+
+int BigRingSettings::videoReadAheadMegabytes() const
+{
+    QSettings settings;
+    settings.beginGroup("video");
+    const int megabytes = settings.value("readAheadMegabytes", QVariant::fromValue(DEFAULT_VIDEO_READ_AHEAD_MEGABYTES)).toInt();
+    return qBound(0, megabytes, MAXIMUM_VIDEO_READ_AHEAD_MEGABYTES);
+}
+
+void BigRingSettings::setVideoReadAheadMegabytes(const int megabytes)
+{
+    _settings.beginGroup("video");
+    _settings.setValue("readAheadMegabytes", QVariant::fromValue(qBound(0, megabytes, MAXIMUM_VIDEO_READ_AHEAD_MEGABYTES)));
+    _settings.endGroup();
+}
+
 qreal BigRingSettings::maximumUphillForSmartTrainer() const
 {
     QSettings settings;
@@ -238,6 +319,37 @@ void BigRingSettings::setMaximumUphillForSmartTrainer(const qreal maximumUphill)
     _settings.endGroup();
 }
 
+int BigRingSettings::rideRecordingRateHz() const
+{
+    QSettings settings;
+    settings.beginGroup("ride");
+    const int recordingRateHz = settings.value("recordingRateHz", QVariant::fromValue(DEFAULT_RIDE_RECORDING_RATE_HZ)).toInt();
+    return qBound(0, recordingRateHz, MAXIMUM_RIDE_RECORDING_RATE_HZ);
+}
+
+void BigRingSettings::setRideRecordingRateHz(const int recordingRateHz)
+{
+    _settings.beginGroup("ride");
+    _settings.setValue("recordingRateHz", QVariant::fromValue(qBound(0, recordingRateHz, MAXIMUM_RIDE_RECORDING_RATE_HZ)));
+    _settings.endGroup();
+}
+
+int BigRingSettings::rideSampleBufferKilobytes() const
+{
+    QSettings settings;
+    settings.beginGroup("ride");
+    const int kilobytes = settings.value("sampleBufferKilobytes", QVariant::fromValue(DEFAULT_RIDE_SAMPLE_BUFFER_KILOBYTES)).toInt();
+    return qBound(MINIMUM_RIDE_SAMPLE_BUFFER_KILOBYTES, kilobytes, MAXIMUM_RIDE_SAMPLE_BUFFER_KILOBYTES);
+}
+
+void BigRingSettings::setRideSampleBufferKilobytes(const int kilobytes)
+{
+    _settings.beginGroup("ride");
+    _settings.setValue("sampleBufferKilobytes", QVariant::fromValue(qBound(MINIMUM_RIDE_SAMPLE_BUFFER_KILOBYTES, kilobytes,
+                                                                           MAXIMUM_RIDE_SAMPLE_BUFFER_KILOBYTES)));
+    _settings.endGroup();
+}
+
 QString BigRingSettings::clientId()
 {
     if (!_settings.contains("clientId")) {
@@ -40,6 +40,12 @@ public:
     QString tcxFolder() const;
     /** Set the absolute path to the folder where tcx ride files are saved */
     void setTcxFolder(const QString &folder);
+    /** true if ride files are compressed with gzip */
+    bool compressRideFiles() const;
+    void setCompressRideFiles(const bool compress);
+    /** true if a FIT file is written next to the TCX file of a ride */
+    bool writeFitFiles() const;
+    void setWriteFitFiles(const bool writeFitFiles);
 
     qreal userWeight() const;
     void setUserWeight(const qreal userWeight);
@@ -47,6 +53,14 @@ public:
     qreal bikeWeight() const;
     void setBikeWeight(const qreal bikeWeight);
 
+    /** Functional threshold power of the cyclist in watts, used for intensity factor, TSS and W' balance */
+    int functionalThresholdPower() const;
+    void setFunctionalThresholdPower(const int watts);
+
+    /** Anaerobic work capacity (W') of the cyclist in joules */
+    int anaerobicWorkCapacity() const;
+    void setAnaerobicWorkCapacity(const int joules);
+
     int powerAveragingForDisplayMilliseconds() const;
     void setPowerAveragingForDisplayMilliseconds(const int averagingMilliseconds);
 
@@ -68,6 +82,22 @@ public:
     int difficultySetting() const;
     void setDifficultySetting(const int percent);
 
+    /** Number of physics steps the simulation takes per second */
+    int simulationStepsPerSecond() const;
+    void setSimulationStepsPerSecond(const int stepsPerSecond);
+
+    /** Minimum size of the read-ahead window for video files, 0 to disable reading ahead */
+    int videoReadAheadMegabytes() const;
+    void setVideoReadAheadMegabytes(const int megabytes);
+
+    /** Number of samples per second in a ride file, 0 to record a sample for every power measurement */
+    int rideRecordingRateHz() const;
+    void setRideRecordingRateHz(const int recordingRateHz);
+
+    /** Memory for the sensor measurements that are combined into the samples of a ride file */
+    int rideSampleBufferKilobytes() const;
+    void setRideSampleBufferKilobytes(const int kilobytes);
+
     /** Get the unique id for this installation */
     QString clientId();
 private:
@@ -26,6 +26,7 @@
 
 #include "quantityprinter.h"
 #include "model/reallifevideo.h"
+#include "model/reallifevideosummary.h"
 #include "model/unitconverter.h"
 
 #include <array>
@@ -91,6 +92,49 @@ QPixmap ProfilePainter::paintProfileWithHighLight(const RealLifeVideo &rlv, qrea
     return copy;
 }
 
+QPixmap ProfilePainter::paintMiniProfile(const RealLifeVideoSummary &summary, const QRect &rect) const
+{
+    QPixmap profilePixmap;
+    if (summary.isValid()) {
+        const QString pixmapName = QString("mini_%1_%2x%3").arg(summary.name()).arg(rect.size().width()).arg(rect.size().height());
+        if (!QPixmapCache::find(pixmapName, &profilePixmap)) {
+            profilePixmap = drawMiniProfilePixmap(QRect(QPoint(0,0), rect.size()), summary);
+            QPixmapCache::insert(pixmapName, profilePixmap);
+        }
+    }
+    return profilePixmap;
+}
+
+QPixmap ProfilePainter::drawMiniProfilePixmap(const QRect &rect, const RealLifeVideoSummary &summary) const
+{
+    const std::vector<float>& altitudes = summary.miniProfileAltitudes();
+    const std::vector<float>& slopes = summary.miniProfileSlopes();
+    if (rect.isEmpty() || altitudes.empty()) {
+        return QPixmap();
+    }
+
+    QPixmap pixmap(rect.size());
+    QPainter painter(&pixmap);
+
+    const float altitudeDiff = summary.maximumAltitude() - summary.minimumAltitude();
+    painter.setBrush(Qt::gray);
+    painter.drawRect(rect);
+    painter.setPen(Qt::NoPen);
+    painter.setRenderHint(QPainter::Antialiasing);
+
+    for(int x = 0; x < rect.width(); x += 1) {
+        const std::size_t point = std::min(altitudes.size() - 1,
+                                         static_cast<std::size_t>(x) * altitudes.size() / static_cast<std::size_t>(rect.width()));
+        painter.setBrush(colorForSlope(slopes[point]));
+
+        int y = altitudeToHeight(rect, altitudes[point] - summary.minimumAltitude(), altitudeDiff);
+        QRect  box(x, rect.bottom() - y, 1, rect.bottom());
+        painter.drawRect(box);
+    }
+    painter.end();
+    return pixmap;
+}
+
 QPixmap ProfilePainter::drawProfilePixmap(QRect& rect, const RealLifeVideo& rlv, float startDistance, float endDistance, bool withMarkers ) const
 {
     if (rect.isEmpty()) {
@@ -26,6 +26,7 @@
 
 class QuantityPrinter;
 class RealLifeVideo;
+class RealLifeVideoSummary;
 class UnitConverter;
 
 class ProfilePainter : public QObject
@@ -38,7 +39,10 @@ public:
     QPixmap paintProfile(const RealLifeVideo& rlv, const QRect& rect, bool withMarkers) const;
     QPixmap paintProfileWithHighLight(const RealLifeVideo &rlv, qreal startDistance, qreal endDistance,
                                       const QRect &rect, const QBrush highlightColor) const;
+    /** Paint the profile of a video from its summary, without markers. */
+    QPixmap paintMiniProfile(const RealLifeVideoSummary& summary, const QRect& rect) const;
 private:
+    QPixmap drawMiniProfilePixmap(const QRect& rect, const RealLifeVideoSummary& summary) const;
     QPixmap drawProfilePixmap(QRect& rect, const RealLifeVideo& rlv, float startDistance, float endDistance, bool withMarkers) const;
     void drawDistanceMarkers(QPainter &painter, const QRect &rect, float startDistance, float totalDistance) const;
     double determineDistanceMarkers(float totalDistance) const;
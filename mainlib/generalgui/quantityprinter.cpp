@@ -48,6 +48,12 @@ QString QuantityPrinter::unitString(QuantityPrinter::Quantity quantity, Quantity
         return "%";
     case Quantity::FramesPerSecond:
         return "FPS";
+    case Quantity::NormalizedPower:
+        return tr("NP");
+    case Quantity::WPrimeBalance:
+        return "W'";
+    case Quantity::ClimbElevationGain:
+        return tr("%1 Climb").arg(unitForAltitude());
     default:
         return "#";
     }
@@ -101,6 +107,13 @@ QString QuantityPrinter::print(QVariant value, QuantityPrinter::Quantity quantit
         return printWeight(value.toReal());
     case Quantity::FramesPerSecond:
         return QString("%1").arg(value.toInt(), width);
+    case Quantity::NormalizedPower:
+        return QString("%1").arg(value.toInt(), width);
+    case Quantity::WPrimeBalance:
+        // W' balance is in joules, shown in kilojoules.
+        return QString("%1").arg(value.toReal() / 1000.0, width, 'f', 1);
+    case Quantity::ClimbElevationGain:
+        return printAltitude(value.toReal());
     }
     Q_ASSERT_X(false, "QuantityPrinter::print", "This should not be reached");
     return "";
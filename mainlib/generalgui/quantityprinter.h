@@ -44,7 +44,10 @@ public:
         Cadence,
         Grade,
         Weight,
-        FramesPerSecond
+        FramesPerSecond,
+        NormalizedPower,
+        WPrimeBalance,
+        ClimbElevationGain
     };
 
     explicit QuantityPrinter(QObject *parent = 0);
@@ -22,9 +22,12 @@
 #include "importer/gpxfileparser.h"
 #include "importer/rlvfileparser.h"
 #include "importer/virtualtrainingfileparser.h"
+#include "model/reallifevideosummary.h"
 #include "reallifevideoimporter.h"
 #include "reallifevideocache.h"
+#include "reallifevideolibrary.h"
 
+#include <algorithm>
 #include <functional>
 
 #include <QtCore/QCoreApplication>
@@ -72,9 +75,10 @@ RealLifeVideoImporter::~RealLifeVideoImporter()
 
 void RealLifeVideoImporter::importRealLiveVideoFilesFromDir()
 {
-    QFutureWatcher<RealLifeVideoList> *futureWatcher = new QFutureWatcher<RealLifeVideoList>();
-    connect(futureWatcher, &QFutureWatcher<RealLifeVideoList>::finished, futureWatcher, [=]() {
-        importReady(futureWatcher->future().result());
+    typedef std::shared_ptr<RealLifeVideoLibrary> LibraryPtr;
+    QFutureWatcher<LibraryPtr> *futureWatcher = new QFutureWatcher<LibraryPtr>();
+    connect(futureWatcher, &QFutureWatcher<LibraryPtr>::finished, futureWatcher, [=]() {
+        emit importFinished(futureWatcher->future().result());
         futureWatcher->deleteLater();
     });
 
@@ -83,6 +87,12 @@ void RealLifeVideoImporter::importRealLiveVideoFilesFromDir()
     }));
 }
 
+RealLifeVideo RealLifeVideoImporter::importRealLifeVideo(QFile &rlvFile, const QList<QString> &videoFilePaths,
+                                                        const QList<QString> &pgmfFilePaths)
+{
+    return parseRealLiveVideoFile(rlvFile, videoFilePaths, pgmfFilePaths);
+}
+
 bool RealLifeVideoImporter::event(QEvent *event)
 {
     if (event->type() == NR_OF_RLVS_FOUND_TYPE) {
@@ -96,41 +106,41 @@ bool RealLifeVideoImporter::event(QEvent *event)
     }
 }
 
-RealLifeVideoList RealLifeVideoImporter::importRlvFiles(const QStringList& rootFolders)
+std::shared_ptr<RealLifeVideoLibrary> RealLifeVideoImporter::importRlvFiles(const QStringList& rootFolders)
 {
 
     const QSet<QString> rlvFiles = findRlvFiles(rootFolders);
     qDebug() << "rlv files" << rlvFiles;
-    const QSet<QString> pgmfFiles = findFiles(rootFolders, { "*.pgmf" });
-    const QSet<QString> aviFiles = findFiles(rootFolders, { "*.avi", "*.mp4" });
+    const QList<QString> pgmfFiles = findFiles(rootFolders, { "*.pgmf" }).toList();
+    const QList<QString> aviFiles = findFiles(rootFolders, { "*.avi", "*.mp4" }).toList();
 
     QCoreApplication::postEvent(this, new NrOfRlvsFoundEvent(rlvFiles.size()));
 
-    std::function<RealLifeVideo(const QFileInfo&)> importFunction([this, aviFiles, pgmfFiles](const QFileInfo& fileInfo) -> RealLifeVideo {
-        QFile file(fileInfo.canonicalFilePath());
-        RealLifeVideo rlv = parseRealLiveVideoFile(file, aviFiles.toList(), pgmfFiles.toList());
+    // Only a summary of every video is kept. The complete video is loaded again, from the cache, when it is selected.
+    std::function<RealLifeVideoSummary(const QString&)> importFunction(
+                [this, aviFiles, pgmfFiles](const QString& filePath) -> RealLifeVideoSummary {
+        QFile file(QFileInfo(filePath).canonicalFilePath());
+        const RealLifeVideo rlv = parseRealLiveVideoFile(file, aviFiles, pgmfFiles);
         QCoreApplication::postEvent(this, new RlvImportedEvent);
-        return rlv;
+        if (rlv.isValid() && rlv.type() == ProfileType::SLOPE) {
+            return RealLifeVideoSummary(rlv, file.fileName());
+        }
+        return RealLifeVideoSummary();
     });
 
-    return QtConcurrent::mapped(rlvFiles.begin(), rlvFiles.end(), importFunction).results();
-}
+    const QList<RealLifeVideoSummary> summaries =
+            QtConcurrent::mapped(rlvFiles.begin(), rlvFiles.end(), importFunction).results();
 
-
-void RealLifeVideoImporter::importReady(const RealLifeVideoList &rlvs)
-{
-
-    RealLifeVideoList validRlvs;
-
-    for (const RealLifeVideo& rlv: rlvs) {
-        if (rlv.isValid() && rlv.type() == ProfileType::SLOPE) {
-            validRlvs.append(rlv);
+    std::vector<RealLifeVideoSummary> validSummaries;
+    for (const RealLifeVideoSummary& summary: summaries) {
+        if (summary.isValid()) {
+            validSummaries.push_back(summary);
         }
     }
-    // sort rlv list by name
-    qSort(validRlvs.begin(), validRlvs.end(), RealLifeVideo::compareByName);
+    // sort summaries by name
+    std::sort(validSummaries.begin(), validSummaries.end(), RealLifeVideoSummary::compareByName);
 
-    emit importFinished(validRlvs);
+    return std::make_shared<RealLifeVideoLibrary>(std::move(validSummaries), aviFiles, pgmfFiles);
 }
 
 namespace
@@ -185,7 +195,8 @@ RealLifeVideo parseRealLiveVideoFile(QFile &rlvFile, const QList<QString>& video
         settings.endGroup();
     }
     QDateTime end = QDateTime::currentDateTime();
-    qDebug() << "import of" << rlvFile.fileName() << "took" << start.msecsTo(end) << "ms";
+    qDebug() << "import of" << rlvFile.fileName() << "took" << start.msecsTo(end) << "ms, route data uses"
+             << rlv.memoryUsage() / 1024 << "KiB";
     return rlv;
 }
 
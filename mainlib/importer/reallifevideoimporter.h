@@ -21,13 +21,16 @@
 #ifndef REALLIVEVIDEOPARSER_H
 #define REALLIVEVIDEOPARSER_H
 
+#include <memory>
+
 #include <QFile>
 #include <QFutureWatcher>
 #include <QObject>
-#include <QSharedPointer>
 
 #include "model/reallifevideo.h"
 
+class RealLifeVideoLibrary;
+
 /**
  * @brief Importer for Tacx RLV files.
  *
@@ -35,8 +38,8 @@
  * Call ::parseRealLiveVideoFilesFromDir with a root directory. When ready, ::importReady will be emitted.
  *
  * This importer will search for files with the extension .rlv and, for each of those files, find the corresponding
- * .pgmf and .avi file. The result will be a list of RealLifeVideo objects. Only slope-based files will be found,
- * power-based rlv files will be ommitted for now.
+ * .pgmf and .avi file. The result will be a RealLifeVideoLibrary, which holds a summary of every video. Only
+ * slope-based files will be found, power-based rlv files will be ommitted for now.
  */
 class RealLifeVideoImporter: public QObject
 {
@@ -52,6 +55,15 @@ public:
      */
     void importRealLiveVideoFilesFromDir();
 
+    /**
+     * @brief import a single video file, including the custom courses that were saved for it.
+     * @param rlvFile the rlv, xml or gpx file.
+     * @param videoFilePaths the video files to find the video of the file in.
+     * @param pgmfFilePaths the pgmf files to find the profile of an rlv file in.
+     */
+    static RealLifeVideo importRealLifeVideo(QFile &rlvFile, const QList<QString> &videoFilePaths,
+                                             const QList<QString> &pgmfFilePaths);
+
 signals:
     /**
       * the number of rlvs to be imported.
@@ -63,15 +75,14 @@ signals:
     void rlvImported();
     /**
      * @brief signal emitted when the import is finished.
-     * @param rlvs list of RealLifeVideo objects.
+     * @param library the library of all imported videos.
      */
-    void importFinished(RealLifeVideoList rlvs);
+    void importFinished(std::shared_ptr<RealLifeVideoLibrary> library);
 
 protected:
     virtual bool event(QEvent *event);
 private:
-    RealLifeVideoList importRlvFiles(const QStringList &rootFolders);
-    void importReady(const RealLifeVideoList &rlvs);
+    std::shared_ptr<RealLifeVideoLibrary> importRlvFiles(const QStringList &rootFolders);
 };
 
 #endif // REALLIVEVIDEOPARSER_H
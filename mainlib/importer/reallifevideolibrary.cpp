@@ -0,0 +1,90 @@
+/*
+ * Copyright (c) 2015 Ilja Booij (ibooij@gmail.com)
+ *
+ * This file is part of Big Ring Indoor Video Cycling
+ *
+ * Big Ring Indoor Video Cycling is free software: you can redistribute
+ * it and/or modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation, either version 3 of the
+ * License, or (at your option) any later version.
+ *
+ * Big Ring Indoor Video Cycling  is distributed in the hope that it will
+ * be useful, but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+
+ * You should have received a copy of the GNU General Public License
+ * along with Big Ring Indoor Video Cycling.  If not, see
+ * <http://www.gnu.org/licenses/>.
+ */
+
+#include "reallifevideolibrary.h"
+
+#include <QtCore/QFile>
+#include <QtCore/QtDebug>
+
+#include "reallifevideoimporter.h"
+
+namespace
+{
+const std::size_t MAXIMUM_LOADED_VIDEOS = 4;
+const RealLifeVideoSummary INVALID_SUMMARY;
+}
+
+RealLifeVideoLibrary::RealLifeVideoLibrary()
+{
+    // empty
+}
+
+RealLifeVideoLibrary::RealLifeVideoLibrary(std::vector<RealLifeVideoSummary> summaries,
+                                           const QList<QString> &videoFilePaths, const QList<QString> &pgmfFilePaths):
+    _summaries(std::move(summaries)), _videoFilePaths(videoFilePaths), _pgmfFilePaths(pgmfFilePaths)
+{
+    // empty
+}
+
+int RealLifeVideoLibrary::size() const
+{
+    return static_cast<int>(_summaries.size());
+}
+
+const RealLifeVideoSummary &RealLifeVideoLibrary::summary(int index) const
+{
+    if (index < 0 || index >= size()) {
+        return INVALID_SUMMARY;
+    }
+    return _summaries[index];
+}
+
+RealLifeVideo RealLifeVideoLibrary::video(int index)
+{
+    if (index < 0 || index >= size()) {
+        return RealLifeVideo();
+    }
+    for (auto it = _loadedVideos.begin(); it != _loadedVideos.end(); ++it) {
+        if (it->first == index) {
+            _loadedVideos.splice(_loadedVideos.begin(), _loadedVideos, it);
+            return _loadedVideos.front().second;
+        }
+    }
+    QFile file(_summaries[index].filePath());
+    const RealLifeVideo rlv = RealLifeVideoImporter::importRealLifeVideo(file, _videoFilePaths, _pgmfFilePaths);
+    if (!rlv.isValid()) {
+        qWarning("Unable to load %s", qPrintable(file.fileName()));
+        return rlv;
+    }
+    _loadedVideos.push_front(std::make_pair(index, rlv));
+    if (_loadedVideos.size() > MAXIMUM_LOADED_VIDEOS) {
+        _loadedVideos.pop_back();
+    }
+    return rlv;
+}
+
+void RealLifeVideoLibrary::updateVideo(const RealLifeVideo &rlv)
+{
+    for (auto &loadedVideo: _loadedVideos) {
+        if (loadedVideo.second == rlv) {
+            loadedVideo.second = rlv;
+        }
+    }
+}
@@ -0,0 +1,67 @@
+/*
+ * Copyright (c) 2015 Ilja Booij (ibooij@gmail.com)
+ *
+ * This file is part of Big Ring Indoor Video Cycling
+ *
+ * Big Ring Indoor Video Cycling is free software: you can redistribute
+ * it and/or modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation, either version 3 of the
+ * License, or (at your option) any later version.
+ *
+ * Big Ring Indoor Video Cycling  is distributed in the hope that it will
+ * be useful, but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+
+ * You should have received a copy of the GNU General Public License
+ * along with Big Ring Indoor Video Cycling.  If not, see
+ * <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef REALLIFEVIDEOLIBRARY_H
+#define REALLIFEVIDEOLIBRARY_H
+
+#include <list>
+#include <utility>
+#include <vector>
+
+#include <QtCore/QList>
+#include <QtCore/QString>
+
+#include "model/reallifevideo.h"
+#include "model/reallifevideosummary.h"
+
+/**
+ * All imported videos.
+ *
+ * The library only keeps a RealLifeVideoSummary of every video in memory. The complete video is loaded when it is
+ * needed, from the RealLifeVideoCache, which is fast. The last few videos that were loaded are kept, so switching
+ * between a couple of videos does not load them again and again.
+ */
+class RealLifeVideoLibrary
+{
+public:
+    explicit RealLifeVideoLibrary();
+    /**
+     * @param summaries the summaries of the videos.
+     * @param videoFilePaths the video files that were found during the import.
+     * @param pgmfFilePaths the pgmf files that were found during the import.
+     */
+    explicit RealLifeVideoLibrary(std::vector<RealLifeVideoSummary> summaries,
+                                  const QList<QString> &videoFilePaths, const QList<QString> &pgmfFilePaths);
+
+    int size() const;
+    const RealLifeVideoSummary &summary(int index) const;
+    /** Get the complete video at index. Returns an invalid video if it could not be loaded. */
+    RealLifeVideo video(int index);
+    /** Replace a loaded video with a changed copy of it, like one with a new custom course. */
+    void updateVideo(const RealLifeVideo &rlv);
+private:
+    const std::vector<RealLifeVideoSummary> _summaries;
+    const QList<QString> _videoFilePaths;
+    const QList<QString> _pgmfFilePaths;
+    /** the most recently used videos, with their indexes, most recently used first. */
+    std::list<std::pair<int,RealLifeVideo>> _loadedVideos;
+};
+
+#endif // REALLIFEVIDEOLIBRARY_H
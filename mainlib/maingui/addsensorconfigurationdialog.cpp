@@ -95,6 +95,9 @@ AddSensorConfigurationDialog::AddSensorConfigurationDialog(
     fillUsbStickPresentLabel(_antCentralDispatch->antAdapterPresent());
     connect(_antCentralDispatch, &AntCentralDispatch::antUsbStickScanningFinished, this,
             &AddSensorConfigurationDialog::fillUsbStickPresentLabel);
+    connect(_antCentralDispatch, &AntCentralDispatch::antUsbStickLost, this, [this]() {
+        fillUsbStickPresentLabel(_antCentralDispatch->antAdapterPresent());
+    });
 }
 
 AddSensorConfigurationDialog::~AddSensorConfigurationDialog()
@@ -35,12 +35,14 @@
 #include "videolistview.h"
 #include "settingsdialog.h"
 #include "ant/antcentraldispatch.h"
-#include "model/cyclist.h"
+#include "model/ridejournal.h"
 #include "model/simulation.h"
 #include "network/analyticssender.h"
 #include "network/versionchecker.h"
 #include "ridegui/run.h"
 #include "ridegui/newvideowidget.h"
+#include "ride/fitfilewriter.h"
+#include "ride/ridefilewriter.h"
 
 
 MainWindow::MainWindow(bool showDebugOutput, QWidget *parent) :
@@ -115,9 +117,9 @@ void MainWindow::keyPressEvent(QKeyEvent *event)
     event->accept();
 }
 
-void MainWindow::importFinished(RealLifeVideoList rlvs)
+void MainWindow::importFinished(std::shared_ptr<RealLifeVideoLibrary> library)
 {
-    _listView->setVideos(rlvs);
+    _listView->setVideos(library);
 }
 
 void MainWindow::removeDisplayMessage()
@@ -165,8 +167,8 @@ void MainWindow::loadVideos()
 
     QProgressDialog *progressDialog = new QProgressDialog("Importing Videos", QString(), 0, 0, this);
 
-    connect(importer, &RealLifeVideoImporter::importFinished, this, [=](RealLifeVideoList list) {
-        this->importFinished(list);
+    connect(importer, &RealLifeVideoImporter::importFinished, this, [=](std::shared_ptr<RealLifeVideoLibrary> library) {
+        this->importFinished(library);
         importer->deleteLater();
         progressDialog->deleteLater();
     });
@@ -240,7 +242,6 @@ void MainWindow::startRun(RealLifeVideo rlv, int courseNr)
     } else {
         _guiFullScreen = false;
     }
-    connect(&_run->simulation().cyclist(), &Cyclist::distanceChanged, _videoWidget.data(), &NewVideoWidget::setDistance);
     connect(_videoWidget.data(), &NewVideoWidget::readyToPlay, this, [this](bool ready) {
         if (ready) {
             _run->start();
@@ -248,6 +249,7 @@ void MainWindow::startRun(RealLifeVideo rlv, int courseNr)
         }
     });
     connect(_run.get(), &Run::newInformationMessage, _videoWidget.data(), &NewVideoWidget::displayInformationBox);
+    connect(_run.get(), &Run::trainingMetricsUpdated, _videoWidget.data(), &NewVideoWidget::setTrainingMetrics);
     connect(_run.get(), &Run::stopped, _run.get(), [this]() {
         _run.reset();
         _stackedWidget->setCurrentIndex(_stackedWidget->indexOf(_listView));
@@ -277,10 +279,16 @@ void MainWindow::startRun(RealLifeVideo rlv, int courseNr)
 
 void MainWindow::closeEvent(QCloseEvent *event)
 {
-    // if the user chooses not stop the run, just ignore the event.
-    if (_run && !_run->handleStopRun(this)) {
-        event->ignore();
-        return;
+    if (_run) {
+        // stopping the run resets _run, but the run itself is only deleted later, from the event loop.
+        Run *run = _run.get();
+        // if the user chooses not stop the run, just ignore the event.
+        if (!run->handleStopRun(this)) {
+            event->ignore();
+            return;
+        }
+        // don't exit while the ride file is still being written.
+        run->waitUntilSaved();
     }
     qDebug() << "closing main window";
     event->accept();
@@ -296,9 +304,50 @@ void MainWindow::showEvent(QShowEvent *showEvent)
 
 void MainWindow::initialize()
 {
+    recoverInterruptedRides();
     loadVideos();
     VersionChecker *versionChecker = new VersionChecker(this);
     connect(versionChecker, &VersionChecker::newVersionAvailable, this, &MainWindow::newVersionAvailable);
     connect(versionChecker, &VersionChecker::newVersionAvailable, versionChecker, &VersionChecker::deleteLater);
     versionChecker->checkForNewVersion();
 }
+
+/**
+ * Offer to save the rides that were interrupted by a crash or power failure, from their journals.
+ */
+void MainWindow::recoverInterruptedRides()
+{
+    for (const QString &journalPath: RideJournal::interruptedJournals()) {
+        const std::unique_ptr<RideFile> rideFile = RideJournal::readRideFile(journalPath);
+        if (rideFile && !rideFile->samples().empty()) {
+            QMessageBox recoverMessageBox(this);
+            recoverMessageBox.setText(tr("A ride was interrupted. Save it?"));
+            recoverMessageBox.setIcon(QMessageBox::Question);
+            recoverMessageBox.setInformativeText(
+                        tr("The ride on %1, started at %2, will be written to %3.")
+                        .arg(rideFile->rlvName())
+                        .arg(rideFile->startTime().toLocalTime().toString(Qt::SystemLocaleShortDate))
+                        .arg(RideFileWriter().determineFilePath(*rideFile)));
+            recoverMessageBox.setStandardButtons(QMessageBox::Save | QMessageBox::Discard);
+            recoverMessageBox.setDefaultButton(QMessageBox::Save);
+            if (recoverMessageBox.exec() == QMessageBox::Save) {
+                const QString filePath = RideFileWriter().writeRideFile(*rideFile);
+                if (filePath.isEmpty()) {
+                    // keep the journal, so the ride can be recovered the next time.
+                    QMessageBox::warning(this, tr("Unable to save ride"),
+                                         tr("The ride on %1 could not be written to %2. It will be offered again "
+                                            "the next time the program is started.")
+                                         .arg(rideFile->rlvName())
+                                         .arg(RideFileWriter().determineFilePath(*rideFile)));
+                    continue;
+                }
+                if (BigRingSettings().writeFitFiles()) {
+                    FitFileWriter().writeRideFile(*rideFile);
+                }
+            }
+        }
+        if (!QFile::remove(journalPath)) {
+            qWarning("Unable to remove %s", qPrintable(journalPath));
+        }
+    }
+}
@@ -62,12 +62,13 @@ protected:
 private slots:
     void initialize();
     void loadVideos();
-    void importFinished(RealLifeVideoList rlvs);
+    void importFinished(std::shared_ptr<RealLifeVideoLibrary> library);
     void removeDisplayMessage();
     /** Show that a new version is available */
     void newVersionAvailable(bool newVersion, const QString &version);
 private:
     void setupMenuBar();
+    void recoverInterruptedRides();
     void startRun(RealLifeVideo rlv, int courseNr);
 
     indoorcycling::AntCentralDispatch* const _antCentralDispatch;
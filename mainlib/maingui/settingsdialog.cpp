@@ -201,6 +201,13 @@ void SettingsDialog::fillWeights()
 
     _ui->userWeightSpinBox->blockSignals(false);
     _ui->bikeWeightSpinBox->blockSignals(false);
+
+    _ui->functionalThresholdPowerSpinBox->blockSignals(true);
+    _ui->anaerobicWorkCapacitySpinBox->blockSignals(true);
+    _ui->functionalThresholdPowerSpinBox->setValue(_settings.functionalThresholdPower());
+    _ui->anaerobicWorkCapacitySpinBox->setValue(_settings.anaerobicWorkCapacity() / 1000.0);
+    _ui->functionalThresholdPowerSpinBox->blockSignals(false);
+    _ui->anaerobicWorkCapacitySpinBox->blockSignals(false);
 }
 
 void SettingsDialog::fillPowerAveragingComboBox()
@@ -283,6 +290,8 @@ void SettingsDialog::reset()
     fillDifficultySetting();
 
     _ui->tcxSaveLocationTextEdit->setText(_settings.tcxFolder());
+    _ui->compressTcxCheckBox->setChecked(_settings.compressRideFiles());
+    _ui->writeFitCheckBox->setChecked(_settings.writeFitFiles());
     _ui->powerForElevationCorrectionSpinBox->setValue(_settings.powerForElevationCorrection());
 }
 
@@ -319,6 +328,16 @@ void SettingsDialog::on_bikeWeightSpinBox_valueChanged(double bikeWeight)
     BigRingSettings().setBikeWeight(weightInKilograms);
 }
 
+void SettingsDialog::on_functionalThresholdPowerSpinBox_valueChanged(int functionalThresholdPower)
+{
+    BigRingSettings().setFunctionalThresholdPower(functionalThresholdPower);
+}
+
+void SettingsDialog::on_anaerobicWorkCapacitySpinBox_valueChanged(double anaerobicWorkCapacityKilojoules)
+{
+    BigRingSettings().setAnaerobicWorkCapacity(qRound(anaerobicWorkCapacityKilojoules * 1000.0));
+}
+
 void SettingsDialog::on_changeTcxFolderButton_clicked()
 {
     const QStringList homeDirectories = QStandardPaths::standardLocations(QStandardPaths::HomeLocation);
@@ -340,6 +359,16 @@ void SettingsDialog::on_changeTcxFolderButton_clicked()
     }
 }
 
+void SettingsDialog::on_compressTcxCheckBox_toggled(bool checked)
+{
+    _settings.setCompressRideFiles(checked);
+}
+
+void SettingsDialog::on_writeFitCheckBox_toggled(bool checked)
+{
+    _settings.setWriteFitFiles(checked);
+}
+
 void SettingsDialog::on_videoFillScreenOption_toggled(bool checked)
 {
     if (checked) {
@@ -66,8 +66,16 @@ private slots:
 
     void on_bikeWeightSpinBox_valueChanged(double arg1);
 
+    void on_functionalThresholdPowerSpinBox_valueChanged(int functionalThresholdPower);
+
+    void on_anaerobicWorkCapacitySpinBox_valueChanged(double anaerobicWorkCapacityKilojoules);
+
     void on_changeTcxFolderButton_clicked();
 
+    void on_compressTcxCheckBox_toggled(bool checked);
+
+    void on_writeFitCheckBox_toggled(bool checked);
+
     void on_videoFillScreenOption_toggled(bool checked);
 
     void on_videoShowWholeVideoOption_toggled(bool checked);
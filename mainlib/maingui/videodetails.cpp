@@ -22,10 +22,12 @@
 #include <QtCore/QtDebug>
 #include "createnewcoursedialog.h"
 #include "generalgui/quantityprinter.h"
+#include "video/videoprefetcher.h"
 
 VideoDetails::VideoDetails(QWidget *parent) :
     QWidget(parent),
     _quantityPrinter(new QuantityPrinter(this)),
+    _videoPrefetcher(new VideoPrefetcher(this)),
     ui(new Ui::VideoDetails)
 {
     ui->setupUi(this);
@@ -63,6 +65,7 @@ void VideoDetails::on_courseListWidget_currentRowChanged(int currentRow)
     ui->altitudeProfileWidget->setCourseIndex(_courseIndex);
     if (currentRow >= 0) {
         ui->videoScreenshotWidget->setDistance(_currentRlv.courses()[currentRow].start());
+        _videoPrefetcher->prefetch(_currentRlv, _currentRlv.courses()[currentRow].start());
         qDebug() << "course selected:" << _currentRlv.courses()[currentRow].name();
     }
 }
@@ -82,6 +85,7 @@ void VideoDetails::on_newCourseButton_clicked()
         settings.setValue(courseName, QVariant::fromValue(startDistanceOfCustomRun));
         settings.setValue(courseName + "_end", QVariant::fromValue(endDistanceOfCustomRun));
         settings.endGroup();
+        emit customCourseAdded(_currentRlv);
 
         ui->courseListWidget->clear();
         for (const Course& course: _currentRlv.courses()) {
@@ -25,6 +25,7 @@
 #include "model/reallifevideo.h"
 
 class QuantityPrinter;
+class VideoPrefetcher;
 
 namespace Ui {
 class VideoDetails;
@@ -42,6 +43,8 @@ public slots:
     void setVideo(RealLifeVideo& rlv);
 signals:
     void playClicked(RealLifeVideo& rlv, int courseNr);
+    /** emitted with the changed video when the user adds a custom course to it. */
+    void customCourseAdded(const RealLifeVideo& rlv);
 private slots:
     void on_startButton_clicked();
 
@@ -53,6 +56,7 @@ private:
     RealLifeVideo _currentRlv;
     int _courseIndex;
     QuantityPrinter* const _quantityPrinter;
+    VideoPrefetcher* const _videoPrefetcher;
     Ui::VideoDetails *ui;
 };
 
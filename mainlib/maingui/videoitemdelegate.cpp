@@ -19,6 +19,7 @@
  */
 #include "generalgui/profilepainter.h"
 #include "generalgui/quantityprinter.h"
+#include "model/reallifevideosummary.h"
 #include "videoitemdelegate.h"
 #include "videolistmodel.h"
 #include <QtWidgets/QApplication>
@@ -40,8 +41,7 @@ void VideoItemDelegate::paint(QPainter *painter, const QStyleOptionViewItem &opt
     QPen pen(((option.state & QStyle::State_Selected) ? option.palette.highlightedText() : option.palette.text()).color());
     painter->setBrush(rectBrush);
     painter->drawRoundedRect(option.rect, 3, 3);
-    QVariant rlvData = index.data(VideoDataRole);
-    RealLifeVideo video = rlvData.value<RealLifeVideo>();
+    const RealLifeVideoSummary &video = VideoListModel::summary(index);
 
     QSize rectSize = option.rect.size();
     QRect profileRect(option.rect.topLeft(), QSize(rectSize).scaled(.9 * rectSize.width(), .9 * rectSize.height(),
@@ -64,9 +64,9 @@ QSize VideoItemDelegate::sizeHint(const QStyleOptionViewItem &, const QModelInde
     return QSize(200, 100);
 }
 
-void VideoItemDelegate::paintProfile(QPainter *painter, QRect &rect, RealLifeVideo &rlv) const
+void VideoItemDelegate::paintProfile(QPainter *painter, QRect &rect, const RealLifeVideoSummary &summary) const
 {
-    QPixmap profilePixmap = _profilePainter->paintProfile(rlv, rect, false);
+    QPixmap profilePixmap = _profilePainter->paintMiniProfile(summary, rect);
     if (!profilePixmap.isNull()) {
         painter->drawPixmap(rect, profilePixmap);
     }
@@ -24,7 +24,7 @@
 
 class ProfilePainter;
 class QuantityPrinter;
-class RealLifeVideo;
+class RealLifeVideoSummary;
 
 class VideoItemDelegate: public QAbstractItemDelegate
 {
@@ -36,7 +36,7 @@ public:
     virtual QSize sizeHint(const QStyleOptionViewItem &option, const QModelIndex &index) const override;
 
 private:
-    void paintProfile(QPainter* painter, QRect& rect, RealLifeVideo& rlv) const;
+    void paintProfile(QPainter* painter, QRect& rect, const RealLifeVideoSummary& summary) const;
 
     ProfilePainter* _profilePainter;
     QuantityPrinter* _quantityPrinter;
@@ -19,36 +19,78 @@
  */
 #include "videolistmodel.h"
 
+#include <QtCore/QAbstractProxyModel>
 #include <QtCore/QtDebug>
 
+#include "importer/reallifevideolibrary.h"
+#include "model/reallifevideosummary.h"
+
+namespace
+{
+const RealLifeVideoSummary INVALID_SUMMARY;
+}
+
 VideoListModel::VideoListModel(QObject *parent) :
-    QAbstractListModel(parent)
+    QAbstractListModel(parent), _library(std::make_shared<RealLifeVideoLibrary>())
 {
 }
 
-void VideoListModel::setVideos(RealLifeVideoList &rlvs)
+void VideoListModel::setVideos(std::shared_ptr<RealLifeVideoLibrary> library)
 {
     qDebug() << "settings videos in model";
-    beginInsertRows(QModelIndex(), 0, 0);
-    _rlvs = rlvs;
-    endInsertRows();
+    beginResetModel();
+    _library = library;
+    endResetModel();
+}
+
+void VideoListModel::updateVideo(const RealLifeVideo &rlv)
+{
+    _library->updateVideo(rlv);
 }
 
 int VideoListModel::rowCount(const QModelIndex &) const
 {
-    return _rlvs.size();
+    return _library->size();
 }
 
 QVariant VideoListModel::data(const QModelIndex &index, int role) const
 {
-    if (index.row() <= _rlvs.size()) {
-        const RealLifeVideo &rlv = _rlvs[index.row()];
-        switch(role) {
-        case Qt::DisplayRole:
-            return QVariant::fromValue(rlv.name());
-        case VideoDataRole:
-            return QVariant::fromValue(rlv);
-        }
+    if (index.row() < _library->size() && role == Qt::DisplayRole) {
+        return QVariant::fromValue(_library->summary(index.row()).name());
     }
     return QVariant();
 }
+
+const RealLifeVideoSummary &VideoListModel::summary(const QModelIndex &index)
+{
+    int row;
+    const VideoListModel* model = sourceModel(index, row);
+    if (!model) {
+        return INVALID_SUMMARY;
+    }
+    return model->_library->summary(row);
+}
+
+RealLifeVideo VideoListModel::video(const QModelIndex &index)
+{
+    int row;
+    const VideoListModel* model = sourceModel(index, row);
+    if (!model) {
+        return RealLifeVideo();
+    }
+    return model->_library->video(row);
+}
+
+const VideoListModel *VideoListModel::sourceModel(const QModelIndex &index, int &row)
+{
+    QModelIndex sourceIndex = index;
+    while (const QAbstractProxyModel* proxyModel = qobject_cast<const QAbstractProxyModel*>(sourceIndex.model())) {
+        sourceIndex = proxyModel->mapToSource(sourceIndex);
+    }
+    const VideoListModel* model = qobject_cast<const VideoListModel*>(sourceIndex.model());
+    row = sourceIndex.row();
+    if (!model || row < 0 || row >= model->_library->size()) {
+        return nullptr;
+    }
+    return model;
+}
@@ -20,10 +20,14 @@
 #ifndef VIDEOLISTMODEL_H
 #define VIDEOLISTMODEL_H
 
+#include <memory>
+
 #include <QtCore/QAbstractListModel>
 #include "model/reallifevideo.h"
 
-const int VideoDataRole = Qt::UserRole + 1;
+class RealLifeVideoLibrary;
+class RealLifeVideoSummary;
+
 class VideoListModel : public QAbstractListModel
 {
     Q_OBJECT
@@ -32,13 +36,28 @@ public:
 
     virtual int rowCount(const QModelIndex &parent = QModelIndex()) const;
     virtual QVariant data(const QModelIndex &index, int role) const;
+
+    /**
+     * Get the summary of the video for an index of a VideoListModel, or of a proxy model on top of one.
+     * Returns an invalid summary if the index does not belong to a VideoListModel.
+     */
+    static const RealLifeVideoSummary &summary(const QModelIndex &index);
+    /**
+     * Get the complete video for an index of a VideoListModel, or of a proxy model on top of one. The video is loaded
+     * if it was not loaded recently. Returns an invalid video if the index does not belong to a VideoListModel.
+     */
+    static RealLifeVideo video(const QModelIndex &index);
 signals:
 
 public slots:
-    void setVideos(RealLifeVideoList& rlvs);
+    void setVideos(std::shared_ptr<RealLifeVideoLibrary> library);
+    /** replace the video that is equal to rlv, for instance after a custom course was added to it. */
+    void updateVideo(const RealLifeVideo& rlv);
 
 private:
-    RealLifeVideoList _rlvs;
+    static const VideoListModel *sourceModel(const QModelIndex &index, int &row);
+
+    std::shared_ptr<RealLifeVideoLibrary> _library;
 };
 
 #endif // VIDEOLISTMODEL_H
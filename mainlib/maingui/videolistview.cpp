@@ -61,6 +61,7 @@ VideoListView::VideoListView(QWidget *parent) :
     layout->addWidget(_detailsWidget, 3);
 
     connect(_detailsWidget, &VideoDetails::playClicked, this, &VideoListView::videoSelected);
+    connect(_detailsWidget, &VideoDetails::customCourseAdded, _videoListModel, &VideoListModel::updateVideo);
     connect(_filterLineEdit, &QLineEdit::textChanged, _filterLineEdit, [=](const QString& text) {
         _filterProxyModel->setFilterRegExp(QRegExp(text, Qt::CaseInsensitive, QRegExp::FixedString));
     });
@@ -68,9 +69,9 @@ VideoListView::VideoListView(QWidget *parent) :
     setLayout(layout);
 }
 
-void VideoListView::setVideos(RealLifeVideoList &rlvs)
+void VideoListView::setVideos(std::shared_ptr<RealLifeVideoLibrary> library)
 {
-    _videoListModel->setVideos(rlvs);
+    _videoListModel->setVideos(library);
     _filterProxyModel->setSourceModel(_videoListModel);
 }
 
@@ -78,7 +79,7 @@ void VideoListView::selectionChanged(const QItemSelection &selected, const QItem
 {
     RealLifeVideo rlv;
     if (!selected.isEmpty()) {
-        rlv = selected.indexes()[0].data(VideoDataRole).value<RealLifeVideo>();
+        rlv = VideoListModel::video(selected.indexes()[0]);
     }
     _detailsWidget->setVideo(rlv);
 }
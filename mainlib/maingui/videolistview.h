@@ -20,12 +20,15 @@
 #ifndef VIDEOLISTVIEW_H
 #define VIDEOLISTVIEW_H
 
+#include <memory>
+
 #include <QtCore/QSortFilterProxyModel>
 #include <QtGui/QPainter>
 #include <QtWidgets/QWidget>
 #include <QtWidgets/QListView>
 #include <QtWidgets/QLineEdit>
 
+class RealLifeVideoLibrary;
 class VideoListModel;
 class VideoDetails;
 
@@ -45,7 +48,7 @@ signals:
     void videoSelected(RealLifeVideo& rlv, int courseNr);
 
 public slots:
-    void setVideos(RealLifeVideoList& rlvs);
+    void setVideos(std::shared_ptr<RealLifeVideoLibrary> library);
 
 private slots:
     void selectionChanged(const QItemSelection & selected, const QItemSelection & deselected);
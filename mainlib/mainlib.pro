@@ -21,9 +21,11 @@ ANT_HEADERS += \
     ant/antchannelhandler.h \
     ant/antsensortype.h \
     ant/antheartratechannelhandler.h \
+    ant/antmasterchannelscheduler.h \
     ant/antpowerchannelhandler.h \
     ant/antsmarttrainerchannelhandler.h \
     ant/antspeedandcadencechannelhandler.h \
+    ant/simulatedantdevice.h \
 
 ANT_SOURCES += \
     ant/antdevice.cpp \
@@ -34,9 +36,11 @@ ANT_SOURCES += \
     ant/antcentraldispatch.cpp \
     ant/antchannelhandler.cpp \
     ant/antheartratechannelhandler.cpp \
+    ant/antmasterchannelscheduler.cpp \
     ant/antpowerchannelhandler.cpp \
     ant/antsmarttrainerchannelhandler.cpp \
-    ant/antspeedandcadencechannelhandler.cpp
+    ant/antspeedandcadencechannelhandler.cpp \
+    ant/simulatedantdevice.cpp
 
 linux {
     ANT_SOURCES += thirdparty/libusb-compat/core.c
@@ -69,6 +73,7 @@ IMPORTER_HEADERS += \
     importer/virtualtrainingfileparser.h \
     importer/reallifevideocache.h \
     importer/reallifevideoimporter.h \
+    importer/reallifevideolibrary.h \
     importer/rlvfileparser.h
 
 IMPORTER_SOURCES += \
@@ -76,6 +81,7 @@ IMPORTER_SOURCES += \
     importer/virtualtrainingfileparser.cpp \
     importer/reallifevideocache.cpp \
     importer/reallifevideoimporter.cpp \
+    importer/reallifevideolibrary.cpp \
     importer/rlvfileparser.cpp
 
 MAINGUI_HEADERS +=\
@@ -115,33 +121,52 @@ MAINGUI_FORMS +=\
     maingui/videoscreenshotwidget.ui
 
 MODEL_HEADERS += \
+    model/cyclingphysics.h \
     model/cyclist.h \
     model/distanceentrycollection.h \
+    model/distancelookuptable.h \
     model/distancemappingentry.h \
     model/geoposition.h \
+    model/normalizedpower.h \
     model/profile.h \
     model/reallifevideo.h \
+    model/reallifevideosummary.h \
     model/ridefile.h \
+    model/ridejournal.h \
     model/ridesampler.h \
-    model/rollingaveragecalculator.h \
+    model/ridesimulator.h \
+    model/sensorchannel.h \
     model/simulation.h \
+    model/simulationengine.h \
+    model/simulationstate.h \
+    model/trainingmetrics.h \
     model/unitconverter.h \
     model/videoinformation.h \
-    model/virtualpower.h
+    model/virtualpower.h \
+    model/windowedstatistics.h
 
 MODEL_SOURCES += \
+    model/cyclingphysics.cpp \
     model/cyclist.cpp \
+    model/distancelookuptable.cpp \
     model/distancemappingentry.cpp \
     model/geoposition.cpp \
+    model/normalizedpower.cpp \
     model/profile.cpp \
     model/reallifevideo.cpp \
+    model/reallifevideosummary.cpp \
     model/ridefile.cpp \
+    model/ridejournal.cpp \
     model/ridesampler.cpp \
-    model/rollingaveragecalculator.cpp \
+    model/ridesimulator.cpp \
+    model/sensorchannel.cpp \
     model/simulation.cpp \
+    model/simulationengine.cpp \
+    model/trainingmetrics.cpp \
     model/unitconverter.cpp \
     model/videoinformation.cpp \
-    model/virtualpower.cpp
+    model/virtualpower.cpp \
+    model/windowedstatistics.cpp
 
 NETWORK_HEADERS += \
     network/analyticssender.h \
@@ -153,16 +178,20 @@ NETWORK_SOURCES += \
 
 RIDE_HEADERS += \
     ride/actuators.h \
+    ride/fitfilewriter.h \
     ride/ridefilewriter.h \
     ride/sensors.h
 
 RIDE_SOURCES += \
     ride/actuators.cpp \
+    ride/fitfilewriter.cpp \
     ride/ridefilewriter.cpp \
     ride/sensors.cpp
 
 RIDEGUI_HEADERS += \
     ridegui/clockgraphicsitem.h \
+    ridegui/glyphatlas.h \
+    ridegui/hudmodel.h \
     ridegui/informationboxgraphicsitem.h \
     ridegui/messagepanelitem.h \
     ridegui/newvideowidget.h \
@@ -173,6 +202,8 @@ RIDEGUI_HEADERS += \
 
 RIDEGUI_SOURCES += \
     ridegui/clockgraphicsitem.cpp \
+    ridegui/glyphatlas.cpp \
+    ridegui/hudmodel.cpp \
     ridegui/informationboxgraphicsitem.cpp \
     ridegui/messagepanelitem.cpp \
     ridegui/newvideowidget.cpp \
@@ -192,20 +223,26 @@ VIDEO_HEADERS += \
     video/framebuffer.h \
     video/genericvideoreader.h \
     video/openglpainter2.h \
+    video/prefetchingvideoreader.h \
+    video/readaheadfile.h \
     video/thumbnailcreatingvideoreader.h \
     video/framecopyingvideoreader.h \
     video/thumbnailer.h \
     video/videoinforeader.h \
-    video/videoplayer.h
+    video/videoplayer.h \
+    video/videoprefetcher.h
 
 VIDEO_SOURCES += \
     video/genericvideoreader.cpp \
     video/openglpainter2.cpp \
+    video/prefetchingvideoreader.cpp \
+    video/readaheadfile.cpp \
     video/thumbnailcreatingvideoreader.cpp \
     video/framecopyingvideoreader.cpp \
     video/thumbnailer.cpp \
     video/videoinforeader.cpp \
-    video/videoplayer.cpp
+    video/videoplayer.cpp \
+    video/videoprefetcher.cpp
 
 
 HEADERS += \
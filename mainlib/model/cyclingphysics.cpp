@@ -0,0 +1,163 @@
+/*
+ * Copyright (c) 2015 Ilja Booij (ibooij@gmail.com)
+ *
+ * This file is part of Big Ring Indoor Video Cycling
+ *
+ * Big Ring Indoor Video Cycling is free software: you can redistribute
+ * it and/or modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation, either version 3 of the
+ * License, or (at your option) any later version.
+ *
+ * Big Ring Indoor Video Cycling  is distributed in the hope that it will
+ * be useful, but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+
+ * You should have received a copy of the GNU General Public License
+ * along with Big Ring Indoor Video Cycling.  If not, see
+ * <http://www.gnu.org/licenses/>.
+ */
+
+#include "cyclingphysics.h"
+
+namespace
+{
+const double NS_PER_S = 1e9;
+
+/** Frontal area of a cyclist is around .5 m*m */
+const float FRONTAL_AREA = 0.58f;
+const float DRAG_COEFFICIENT = 0.63f;
+const float AIR_DENSITY = 1.226f; // Sea level
+
+const float MINIMUM_SPEED = 0.5f; // m/s
+
+const qint64 MAX_IDLE_TIME_NS = Q_INT64_C(5000000000);
+const qint64 MAX_SUB_STEP_NS = Q_INT64_C(10000000);
+
+/** Calculate drag from wind resistance */
+double calculateAeroDrag(const double speed)
+{
+    return FRONTAL_AREA * DRAG_COEFFICIENT * AIR_DENSITY * speed * speed * .5;
+}
+
+const float GRAVITY_CONSTANT = 9.81f;
+const float ROLLING_RESISTANCE_COEFFICIENT = 0.004;
+
+double calculateGroundResistance(const qreal totalWeight)
+{
+    return totalWeight * GRAVITY_CONSTANT * ROLLING_RESISTANCE_COEFFICIENT;
+}
+
+double calculateGravityForce(const qreal totalWeight, float grade)
+{
+    return GRAVITY_CONSTANT * grade * 0.01 * totalWeight;
+}
+}
+
+CyclingPhysics::CyclingPhysics(const PhysicsParameters &parameters):
+    _parameters(parameters)
+{
+    // empty
+}
+
+const PhysicsParameters &CyclingPhysics::parameters() const
+{
+    return _parameters;
+}
+
+PhysicsState CyclingPhysics::step(const PhysicsState &state, const Profile &profile, int measuredPower,
+                                  qint64 timeDeltaNs) const
+{
+    const double power = (1.0 + _parameters.powerForElevationCorrection) * measuredPower;
+
+    PhysicsState nextState = state;
+    if (power < 1.0f) {
+        // if there is no power input and current speed is zero, assume we have no input.
+        if (state.speed < MINIMUM_SPEED) {
+            return advance(nextState, 0, timeDeltaNs);
+        }
+        // let the cyclist slow down and stop running after MAX_IDLE_TIME.
+        nextState.idleTimeNs += timeDeltaNs;
+        if (nextState.idleTimeNs > MAX_IDLE_TIME_NS) {
+            return advance(nextState, 0, timeDeltaNs);
+        }
+    } else {
+        nextState.idleTimeNs = 0;
+    }
+
+    const qint64 subSteps = qMax(Q_INT64_C(1), (timeDeltaNs + MAX_SUB_STEP_NS - 1) / MAX_SUB_STEP_NS);
+    const double h = timeDeltaNs / NS_PER_S / subSteps;
+
+    double speed = state.speed;
+    double distanceTravelled = 0;
+    for (qint64 i = 0; i < subSteps; ++i) {
+        const double distance = state.distance + distanceTravelled;
+
+        const double k1Speed = acceleration(profile, power, speed, distance);
+        const double k1Distance = speed;
+        const double k2Speed = acceleration(profile, power, speed + h / 2 * k1Speed, distance + h / 2 * k1Distance);
+        const double k2Distance = speed + h / 2 * k1Speed;
+        const double k3Speed = acceleration(profile, power, speed + h / 2 * k2Speed, distance + h / 2 * k2Distance);
+        const double k3Distance = speed + h / 2 * k2Speed;
+        const double k4Speed = acceleration(profile, power, speed + h * k3Speed, distance + h * k3Distance);
+        const double k4Distance = speed + h * k3Speed;
+
+        distanceTravelled += h / 6 * (k1Distance + 2 * k2Distance + 2 * k3Distance + k4Distance);
+        speed += h / 6 * (k1Speed + 2 * k2Speed + 2 * k3Speed + k4Speed);
+
+        // If there's power applied, always ride at least at MINIMUM_SPEED.
+        speed = qMax(static_cast<double>(MINIMUM_SPEED), speed);
+    }
+
+    if (state.speed > 0) {
+        nextState.runTimeNs += timeDeltaNs;
+    }
+    nextState.speed = speed;
+    nextState.distance = state.distance + distanceTravelled;
+    nextState.distanceTravelled = state.distanceTravelled + distanceTravelled;
+    return nextState;
+}
+
+PhysicsState CyclingPhysics::stepWithSpeed(const PhysicsState &state, double speed, qint64 timeDeltaNs) const
+{
+    return advance(state, speed, timeDeltaNs);
+}
+
+PhysicsState CyclingPhysics::interpolate(const PhysicsState &from, const PhysicsState &to, double alpha)
+{
+    PhysicsState state = to;
+    state.speed = from.speed + alpha * (to.speed - from.speed);
+    state.distance = from.distance + alpha * (to.distance - from.distance);
+    state.distanceTravelled = from.distanceTravelled + alpha * (to.distanceTravelled - from.distanceTravelled);
+    state.runTimeNs = from.runTimeNs + static_cast<qint64>(alpha * (to.runTimeNs - from.runTimeNs));
+    return state;
+}
+
+/**
+ * Acceleration of the cyclist at speed and distance.
+ */
+double CyclingPhysics::acceleration(const Profile &profile, double power, double speed, double distance) const
+{
+    // if speed is very low, use cyclist weight, otherwise force gets very high. Is there
+    // a better way to do this?
+    const double force = (speed > (MINIMUM_SPEED - 0.1)) ? power / speed : _parameters.totalWeight;
+
+    const double resistantForce = calculateAeroDrag(speed) +
+            calculateGravityForce(_parameters.totalWeight, profile.slopeForDistance(distance)) +
+            calculateGroundResistance(_parameters.totalWeight);
+    return (force - resistantForce) / _parameters.totalWeight;
+}
+
+PhysicsState CyclingPhysics::advance(const PhysicsState &state, double speed, qint64 timeDeltaNs) const
+{
+    PhysicsState nextState = state;
+    if (state.speed > 0) {
+        nextState.runTimeNs += timeDeltaNs;
+    }
+    const double distanceTravelled = speed * timeDeltaNs / NS_PER_S;
+
+    nextState.speed = speed;
+    nextState.distance += distanceTravelled;
+    nextState.distanceTravelled += distanceTravelled;
+    return nextState;
+}
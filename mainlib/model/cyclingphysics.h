@@ -0,0 +1,94 @@
+/*
+ * Copyright (c) 2015 Ilja Booij (ibooij@gmail.com)
+ *
+ * This file is part of Big Ring Indoor Video Cycling
+ *
+ * Big Ring Indoor Video Cycling is free software: you can redistribute
+ * it and/or modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation, either version 3 of the
+ * License, or (at your option) any later version.
+ *
+ * Big Ring Indoor Video Cycling  is distributed in the hope that it will
+ * be useful, but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+
+ * You should have received a copy of the GNU General Public License
+ * along with Big Ring Indoor Video Cycling.  If not, see
+ * <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef CYCLINGPHYSICS_H
+#define CYCLINGPHYSICS_H
+
+#include <QtCore/QtGlobal>
+
+#include "profile.h"
+
+/** Parameters of the physics that stay the same during a ride. */
+struct PhysicsParameters
+{
+    qreal totalWeight = 0; // kg, cyclist and bike
+    /** extra power, as a fraction of the power, to compensate for the elevation changes in a video */
+    double powerForElevationCorrection = 0;
+};
+
+/**
+ * Moving state of the cyclist, as integrated by CyclingPhysics. Speed and distances are doubles, as with small steps
+ * the changes per step get too small for the precision of a float.
+ */
+struct PhysicsState
+{
+    double speed = 0; // m/s
+    /** distance on track */
+    double distance = 0; // m
+    /** distance travelled from start of course */
+    double distanceTravelled = 0; // m
+    /** time ridden, only advances while the cyclist is moving */
+    qint64 runTimeNs = 0;
+    /** time without power input while still moving */
+    qint64 idleTimeNs = 0;
+};
+
+/**
+ * The physics of riding a bike over a profile: power against aerodynamic drag, gravity and rolling resistance.
+ *
+ * CyclingPhysics has no state of its own, it only calculates the next state from the current one. That makes it
+ * usable from the real time SimulationEngine as well as for simulating complete rides offline, from any thread, as
+ * long as every thread uses its own copy of the Profile.
+ *
+ * Speed and distance are integrated with the classic fourth order Runge-Kutta method, in sub-steps of at most 10 ms.
+ * The slope is looked up at the distance of every intermediate stage, so the slope is integrated over the distance
+ * covered in a step, instead of being taken from the start of the step only. The result hardly depends on the
+ * length of the steps, so a late step does not make the speed jump.
+ */
+class CyclingPhysics
+{
+public:
+    explicit CyclingPhysics(const PhysicsParameters &parameters);
+
+    const PhysicsParameters &parameters() const;
+
+    /**
+     * Calculate the state after timeDeltaNs of riding with power (W) over profile.
+     */
+    PhysicsState step(const PhysicsState &state, const Profile &profile, int power, qint64 timeDeltaNs) const;
+
+    /**
+     * Calculate the state after timeDeltaNs of riding at speed (m/s), for when speed is measured directly.
+     */
+    PhysicsState stepWithSpeed(const PhysicsState &state, double speed, qint64 timeDeltaNs) const;
+
+    /**
+     * Interpolate linearly between two states, with alpha from 0 (from) to 1 (to). Used to show a state between
+     * two steps.
+     */
+    static PhysicsState interpolate(const PhysicsState &from, const PhysicsState &to, double alpha);
+private:
+    double acceleration(const Profile &profile, double power, double speed, double distance) const;
+    PhysicsState advance(const PhysicsState &state, double speed, qint64 timeDeltaNs) const;
+
+    const PhysicsParameters _parameters;
+};
+
+#endif // CYCLINGPHYSICS_H
@@ -25,53 +25,35 @@ Cyclist::Cyclist(const qreal userWeight, const qreal bikeWeight, QObject *parent
 {
 }
 
-void Cyclist::setSpeed(float speed) {
-    _speed = speed;
-    emit speedChanged(speed);
-}
-
-void Cyclist::setGeoPosition(const GeoPosition &position)
-{
-    _geoPosition = position;
-    emit geoPositionChanged(_geoPosition);
-}
-
-void Cyclist::setDistance(float distance) {
-    _distance = distance;
-    emit distanceChanged(distance);
-}
-
-void Cyclist::setDistanceTravelled(float distanceTravelled)
+void Cyclist::setState(const CyclistState &state)
 {
-    _distanceTravelled = distanceTravelled;
-    emit distanceTravelledChanged(distanceTravelled);
+    _state = state;
+    emit stateUpdated();
 }
 
-void Cyclist::setAltitude(float altitude)
+const CyclistState &Cyclist::state() const
 {
-    _altitude = altitude;
-    emit altitudeChanged(altitude);
+    return _state;
 }
 
-
 float Cyclist::distance() const
 {
-    return _distance;
+    return _state.distance;
 }
 
 float Cyclist::distanceTravelled() const
 {
-    return _distanceTravelled;
+    return _state.distanceTravelled;
 }
 
 float Cyclist::altitude() const
 {
-    return _altitude;
+    return _state.altitude;
 }
 
 float Cyclist::speed() const
 {
-    return _speed;
+    return _state.speed;
 }
 
 int Cyclist::heartRate() const
@@ -86,7 +68,7 @@ int Cyclist::power() const
 
 GeoPosition Cyclist::geoPosition() const
 {
-    return _geoPosition;
+    return _state.geoPosition;
 }
 
 int Cyclist::cadence() const
@@ -24,17 +24,30 @@
 #include <QtCore/QObject>
 #include "geoposition.h"
 
+/**
+ * Where the cyclist is and how fast they are going. Changes with every simulation step, so it is set as one value,
+ * with one notification.
+ */
+struct CyclistState
+{
+    float speed = 0; // m/s
+    /** distance on track */
+    float distance = 0; // m
+    /** distance travelled from start of course */
+    float distanceTravelled = 0; // m
+    float altitude = 0; // m
+    GeoPosition geoPosition;
+};
+
 class Cyclist : public QObject
 {
     Q_OBJECT
 public:
     explicit Cyclist(const qreal userWeight, const qreal bikeWeight, QObject *parent = 0);
-    void setDistance(float distance);
-    void setDistanceTravelled(float distanceTravelled);
-    void setAltitude(float altitude);
-    void setSpeed(float speed);
-    void setGeoPosition(const GeoPosition &position);
+    /** set the state after a simulation step and emit stateUpdated() */
+    void setState(const CyclistState &state);
 
+    const CyclistState &state() const;
     float distance() const;
     float distanceTravelled() const;
     float altitude() const;
@@ -58,16 +71,8 @@ signals:
     void cadenceChanged(int cadence);
     void powerChanged(int power);
 
-
-    void speedChanged(float speed);
-    /** distance on track changed */
-    void distanceChanged(float distance);
-    /** distance travelled from start of course */
-    void distanceTravelledChanged(float distanceTravelled);
-    /** altitude changed */
-    void altitudeChanged(float altitude);
-    /** geo position changed */
-    void geoPositionChanged(const GeoPosition &geoPosition);
+    /** speed, distance, altitude and position changed, get them with state() */
+    void stateUpdated();
 
 private:
     const qreal _userWeight;
@@ -76,11 +81,7 @@ private:
     int _cadence = 0;
     int _power = 0;
 
-    float _speed = 0;
-    float _distance = 0;
-    float _distanceTravelled = 0;
-    float _altitude = 0;
-    GeoPosition _geoPosition;
+    CyclistState _state;
 };
 
 #endif // CYCLIST_H
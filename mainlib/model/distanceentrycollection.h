@@ -21,128 +21,216 @@
 #ifndef DISTANCEENTRYCOLLECTION_H
 #define DISTANCEENTRYCOLLECTION_H
 
-#include <functional>
+#include <cstddef>
+#include <memory>
 #include <vector>
 
-template <typename T>
+#include <QtCore/QtGlobal>
+
+/**
+ * Find the index of the first key that is not smaller than value in sorted keys, like std::lower_bound.
+ *
+ * The search halves the range without branching on the comparison, so it does not suffer from branch
+ * mispredictions, which are very likely with the random outcomes of a binary search.
+ * @return the index of the key, or size if all keys are smaller than value.
+ */
+inline std::size_t branchlessLowerBound(const float *keys, std::size_t size, float value)
+{
+    if (size == 0) {
+        return 0;
+    }
+    const float *base = keys;
+    while (size > 1) {
+        const std::size_t half = size / 2;
+        base = (base[half] < value) ? base + half : base;
+        size -= half;
+    }
+    return static_cast<std::size_t>(base - keys) + ((*base < value) ? 1 : 0);
+}
+
+/**
+ * Default key extractor for DistanceEntryCollection, for entry types with a distance() method.
+ */
+struct EntryDistance
+{
+    template <typename T>
+    qreal operator()(const T &entry) const {
+        return entry.distance();
+    }
+};
+
+/**
+ * A collection of entries ordered by distance, like ProfileEntries or GeoPositions, in which the entry for a
+ * distance can be found quickly.
+ *
+ * The distance of an entry is determined by DistanceOf, a function object type, so the compiler can inline it.
+ * The distances of the entries are kept in a separate, contiguous array of floats. Searches only touch that array,
+ * the entries themselves are only read when they are found.
+ *
+ * The entries are immutable and shared between copies of a collection, so copying is cheap. Searching does not
+ * change the collection, so a collection can be searched from several threads at once. Callers that walk through
+ * the collection from beginning to end can keep their own search position in a hint.
+ */
+template <typename T, typename DistanceOf = EntryDistance>
 class DistanceEntryCollection {
 public:
-    explicit DistanceEntryCollection();
-    explicit DistanceEntryCollection(const std::vector<T> &entries, std::function<qreal(const T&)> distanceFunction);
-    explicit DistanceEntryCollection(const DistanceEntryCollection& other);
+    typedef typename std::vector<T>::const_iterator const_iterator;
 
-    DistanceEntryCollection<T> &operator =(const DistanceEntryCollection& other);
+    explicit DistanceEntryCollection();
+    explicit DistanceEntryCollection(const std::vector<T> &entries);
 
     bool empty() const {
-        return _entries.empty();
+        return _storage->entries.empty();
     }
 
     const std::vector<T> &entries() const {
-        return _entries;
+        return _storage->entries;
     }
 
-    const typename std::vector<T>::const_iterator iteratorForDistance(const qreal distance);
+    /** Find the entry for distance, with a binary search over all entries. */
+    const const_iterator iteratorForDistance(const qreal distance) const;
 
-    const T *entryForDistance(const qreal distance);
+    /**
+     * Find the entry for distance, starting at the entry at index hint. The hint is set to the index of the entry
+     * that is found, so when the next distance is close to this one, the entry is found without searching.
+     */
+    const const_iterator iteratorForDistance(const qreal distance, std::size_t &hint) const;
 
-    bool isEndEntryIterator(const typename std::vector<T>::const_iterator &it) const;
+    const T *entryForDistance(const qreal distance) const;
+
+    bool isEndEntryIterator(const const_iterator &it) const;
+
+    /** number of bytes used by the entries and their distances, which are shared with all copies. */
+    std::size_t memoryUsage() const {
+        return _storage->entries.capacity() * sizeof(T) + _storage->distances.capacity() * sizeof(float);
+    }
 private:
-    std::vector<T> _entries;
-    std::function<qreal(const T&)> _distanceFunction;
+    struct Storage
+    {
+        explicit Storage(const std::vector<T> &entries);
+
+        const std::vector<T> entries;
+        std::vector<float> distances;
+    };
+
+    /** index of the last entry in [begin, end) that starts at or before key, or begin if there is none. */
+    std::size_t indexForDistance(const float key, const std::size_t begin, const std::size_t end) const;
 
-    typename std::vector<T>::const_iterator _currentEntry;
+    std::shared_ptr<const Storage> _storage;
 };
 
-template <typename T>
-DistanceEntryCollection<T>::DistanceEntryCollection()
+template <typename T, typename DistanceOf>
+DistanceEntryCollection<T, DistanceOf>::Storage::Storage(const std::vector<T> &entries):
+    entries(entries)
 {
-    // empty
+    const DistanceOf distanceOf = DistanceOf();
+    distances.reserve(entries.size());
+    for (const T &entry: entries) {
+        distances.push_back(static_cast<float>(distanceOf(entry)));
+    }
 }
 
-template <typename T>
-DistanceEntryCollection<T>::DistanceEntryCollection(const std::vector<T> &entries, std::function<qreal(const T &)> distanceFunction):
-    _entries(entries), _distanceFunction(distanceFunction), _currentEntry(_entries.begin())
+template <typename T, typename DistanceOf>
+DistanceEntryCollection<T, DistanceOf>::DistanceEntryCollection()
+{
+    // all empty collections share the same storage.
+    static const std::shared_ptr<const Storage> emptyStorage = std::make_shared<const Storage>(std::vector<T>());
+    _storage = emptyStorage;
+}
+
+template <typename T, typename DistanceOf>
+DistanceEntryCollection<T, DistanceOf>::DistanceEntryCollection(const std::vector<T> &entries):
+    _storage(std::make_shared<const Storage>(entries))
 {
     // empty
 }
 
-template <typename T>
-DistanceEntryCollection<T>::DistanceEntryCollection(const DistanceEntryCollection &other):
-    DistanceEntryCollection<T>(other._entries, other._distanceFunction)
+template <typename T, typename DistanceOf>
+std::size_t DistanceEntryCollection<T, DistanceOf>::indexForDistance(const float key, const std::size_t begin,
+                                                                    const std::size_t end) const
 {
+    const std::vector<float> &distances = _storage->distances;
+    std::size_t index = begin + branchlessLowerBound(distances.data() + begin, end - begin, key);
 
+    // lower bound gives us the first entry that is not smaller then distance, so we need to
+    // go back one step, unless we're already at the beginning.
+    if (index != 0 && (index == distances.size() || distances[index] > key)) {
+        index--;
+    }
+    return index;
 }
 
-template <typename T>
-DistanceEntryCollection<T> &DistanceEntryCollection<T>::operator =(const DistanceEntryCollection<T> &other)
+template <typename T, typename DistanceOf>
+const typename DistanceEntryCollection<T, DistanceOf>::const_iterator
+DistanceEntryCollection<T, DistanceOf>::iteratorForDistance(const qreal distance) const
 {
-    _entries = other._entries;
-    _distanceFunction = other._distanceFunction;
-    _currentEntry = _entries.begin();
-
-    return *this;
+    const std::vector<T> &entries = _storage->entries;
+    if (entries.empty()) {
+        return entries.end();
+    }
+    // the distances of the entries are stored as floats, so compare with the distance as a float too, otherwise an
+    // entry might not be found for its own distance.
+    return entries.begin() + indexForDistance(static_cast<float>(distance), 0, entries.size());
 }
 
-template <typename T>
-const typename std::vector<T>::const_iterator DistanceEntryCollection<T>::iteratorForDistance(const qreal distance)
+template <typename T, typename DistanceOf>
+const typename DistanceEntryCollection<T, DistanceOf>::const_iterator
+DistanceEntryCollection<T, DistanceOf>::iteratorForDistance(const qreal distance, std::size_t &hint) const
 {
-    if (_entries.empty()) {
-        return _entries.end();
+    const std::vector<T> &entries = _storage->entries;
+    const std::vector<float> &distances = _storage->distances;
+    if (entries.empty()) {
+        return entries.end();
     }
-    auto nextEntry = _currentEntry + 1;
-    const bool atLastEntry = _currentEntry == _entries.end() || nextEntry == _entries.end();
-    const bool isDistanceBiggerThenEndOfCurrent = !atLastEntry && distance > _distanceFunction(*(nextEntry));
+    const float key = static_cast<float>(distance);
+    const std::size_t size = distances.size();
+    if (hint >= size) {
+        // the hint was for another collection, or nothing was found yet.
+        hint = 0;
+    }
+    const std::size_t nextIndex = hint + 1;
+    const bool atLastEntry = nextIndex == size;
+    const bool isDistanceBiggerThenEndOfCurrent = !atLastEntry && key >= distances[nextIndex];
 
     // optimization for the common case. With most of these distance entry collections, we're going through them
     // from beginning to end. Rather than doing a binary search right away, we'll first check if the distance that
     // is requested is bigger than the start of the next entry, but smaller than the start of the entry after that.
     // If so, we can just use the next entry, without going to search mode.
-    if (!atLastEntry && isDistanceBiggerThenEndOfCurrent) {
-        auto entryAfterNext = nextEntry + 1;
-        const bool distanceSmallerThanEndOfNextEntry = entryAfterNext != _entries.end() && distance < _distanceFunction(*entryAfterNext);
+    if (isDistanceBiggerThenEndOfCurrent) {
+        const bool distanceSmallerThanEndOfNextEntry = nextIndex + 1 < size && key < distances[nextIndex + 1];
         if (distanceSmallerThanEndOfNextEntry) {
-            _currentEntry = nextEntry;
-            return _currentEntry;
+            hint = nextIndex;
+            return entries.begin() + hint;
         }
     }
-    const bool isDistanceSmallerThenStartOfCurrent = distance < _distanceFunction(*_currentEntry);
+    const bool isDistanceSmallerThenStartOfCurrent = key < distances[hint];
     // if the distance we're looking for is smaller than the current entry, or bigger than the
     // start of the next entry, then we need to search which entry to use. If not, we can
     // simply use the current entry.
-    if (isDistanceSmallerThenStartOfCurrent || (!atLastEntry && isDistanceBiggerThenEndOfCurrent)) {
+    if (isDistanceSmallerThenStartOfCurrent || isDistanceBiggerThenEndOfCurrent) {
         // optimization, determine bounds. If distance is before current entry start at begin, otherwise, start at nextEntry.
-        auto begin = isDistanceSmallerThenStartOfCurrent ? _entries.begin() : nextEntry;
+        const std::size_t begin = isDistanceSmallerThenStartOfCurrent ? 0 : nextIndex;
         // if distance is after current entry, end at end of vector, otherwise, end at the current entry.
-        auto end = isDistanceBiggerThenEndOfCurrent ? _entries.end(): _currentEntry;
-
-        auto it = std::lower_bound(begin, end, distance, [this](const T &entry, qreal distance) {
-            return _distanceFunction(entry) < distance;
-        });
-
-        // lower bound gives us the first entry that is not smaller then distance, so we need to
-        // go back one step, unless we're already at the beginning.
-        if (it != _entries.begin() && (it == _entries.end() || _distanceFunction(*it) > distance) ) {
-            it--;
-        }
-        _currentEntry = it;
+        const std::size_t end = isDistanceBiggerThenEndOfCurrent ? size : hint;
+        hint = indexForDistance(key, begin, end);
     }
-    return _currentEntry;
+    return entries.begin() + hint;
 }
 
-template <typename T>
-const T *DistanceEntryCollection<T>::entryForDistance(const qreal distance)
+template <typename T, typename DistanceOf>
+const T *DistanceEntryCollection<T, DistanceOf>::entryForDistance(const qreal distance) const
 {
     auto it = iteratorForDistance(distance);
-    if (it == _entries.end()) {
+    if (it == _storage->entries.end()) {
         return nullptr;
     }
     return &(*it);
 }
 
-template <typename T>
-bool DistanceEntryCollection<T>::isEndEntryIterator(const typename std::vector<T>::const_iterator &it) const
+template <typename T, typename DistanceOf>
+bool DistanceEntryCollection<T, DistanceOf>::isEndEntryIterator(const const_iterator &it) const
 {
-    return it == _entries.end();
+    return it == _storage->entries.end();
 }
 
 #endif // DISTANCEENTRYCOLLECTION_H
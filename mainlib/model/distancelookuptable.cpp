@@ -0,0 +1,49 @@
+/*
+ * Copyright (c) 2015 Ilja Booij (ibooij@gmail.com)
+ *
+ * This file is part of Big Ring Indoor Video Cycling
+ *
+ * Big Ring Indoor Video Cycling is free software: you can redistribute
+ * it and/or modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation, either version 3 of the
+ * License, or (at your option) any later version.
+ *
+ * Big Ring Indoor Video Cycling  is distributed in the hope that it will
+ * be useful, but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+
+ * You should have received a copy of the GNU General Public License
+ * along with Big Ring Indoor Video Cycling.  If not, see
+ * <http://www.gnu.org/licenses/>.
+ */
+
+#include "distancelookuptable.h"
+
+#include <cmath>
+
+DistanceLookupTable::DistanceLookupTable(float totalDistance, float resolution, const ValueFunction &frameFunction,
+                                         const ValueFunction &slopeFunction, const ValueFunction &altitudeFunction):
+    _totalDistance(qMax(0.0f, totalDistance)), _entriesPerMeter(1.0f / resolution)
+{
+    const std::size_t lastIndex = static_cast<std::size_t>(std::ceil(_totalDistance * _entriesPerMeter));
+    _lastPosition = static_cast<float>(lastIndex);
+
+    // one extra entry after the last one, so interpolating at the last entry never reads past the end.
+    _entries.reserve(lastIndex + 2);
+    for (std::size_t i = 0; i <= lastIndex; ++i) {
+        const float distance = qMin(_totalDistance, i * resolution);
+        _entries.push_back({ frameFunction(distance), slopeFunction(distance), altitudeFunction(distance) });
+    }
+    _entries.push_back(_entries.back());
+}
+
+float DistanceLookupTable::resolution() const
+{
+    return 1.0f / _entriesPerMeter;
+}
+
+std::size_t DistanceLookupTable::memoryUsage() const
+{
+    return sizeof(*this) + _entries.capacity() * sizeof(Entry);
+}
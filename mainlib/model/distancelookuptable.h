@@ -0,0 +1,96 @@
+/*
+ * Copyright (c) 2015 Ilja Booij (ibooij@gmail.com)
+ *
+ * This file is part of Big Ring Indoor Video Cycling
+ *
+ * Big Ring Indoor Video Cycling is free software: you can redistribute
+ * it and/or modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation, either version 3 of the
+ * License, or (at your option) any later version.
+ *
+ * Big Ring Indoor Video Cycling  is distributed in the hope that it will
+ * be useful, but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+
+ * You should have received a copy of the GNU General Public License
+ * along with Big Ring Indoor Video Cycling.  If not, see
+ * <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef DISTANCELOOKUPTABLE_H
+#define DISTANCELOOKUPTABLE_H
+
+#include <functional>
+#include <vector>
+
+#include <QtCore/QtGlobal>
+
+/**
+ * Dense table with the frame number, slope and altitude of a route for distances at a fixed interval.
+ *
+ * Looking up a value is an index calculation and an interpolation between two adjacent entries, without searching
+ * or branching, so it takes the same time wherever on the route the distance is. Frame numbers and altitudes are
+ * interpolated linearly, slopes are taken from the entry at or before the distance.
+ */
+class DistanceLookupTable
+{
+public:
+    typedef std::function<float(float)> ValueFunction;
+
+    /**
+     * Build a table with entries from 0 to totalDistance, every resolution meters. The value functions are called
+     * for every entry, in order of increasing distance.
+     */
+    explicit DistanceLookupTable(float totalDistance, float resolution, const ValueFunction& frameFunction,
+                                 const ValueFunction& slopeFunction, const ValueFunction& altitudeFunction);
+
+    /** true if distance is within the table. Outside the table the values are those of the first or last entry. */
+    bool contains(float distance) const {
+        return distance >= 0 && distance <= _totalDistance;
+    }
+
+    float resolution() const;
+    /** number of bytes used by the table */
+    std::size_t memoryUsage() const;
+
+    float frameForDistance(float distance) const {
+        float fraction;
+        const Entry* entry = entryForDistance(distance, fraction);
+        return entry[0].frame + (entry[1].frame - entry[0].frame) * fraction;
+    }
+
+    float slopeForDistance(float distance) const {
+        float fraction;
+        return entryForDistance(distance, fraction)->slope;
+    }
+
+    float altitudeForDistance(float distance) const {
+        float fraction;
+        const Entry* entry = entryForDistance(distance, fraction);
+        return entry[0].altitude + (entry[1].altitude - entry[0].altitude) * fraction;
+    }
+
+private:
+    struct Entry
+    {
+        float frame;
+        float slope;
+        float altitude;
+    };
+
+    /** the entry at or before distance. The entry after it is always valid too. */
+    const Entry* entryForDistance(float distance, float& fraction) const {
+        const float position = qBound(0.0f, distance * _entriesPerMeter, _lastPosition);
+        const std::size_t index = static_cast<std::size_t>(position);
+        fraction = position - index;
+        return &_entries[index];
+    }
+
+    float _totalDistance;
+    float _entriesPerMeter;
+    float _lastPosition;
+    std::vector<Entry> _entries;
+};
+
+#endif // DISTANCELOOKUPTABLE_H
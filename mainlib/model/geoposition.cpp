@@ -29,7 +29,8 @@ GeoPosition::GeoPosition():
 }
 
 GeoPosition::GeoPosition(qreal distance, const QGeoCoordinate &coordinate) :
-    _distance(distance), _coordinate(coordinate)
+    _distance(distance), _latitude(coordinate.latitude()), _longitude(coordinate.longitude()),
+    _altitude(coordinate.altitude())
 {
     // empty
 }
@@ -39,34 +40,34 @@ qreal GeoPosition::distance() const
     return _distance;
 }
 
-const QGeoCoordinate &GeoPosition::coordinate() const
+QGeoCoordinate GeoPosition::coordinate() const
 {
-    return _coordinate;
+    return QGeoCoordinate(_latitude, _longitude, _altitude);
 }
 
 double GeoPosition::latitude() const
 {
-    return _coordinate.latitude();
+    return _latitude;
 }
 
 double GeoPosition::longitude() const
 {
-    return _coordinate.longitude();
+    return _longitude;
 }
 
 double GeoPosition::altitude() const
 {
-    return _coordinate.altitude();
+    return _altitude;
 }
 
 bool GeoPosition::isValid() const
 {
-    return _coordinate.isValid();
+    return coordinate().isValid();
 }
 
 GeoPosition GeoPosition::interpolateBetween(const GeoPosition &position1, const GeoPosition &position2, const double distance)
 {
-    if (position1.coordinate() == position2.coordinate()) {
+    if (position1._latitude == position2._latitude && position1._longitude == position2._longitude) {
         return position1;
     }
     const double distanceBetweenPositions = position2.distance() - position1.distance();
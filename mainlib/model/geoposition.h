@@ -40,7 +40,7 @@ public:
     /** distance from the start */
     qreal distance() const;
     /** the coordinate of the position. Will be invalid if the isValid() method returns false */
-    const QGeoCoordinate &coordinate() const;
+    QGeoCoordinate coordinate() const;
     /** latitude of the position */
     double latitude() const;
     /** longitude of the position */
@@ -70,8 +70,12 @@ public:
      */
     GeoPosition withAltitude(const double altitude) const;
 private:
+    // the coordinate is stored as plain numbers, instead of as a QGeoCoordinate, which allocates its data on the
+    // heap. Routes can have hundreds of thousands of positions.
     qreal _distance;
-    QGeoCoordinate _coordinate;
+    double _latitude;
+    double _longitude;
+    double _altitude;
 };
 
 #endif // GEOPOSITION_H
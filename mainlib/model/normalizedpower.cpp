@@ -0,0 +1,68 @@
+/*
+ * Copyright (c) 2015 Ilja Booij (ibooij@gmail.com)
+ *
+ * This file is part of Big Ring Indoor Video Cycling
+ *
+ * Big Ring Indoor Video Cycling is free software: you can redistribute
+ * it and/or modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation, either version 3 of the
+ * License, or (at your option) any later version.
+ *
+ * Big Ring Indoor Video Cycling  is distributed in the hope that it will
+ * be useful, but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+
+ * You should have received a copy of the GNU General Public License
+ * along with Big Ring Indoor Video Cycling.  If not, see
+ * <http://www.gnu.org/licenses/>.
+ */
+#include "normalizedpower.h"
+
+#include <cmath>
+
+namespace {
+const qint64 THIRTY_SECONDS_MS = 30000;
+const qint64 SECOND_MS = 1000;
+}
+
+NormalizedPower::NormalizedPower():
+    _thirtySecondPower(THIRTY_SECONDS_MS), _started(false), _startMs(0), _nextSecondMs(0), _sumOfFourthPowers(0),
+    _numberOfSeconds(0)
+{
+    // empty
+}
+
+void NormalizedPower::addPower(qint64 timestampMs, float power)
+{
+    if (!_started) {
+        _started = true;
+        _startMs = timestampMs;
+        _nextSecondMs = timestampMs + SECOND_MS;
+    }
+    // sensors only send power when it changes, so the rolling average of the seconds that have passed since the last
+    // measurement is the current one.
+    while (_nextSecondMs <= timestampMs) {
+        if (_nextSecondMs - _startMs >= THIRTY_SECONDS_MS) {
+            const double rollingAverage = _thirtySecondPower.mean();
+            const double rollingAverageSquared = rollingAverage * rollingAverage;
+            _sumOfFourthPowers += rollingAverageSquared * rollingAverageSquared;
+            ++_numberOfSeconds;
+        }
+        _nextSecondMs += SECOND_MS;
+    }
+    _thirtySecondPower.add(timestampMs, power);
+}
+
+float NormalizedPower::thirtySecondPower() const
+{
+    return _thirtySecondPower.mean();
+}
+
+float NormalizedPower::normalizedPower() const
+{
+    if (_numberOfSeconds == 0) {
+        return 0.0f;
+    }
+    return static_cast<float>(std::pow(_sumOfFourthPowers / _numberOfSeconds, 0.25));
+}
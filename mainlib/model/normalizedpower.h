@@ -0,0 +1,55 @@
+/*
+ * Copyright (c) 2015 Ilja Booij (ibooij@gmail.com)
+ *
+ * This file is part of Big Ring Indoor Video Cycling
+ *
+ * Big Ring Indoor Video Cycling is free software: you can redistribute
+ * it and/or modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation, either version 3 of the
+ * License, or (at your option) any later version.
+ *
+ * Big Ring Indoor Video Cycling  is distributed in the hope that it will
+ * be useful, but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+
+ * You should have received a copy of the GNU General Public License
+ * along with Big Ring Indoor Video Cycling.  If not, see
+ * <http://www.gnu.org/licenses/>.
+ */
+#ifndef NORMALIZEDPOWER_H
+#define NORMALIZEDPOWER_H
+
+#include <QtCore/QtGlobal>
+
+#include "windowedstatistics.h"
+
+/**
+ * Incremental calculation of the 30 second power and the normalized power of a ride.
+ *
+ * Normalized power is the fourth root of the mean of the fourth powers of the 30 second rolling average power, taken
+ * every second once the first 30 seconds have passed. Every power measurement is handled in amortized constant time,
+ * so the values can be requested at any time during a ride.
+ */
+class NormalizedPower
+{
+public:
+    NormalizedPower();
+
+    /** Add a power measurement. Timestamps are monotonic milliseconds and should not decrease. */
+    void addPower(qint64 timestampMs, float power);
+
+    /** mean power of the last 30 seconds. */
+    float thirtySecondPower() const;
+    /** normalized power of the ride until now, or 0 for rides shorter than 30 seconds. */
+    float normalizedPower() const;
+private:
+    WindowedStatistics _thirtySecondPower;
+    bool _started;
+    qint64 _startMs;
+    qint64 _nextSecondMs;
+    double _sumOfFourthPowers;
+    qint64 _numberOfSeconds;
+};
+
+#endif // NORMALIZEDPOWER_H
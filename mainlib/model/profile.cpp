@@ -23,11 +23,6 @@
 #include <utility>
 #include <QtCore/QtDebug>
 
-namespace {
-std::function<qreal(const ProfileEntry&)> distanceFromProfileEntry([](const ProfileEntry& entry) {
-    return entry.distance();
-});
-}
 ProfileEntry::ProfileEntry(float distance, float slope, float altitude):
     _distance(distance),_altitude(altitude), _slope(slope)
 {
@@ -46,7 +41,7 @@ bool ProfileEntry::operator ==(const ProfileEntry &other) const
 Profile::Profile(ProfileType type, float startAltitude, const std::vector<ProfileEntry> &&entries):
     _type(type),
     _startAltitude(startAltitude),
-    _entries(entries, distanceFromProfileEntry)
+    _entries(entries)
 {
     // empty
 }
@@ -146,3 +141,8 @@ const std::vector<ProfileEntry> &Profile::entries() const
     return _entries.entries();
 }
 
+std::size_t Profile::memoryUsage() const
+{
+    return _entries.memoryUsage();
+}
+
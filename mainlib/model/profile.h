@@ -71,13 +71,16 @@ public:
     float minimumAltitudeForPart(float start, float end) const;
     float maximumAltitude() const;
     float maximumAltitudeForPart(float start, float end) const;
+
+    /** number of bytes used by the entries of the profile */
+    std::size_t memoryUsage() const;
 private:
     typedef std::vector<ProfileEntry> ProfileEntryVector;
     typedef std::vector<ProfileEntry>::const_iterator ProfileEntryVectorIt;
 
     ProfileType _type;
     float _startAltitude;
-    mutable DistanceEntryCollection<ProfileEntry> _entries;
+    DistanceEntryCollection<ProfileEntry> _entries;
 
     /** Get an iterator the the ProfileEntry we need for a specific distance */
     const ProfileEntryVectorIt entryIteratorForDistance(const float distance) const;
@@ -21,9 +21,13 @@
 #include "reallifevideo.h"
 
 #include "distanceentrycollection.h"
+#include "distancelookuptable.h"
 #include "distancemappingentry.h"
 #include "videoinformation.h"
 
+#include <memory>
+
+#include <QtCore/QElapsedTimer>
 #include <QtDebug>
 #include <QMapIterator>
 
@@ -34,6 +38,9 @@ std::map<RealLifeVideoFileType,const QString> REAL_LIFE_VIDEO_TYPE_NAMES =
  {RealLifeVideoFileType::TACX, "Tacx"},
  {RealLifeVideoFileType::VIRTUAL_TRAINING, "Cycleops Virtual Training"}};
 const QString REAL_LIFE_VIDEO_TYPE_NAMES_UNKNOWN_TYPE;
+const float LOOKUP_TABLE_RESOLUTION = 0.1f; // meters
+/** upper limit for the size of a lookup table, very long routes get a coarser table. */
+const float MAXIMUM_LOOKUP_TABLE_ENTRIES = 2 * 1024 * 1024;
 }
 
 const QString &realLifeVideoFileTypeName(RealLifeVideoFileType type) {
@@ -44,10 +51,14 @@ const QString &realLifeVideoFileTypeName(RealLifeVideoFileType type) {
     return (*it).second;
 }
 
+/**
+ * The route data of a RealLifeVideo. It is never changed after it is created, so it is shared by all copies of a
+ * RealLifeVideo, on all threads. Searching the distance entry collections does not change them.
+ */
 class RealLifeVideoData
 {
 public:
-    RealLifeVideoData()  {}
+    RealLifeVideoData(): _fileType(RealLifeVideoFileType::TACX) {}
 
     ~RealLifeVideoData() {}
 
@@ -57,9 +68,7 @@ public:
     DistanceEntryCollection<DistanceMappingEntry> _distanceMappings;
     DistanceEntryCollection<GeoPosition> _geoPositions;
     VideoInformation _videoInformation;
-    std::vector<Course> _courses;
     std::vector<InformationBox> _informationBoxes;
-    float _videoCorrectionFactor;
 };
 
 Course::Course(const QString &name, const Type type, float start, float end):
@@ -81,36 +90,45 @@ RealLifeVideo::RealLifeVideo(const QString &name, RealLifeVideoFileType fileType
                              const std::vector<Course> &&courses,
                              const std::vector<DistanceMappingEntry> &&distanceMappings,
                              const Profile &profile, const std::vector<InformationBox> &&informationBoxes, const std::vector<GeoPosition> &&geoPositions):
-    _d(new RealLifeVideoData)
-{
-    _d->_name = name;
-    _d->_fileType = fileType;
-    _d->_profile = profile;
-    _d->_videoInformation = videoInformation;
-    _d->_courses = courses;
-    _d->_videoCorrectionFactor = 1.0;
-    _d->_distanceMappings = DistanceEntryCollection<DistanceMappingEntry>(distanceMappings,
-        [](const DistanceMappingEntry &entry) {
-        return entry.distance();
-    });
-    _d->_informationBoxes = informationBoxes;
-    _d->_geoPositions =
-            DistanceEntryCollection<GeoPosition>(geoPositions,
-                                                 [](const GeoPosition &position) {
-        return position.distance();
-    });
+    _courses(std::make_shared<const std::vector<Course>>(courses)), _videoCorrectionFactor(1.0),
+    _lookupTableEnabled(false)
+{
+    std::shared_ptr<RealLifeVideoData> d = std::make_shared<RealLifeVideoData>();
+    d->_name = name;
+    d->_fileType = fileType;
+    d->_profile = profile;
+    d->_videoInformation = videoInformation;
+    d->_distanceMappings = DistanceEntryCollection<DistanceMappingEntry>(distanceMappings);
+    d->_informationBoxes = informationBoxes;
+    d->_geoPositions = DistanceEntryCollection<GeoPosition>(geoPositions);
+    _d = d;
 }
 
 RealLifeVideo::RealLifeVideo(const RealLifeVideo &other):
-    _d(other._d)
+    _d(other._d), _courses(other._courses), _videoCorrectionFactor(other._videoCorrectionFactor),
+    _lookupTableEnabled(other._lookupTableEnabled), _lookupTable(std::atomic_load(&other._lookupTable))
 {
-
+    // empty
 }
 
 RealLifeVideo::RealLifeVideo():
-    _d(new RealLifeVideoData)
+    _videoCorrectionFactor(1.0), _lookupTableEnabled(false)
 {
+    // all invalid videos share the same, empty, data.
+    static const std::shared_ptr<const RealLifeVideoData> emptyData = std::make_shared<const RealLifeVideoData>();
+    static const std::shared_ptr<const std::vector<Course>> noCourses = std::make_shared<const std::vector<Course>>();
+    _d = emptyData;
+    _courses = noCourses;
+}
 
+RealLifeVideo &RealLifeVideo::operator=(const RealLifeVideo &other)
+{
+    _d = other._d;
+    _courses = other._courses;
+    _videoCorrectionFactor = other._videoCorrectionFactor;
+    _lookupTableEnabled = other._lookupTableEnabled;
+    std::atomic_store(&_lookupTable, std::atomic_load(&other._lookupTable));
+    return *this;
 }
 
 bool RealLifeVideo::isValid() const
@@ -150,7 +168,7 @@ float RealLifeVideo::videoFrameRate() const
 
 const std::vector<Course> &RealLifeVideo::courses() const
 {
-    return _d->_courses;
+    return *_courses;
 }
 
 const std::vector<DistanceMappingEntry> &RealLifeVideo::distanceMappings() const
@@ -168,6 +186,11 @@ const std::vector<GeoPosition> &RealLifeVideo::positions() const
     return _d->_geoPositions.entries();
 }
 
+const DistanceEntryCollection<GeoPosition> &RealLifeVideo::positionCollection() const
+{
+    return _d->_geoPositions;
+}
+
 const QGeoRectangle RealLifeVideo::geoRectangle() const
 {
     QList<QGeoCoordinate> coordinates;
@@ -185,8 +208,10 @@ void RealLifeVideo::addStartPoint(float distance, const QString &name)
 
 void RealLifeVideo::addCustomCourse(float startDistance, float endDistance, const QString &name)
 {
-    Course customCourse(name, Course::Type::Custom, startDistance, endDistance);
-    _d->_courses.push_back(customCourse);
+    // copies of this video may share the list of courses, so add the course to a new list.
+    std::shared_ptr<std::vector<Course>> courses = std::make_shared<std::vector<Course>>(*_courses);
+    courses->push_back(Course(name, Course::Type::Custom, startDistance, endDistance));
+    _courses = courses;
 }
 
 float RealLifeVideo::metersPerFrame(const float distance) const
@@ -197,18 +222,28 @@ float RealLifeVideo::metersPerFrame(const float distance) const
 
 quint32 RealLifeVideo::frameForDistance(const float distance) const
 {
-    float correctedDistance = distance * _d->_videoCorrectionFactor;
-    const DistanceMappingEntry& entry = findDistanceMappingEntryFor(correctedDistance);
-    return entry.frameNumber() + (correctedDistance - entry.distance()) / entry.metersPerFrame();
+    const std::shared_ptr<const DistanceLookupTable> table = lookupTable();
+    if (table && table->contains(distance)) {
+        return static_cast<quint32>(table->frameForDistance(distance));
+    }
+    return static_cast<quint32>(exactFrameForDistance(distance));
 }
 
 float RealLifeVideo::slopeForDistance(const float distance) const
 {
+    const std::shared_ptr<const DistanceLookupTable> table = lookupTable();
+    if (table && table->contains(distance)) {
+        return table->slopeForDistance(distance);
+    }
     return _d->_profile.slopeForDistance(distance);
 }
 
 float RealLifeVideo::altitudeForDistance(const float distance) const
 {
+    const std::shared_ptr<const DistanceLookupTable> table = lookupTable();
+    if (table && table->contains(distance)) {
+        return table->altitudeForDistance(distance);
+    }
     return _d->_profile.altitudeForDistance(distance);
 }
 
@@ -257,15 +292,33 @@ float RealLifeVideo::totalDistance() const
     return _d->_profile.totalDistance();
 }
 
+std::size_t RealLifeVideo::memoryUsage() const
+{
+    std::size_t bytes = sizeof(RealLifeVideoData) + _d->_profile.memoryUsage() + _d->_distanceMappings.memoryUsage()
+            + _d->_geoPositions.memoryUsage() + _courses->capacity() * sizeof(Course)
+            + _d->_informationBoxes.capacity() * sizeof(InformationBox);
+    const std::shared_ptr<const DistanceLookupTable> table = std::atomic_load(&_lookupTable);
+    if (table) {
+        bytes += table->memoryUsage();
+    }
+    return bytes;
+}
 
 void RealLifeVideo::setNumberOfFrames(quint64 numberOfFrames)
 {
     if (_d->_fileType == RealLifeVideoFileType::TACX) {
         calculateVideoCorrectionFactor(numberOfFrames);
-        qDebug() << "correction factor" << _d->_videoCorrectionFactor;
+        qDebug() << "correction factor" << _videoCorrectionFactor;
     } else {
         qDebug() << "no correction factor needed.";
     }
+    // the frames for distances depend on the correction factor, so the table has to be built again.
+    std::atomic_store(&_lookupTable, std::shared_ptr<const DistanceLookupTable>());
+}
+
+void RealLifeVideo::enableLookupTable()
+{
+    _lookupTableEnabled = true;
 }
 
 bool RealLifeVideo::operator==(const RealLifeVideo &other) const
@@ -295,7 +348,7 @@ void RealLifeVideo::calculateVideoCorrectionFactor(quint64 totalNrOfFrames)
     // entries in the distancemappings list. For these rlvs, it seems to work
     // better to just use a _videoCorrectionFactor of 1.0.
     if (_d->_distanceMappings.entries().size() < 3) {
-        _d->_videoCorrectionFactor = 1;
+        _videoCorrectionFactor = 1;
     } else {
         const auto &lastDistanceMapping = _d->_distanceMappings.entries().back();
         quint64 framesInLastEntry;
@@ -305,8 +358,43 @@ void RealLifeVideo::calculateVideoCorrectionFactor(quint64 totalNrOfFrames)
             framesInLastEntry = 0u;
         }
         float videoDistance = lastDistanceMapping.distance() + framesInLastEntry * lastDistanceMapping.metersPerFrame();
-        _d->_videoCorrectionFactor = videoDistance / _d->_profile.totalDistance();
+        _videoCorrectionFactor = videoDistance / _d->_profile.totalDistance();
+    }
+}
+
+float RealLifeVideo::exactFrameForDistance(const float distance) const
+{
+    float correctedDistance = distance * _videoCorrectionFactor;
+    const DistanceMappingEntry& entry = findDistanceMappingEntryFor(correctedDistance);
+    return entry.frameNumber() + (correctedDistance - entry.distance()) / entry.metersPerFrame();
+}
+
+/**
+ * Get the lookup table for this video. The table is built the first time it is needed after it has been enabled.
+ * Returns an empty pointer if the table is not enabled.
+ */
+std::shared_ptr<const DistanceLookupTable> RealLifeVideo::lookupTable() const
+{
+    if (!_lookupTableEnabled) {
+        return std::shared_ptr<const DistanceLookupTable>();
+    }
+    std::shared_ptr<const DistanceLookupTable> table = std::atomic_load(&_lookupTable);
+    if (!table) {
+        QElapsedTimer timer;
+        timer.start();
+        const float resolution = qMax(LOOKUP_TABLE_RESOLUTION, totalDistance() / MAXIMUM_LOOKUP_TABLE_ENTRIES);
+        table = std::make_shared<const DistanceLookupTable>(totalDistance(), resolution, [this](float distance) {
+            return exactFrameForDistance(distance);
+        }, [this](float distance) {
+            return _d->_profile.slopeForDistance(distance);
+        }, [this](float distance) {
+            return _d->_profile.altitudeForDistance(distance);
+        });
+        qDebug() << "lookup table for" << name() << "with resolution" << resolution << "m uses"
+                 << table->memoryUsage() / 1024 << "KiB, built in" << timer.elapsed() << "ms";
+        std::atomic_store(&_lookupTable, table);
     }
+    return table;
 }
 
 const DistanceMappingEntry &RealLifeVideo::findDistanceMappingEntryFor(const float distance) const
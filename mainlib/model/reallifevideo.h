@@ -21,15 +21,17 @@
 #ifndef REALLIVEVIDEO_H
 #define REALLIVEVIDEO_H
 
+#include <memory>
+
 #include <QtCore/QFileInfo>
 #include <QtCore/QList>
 #include <QtCore/QMap>
 #include <QtCore/QPair>
-#include <QtCore/QSharedPointer>
 #include <QtCore/QString>
 
 #include <QtPositioning/QGeoRectangle>
 
+#include "distanceentrycollection.h"
 #include "geoposition.h"
 #include "profile.h"
 
@@ -44,6 +46,7 @@ enum class RealLifeVideoFileType {
 const QString &realLifeVideoFileTypeName(RealLifeVideoFileType type);
 
 /* forward declarations */
+class DistanceLookupTable;
 class DistanceMappingEntry;
 class VideoInformation;
 
@@ -108,6 +111,8 @@ public:
     RealLifeVideo(const RealLifeVideo& other);
     explicit RealLifeVideo();
 
+    RealLifeVideo &operator=(const RealLifeVideo& other);
+
     bool isValid() const;
     RealLifeVideoFileType fileType() const;
     ProfileType type() const;
@@ -119,12 +124,14 @@ public:
     const std::vector<DistanceMappingEntry> &distanceMappings() const;
     const std::vector<InformationBox> &informationBoxes() const;
     const std::vector<GeoPosition> &positions() const;
+    /** the positions, indexed by distance. Copies share the positions. */
+    const DistanceEntryCollection<GeoPosition> &positionCollection() const;
 
     const QGeoRectangle geoRectangle() const;
 
-    /** Add a new custom start point */
+    /** Add a new custom start point. Only this copy of the video gets the new course. */
     void addStartPoint(float distance, const QString& name);
-    /** Add a new custom course */
+    /** Add a new custom course. Only this copy of the video gets the new course. */
     void addCustomCourse(float startDistance, float endDistance, const QString& name);
 
     /** Get the number or frames per meter for a certain distance */
@@ -142,18 +149,36 @@ public:
     const InformationBox informationBoxForDistance(const float distance) const;
     /** Total distance */
     float totalDistance() const;
-    /** Set duration of video, in number of frames */
+    /** number of bytes used by the route data of this video */
+    std::size_t memoryUsage() const;
+    /** Set duration of video, in number of frames. */
     void setNumberOfFrames(quint64 numberOfFrames);
+    /**
+     * Let frame, slope and altitude queries use a dense lookup table, which is built on the first query. Building
+     * the table takes time and memory, so only enable it for the copy that is used to play the video, not for
+     * copies that are only used for a few queries.
+     */
+    void enableLookupTable();
 
     bool operator==(const RealLifeVideo& other) const;
     static bool compareByName(const RealLifeVideo& rlv1, const RealLifeVideo& rlv2);
 private:
     void calculateVideoCorrectionFactor(quint64 totalNrOfFrames);
+    float exactFrameForDistance(const float distance) const;
+    std::shared_ptr<const DistanceLookupTable> lookupTable() const;
 
     const DistanceMappingEntry &findDistanceMappingEntryFor(const float distance) const;
     const InformationBox informationBoxForDistanceTacx(const float distance) const;
 
-    QSharedPointer<RealLifeVideoData> _d;
+    /** route data, shared by all copies */
+    std::shared_ptr<const RealLifeVideoData> _d;
+
+    // the parts that can be changed, which are different for every copy.
+    std::shared_ptr<const std::vector<Course>> _courses;
+    float _videoCorrectionFactor;
+    /** the lookup table is only built for copies that enabled it. */
+    bool _lookupTableEnabled;
+    mutable std::shared_ptr<const DistanceLookupTable> _lookupTable;
 };
 typedef QList<RealLifeVideo> RealLifeVideoList;
 
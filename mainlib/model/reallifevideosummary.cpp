@@ -0,0 +1,112 @@
+/*
+ * Copyright (c) 2015 Ilja Booij (ibooij@gmail.com)
+ *
+ * This file is part of Big Ring Indoor Video Cycling
+ *
+ * Big Ring Indoor Video Cycling is free software: you can redistribute
+ * it and/or modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation, either version 3 of the
+ * License, or (at your option) any later version.
+ *
+ * Big Ring Indoor Video Cycling  is distributed in the hope that it will
+ * be useful, but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+
+ * You should have received a copy of the GNU General Public License
+ * along with Big Ring Indoor Video Cycling.  If not, see
+ * <http://www.gnu.org/licenses/>.
+ */
+
+#include "reallifevideosummary.h"
+
+#include <algorithm>
+
+namespace
+{
+/** number of points in the mini profile, enough for the profiles in the video list. */
+const int MINI_PROFILE_POINTS = 256;
+}
+
+RealLifeVideoSummary::RealLifeVideoSummary():
+    _fileType(RealLifeVideoFileType::TACX), _type(ProfileType::SLOPE), _totalDistance(0), _minimumAltitude(0),
+    _maximumAltitude(0)
+{
+    // empty
+}
+
+RealLifeVideoSummary::RealLifeVideoSummary(const RealLifeVideo &rlv, const QString &filePath):
+    _name(rlv.name()), _fileType(rlv.fileType()), _type(rlv.type()), _totalDistance(rlv.totalDistance()),
+    _filePath(filePath), _minimumAltitude(0), _maximumAltitude(0)
+{
+    if (!rlv.isValid()) {
+        _name.clear();
+        return;
+    }
+    const Profile &profile = rlv.profile();
+    _miniProfileAltitudes.reserve(MINI_PROFILE_POINTS);
+    _miniProfileSlopes.reserve(MINI_PROFILE_POINTS);
+    for (int i = 0; i < MINI_PROFILE_POINTS; ++i) {
+        const float distance = _totalDistance * i / (MINI_PROFILE_POINTS - 1);
+        _miniProfileAltitudes.push_back(profile.altitudeForDistance(distance));
+        _miniProfileSlopes.push_back(profile.slopeForDistance(distance));
+    }
+    const auto minMax = std::minmax_element(_miniProfileAltitudes.begin(), _miniProfileAltitudes.end());
+    _minimumAltitude = *minMax.first;
+    _maximumAltitude = *minMax.second;
+}
+
+bool RealLifeVideoSummary::isValid() const
+{
+    return !_name.isEmpty();
+}
+
+const QString &RealLifeVideoSummary::name() const
+{
+    return _name;
+}
+
+RealLifeVideoFileType RealLifeVideoSummary::fileType() const
+{
+    return _fileType;
+}
+
+ProfileType RealLifeVideoSummary::type() const
+{
+    return _type;
+}
+
+float RealLifeVideoSummary::totalDistance() const
+{
+    return _totalDistance;
+}
+
+const QString &RealLifeVideoSummary::filePath() const
+{
+    return _filePath;
+}
+
+const std::vector<float> &RealLifeVideoSummary::miniProfileAltitudes() const
+{
+    return _miniProfileAltitudes;
+}
+
+const std::vector<float> &RealLifeVideoSummary::miniProfileSlopes() const
+{
+    return _miniProfileSlopes;
+}
+
+float RealLifeVideoSummary::minimumAltitude() const
+{
+    return _minimumAltitude;
+}
+
+float RealLifeVideoSummary::maximumAltitude() const
+{
+    return _maximumAltitude;
+}
+
+bool RealLifeVideoSummary::compareByName(const RealLifeVideoSummary &summary1, const RealLifeVideoSummary &summary2)
+{
+    return summary1.name().toLower() < summary2.name().toLower();
+}
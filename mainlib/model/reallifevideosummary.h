@@ -0,0 +1,73 @@
+/*
+ * Copyright (c) 2015 Ilja Booij (ibooij@gmail.com)
+ *
+ * This file is part of Big Ring Indoor Video Cycling
+ *
+ * Big Ring Indoor Video Cycling is free software: you can redistribute
+ * it and/or modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation, either version 3 of the
+ * License, or (at your option) any later version.
+ *
+ * Big Ring Indoor Video Cycling  is distributed in the hope that it will
+ * be useful, but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+
+ * You should have received a copy of the GNU General Public License
+ * along with Big Ring Indoor Video Cycling.  If not, see
+ * <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef REALLIFEVIDEOSUMMARY_H
+#define REALLIFEVIDEOSUMMARY_H
+
+#include <vector>
+
+#include <QtCore/QMetaType>
+#include <QtCore/QString>
+
+#include "reallifevideo.h"
+
+/**
+ * The few properties of a RealLifeVideo that are needed to show it in a list of videos, and a small profile of the
+ * route. A summary uses a few kilobytes, where a complete RealLifeVideo can use many megabytes.
+ */
+class RealLifeVideoSummary
+{
+public:
+    /** Construct an invalid summary */
+    explicit RealLifeVideoSummary();
+    /** Summarize rlv, which was imported from the file at filePath */
+    explicit RealLifeVideoSummary(const RealLifeVideo& rlv, const QString& filePath);
+
+    bool isValid() const;
+    const QString& name() const;
+    RealLifeVideoFileType fileType() const;
+    ProfileType type() const;
+    /** Total distance, in meters */
+    float totalDistance() const;
+    /** The file the video was imported from */
+    const QString& filePath() const;
+
+    /** Altitudes at evenly spaced distances along the route, from start to end */
+    const std::vector<float>& miniProfileAltitudes() const;
+    /** Slopes at the same distances as the altitudes */
+    const std::vector<float>& miniProfileSlopes() const;
+    float minimumAltitude() const;
+    float maximumAltitude() const;
+
+    static bool compareByName(const RealLifeVideoSummary& summary1, const RealLifeVideoSummary& summary2);
+private:
+    QString _name;
+    RealLifeVideoFileType _fileType;
+    ProfileType _type;
+    float _totalDistance;
+    QString _filePath;
+    std::vector<float> _miniProfileAltitudes;
+    std::vector<float> _miniProfileSlopes;
+    float _minimumAltitude;
+    float _maximumAltitude;
+};
+
+Q_DECLARE_METATYPE(RealLifeVideoSummary)
+#endif // REALLIFEVIDEOSUMMARY_H
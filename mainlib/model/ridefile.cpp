@@ -16,7 +16,13 @@ RideFile::RideFile():
 
 
 RideFile::RideFile(const QString &rlvName, const QString &courseName):
-    _startTime(QDateTime::currentDateTimeUtc()), _rlvName(rlvName), _courseName(courseName)
+    RideFile(rlvName, courseName, QDateTime::currentDateTimeUtc())
+{
+    // empty
+}
+
+RideFile::RideFile(const QString &rlvName, const QString &courseName, const QDateTime &startTime):
+    _startTime(startTime), _rlvName(rlvName), _courseName(courseName), _maximumSpeedInMps(0), _maximumHeartRate(0)
 {
     // empty
 }
@@ -54,20 +60,12 @@ float RideFile::totalDistance() const
 
 float RideFile::maximumSpeedInMps() const
 {
-    float max = 0;
-    for (const Sample &sample: _samples) {
-        max = std::max(max, sample.speed);
-    }
-    return max;
+    return _maximumSpeedInMps;
 }
 
 int RideFile::maximumHeartRate() const
 {
-    int max = 0;
-    for (const Sample &sample: _samples) {
-        max = std::max(max, sample.heartRate);
-    }
-    return max;
+    return _maximumHeartRate;
 }
 
 const std::vector<RideFile::Sample> &RideFile::samples() const
@@ -78,4 +76,6 @@ const std::vector<RideFile::Sample> &RideFile::samples() const
 void RideFile::addSample(const RideFile::Sample &sample)
 {
     _samples.push_back(sample);
+    _maximumSpeedInMps = std::max(_maximumSpeedInMps, sample.speed);
+    _maximumHeartRate = std::max(_maximumHeartRate, sample.heartRate);
 }
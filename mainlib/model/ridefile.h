@@ -29,6 +29,8 @@ public:
 
     explicit RideFile();
     explicit RideFile(const QString &rlvName, const QString &courseName);
+    /** construct a RideFile for a ride that started at startTime, like a ride that is recovered from a journal. */
+    explicit RideFile(const QString &rlvName, const QString &courseName, const QDateTime &startTime);
 
     /**
      * Start time of the ride. Timezone of the start time is UTC!
@@ -40,7 +42,9 @@ public:
 
     int durationInMilliSeconds() const;
     float totalDistance() const;
+    /** maximum speed of all samples, kept up to date when samples are added. */
     float maximumSpeedInMps() const;
+    /** maximum heart rate of all samples, kept up to date when samples are added. */
     int maximumHeartRate() const;
 
     void addSample(const Sample &sample);
@@ -50,6 +54,8 @@ private:
     const QString _rlvName;
     const QString _courseName;
     std::vector<Sample> _samples;
+    float _maximumSpeedInMps;
+    int _maximumHeartRate;
 };
 
 #endif // RIDEFILE_H
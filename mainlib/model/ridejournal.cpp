@@ -0,0 +1,344 @@
+/*
+ * Copyright (c) 2015 Ilja Booij (ibooij@gmail.com)
+ *
+ * This file is part of Big Ring Indoor Video Cycling
+ *
+ * Big Ring Indoor Video Cycling is free software: you can redistribute
+ * it and/or modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation, either version 3 of the
+ * License, or (at your option) any later version.
+ *
+ * Big Ring Indoor Video Cycling  is distributed in the hope that it will
+ * be useful, but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+
+ * You should have received a copy of the GNU General Public License
+ * along with Big Ring Indoor Video Cycling.  If not, see
+ * <http://www.gnu.org/licenses/>.
+ */
+
+#include "ridejournal.h"
+
+#include <cstring>
+
+#include <QtCore/QDataStream>
+#include <QtCore/QDir>
+#include <QtCore/QFileInfo>
+#include <QtCore/QStandardPaths>
+#include <QtCore/QtDebug>
+#include <QtCore/QtEndian>
+
+#ifdef Q_OS_WIN
+#include <io.h>
+#else
+#include <unistd.h>
+#endif
+
+namespace
+{
+const quint32 JOURNAL_MAGIC = 0x42524a31; // "BRJ1"
+const quint16 JOURNAL_VERSION = 1;
+const QString JOURNAL_SUFFIX = "journal";
+/** the file is synced to disk at least this often, so at most this much of a ride is lost on a power failure. */
+const int SYNC_INTERVAL_MS = 5000;
+
+/**
+ * Layout of a record, all values little endian:
+ *  0 quint32 time (ms)
+ *  4 float altitude (m)
+ *  8 float distance (m)
+ * 12 float speed (m/s)
+ * 16 qint16 cadence (rpm)
+ * 18 qint16 heart rate (bpm)
+ * 20 qint16 power (W)
+ * 22 quint16 checksum of the record, calculated with the checksum set to 0.
+ * 24 double latitude (degrees)
+ * 32 double longitude (degrees)
+ * 40 double altitude of the position (m)
+ * 48 double distance of the position (m)
+ */
+const int RECORD_BYTES = 56;
+const int CHECKSUM_OFFSET = 22;
+
+quint32 floatBits(float value)
+{
+    quint32 bits;
+    std::memcpy(&bits, &value, sizeof(bits));
+    return bits;
+}
+
+float floatFromBits(quint32 bits)
+{
+    float value;
+    std::memcpy(&value, &bits, sizeof(value));
+    return value;
+}
+
+quint64 doubleBits(double value)
+{
+    quint64 bits;
+    std::memcpy(&bits, &value, sizeof(bits));
+    return bits;
+}
+
+double doubleFromBits(quint64 bits)
+{
+    double value;
+    std::memcpy(&value, &bits, sizeof(value));
+    return value;
+}
+
+qint16 boundedShort(int value)
+{
+    return static_cast<qint16>(qBound(0, value, 0x7fff));
+}
+
+quint16 recordChecksum(const QByteArray &record)
+{
+    QByteArray copy(record);
+    copy[CHECKSUM_OFFSET] = 0;
+    copy[CHECKSUM_OFFSET + 1] = 0;
+    return qChecksum(copy.constData(), static_cast<uint>(copy.size()));
+}
+
+QByteArray encodeRecord(const RideFile::Sample &sample)
+{
+    QByteArray record(RECORD_BYTES, '\0');
+    uchar* data = reinterpret_cast<uchar*>(record.data());
+    qToLittleEndian<quint32>(static_cast<quint32>(sample.time.msecsSinceStartOfDay()), data);
+    qToLittleEndian<quint32>(floatBits(sample.altitude), data + 4);
+    qToLittleEndian<quint32>(floatBits(sample.distance), data + 8);
+    qToLittleEndian<quint32>(floatBits(sample.speed), data + 12);
+    qToLittleEndian<qint16>(boundedShort(sample.cadence), data + 16);
+    qToLittleEndian<qint16>(boundedShort(sample.heartRate), data + 18);
+    qToLittleEndian<qint16>(boundedShort(sample.power), data + 20);
+    qToLittleEndian<quint64>(doubleBits(sample.position.latitude()), data + 24);
+    qToLittleEndian<quint64>(doubleBits(sample.position.longitude()), data + 32);
+    qToLittleEndian<quint64>(doubleBits(sample.position.altitude()), data + 40);
+    qToLittleEndian<quint64>(doubleBits(sample.position.distance()), data + 48);
+    qToLittleEndian<quint16>(recordChecksum(record), data + CHECKSUM_OFFSET);
+    return record;
+}
+
+bool decodeRecord(const QByteArray &record, RideFile::Sample &sample)
+{
+    const uchar* data = reinterpret_cast<const uchar*>(record.constData());
+    if (qFromLittleEndian<quint16>(data + CHECKSUM_OFFSET) != recordChecksum(record)) {
+        return false;
+    }
+    const QGeoCoordinate coordinate(doubleFromBits(qFromLittleEndian<quint64>(data + 24)),
+                                    doubleFromBits(qFromLittleEndian<quint64>(data + 32)),
+                                    doubleFromBits(qFromLittleEndian<quint64>(data + 40)));
+    sample = { QTime::fromMSecsSinceStartOfDay(static_cast<int>(qFromLittleEndian<quint32>(data))),
+               floatFromBits(qFromLittleEndian<quint32>(data + 4)),
+               qFromLittleEndian<qint16>(data + 16),
+               floatFromBits(qFromLittleEndian<quint32>(data + 8)),
+               qFromLittleEndian<qint16>(data + 18),
+               qFromLittleEndian<qint16>(data + 20),
+               floatFromBits(qFromLittleEndian<quint32>(data + 12)),
+               GeoPosition(doubleFromBits(qFromLittleEndian<quint64>(data + 48)), coordinate) };
+    return true;
+}
+
+/** write the buffers of the file to disk, without waiting for a metadata update where the platform allows it. */
+bool syncToDisk(QFile &file)
+{
+    if (!file.flush()) {
+        return false;
+    }
+#if defined(Q_OS_WIN)
+    return _commit(file.handle()) == 0;
+#elif defined(Q_OS_MAC)
+    return fsync(file.handle()) == 0;
+#else
+    return fdatasync(file.handle()) == 0;
+#endif
+}
+}
+
+RideJournal::RideJournal(const QString &filePath, QObject *parent):
+    QThread(parent), _filePath(filePath), _file(filePath), _stopping(false), _syncsRequested(0), _syncsCompleted(0)
+{
+    // empty
+}
+
+RideJournal::~RideJournal()
+{
+    stop();
+}
+
+bool RideJournal::open(const QDateTime &startTime, const QString &rlvName, const QString &courseName)
+{
+    QDir journalDir(QFileInfo(_filePath).absolutePath());
+    if (!journalDir.exists() && !journalDir.mkpath(".")) {
+        qWarning("Unable to create directory %s", qPrintable(journalDir.absolutePath()));
+        return false;
+    }
+    if (!_file.open(QIODevice::WriteOnly | QIODevice::Truncate)) {
+        qWarning("Unable to open %s: %s", qPrintable(_filePath), qPrintable(_file.errorString()));
+        return false;
+    }
+    QDataStream stream(&_file);
+    stream.setByteOrder(QDataStream::LittleEndian);
+    stream << JOURNAL_MAGIC << JOURNAL_VERSION << static_cast<quint16>(RECORD_BYTES)
+           << startTime.toMSecsSinceEpoch() << rlvName << courseName;
+    if (stream.status() != QDataStream::Ok || !syncToDisk(_file)) {
+        qWarning("Unable to write header of %s", qPrintable(_filePath));
+        _file.close();
+        return false;
+    }
+    _syncTimer.start();
+    start();
+    return true;
+}
+
+const QString &RideJournal::filePath() const
+{
+    return _filePath;
+}
+
+void RideJournal::append(const RideFile::Sample &sample)
+{
+    const QByteArray record = encodeRecord(sample);
+    QMutexLocker locker(&_mutex);
+    _pendingRecords.append(record);
+    _recordsAppended.wakeAll();
+}
+
+void RideJournal::flush()
+{
+    QMutexLocker locker(&_mutex);
+    if (!isRunning()) {
+        return;
+    }
+    const quint64 request = ++_syncsRequested;
+    _recordsAppended.wakeAll();
+    while (_syncsCompleted < request && isRunning()) {
+        _recordsSynced.wait(&_mutex);
+    }
+}
+
+void RideJournal::close()
+{
+    stop();
+    _file.close();
+}
+
+void RideJournal::remove()
+{
+    close();
+    if (!QFile::remove(_filePath)) {
+        qWarning("Unable to remove %s", qPrintable(_filePath));
+    }
+}
+
+QString RideJournal::journalDirectory()
+{
+    return QString("%1/journal").arg(QStandardPaths::writableLocation(QStandardPaths::DataLocation));
+}
+
+QString RideJournal::journalFilePath(const QDateTime &startTime)
+{
+    return QDir(journalDirectory()).filePath(QString("%1.%2").arg(startTime.toString("yyyy_MM_dd_HH_mm_ss"))
+                                             .arg(JOURNAL_SUFFIX));
+}
+
+QStringList RideJournal::interruptedJournals()
+{
+    const QDir journalDir(journalDirectory());
+    QStringList filePaths;
+    for (const QString &fileName: journalDir.entryList({ QString("*.%1").arg(JOURNAL_SUFFIX) }, QDir::Files,
+                                                       QDir::Name)) {
+        filePaths.append(journalDir.filePath(fileName));
+    }
+    return filePaths;
+}
+
+std::unique_ptr<RideFile> RideJournal::readRideFile(const QString &filePath)
+{
+    QFile file(filePath);
+    if (!file.open(QIODevice::ReadOnly)) {
+        qWarning("Unable to open %s: %s", qPrintable(filePath), qPrintable(file.errorString()));
+        return std::unique_ptr<RideFile>();
+    }
+    QDataStream stream(&file);
+    stream.setByteOrder(QDataStream::LittleEndian);
+    quint32 magic;
+    quint16 version;
+    quint16 recordBytes;
+    qint64 startTimeMsecs;
+    QString rlvName;
+    QString courseName;
+    stream >> magic >> version >> recordBytes >> startTimeMsecs >> rlvName >> courseName;
+    if (stream.status() != QDataStream::Ok || magic != JOURNAL_MAGIC || version != JOURNAL_VERSION
+            || recordBytes != RECORD_BYTES) {
+        qWarning("%s is not a ride journal", qPrintable(filePath));
+        return std::unique_ptr<RideFile>();
+    }
+
+    std::unique_ptr<RideFile> rideFile(
+                new RideFile(rlvName, courseName, QDateTime::fromMSecsSinceEpoch(startTimeMsecs, Qt::UTC)));
+    RideFile::Sample sample;
+    while (true) {
+        const QByteArray record = file.read(RECORD_BYTES);
+        // a record that is too short, or has a wrong checksum, was being written when the ride was interrupted.
+        if (record.size() != RECORD_BYTES || !decodeRecord(record, sample)) {
+            break;
+        }
+        rideFile->addSample(sample);
+    }
+    return rideFile;
+}
+
+/**
+ * The writer thread. Records are written without holding the mutex, so append() never waits for the disk.
+ */
+void RideJournal::run()
+{
+    bool unsyncedRecords = false;
+    QMutexLocker locker(&_mutex);
+    while (true) {
+        if (_pendingRecords.isEmpty() && _syncsCompleted == _syncsRequested && !_stopping) {
+            _recordsAppended.wait(&_mutex, SYNC_INTERVAL_MS);
+        }
+        QByteArray records;
+        records.swap(_pendingRecords);
+        const quint64 syncsRequested = _syncsRequested;
+        const bool stopping = _stopping;
+        locker.unlock();
+
+        if (!records.isEmpty()) {
+            if (_file.write(records) != records.size()) {
+                qWarning("Unable to write to %s: %s", qPrintable(_filePath), qPrintable(_file.errorString()));
+            }
+            unsyncedRecords = true;
+        }
+        const bool syncNeeded = stopping || syncsRequested > _syncsCompleted
+                || _syncTimer.elapsed() >= SYNC_INTERVAL_MS;
+        if (unsyncedRecords && syncNeeded) {
+            if (!syncToDisk(_file)) {
+                qWarning("Unable to sync %s", qPrintable(_filePath));
+            }
+            unsyncedRecords = false;
+            _syncTimer.restart();
+        }
+
+        locker.relock();
+        _syncsCompleted = syncsRequested;
+        _recordsSynced.wakeAll();
+        if (stopping) {
+            break;
+        }
+    }
+}
+
+void RideJournal::stop()
+{
+    {
+        QMutexLocker locker(&_mutex);
+        _stopping = true;
+        _recordsAppended.wakeAll();
+    }
+    wait();
+}
@@ -0,0 +1,99 @@
+/*
+ * Copyright (c) 2015 Ilja Booij (ibooij@gmail.com)
+ *
+ * This file is part of Big Ring Indoor Video Cycling
+ *
+ * Big Ring Indoor Video Cycling is free software: you can redistribute
+ * it and/or modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation, either version 3 of the
+ * License, or (at your option) any later version.
+ *
+ * Big Ring Indoor Video Cycling  is distributed in the hope that it will
+ * be useful, but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+
+ * You should have received a copy of the GNU General Public License
+ * along with Big Ring Indoor Video Cycling.  If not, see
+ * <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef RIDEJOURNAL_H
+#define RIDEJOURNAL_H
+
+#include <memory>
+
+#include <QtCore/QByteArray>
+#include <QtCore/QDateTime>
+#include <QtCore/QElapsedTimer>
+#include <QtCore/QFile>
+#include <QtCore/QMutex>
+#include <QtCore/QStringList>
+#include <QtCore/QThread>
+#include <QtCore/QWaitCondition>
+
+#include "ridefile.h"
+
+/**
+ * An append-only file with the samples of a ride, so a ride is not lost when the application crashes or the
+ * computer loses power.
+ *
+ * The journal starts with a header, with the start time, video and course of the ride, followed by a record of fixed
+ * size for every sample. Records are written to disk by a separate thread, which syncs the file every few seconds, so
+ * append() never blocks the GUI thread on disk access. A record that was only partly written when the ride was
+ * interrupted is detected by its checksum and ignored.
+ *
+ * The journal is removed when the ride is saved or discarded. A journal that still exists when the application starts
+ * belongs to an interrupted ride, which can be recovered with readRideFile().
+ */
+class RideJournal : public QThread
+{
+    Q_OBJECT
+public:
+    explicit RideJournal(const QString &filePath, QObject *parent = 0);
+    /** writes all samples that were appended and syncs the file. */
+    virtual ~RideJournal();
+
+    /** create the journal and start the writer thread. */
+    bool open(const QDateTime &startTime, const QString &rlvName, const QString &courseName);
+    const QString &filePath() const;
+
+    /** add a sample to the journal. The sample is written to disk by the writer thread. */
+    void append(const RideFile::Sample &sample);
+    /** blocks until all samples that were appended are written and synced to disk. */
+    void flush();
+    /** stop the writer thread and close the journal file. */
+    void close();
+    /** stop the writer thread and remove the journal file. */
+    void remove();
+
+    /** the directory that holds the journals. */
+    static QString journalDirectory();
+    /** the path for the journal of a ride that started at startTime. */
+    static QString journalFilePath(const QDateTime &startTime);
+    /** the journals that are left behind by rides that were interrupted. */
+    static QStringList interruptedJournals();
+    /**
+     * Read a journal into a RideFile.
+     * @return the RideFile, or nullptr if the journal could not be read.
+     */
+    static std::unique_ptr<RideFile> readRideFile(const QString &filePath);
+protected:
+    void run() override;
+private:
+    void stop();
+
+    const QString _filePath;
+    QFile _file;
+
+    QMutex _mutex;
+    QWaitCondition _recordsAppended;
+    QWaitCondition _recordsSynced;
+    bool _stopping;
+    quint64 _syncsRequested;
+    quint64 _syncsCompleted;
+    QByteArray _pendingRecords;
+    QElapsedTimer _syncTimer;
+};
+
+#endif // RIDEJOURNAL_H
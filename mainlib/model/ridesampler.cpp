@@ -27,45 +27,141 @@
 #include <QtCore/QDir>
 #include <QtCore/QStandardPaths>
 
+#include <limits>
 
 namespace {
-// We sample every second.
-const int SAMPLE_INTERVAL_MS = 1000;
+const int MSECS_PER_SECOND = 1000;
+// power, cadence and heart rate
+const int NUMBER_OF_CHANNELS = 3;
+
+int channelCapacity(const qint64 bufferBytes)
+{
+    return static_cast<int>(qBound<qint64>(1, bufferBytes / (NUMBER_OF_CHANNELS * SensorChannel::memoryUsage(1)),
+                                           std::numeric_limits<int>::max()));
+}
 }
 
-RideSampler::RideSampler(const QString &rlvName, const QString &courseName, const Simulation &simulation, QObject *parent):
-    QObject(parent), _simulation(simulation), _rideFile(rlvName, courseName)
+RideSampler::RideSampler(const QString &rlvName, const QString &courseName, const Simulation &simulation,
+                         int recordingRateHz, qint64 bufferBytes, const TrainingMetrics &trainingMetrics,
+                         QObject *parent):
+    QObject(parent), _simulation(simulation), _sampleEveryPowerMeasurement(recordingRateHz <= 0),
+    _lastSampleMs(0), _running(false), _power(channelCapacity(bufferBytes)), _cadence(channelCapacity(bufferBytes)),
+    _heartRate(channelCapacity(bufferBytes)), _rideFile(rlvName, courseName),
+    _journal(RideJournal::journalFilePath(_rideFile.startTime())), _journalOpen(false),
+    _trainingMetrics(trainingMetrics)
 {
-    _sampleTimer.setInterval(SAMPLE_INTERVAL_MS);
-    connect(&_sampleTimer, &QTimer::timeout, this, &RideSampler::takeSample);
+    if (!_sampleEveryPowerMeasurement) {
+        _sampleTimer.setTimerType(Qt::PreciseTimer);
+        _sampleTimer.setInterval(MSECS_PER_SECOND / recordingRateHz);
+        connect(&_sampleTimer, &QTimer::timeout, this, &RideSampler::takeSample);
+    }
+    _clock.start();
+    _journalOpen = _journal.open(_rideFile.startTime(), rlvName, courseName);
+    if (!_journalOpen) {
+        qWarning("Unable to create ride journal, the ride is only kept in memory");
+    }
 }
 
-const RideFile &RideSampler::rideFile() const
+RideFile RideSampler::rideFile()
 {
+    if (_journalOpen) {
+        _journal.flush();
+        const std::unique_ptr<RideFile> rideFile = RideJournal::readRideFile(_journal.filePath());
+        if (rideFile) {
+            return *rideFile;
+        }
+    }
     return _rideFile;
 }
 
+void RideSampler::removeJournal()
+{
+    if (_journalOpen) {
+        _journal.remove();
+        _journalOpen = false;
+    }
+}
+
+QString RideSampler::closeJournal()
+{
+    if (!_journalOpen) {
+        return QString();
+    }
+    _journal.close();
+    _journalOpen = false;
+    return _journal.filePath();
+}
+
+const TrainingMetrics &RideSampler::trainingMetrics() const
+{
+    return _trainingMetrics;
+}
+
 void RideSampler::start()
 {
-    _sampleTimer.start();
+    _lastSampleMs = _clock.elapsed();
+    _running = true;
+    if (!_sampleEveryPowerMeasurement) {
+        _sampleTimer.start();
+    }
 }
 
 void RideSampler::stop()
 {
+    _running = false;
     _sampleTimer.stop();
 }
 
+void RideSampler::addPower(int power)
+{
+    const qint64 nowMs = _clock.elapsed();
+    _power.add(nowMs, power);
+    if (_running && _sampleEveryPowerMeasurement) {
+        addSample(power,
+                  qRound(_cadence.decimate(_lastSampleMs, nowMs, Decimation::MEAN)),
+                  qRound(_heartRate.decimate(_lastSampleMs, nowMs, Decimation::MEAN)));
+        _lastSampleMs = nowMs;
+    }
+}
+
+void RideSampler::addCadence(float cadence)
+{
+    _cadence.add(_clock.elapsed(), cadence);
+}
+
+void RideSampler::addHeartRate(int heartRate)
+{
+    _heartRate.add(_clock.elapsed(), heartRate);
+}
+
 void RideSampler::takeSample()
 {
-    const Cyclist &cyclist = _simulation.cyclist();
-    RideFile::Sample sample = { _simulation.runTime(),
-                                cyclist.altitude(),
-                                cyclist.cadence(),
-                                cyclist.distanceTravelled(),
-                                cyclist.heartRate(),
-                                cyclist.power(),
-                                cyclist.speed(),
-                                cyclist.geoPosition()};
-    _rideFile.addSample(sample);
+    // use the real time since the last sample as window, so a late timer does not lose any measurements.
+    const qint64 nowMs = _clock.elapsed();
+    addSample(qRound(_power.decimate(_lastSampleMs, nowMs, Decimation::MEAN)),
+              qRound(_cadence.decimate(_lastSampleMs, nowMs, Decimation::MEAN)),
+              qRound(_heartRate.decimate(_lastSampleMs, nowMs, Decimation::MEAN)));
+    _lastSampleMs = nowMs;
+}
+
+void RideSampler::addSample(int power, int cadence, int heartRate)
+{
+    // take all other values from the same simulation state, so they belong together.
+    const std::shared_ptr<const SimulationState> state = _simulation.state();
+    RideFile::Sample sample = { state->runTime(),
+                                state->altitude,
+                                cadence,
+                                state->distanceTravelled,
+                                heartRate,
+                                power,
+                                state->speed,
+                                state->geoPosition};
+    if (_journalOpen) {
+        _journal.append(sample);
+    } else {
+        _rideFile.addSample(sample);
+    }
+    _trainingMetrics.addSample(sample);
+    emit trainingMetricsUpdated(_trainingMetrics);
 }
 
@@ -20,33 +20,87 @@
 #ifndef RIDESAMPLER_H
 #define RIDESAMPLER_H
 
+#include <QtCore/QElapsedTimer>
 #include <QtCore/QObject>
 #include <QtCore/QTimer>
 
 #include "ridefile.h"
+#include "ridejournal.h"
+#include "sensorchannel.h"
+#include "trainingmetrics.h"
 
 class Simulation;
 
 /**
  * Sample the simulation continously and keeps a record of all values (altitude, speed, power etc) in the ride.
+ *
+ * Power, cadence and heart rate measurements are recorded with their receive time in a SensorChannel as they arrive
+ * from the sensors. For every sample, the measurements since the previous sample are averaged, so short peaks, like
+ * the power of a sprint, are not lost when sampling at a lower rate than the sensors send their values. Speed,
+ * distance, altitude and position are taken from the simulation.
+ *
+ * The recording rate is in samples per second. With a recording rate of 0, a sample is taken for every power
+ * measurement.
+ *
+ * Every sample is also added to the TrainingMetrics of the ride, which are updated live.
+ *
+ * The samples are written to a RideJournal, instead of being kept in memory, so the ride can be recovered if the
+ * application is interrupted. Only if the journal can not be created, the samples are kept in memory.
  */
 class RideSampler : public QObject
 {
     Q_OBJECT
 public:
-    explicit RideSampler(const QString &rlvName, const QString &courseName, const Simulation &simulation, QObject *parent = 0);
+    /**
+     * Create a RideSampler.
+     * @param recordingRateHz number of samples per second, or 0 to take a sample for every power measurement.
+     * @param bufferBytes memory budget for the recorded sensor measurements.
+     * @param trainingMetrics metrics of the ride, without samples.
+     */
+    explicit RideSampler(const QString &rlvName, const QString &courseName, const Simulation &simulation,
+                         int recordingRateHz, qint64 bufferBytes, const TrainingMetrics &trainingMetrics,
+                         QObject *parent = 0);
 
     /** Get the ride file, with all values. This method can be called multiple times to get updates */
-    const RideFile &rideFile() const;
+    RideFile rideFile();
+    /** Remove the journal of the ride, when the ride is discarded. */
+    void removeJournal();
+    /**
+     * Stop writing the journal of the ride, when the ride is saved.
+     * @return the path of the journal, which should be removed when the ride is saved, or an empty string if there is
+     * no journal.
+     */
+    QString closeJournal();
+
+    const TrainingMetrics &trainingMetrics() const;
+signals:
+    /** emitted every time a sample is taken */
+    void trainingMetricsUpdated(const TrainingMetrics &trainingMetrics);
 public slots:
     void start();
     void stop();
+
+    void addPower(int power);
+    void addCadence(float cadence);
+    void addHeartRate(int heartRate);
 private slots:
     void takeSample();
 private:
+    void addSample(int power, int cadence, int heartRate);
+
     const Simulation &_simulation;
+    const bool _sampleEveryPowerMeasurement;
     QTimer _sampleTimer;
+    QElapsedTimer _clock;
+    qint64 _lastSampleMs;
+    bool _running;
+    SensorChannel _power;
+    SensorChannel _cadence;
+    SensorChannel _heartRate;
     RideFile _rideFile;
+    RideJournal _journal;
+    bool _journalOpen;
+    TrainingMetrics _trainingMetrics;
 };
 
 #endif // RIDESAMPLER_H
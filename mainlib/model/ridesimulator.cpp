@@ -0,0 +1,98 @@
+/*
+ * Copyright (c) 2015 Ilja Booij (ibooij@gmail.com)
+ *
+ * This file is part of Big Ring Indoor Video Cycling
+ *
+ * Big Ring Indoor Video Cycling is free software: you can redistribute
+ * it and/or modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation, either version 3 of the
+ * License, or (at your option) any later version.
+ *
+ * Big Ring Indoor Video Cycling  is distributed in the hope that it will
+ * be useful, but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+
+ * You should have received a copy of the GNU General Public License
+ * along with Big Ring Indoor Video Cycling.  If not, see
+ * <http://www.gnu.org/licenses/>.
+ */
+
+#include "ridesimulator.h"
+
+#include <functional>
+
+#include <QtConcurrent/QtConcurrentMap>
+
+namespace
+{
+const qint64 NS_PER_MS = 1000000;
+const qint64 NS_PER_S = 1000000000;
+}
+
+RideSimulator::RideSimulator(const PhysicsParameters &parameters, int stepsPerSecond):
+    _physics(parameters), _stepDurationNs(NS_PER_S / qMax(1, stepsPerSecond))
+{
+    // empty
+}
+
+std::vector<PowerSample> RideSimulator::powerTraceForRideFile(const RideFile &rideFile)
+{
+    std::vector<PowerSample> powerTrace;
+    powerTrace.reserve(rideFile.samples().size());
+    for (const RideFile::Sample &sample: rideFile.samples()) {
+        powerTrace.push_back({ sample.time.msecsSinceStartOfDay(), sample.power });
+    }
+    return powerTrace;
+}
+
+/**
+ * Integrate with the same fixed steps as the SimulationEngine uses, until the end of the route is reached or the
+ * cyclist has stopped after the end of the power trace. The finish time is interpolated within the last step.
+ */
+RideSimulationResult RideSimulator::simulate(const RideSimulationRoute &route,
+                                             const std::vector<PowerSample> &powerTrace) const
+{
+    const qint64 powerTraceEndNs = powerTrace.empty() ? 0 : powerTrace.back().timeMs * NS_PER_MS;
+
+    PhysicsState state;
+    state.distance = route.startDistance;
+    qint64 timeNs = 0;
+    std::size_t sampleIndex = 0;
+    while (state.distance < route.endDistance) {
+        while (sampleIndex + 1 < powerTrace.size() && powerTrace[sampleIndex + 1].timeMs * NS_PER_MS <= timeNs) {
+            ++sampleIndex;
+        }
+        const bool powerTraceEnded = powerTrace.empty() || timeNs > powerTraceEndNs;
+        const int power = powerTraceEnded ? 0 : powerTrace[sampleIndex].power;
+
+        state = _physics.step(state, route.profile, power, _stepDurationNs);
+        timeNs += _stepDurationNs;
+
+        if (powerTraceEnded && state.speed <= 0) {
+            RideSimulationResult result;
+            result.durationMs = timeNs / NS_PER_MS;
+            result.distanceTravelled = state.distanceTravelled;
+            return result;
+        }
+    }
+
+    const double overshoot = state.distance - route.endDistance;
+    const qint64 overshootNs = (state.speed > 0) ? static_cast<qint64>(overshoot / state.speed * NS_PER_S) : 0;
+
+    RideSimulationResult result;
+    result.finished = true;
+    result.durationMs = (timeNs - overshootNs) / NS_PER_MS;
+    result.distanceTravelled = state.distanceTravelled - overshoot;
+    return result;
+}
+
+QList<RideSimulationResult> RideSimulator::simulate(const QList<RideSimulationRoute> &routes,
+                                                    const std::vector<PowerSample> &powerTrace) const
+{
+    std::function<RideSimulationResult(const RideSimulationRoute&)> simulateFunction(
+                [this, &powerTrace](const RideSimulationRoute &route) -> RideSimulationResult {
+        return simulate(route, powerTrace);
+    });
+    return QtConcurrent::mapped(routes.begin(), routes.end(), simulateFunction).results();
+}
@@ -0,0 +1,87 @@
+/*
+ * Copyright (c) 2015 Ilja Booij (ibooij@gmail.com)
+ *
+ * This file is part of Big Ring Indoor Video Cycling
+ *
+ * Big Ring Indoor Video Cycling is free software: you can redistribute
+ * it and/or modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation, either version 3 of the
+ * License, or (at your option) any later version.
+ *
+ * Big Ring Indoor Video Cycling  is distributed in the hope that it will
+ * be useful, but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+
+ * You should have received a copy of the GNU General Public License
+ * along with Big Ring Indoor Video Cycling.  If not, see
+ * <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef RIDESIMULATOR_H
+#define RIDESIMULATOR_H
+
+#include <vector>
+
+#include <QtCore/QList>
+#include <QtCore/QtGlobal>
+
+#include "cyclingphysics.h"
+#include "profile.h"
+#include "ridefile.h"
+
+/** A power measurement in a recorded ride. */
+struct PowerSample
+{
+    qint64 timeMs;
+    int power; // W
+};
+
+/** A part of a profile to ride, from startDistance to endDistance. */
+struct RideSimulationRoute
+{
+    Profile profile;
+    float startDistance; // m
+    float endDistance; // m
+};
+
+/** Outcome of a simulated ride. */
+struct RideSimulationResult
+{
+    /** true if the end of the route was reached before the power trace ran out */
+    bool finished = false;
+    /** time to reach the end of the route, or time until the cyclist stopped when the ride was not finished */
+    qint64 durationMs = 0;
+    float distanceTravelled = 0; // m
+};
+
+/**
+ * Simulates complete rides by replaying a recorded power trace over a route, as fast as the CPU allows. Used to
+ * predict finish times and to see the effect of physics parameters, without a video or sensors.
+ *
+ * The power trace is a step function: every power sample holds until the next one. After the last sample, the
+ * cyclist stops pedalling.
+ */
+class RideSimulator
+{
+public:
+    explicit RideSimulator(const PhysicsParameters &parameters, int stepsPerSecond);
+
+    /** Power trace of a recorded ride, one power sample for every sample in the ride file. */
+    static std::vector<PowerSample> powerTraceForRideFile(const RideFile &rideFile);
+
+    /** Simulate riding route with powerTrace. */
+    RideSimulationResult simulate(const RideSimulationRoute &route, const std::vector<PowerSample> &powerTrace) const;
+
+    /**
+     * Simulate riding every route with the same powerTrace. Routes are simulated in parallel, on the global
+     * thread pool. Results are in the same order as the routes.
+     */
+    QList<RideSimulationResult> simulate(const QList<RideSimulationRoute> &routes,
+                                         const std::vector<PowerSample> &powerTrace) const;
+private:
+    const CyclingPhysics _physics;
+    const qint64 _stepDurationNs;
+};
+
+#endif // RIDESIMULATOR_H
@@ -0,0 +1,87 @@
+/*
+ * Copyright (c) 2015 Ilja Booij (ibooij@gmail.com)
+ *
+ * This file is part of Big Ring Indoor Video Cycling
+ *
+ * Big Ring Indoor Video Cycling is free software: you can redistribute
+ * it and/or modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation, either version 3 of the
+ * License, or (at your option) any later version.
+ *
+ * Big Ring Indoor Video Cycling  is distributed in the hope that it will
+ * be useful, but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+
+ * You should have received a copy of the GNU General Public License
+ * along with Big Ring Indoor Video Cycling.  If not, see
+ * <http://www.gnu.org/licenses/>.
+ */
+#include "sensorchannel.h"
+
+SensorChannel::SensorChannel(int capacity):
+    _measurements(static_cast<size_t>(qMax(1, capacity))), _first(0), _size(0)
+{
+    // empty
+}
+
+void SensorChannel::add(qint64 timestampMs, float value)
+{
+    const int capacity = static_cast<int>(_measurements.size());
+    if (_size < capacity) {
+        _measurements[static_cast<size_t>((_first + _size) % capacity)] = { timestampMs, value };
+        ++_size;
+    } else {
+        // overwrite the oldest measurement
+        _measurements[static_cast<size_t>(_first)] = { timestampMs, value };
+        _first = (_first + 1) % capacity;
+    }
+}
+
+float SensorChannel::decimate(qint64 fromMs, qint64 toMs, Decimation decimation) const
+{
+    // walk back from the newest measurement, as the window is almost always at the end of the buffer.
+    int index = _size - 1;
+    while (index >= 0 && measurement(index).timestampMs > toMs) {
+        --index;
+    }
+    if (index < 0) {
+        return 0;
+    }
+    const float lastBeforeWindowEnd = measurement(index).value;
+
+    int count = 0;
+    double total = 0;
+    for (; index >= 0 && measurement(index).timestampMs > fromMs; --index) {
+        total += measurement(index).value;
+        ++count;
+    }
+    if (count == 0) {
+        return lastBeforeWindowEnd;
+    }
+    switch (decimation) {
+    case Decimation::MEAN:
+        return static_cast<float>(total / count);
+    }
+    return lastBeforeWindowEnd;
+}
+
+int SensorChannel::size() const
+{
+    return _size;
+}
+
+int SensorChannel::capacity() const
+{
+    return static_cast<int>(_measurements.size());
+}
+
+qint64 SensorChannel::memoryUsage(int capacity)
+{
+    return static_cast<qint64>(sizeof(Measurement)) * capacity;
+}
+
+const SensorChannel::Measurement &SensorChannel::measurement(int index) const
+{
+    return _measurements[static_cast<size_t>((_first + index) % capacity())];
+}
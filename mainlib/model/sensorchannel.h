@@ -0,0 +1,74 @@
+/*
+ * Copyright (c) 2015 Ilja Booij (ibooij@gmail.com)
+ *
+ * This file is part of Big Ring Indoor Video Cycling
+ *
+ * Big Ring Indoor Video Cycling is free software: you can redistribute
+ * it and/or modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation, either version 3 of the
+ * License, or (at your option) any later version.
+ *
+ * Big Ring Indoor Video Cycling  is distributed in the hope that it will
+ * be useful, but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+
+ * You should have received a copy of the GNU General Public License
+ * along with Big Ring Indoor Video Cycling.  If not, see
+ * <http://www.gnu.org/licenses/>.
+ */
+#ifndef SENSORCHANNEL_H
+#define SENSORCHANNEL_H
+
+#include <QtCore/QtGlobal>
+
+#include <vector>
+
+/** How the measurements in a sample window are combined into a single value. */
+enum class Decimation {
+    MEAN
+};
+
+/**
+ * Fixed capacity ring buffer of timestamped measurements of a single sensor channel, like power or cadence.
+ *
+ * Measurements are added as they arrive from the sensor, and are combined into a single value for every sample
+ * window by decimate(). When the buffer is full, the oldest measurements are overwritten, so memory use is bounded,
+ * whatever the rate of the sensor.
+ */
+class SensorChannel
+{
+public:
+    struct Measurement {
+        qint64 timestampMs;
+        float value;
+    };
+
+    explicit SensorChannel(int capacity);
+
+    /** Add a measurement. Timestamps should not decrease. */
+    void add(qint64 timestampMs, float value);
+
+    /**
+     * Combine the measurements in the window (fromMs, toMs] into a single value. If there are no measurements in the
+     * window, the last measurement before the window is used, as sensors only send values when they change. If there
+     * are no measurements at all, 0 is returned.
+     */
+    float decimate(qint64 fromMs, qint64 toMs, Decimation decimation) const;
+
+    /** the number of measurements in the channel */
+    int size() const;
+    /** the maximum number of measurements in the channel */
+    int capacity() const;
+
+    /** the number of bytes used for a channel with the given capacity */
+    static qint64 memoryUsage(int capacity);
+private:
+    const Measurement &measurement(int index) const;
+
+    std::vector<Measurement> _measurements;
+    int _first;
+    int _size;
+};
+
+#endif // SENSORCHANNEL_H
@@ -18,56 +18,20 @@
  * <http://www.gnu.org/licenses/>.
  */
 
-#include <QtDebug>
 #include "simulation.h"
-#include <math.h>
-namespace {
 
-/** Frontal area of a cyclist is around .5 m*m */
-const float FRONTAL_AREA = 0.58f;
-const float DRAG_COEFFICIENT = 0.63f;
-const float AIR_DENSITY = 1.226f; // Sea level
-
-const float MINIMUM_SPEED = 0.5f; // m/s
-
-const QTime MAX_IDLE_TIME(0, 0, 5);
-
-
-/** Calculate drag from wind resistance */
-float calculateAeroDrag(const Cyclist& cyclist)
-{
-    return FRONTAL_AREA * DRAG_COEFFICIENT * AIR_DENSITY * cyclist.speed() * cyclist.speed() * .5;
-}
-
-const float GRAVITY_CONSTANT = 9.81f;
-const float ROLLING_RESISTANCE_COEFFICIENT = 0.004;
-
-float calculateGroundResistance(const Cyclist& cylist)
-{
-    return cylist.totalWeight() * GRAVITY_CONSTANT * ROLLING_RESISTANCE_COEFFICIENT;
-}
-
-
-float calculateGravityForce(const Cyclist& cyclist, float grade)
+Simulation::Simulation(SimulationSetting simulationSetting, Cyclist &cyclist, double powerForElevationCorrection,
+                       int stepsPerSecond, QObject *parent) :
+    QObject(parent), _runTime(0, 0, 0), _cyclist(cyclist),
+    _engine(simulationSetting, cyclist.totalWeight(), powerForElevationCorrection, stepsPerSecond)
 {
-    return GRAVITY_CONSTANT * grade * 0.01 * cyclist.totalWeight();
-}
-
-}
-
-
-
-Simulation::Simulation(SimulationSetting simulationSetting, Cyclist &cyclist, double powerForElevationCorrection, QObject *parent) :
-    QObject(parent), _simulationSetting(simulationSetting),
-    _lastElapsed(0), _simulationTime(0,0,0), _idleTime(),_cyclist(cyclist), _powerForElevationCorrection(powerForElevationCorrection)
-{
-    _simulationUpdateTimer.setInterval(1000 / 30);
-    connect(&_simulationUpdateTimer, SIGNAL(timeout()), SLOT(simulationStep()));
+    // the engine emits from its own thread, make sure the states are applied in ours.
+    connect(&_engine, &SimulationEngine::stateUpdated, this, &Simulation::applyState, Qt::QueuedConnection);
 }
 
 Simulation::~Simulation()
 {
-    _simulationUpdateTimer.stop();
+    // empty
 }
 
 Cyclist &Simulation::cyclist() const
@@ -77,7 +41,7 @@ Cyclist &Simulation::cyclist() const
 
 bool Simulation::isPlaying() const
 {
-    return _simulationUpdateTimer.isActive();
+    return _engine.isPlaying();
 }
 
 QTime Simulation::runTime() const
@@ -85,137 +49,95 @@ QTime Simulation::runTime() const
     return _runTime;
 }
 
-void Simulation::play(bool play)
+std::shared_ptr<const SimulationState> Simulation::state() const
 {
-    if (play) {
-        _simulationUpdateTimer.start();
-        _simulationTime.restart();
-        _lastElapsed = 0;
-    } else {
-        _simulationUpdateTimer.stop();
-    }
-    emit playing(play);
+    return _engine.state();
 }
 
-void Simulation::simulationStep()
+void Simulation::play(bool play)
 {
-    if (!_currentRlv.isValid())
-        return;
-
-    qint64 currentElapsed = _simulationTime.elapsed();
-    qint64 elapsed = currentElapsed - _lastElapsed;
-    _lastElapsed = currentElapsed;
-    if (_cyclist.speed() > 0) {
-        _runTime = _runTime.addMSecs(elapsed);
-        emit runTimeChanged(_runTime);
-    }
-
-    float speed = calculateSpeed(elapsed);
-    float distanceTravelled = (speed * elapsed) * 0.001;
-
-    _cyclist.setSpeed(speed);
-    _cyclist.setDistance(_cyclist.distance() + distanceTravelled);
-    _cyclist.setDistanceTravelled(_cyclist.distanceTravelled() + distanceTravelled);
-    _cyclist.setAltitude(_currentRlv.altitudeForDistance(_cyclist.distance()));
-    _cyclist.setGeoPosition(_currentRlv.positionForDistance(_cyclist.distance()));
-
-
-    emit slopeChanged(_currentRlv.slopeForDistance(_cyclist.distance()));
+    _engine.setPlaying(play);
+    emit playing(play);
 }
 
 void Simulation::rlvSelected(RealLifeVideo rlv)
 {
-    reset();
     _currentRlv = rlv;
+    _engine.setRoute(rlv);
+    reset();
 }
 
 void Simulation::courseSelected(int courseNr)
 {
-    reset();
-    if (courseNr == -1) {
+    if (courseNr == -1 || !_currentRlv.isValid()) {
+        reset();
         return;
     }
-    if (!_currentRlv.isValid())
-        return;
 
-    const Course& course = _currentRlv.courses()[courseNr];
-    courseSelected(course);
-    _cyclist.setDistance(course.start());
+    courseSelected(_currentRlv.courses()[courseNr]);
 }
 
 void Simulation::courseSelected(const Course &course)
 {
-    reset();
-    _cyclist.setDistance(course.start());
-    _cyclist.setAltitude(_currentRlv.altitudeForDistance(course.start()));
+    reset(course.start());
 }
 
 void Simulation::setPower(int power)
 {
+    _engine.setPower(power);
     _cyclist.setPower(power);
 }
 
 void Simulation::setCadence(float cadenceRpm)
 {
+    _engine.setCadence(cadenceRpm);
     _cyclist.setCadence(cadenceRpm);
 }
 
 void Simulation::setWheelSpeed(float wheelSpeedMetersPerSecond)
 {
-    _wheelSpeedMetersPerSecond = wheelSpeedMetersPerSecond;
+    _engine.setWheelSpeed(wheelSpeedMetersPerSecond);
 }
 
 void Simulation::setHeartRate(int heartRate)
 {
+    _engine.setHeartRate(heartRate);
     _cyclist.setHeartRate(heartRate);
 }
 
-float Simulation::calculateSpeed(quint64 timeDelta)
+/**
+ * Apply the latest state of the engine to the cyclist. When the GUI thread was busy, intermediate states are
+ * skipped, we'll always apply the latest one. Power, cadence and heart rate are set on the cyclist directly when
+ * they're measured, so we don't overwrite them with the (older) values of the state.
+ */
+void Simulation::applyState()
 {
-    if (_simulationSetting == SimulationSetting::DIRECT_SPEED) {
-        return _wheelSpeedMetersPerSecond;
-    }
-
-    double power = (1.0 + _powerForElevationCorrection) * _cyclist.power();
-
-    // Calculate speed from power.
-    if (power < 1.0f) {
-        // if there is no power input and current speed is zero, assume we have no input.
-        if (_cyclist.speed() < MINIMUM_SPEED)
-            return 0;
-
-        // let the cyclist slow down and stop running after MAX_IDLE_TIME.
-        _idleTime = _idleTime.addMSecs(timeDelta);
+    _engine.acknowledgeStateUpdate();
+    const std::shared_ptr<const SimulationState> state = _engine.state();
 
-        if (_idleTime > MAX_IDLE_TIME)
-            return 0;
-    } else {
-        _idleTime = QTime(0,0,0);
+    const QTime runTime = state->runTime();
+    if (runTime != _runTime) {
+        _runTime = runTime;
+        emit runTimeChanged(_runTime);
     }
 
-    // if speed is very low, use cyclist weight, otherwise force gets very high. Is there
-    // a better way to do this?
-    const float force = (_cyclist.speed() > (MINIMUM_SPEED - 0.1)) ? power / _cyclist.speed() : _cyclist.totalWeight();
-
-    const float resistantForce = calculateAeroDrag(_cyclist) +
-            calculateGravityForce(_cyclist, _currentRlv.slopeForDistance(_cyclist.distance())) +
-            calculateGroundResistance(_cyclist);
-    const float resultingForce = force - resistantForce;
-
-    const float accelaration = resultingForce / _cyclist.totalWeight();
-    const float speedChange = accelaration * timeDelta * 0.001;
-    const float speed = _cyclist.speed() + speedChange;
-
-    // If there's power applied, always return at least MINIMUM_SPEED.
-    return qMax(MINIMUM_SPEED, speed);
+    CyclistState cyclistState;
+    cyclistState.speed = state->speed;
+    cyclistState.distance = state->distance;
+    cyclistState.distanceTravelled = state->distanceTravelled;
+    cyclistState.altitude = state->altitude;
+    cyclistState.geoPosition = state->geoPosition;
+    _cyclist.setState(cyclistState);
+
+    // a state published just before we stopped playing might arrive later, don't let it change the slope anymore.
+    if (_engine.isPlaying()) {
+        emit slopeChanged(state->slope);
+    }
 }
 
-void Simulation::reset()
+void Simulation::reset(float distance)
 {
-    play(false);
-    _runTime = QTime(0, 0, 0);
-    emit runTimeChanged(_runTime);
-    _cyclist.setSpeed(0);
-    _cyclist.setDistance(0);
-    _cyclist.setDistanceTravelled(0);
+    _engine.reset(distance);
+    emit playing(false);
+    applyState();
 }
@@ -21,32 +21,35 @@
 #ifndef SIMULATION_H
 #define SIMULATION_H
 
+#include <memory>
+
 #include <QtCore/QObject>
 #include <QtCore/QTime>
-#include <QtCore/QTimer>
 
 #include "cyclist.h"
 #include "reallifevideo.h"
+#include "simulationengine.h"
+#include "simulationstate.h"
 
-enum class SimulationSetting {
-    FIXED_POWER,
-    DIRECT_POWER,
-    VIRTUAL_POWER,
-    DIRECT_SPEED
-};
-
+/**
+ * The simulation of a ride. The physics run in a SimulationEngine, in their own thread. The Simulation object lives
+ * in the GUI thread and applies the states published by the engine to the Cyclist, so the GUI can keep using the
+ * signals of Cyclist and Simulation.
+ */
 class Simulation : public QObject
 {
     Q_OBJECT
 public:
     explicit Simulation(SimulationSetting simulationSetting, Cyclist& cyclist,
-                        double powerForElevationCorrection,
+                        double powerForElevationCorrection, int stepsPerSecond,
                         QObject *parent = 0);
     virtual ~Simulation();
 
     Cyclist& cyclist() const;
     bool isPlaying() const;
     QTime runTime() const;
+    /** the latest state of the simulation. Can be called from any thread. */
+    std::shared_ptr<const SimulationState> state() const;
 signals:
     void slopeChanged(float slope);
     void runTimeChanged(QTime& runTime);
@@ -55,7 +58,6 @@ signals:
 
 public slots:
     void play(bool play);
-    void simulationStep();
     void rlvSelected(RealLifeVideo rlv);
     void courseSelected(int courseNr);
     void courseSelected(const Course& course);
@@ -65,22 +67,16 @@ public slots:
     void setWheelSpeed(float wheelSpeedMetersPerSecond);
     void setHeartRate(int heartRate);
 
+private slots:
+    void applyState();
+
 private:
-    float calculateSpeed(quint64 timeDelta);
-    void reset();
+    void reset(float distance = 0);
 
-    const SimulationSetting _simulationSetting;
-    /** in case of indoorcycling::SimulationSetting::DIRECT_SPEED, we store the
-     * wheel speed and use it directly, without calculating it from power */
-    float _wheelSpeedMetersPerSecond;
-    qint64 _lastElapsed;
     QTime _runTime;
-    QTime _simulationTime;
-    QTime _idleTime;
     Cyclist& _cyclist;
-    const double _powerForElevationCorrection;
     RealLifeVideo _currentRlv;
-    QTimer _simulationUpdateTimer;
+    SimulationEngine _engine;
 };
 
 #endif // SIMULATION_H
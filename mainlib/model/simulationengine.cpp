@@ -0,0 +1,237 @@
+/*
+ * Copyright (c) 2015 Ilja Booij (ibooij@gmail.com)
+ *
+ * This file is part of Big Ring Indoor Video Cycling
+ *
+ * Big Ring Indoor Video Cycling is free software: you can redistribute
+ * it and/or modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation, either version 3 of the
+ * License, or (at your option) any later version.
+ *
+ * Big Ring Indoor Video Cycling  is distributed in the hope that it will
+ * be useful, but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+
+ * You should have received a copy of the GNU General Public License
+ * along with Big Ring Indoor Video Cycling.  If not, see
+ * <http://www.gnu.org/licenses/>.
+ */
+
+#include "simulationengine.h"
+
+namespace
+{
+const qint64 NS_PER_MS = 1000000;
+const qint64 NS_PER_US = 1000;
+
+/** most time the engine will catch up on after it has been delayed, any time beyond this is dropped. */
+const std::chrono::seconds MAX_CATCH_UP_TIME(1);
+
+PhysicsParameters physicsParameters(qreal totalWeight, double powerForElevationCorrection)
+{
+    PhysicsParameters parameters;
+    parameters.totalWeight = totalWeight;
+    parameters.powerForElevationCorrection = powerForElevationCorrection;
+    return parameters;
+}
+}
+
+SimulationEngine::SimulationEngine(SimulationSetting simulationSetting, qreal totalWeight,
+                                   double powerForElevationCorrection, int stepsPerSecond, QObject *parent):
+    QThread(parent), _simulationSetting(simulationSetting),
+    _physics(physicsParameters(totalWeight, powerForElevationCorrection)),
+    _stepDuration(std::chrono::nanoseconds(std::chrono::seconds(1)) / qMax(1, stepsPerSecond)),
+    _stopping(false), _playing(false), _routeValid(false), _geoPositionHint(0), _accumulatedTime(0), _power(0),
+    _cadence(0), _heartRate(0), _wheelSpeedMetersPerSecond(0),
+    _state(std::make_shared<const SimulationState>()), _stateUpdatePending(false)
+{
+    start(QThread::HighPriority);
+}
+
+SimulationEngine::~SimulationEngine()
+{
+    {
+        QMutexLocker locker(&_mutex);
+        _stopping = true;
+        _playingChanged.wakeAll();
+    }
+    wait();
+}
+
+std::shared_ptr<const SimulationState> SimulationEngine::state() const
+{
+    return std::atomic_load(&_state);
+}
+
+void SimulationEngine::acknowledgeStateUpdate()
+{
+    _stateUpdatePending.store(false);
+}
+
+bool SimulationEngine::isPlaying() const
+{
+    QMutexLocker locker(&_mutex);
+    return _playing;
+}
+
+void SimulationEngine::setPlaying(bool playing)
+{
+    QMutexLocker locker(&_mutex);
+    if (playing && !_playing) {
+        _lastStepTime = Clock::now();
+        _nextStepTime = _lastStepTime + _stepDuration;
+        _accumulatedTime = std::chrono::nanoseconds(0);
+    }
+    _playing = playing;
+    _playingChanged.wakeAll();
+}
+
+void SimulationEngine::setRoute(const RealLifeVideo &rlv)
+{
+    QMutexLocker locker(&_mutex);
+    _routeValid = rlv.isValid();
+    _profile = rlv.profile();
+    _geoPositions = rlv.positionCollection();
+    _geoPositionHint = 0;
+}
+
+void SimulationEngine::reset(float distance)
+{
+    QMutexLocker locker(&_mutex);
+    _playing = false;
+    _playingChanged.wakeAll();
+    _physicsState = PhysicsState();
+    _physicsState.distance = distance;
+    _previousPhysicsState = _physicsState;
+    _accumulatedTime = std::chrono::nanoseconds(0);
+    publishState();
+}
+
+void SimulationEngine::setPower(int power)
+{
+    _power.store(power);
+}
+
+void SimulationEngine::setCadence(int cadence)
+{
+    _cadence.store(cadence);
+}
+
+void SimulationEngine::setHeartRate(int heartRate)
+{
+    _heartRate.store(heartRate);
+}
+
+void SimulationEngine::setWheelSpeed(float wheelSpeedMetersPerSecond)
+{
+    _wheelSpeedMetersPerSecond.store(wheelSpeedMetersPerSecond);
+}
+
+/**
+ * The wait condition only has millisecond resolution, so we'll wait for whole milliseconds and sleep for the
+ * rest of the time until the next step is due. If we're late, step() catches up on the missed steps.
+ */
+void SimulationEngine::run()
+{
+    QMutexLocker locker(&_mutex);
+    while (!_stopping) {
+        if (!_playing) {
+            _playingChanged.wait(&_mutex);
+            continue;
+        }
+        const Clock::time_point now = Clock::now();
+        if (now >= _nextStepTime) {
+            step(now);
+            const auto stepsBehind = (now - _nextStepTime) / _stepDuration;
+            _nextStepTime += _stepDuration * (stepsBehind + 1);
+            continue;
+        }
+        const qint64 waitNs = std::chrono::duration_cast<std::chrono::nanoseconds>(_nextStepTime - now).count();
+        if (waitNs >= NS_PER_MS) {
+            _playingChanged.wait(&_mutex, static_cast<unsigned long>(waitNs / NS_PER_MS));
+        } else {
+            locker.unlock();
+            usleep(static_cast<unsigned long>((waitNs + NS_PER_US - 1) / NS_PER_US));
+            locker.relock();
+        }
+    }
+}
+
+/**
+ * The physics always advance in steps of exactly _stepDuration, so the simulation does not depend on when the
+ * thread happens to wake up. The time that passed is added to an accumulator and as many whole steps are taken as
+ * fit in it. If we were delayed, that means taking a few steps at once, up to MAX_CATCH_UP_TIME, for instance after
+ * the system was suspended. The remainder is carried over to the next call.
+ */
+void SimulationEngine::step(Clock::time_point now)
+{
+    const std::chrono::nanoseconds timeDelta = std::chrono::duration_cast<std::chrono::nanoseconds>(now - _lastStepTime);
+    _lastStepTime = now;
+    if (!_routeValid) {
+        return;
+    }
+
+    _accumulatedTime = qMin(_accumulatedTime + timeDelta,
+                            std::chrono::duration_cast<std::chrono::nanoseconds>(MAX_CATCH_UP_TIME));
+    while (_accumulatedTime >= _stepDuration) {
+        _previousPhysicsState = _physicsState;
+        if (_simulationSetting == SimulationSetting::DIRECT_SPEED) {
+            _physicsState = _physics.stepWithSpeed(_physicsState, _wheelSpeedMetersPerSecond.load(),
+                                                   _stepDuration.count());
+        } else {
+            _physicsState = _physics.step(_physicsState, _profile, _power.load(), _stepDuration.count());
+        }
+        _accumulatedTime -= _stepDuration;
+    }
+
+    publishState();
+}
+
+/**
+ * Same as RealLifeVideo::positionForDistance(), but using our own copy of the positions.
+ */
+GeoPosition SimulationEngine::positionForDistance(float distance)
+{
+    const auto entry = _geoPositions.iteratorForDistance(distance, _geoPositionHint);
+    if (_geoPositions.isEndEntryIterator(entry)) {
+        return GeoPosition::NULL_POSITION;
+    }
+    const auto nextEntry = entry + 1;
+    if (_geoPositions.isEndEntryIterator(nextEntry)) {
+        return *entry;
+    }
+    return GeoPosition::interpolateBetween(*entry, *nextEntry, distance);
+}
+
+/**
+ * Publish a new state. Must be called with the mutex held. Readers that still hold the previous state keep a
+ * consistent copy of it, as states are never changed after they have been published.
+ *
+ * The published state is interpolated between the last two physics steps, by the time that is left in the
+ * accumulator, so the video and the display move smoothly even when the thread does not wake up exactly on a step.
+ */
+void SimulationEngine::publishState()
+{
+    const double alpha = std::chrono::duration<double>(_accumulatedTime) / _stepDuration;
+    const PhysicsState physicsState = CyclingPhysics::interpolate(_previousPhysicsState, _physicsState, alpha);
+
+    std::shared_ptr<SimulationState> state = std::make_shared<SimulationState>();
+    state->runTimeNs = physicsState.runTimeNs;
+    state->speed = physicsState.speed;
+    state->distance = physicsState.distance;
+    state->distanceTravelled = physicsState.distanceTravelled;
+    if (_routeValid) {
+        state->altitude = _profile.altitudeForDistance(physicsState.distance);
+        state->slope = _profile.slopeForDistance(physicsState.distance);
+        state->geoPosition = positionForDistance(physicsState.distance);
+    }
+    state->power = _power.load();
+    state->cadence = _cadence.load();
+    state->heartRate = _heartRate.load();
+
+    std::atomic_store(&_state, std::shared_ptr<const SimulationState>(state));
+    if (!_stateUpdatePending.exchange(true)) {
+        emit stateUpdated();
+    }
+}
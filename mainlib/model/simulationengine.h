@@ -0,0 +1,135 @@
+/*
+ * Copyright (c) 2015 Ilja Booij (ibooij@gmail.com)
+ *
+ * This file is part of Big Ring Indoor Video Cycling
+ *
+ * Big Ring Indoor Video Cycling is free software: you can redistribute
+ * it and/or modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation, either version 3 of the
+ * License, or (at your option) any later version.
+ *
+ * Big Ring Indoor Video Cycling  is distributed in the hope that it will
+ * be useful, but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+
+ * You should have received a copy of the GNU General Public License
+ * along with Big Ring Indoor Video Cycling.  If not, see
+ * <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef SIMULATIONENGINE_H
+#define SIMULATIONENGINE_H
+
+#include <atomic>
+#include <chrono>
+#include <memory>
+
+#include <QtCore/QMutex>
+#include <QtCore/QThread>
+#include <QtCore/QWaitCondition>
+
+#include "cyclingphysics.h"
+#include "distanceentrycollection.h"
+#include "geoposition.h"
+#include "profile.h"
+#include "reallifevideo.h"
+#include "simulationstate.h"
+
+enum class SimulationSetting {
+    FIXED_POWER,
+    DIRECT_POWER,
+    VIRTUAL_POWER,
+    DIRECT_SPEED
+};
+
+/**
+ * Runs the physics of the simulation in its own thread, at a fixed number of steps per second. The physics
+ * themselves are calculated by CyclingPhysics, the engine feeds it the latest measurements and publishes the results.
+ *
+ * Time deltas are measured with a monotonic clock in nanoseconds and the physics advance in fixed steps, so the
+ * speed integration does not depend on how busy the GUI thread is or on when the engine thread wakes up. After every
+ * step, the engine publishes a new SimulationState. Readers get the latest state with state(), which never waits for
+ * a simulation step to finish.
+ *
+ * The engine keeps its own snapshot of the profile and positions of the route, which setRoute() replaces under the
+ * engine's mutex, so the route cannot change in the middle of a step. The positions are looked up in order of
+ * distance, so the engine keeps its own search hint for them.
+ */
+class SimulationEngine : public QThread
+{
+    Q_OBJECT
+public:
+    explicit SimulationEngine(SimulationSetting simulationSetting, qreal totalWeight,
+                              double powerForElevationCorrection, int stepsPerSecond, QObject* parent = 0);
+    virtual ~SimulationEngine();
+
+    /** the latest published state. Can be called from any thread. */
+    std::shared_ptr<const SimulationState> state() const;
+    /**
+     * Mark the published state as seen. stateUpdated() is not emitted again until the state has been acknowledged,
+     * so a busy receiver does not get a queue full of stale notifications.
+     */
+    void acknowledgeStateUpdate();
+
+    bool isPlaying() const;
+    void setPlaying(bool playing);
+
+    /** set the route to simulate */
+    void setRoute(const RealLifeVideo& rlv);
+    /** stop moving and put the cyclist at distance, resetting the run time and distance travelled. */
+    void reset(float distance);
+
+    // inputs, can be set from any thread.
+    void setPower(int power);
+    void setCadence(int cadence);
+    void setHeartRate(int heartRate);
+    void setWheelSpeed(float wheelSpeedMetersPerSecond);
+signals:
+    /** emitted when a new state was published. */
+    void stateUpdated();
+protected:
+    void run() override;
+private:
+    typedef std::chrono::steady_clock Clock;
+
+    void step(Clock::time_point now);
+    GeoPosition positionForDistance(float distance);
+    void publishState();
+
+    const SimulationSetting _simulationSetting;
+    const CyclingPhysics _physics;
+    const std::chrono::nanoseconds _stepDuration;
+
+    mutable QMutex _mutex;
+    QWaitCondition _playingChanged;
+    bool _stopping;
+    bool _playing;
+    Clock::time_point _lastStepTime;
+    Clock::time_point _nextStepTime;
+
+    bool _routeValid;
+    Profile _profile;
+    DistanceEntryCollection<GeoPosition> _geoPositions;
+    /** search position in _geoPositions, the positions are looked up in order of distance */
+    std::size_t _geoPositionHint;
+
+    /** state after the last two physics steps, published states are interpolated between them */
+    PhysicsState _previousPhysicsState;
+    PhysicsState _physicsState;
+    /** time that has passed, but is not yet simulated */
+    std::chrono::nanoseconds _accumulatedTime;
+
+    std::atomic<int> _power;
+    std::atomic<int> _cadence;
+    std::atomic<int> _heartRate;
+    /** in case of SimulationSetting::DIRECT_SPEED, we use the wheel speed directly, without calculating it from
+     * power */
+    std::atomic<float> _wheelSpeedMetersPerSecond;
+
+    /** only accessed with std::atomic_load and std::atomic_store */
+    std::shared_ptr<const SimulationState> _state;
+    std::atomic<bool> _stateUpdatePending;
+};
+
+#endif // SIMULATIONENGINE_H
@@ -0,0 +1,53 @@
+/*
+ * Copyright (c) 2015 Ilja Booij (ibooij@gmail.com)
+ *
+ * This file is part of Big Ring Indoor Video Cycling
+ *
+ * Big Ring Indoor Video Cycling is free software: you can redistribute
+ * it and/or modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation, either version 3 of the
+ * License, or (at your option) any later version.
+ *
+ * Big Ring Indoor Video Cycling  is distributed in the hope that it will
+ * be useful, but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+
+ * You should have received a copy of the GNU General Public License
+ * along with Big Ring Indoor Video Cycling.  If not, see
+ * <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef SIMULATIONSTATE_H
+#define SIMULATIONSTATE_H
+
+#include <QtCore/QTime>
+
+#include "geoposition.h"
+
+/**
+ * The state of the simulation after a simulation step. States are published by the simulation thread as immutable
+ * snapshots, so all values in a state belong to the same moment.
+ */
+struct SimulationState
+{
+    /** time ridden, only advances while the cyclist is moving */
+    qint64 runTimeNs = 0;
+    float speed = 0; // m/s
+    /** distance on track */
+    float distance = 0; // m
+    /** distance travelled from start of course */
+    float distanceTravelled = 0; // m
+    float altitude = 0; // m
+    float slope = 0; // %
+    GeoPosition geoPosition;
+    int power = 0; // W
+    int cadence = 0; // rpm
+    int heartRate = 0; // bpm
+
+    QTime runTime() const {
+        return QTime(0, 0, 0).addMSecs(static_cast<int>(runTimeNs / 1000000));
+    }
+};
+
+#endif // SIMULATIONSTATE_H
@@ -0,0 +1,213 @@
+/*
+ * Copyright (c) 2015 Ilja Booij (ibooij@gmail.com)
+ *
+ * This file is part of Big Ring Indoor Video Cycling
+ *
+ * Big Ring Indoor Video Cycling is free software: you can redistribute
+ * it and/or modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation, either version 3 of the
+ * License, or (at your option) any later version.
+ *
+ * Big Ring Indoor Video Cycling  is distributed in the hope that it will
+ * be useful, but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+
+ * You should have received a copy of the GNU General Public License
+ * along with Big Ring Indoor Video Cycling.  If not, see
+ * <http://www.gnu.org/licenses/>.
+ */
+#include "trainingmetrics.h"
+
+namespace {
+const double MSECS_PER_HOUR = 3600000.0;
+// a climb should gain at least this much elevation to be counted.
+const float MINIMUM_CLIMB_ELEVATION_GAIN = 20.0f; // m
+// a climb ends when the cyclist has descended this much from the top.
+const float CLIMB_END_DESCENT = 10.0f; // m
+}
+
+TrainingMetrics::TrainingMetrics(int functionalThresholdPower, int anaerobicWorkCapacity):
+    _functionalThresholdPower(qMax(1, functionalThresholdPower)), _anaerobicWorkCapacity(qMax(1, anaerobicWorkCapacity)),
+    _numberOfSamples(0), _firstTimeMs(0), _lastTimeMs(0), _powerSum(0), _cadenceSum(0), _heartRateSum(0),
+    _maximumPower(0), _maximumHeartRate(0), _maximumSpeed(0), _wPrimeBalance(_anaerobicWorkCapacity),
+    _minimumWPrimeBalance(_anaerobicWorkCapacity), _climbStart(), _climbTop()
+{
+    // empty
+}
+
+TrainingMetrics TrainingMetrics::forRideFile(const RideFile &rideFile, int functionalThresholdPower,
+                                             int anaerobicWorkCapacity)
+{
+    TrainingMetrics trainingMetrics(functionalThresholdPower, anaerobicWorkCapacity);
+    for (const RideFile::Sample &sample: rideFile.samples()) {
+        trainingMetrics.addSample(sample);
+    }
+    return trainingMetrics;
+}
+
+void TrainingMetrics::addSample(const RideFile::Sample &sample)
+{
+    const qint64 timeMs = sample.time.msecsSinceStartOfDay();
+    if (_numberOfSamples == 0) {
+        _firstTimeMs = timeMs;
+        _lastTimeMs = timeMs;
+    }
+    const double seconds = qMax<qint64>(0, timeMs - _lastTimeMs) / 1000.0;
+    _lastTimeMs = qMax(_lastTimeMs, timeMs);
+
+    ++_numberOfSamples;
+    _powerSum += sample.power;
+    _cadenceSum += sample.cadence;
+    _heartRateSum += sample.heartRate;
+    _maximumPower = qMax(_maximumPower, sample.power);
+    _maximumHeartRate = qMax(_maximumHeartRate, sample.heartRate);
+    _maximumSpeed = qMax(_maximumSpeed, sample.speed);
+
+    _normalizedPower.addPower(timeMs, sample.power);
+
+    const double criticalPower = _functionalThresholdPower;
+    if (sample.power > criticalPower) {
+        _wPrimeBalance -= (sample.power - criticalPower) * seconds;
+    } else {
+        _wPrimeBalance += (criticalPower - sample.power) * seconds
+                * (_anaerobicWorkCapacity - _wPrimeBalance) / _anaerobicWorkCapacity;
+    }
+    _minimumWPrimeBalance = qMin(_minimumWPrimeBalance, _wPrimeBalance);
+
+    updateClimbs(climbPoint(sample));
+}
+
+int TrainingMetrics::functionalThresholdPower() const
+{
+    return _functionalThresholdPower;
+}
+
+int TrainingMetrics::anaerobicWorkCapacity() const
+{
+    return _anaerobicWorkCapacity;
+}
+
+int TrainingMetrics::numberOfSamples() const
+{
+    return _numberOfSamples;
+}
+
+qint64 TrainingMetrics::durationMs() const
+{
+    return _lastTimeMs - _firstTimeMs;
+}
+
+float TrainingMetrics::averagePower() const
+{
+    return (_numberOfSamples == 0) ? 0.0f : static_cast<float>(_powerSum / _numberOfSamples);
+}
+
+int TrainingMetrics::maximumPower() const
+{
+    return _maximumPower;
+}
+
+float TrainingMetrics::averageCadence() const
+{
+    return (_numberOfSamples == 0) ? 0.0f : static_cast<float>(_cadenceSum / _numberOfSamples);
+}
+
+float TrainingMetrics::averageHeartRate() const
+{
+    return (_numberOfSamples == 0) ? 0.0f : static_cast<float>(_heartRateSum / _numberOfSamples);
+}
+
+int TrainingMetrics::maximumHeartRate() const
+{
+    return _maximumHeartRate;
+}
+
+float TrainingMetrics::maximumSpeed() const
+{
+    return _maximumSpeed;
+}
+
+float TrainingMetrics::normalizedPower() const
+{
+    return _normalizedPower.normalizedPower();
+}
+
+float TrainingMetrics::intensityFactor() const
+{
+    return normalizedPower() / _functionalThresholdPower;
+}
+
+float TrainingMetrics::trainingStressScore() const
+{
+    // TSS is 100 for riding an hour at FTP.
+    const double intensityFactor = this->intensityFactor();
+    return static_cast<float>(durationMs() / MSECS_PER_HOUR * intensityFactor * intensityFactor * 100.0);
+}
+
+float TrainingMetrics::wPrimeBalance() const
+{
+    return static_cast<float>(_wPrimeBalance);
+}
+
+float TrainingMetrics::minimumWPrimeBalance() const
+{
+    return static_cast<float>(_minimumWPrimeBalance);
+}
+
+std::vector<TrainingMetrics::Climb> TrainingMetrics::climbs() const
+{
+    std::vector<Climb> climbs(_climbs);
+    if (isClimbing()) {
+        climbs.push_back(currentClimb());
+    }
+    return climbs;
+}
+
+bool TrainingMetrics::isClimbing() const
+{
+    return _numberOfSamples > 0 && _climbTop.altitude - _climbStart.altitude >= MINIMUM_CLIMB_ELEVATION_GAIN;
+}
+
+TrainingMetrics::Climb TrainingMetrics::currentClimb() const
+{
+    return climbBetween(_climbStart, _climbTop);
+}
+
+TrainingMetrics::ClimbPoint TrainingMetrics::climbPoint(const RideFile::Sample &sample) const
+{
+    return { sample.distance, sample.altitude, _lastTimeMs, _numberOfSamples, _powerSum };
+}
+
+/**
+ * Track the lowest point before the current climb and the highest point of the climb. When the cyclist descends too
+ * far from the top, the climb is finished and a new one can start.
+ */
+void TrainingMetrics::updateClimbs(const ClimbPoint &point)
+{
+    if (_numberOfSamples == 1) {
+        _climbStart = point;
+        _climbTop = point;
+    } else if (point.altitude > _climbTop.altitude) {
+        _climbTop = point;
+    } else if (_climbTop.altitude - point.altitude >= CLIMB_END_DESCENT) {
+        if (_climbTop.altitude - _climbStart.altitude >= MINIMUM_CLIMB_ELEVATION_GAIN) {
+            _climbs.push_back(climbBetween(_climbStart, _climbTop));
+        }
+        _climbStart = point;
+        _climbTop = point;
+    } else if (point.altitude <= _climbStart.altitude) {
+        // a climb starts at the last of its lowest points.
+        _climbStart = point;
+        _climbTop = point;
+    }
+}
+
+TrainingMetrics::Climb TrainingMetrics::climbBetween(const ClimbPoint &start, const ClimbPoint &top)
+{
+    const int numberOfSamples = top.numberOfSamples - start.numberOfSamples;
+    const float averagePower = (numberOfSamples == 0) ? 0.0f
+                                                      : static_cast<float>((top.powerSum - start.powerSum) / numberOfSamples);
+    return { start.distance, top.distance - start.distance, top.altitude - start.altitude, top.timeMs - start.timeMs,
+                averagePower, start.numberOfSamples - 1, top.numberOfSamples - 1 };
+}
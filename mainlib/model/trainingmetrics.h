@@ -0,0 +1,133 @@
+/*
+ * Copyright (c) 2015 Ilja Booij (ibooij@gmail.com)
+ *
+ * This file is part of Big Ring Indoor Video Cycling
+ *
+ * Big Ring Indoor Video Cycling is free software: you can redistribute
+ * it and/or modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation, either version 3 of the
+ * License, or (at your option) any later version.
+ *
+ * Big Ring Indoor Video Cycling  is distributed in the hope that it will
+ * be useful, but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+
+ * You should have received a copy of the GNU General Public License
+ * along with Big Ring Indoor Video Cycling.  If not, see
+ * <http://www.gnu.org/licenses/>.
+ */
+#ifndef TRAININGMETRICS_H
+#define TRAININGMETRICS_H
+
+#include <QtCore/QtGlobal>
+
+#include <vector>
+
+#include "normalizedpower.h"
+#include "ridefile.h"
+
+/**
+ * Training metrics of a ride: averages and maximums, normalized power, intensity factor, training stress score (TSS),
+ * W' balance and the climbs of the ride.
+ *
+ * The metrics are fed from the samples of the ride, while it is recorded, or from a complete ride file. Every sample
+ * is handled in constant time and all metrics can be requested at any time, without going over the samples again.
+ *
+ * Intensity factor and TSS are relative to the functional threshold power (FTP) of the cyclist. For the W' balance,
+ * FTP is used as critical power, W' is depleted when riding above it and recovers exponentially when riding below it
+ * (the differential form of the model of Skiba et al.).
+ */
+class TrainingMetrics
+{
+public:
+    /** A climb of the ride, from its lowest to its highest point. */
+    struct Climb {
+        float startDistance; // m
+        float distance; // m
+        float elevationGain; // m
+        qint64 durationMs;
+        float averagePower; // W
+        /** indices of the samples at the start and at the top of the climb. */
+        int startSample;
+        int topSample;
+    };
+
+    /**
+     * Create a new TrainingMetrics object.
+     * @param functionalThresholdPower FTP of the cyclist in watts.
+     * @param anaerobicWorkCapacity W' of the cyclist in joules.
+     */
+    explicit TrainingMetrics(int functionalThresholdPower, int anaerobicWorkCapacity);
+
+    /** Calculate the metrics of a complete ride. */
+    static TrainingMetrics forRideFile(const RideFile &rideFile, int functionalThresholdPower,
+                                       int anaerobicWorkCapacity);
+
+    /** Add the next sample of the ride. Samples should be added in order of time. */
+    void addSample(const RideFile::Sample &sample);
+
+    int functionalThresholdPower() const;
+    int anaerobicWorkCapacity() const;
+
+    int numberOfSamples() const;
+    qint64 durationMs() const;
+
+    float averagePower() const;
+    int maximumPower() const;
+    float averageCadence() const;
+    float averageHeartRate() const;
+    int maximumHeartRate() const;
+    float maximumSpeed() const;
+
+    float normalizedPower() const;
+    float intensityFactor() const;
+    float trainingStressScore() const;
+
+    /** Remaining W' in joules. */
+    float wPrimeBalance() const;
+    /** Lowest W' balance of the ride in joules. */
+    float minimumWPrimeBalance() const;
+
+    /** all climbs of the ride, including the current one, if the cyclist is climbing. */
+    std::vector<Climb> climbs() const;
+    /** true if the cyclist is on a climb that has gained enough elevation to be counted. */
+    bool isClimbing() const;
+    /** the climb the cyclist is on. Only valid if isClimbing() is true. */
+    Climb currentClimb() const;
+private:
+    /** Point of the ride where a climb can start or end. */
+    struct ClimbPoint {
+        float distance;
+        float altitude;
+        qint64 timeMs;
+        int numberOfSamples;
+        double powerSum;
+    };
+    ClimbPoint climbPoint(const RideFile::Sample &sample) const;
+    void updateClimbs(const ClimbPoint &point);
+    static Climb climbBetween(const ClimbPoint &start, const ClimbPoint &top);
+
+    int _functionalThresholdPower;
+    int _anaerobicWorkCapacity;
+
+    int _numberOfSamples;
+    qint64 _firstTimeMs;
+    qint64 _lastTimeMs;
+    double _powerSum;
+    double _cadenceSum;
+    double _heartRateSum;
+    int _maximumPower;
+    int _maximumHeartRate;
+    float _maximumSpeed;
+
+    NormalizedPower _normalizedPower;
+    double _wPrimeBalance;
+    double _minimumWPrimeBalance;
+
+    ClimbPoint _climbStart;
+    ClimbPoint _climbTop;
+    std::vector<Climb> _climbs;
+};
+
+#endif // TRAININGMETRICS_H
@@ -19,62 +19,88 @@
  */
 #include "virtualpower.h"
 
-#include "unitconverter.h"
-
-#include <QtCore/QtDebug>
-#include <QtCore/QtMath>
 namespace
 {
+using indoorcycling::TrainerPowerCurve;
 using indoorcycling::VirtualPowerTrainer;
 using indoorcycling::VirtualPowerFunctionType;
 
-typedef std::function<float(float)> SpeedConversionFunctionType;
+typedef UnitConverter::SpeedUnit SpeedUnit;
 
-struct PowerCurve {
-    UnitConverter::SpeedUnit speedUnit;
-    std::vector<float> coefficients;
-};
+// fallback for unknown trainers, a constant power of 1 W.
+const TrainerPowerCurve<SpeedUnit::MetersPerSecond, 0> UNKNOWN_TRAINER_POWER_CURVE{{{1}}};
 
-const PowerCurve IDENTITY_POWER_CURVE = { UnitConverter::SpeedUnit::MetersPerSecond, {1} };
+// Kurt Kinetic Road Machine: P = 5.244820 * MPH + 0.019168 * MPH^3
+const TrainerPowerCurve<SpeedUnit::MilesPerHour, 3> KURT_KINETIC_ROAD_MACHINE_CURVE{{{0, 5.244820, 0, 0.019168}}};
+// Kurt Kinetic Cyclone: P = 6.481090 * mph + 0.020106 * (mph*mph*mph)
+const TrainerPowerCurve<SpeedUnit::MilesPerHour, 3> KURT_KINETIC_CYCLONE_CURVE{{{0, 6.481090, 0, 0.020106}}};
+// Cycleops Fluid 2: P = 8.9788 * MPH + 0.0137 * MPH^2 + 0.0115 * MPH^3
+const TrainerPowerCurve<SpeedUnit::MilesPerHour, 3> CYCLEOPS_FLUID_2_CURVE{{{0, 8.9788, 0.0137, 0.0115}}};
+// Cyclops Jet Fluid Pro: P = -46.511 + 15.468 * MPH - 1.0988 * MPH^2 + 0.0736 * MPH^3 - 0.0008 * MPH^4
+const TrainerPowerCurve<SpeedUnit::MilesPerHour, 4> CYCLEOPS_JET_FLUID_PRO_CURVE{
+        {{-46.511, 15.468, -1.0988, 0.0736, -0.0008}}};
+// ELITE QUBO POWER FLUID f(x) = 4.31746 * kmph -2.59259e-002 * kmph^2 +  9.41799e-003 * kmph^3
+const TrainerPowerCurve<SpeedUnit::KilometersPerHour, 3> ELITE_QUBO_POWER_FLUID_CURVE{
+        {{0, 4.31746, -2.59259e-002, 9.41799e-003}}};
+// Elite Turbo Muin 2013 model P =  0.00791667 v^3 + 0.125 v^2 - 0.16669 v
+const TrainerPowerCurve<SpeedUnit::KilometersPerHour, 3> ELITE_TURBO_MUIN_2013_CURVE{
+        {{0, - 0.16669, 0.125, 0.00791667}}};
 
-const std::map<VirtualPowerTrainer, PowerCurve> powerCurves = {
-    // Kurt Kinetic Road Machine: P = 5.244820 * MPH + 0.019168 * MPH^3
-    { VirtualPowerTrainer::KURT_KINETIC_ROAD_MACHINE, { UnitConverter::SpeedUnit::MilesPerHour, {0, 5.244820, 0, 0.019168} }},
-    // Kurt Kinetic Cyclone: P = 6.481090 * mph + 0.020106 * (mph*mph*mph)
-    { VirtualPowerTrainer::KURT_KINETIC_CYCLONE, { UnitConverter::SpeedUnit::MilesPerHour, {0, 6.481090, 0, 0.020106} }},
-    // Cycleops Fluid 2: P = 8.9788 * MPH + 0.0137 * MPH^2 + 0.0115 * MPH^3
-    { VirtualPowerTrainer::CYCLEOPS_FLUID_2, { UnitConverter::SpeedUnit::MilesPerHour, {0, 8.9788, 0.0137, 0.0115} }},
-    // Cyclops Jet Fluid Pro: P = -46.511 + 15.468 * MPH - 1.0988 * MPH^2 + 0.0736 * MPH^3 - 0.0008 * MPH^4
-    { VirtualPowerTrainer::CYCLEOPS_JET_FLUID_PRO, { UnitConverter::SpeedUnit::MilesPerHour, {-46.511, 15.468, -1.0988, 0.0736,-0.0008} }},
-    // ELITE QUBO POWER FLUID f(x) = 4.31746 * kmph -2.59259e-002 * kmph^2 +  9.41799e-003 * kmph^3
-    { VirtualPowerTrainer::ELITE_QUBO_POWER_FLUID, { UnitConverter::SpeedUnit::KilometersPerHour, {0, 4.31746, -2.59259e-002, 9.41799e-003} }},
-    // Elite Turbo Muin 2013 model P =  0.00791667 v^3 + 0.125 v^2 - 0.16669 v
-    { VirtualPowerTrainer::ELITE_TURBO_MUIN_2013, { UnitConverter::SpeedUnit::KilometersPerHour, {0, - 0.16669, 0.125, 0.00791667} }}
-};
-
-const PowerCurve &findPowerCurve(VirtualPowerTrainer trainer)
+/**
+ * Call function with the power curve of the trainer. The switch is done once, so the function is called with the
+ * specialised curve.
+ */
+template <typename Function>
+void withPowerCurve(VirtualPowerTrainer trainer, Function &function)
 {
-    auto it = powerCurves.find(trainer);
-    if (it == powerCurves.end()) {
-        return IDENTITY_POWER_CURVE;
+    switch (trainer) {
+    case VirtualPowerTrainer::KURT_KINETIC_ROAD_MACHINE:
+        function(KURT_KINETIC_ROAD_MACHINE_CURVE);
+        return;
+    case VirtualPowerTrainer::KURT_KINETIC_CYCLONE:
+        function(KURT_KINETIC_CYCLONE_CURVE);
+        return;
+    case VirtualPowerTrainer::CYCLEOPS_FLUID_2:
+        function(CYCLEOPS_FLUID_2_CURVE);
+        return;
+    case VirtualPowerTrainer::CYCLEOPS_JET_FLUID_PRO:
+        function(CYCLEOPS_JET_FLUID_PRO_CURVE);
+        return;
+    case VirtualPowerTrainer::ELITE_QUBO_POWER_FLUID:
+        function(ELITE_QUBO_POWER_FLUID_CURVE);
+        return;
+    case VirtualPowerTrainer::ELITE_TURBO_MUIN_2013:
+        function(ELITE_TURBO_MUIN_2013_CURVE);
+        return;
     }
-    return (*it).second;
+    function(UNKNOWN_TRAINER_POWER_CURVE);
 }
 
-const SpeedConversionFunctionType determineSpeedConversionFunction(VirtualPowerTrainer trainer) {
-    switch (findPowerCurve(trainer).speedUnit) {
-    case UnitConverter::SpeedUnit::KilometersPerHour:
-        return [](double metersPerSecond) {
-            return UnitConverter::convertSpeedTo(metersPerSecond, UnitConverter::SpeedUnit::KilometersPerHour);
-        };
-    case UnitConverter::SpeedUnit::MilesPerHour:
-        return [](double metersPerSecond) {
-            return UnitConverter::convertSpeedTo(metersPerSecond, UnitConverter::SpeedUnit::MilesPerHour);
+/** Function for withPowerCurve, which wraps the power curve in a VirtualPowerFunctionType. */
+struct CreateFunction
+{
+    template <typename PowerCurve>
+    void operator()(const PowerCurve &powerCurve)
+    {
+        result = [powerCurve](float speedMetersPerSecond) {
+            return powerCurve(speedMetersPerSecond);
         };
-    default:
-        return [](float mps) { return mps; };
     }
-}
+    VirtualPowerFunctionType result;
+};
+
+/** Function for withPowerCurve, which calculates the power for a batch of speeds. */
+struct CalculateBatch
+{
+    template <typename PowerCurve>
+    void operator()(const PowerCurve &powerCurve)
+    {
+        powerCurve(speedsMetersPerSecond, powers, count);
+    }
+    const float *speedsMetersPerSecond;
+    float *powers;
+    std::size_t count;
+};
 }
 
 namespace indoorcycling
@@ -82,19 +108,22 @@ namespace indoorcycling
 
 VirtualPowerFunctionType virtualPowerFunctionForTrainer(VirtualPowerTrainer trainer)
 {
-    const PowerCurve &powerCurve = findPowerCurve(trainer);
-    SpeedConversionFunctionType speedConversionFunction = determineSpeedConversionFunction(trainer);
+    CreateFunction createFunction;
+    withPowerCurve(trainer, createFunction);
+    return createFunction.result;
+}
 
-    return [powerCurve, speedConversionFunction](float speedMetersPerSecond) {
-        const float convertedSpeed = speedConversionFunction(speedMetersPerSecond);
+void virtualPowerForSpeeds(VirtualPowerTrainer trainer, const float *speedsMetersPerSecond, float *powers,
+                           std::size_t count)
+{
+    CalculateBatch calculateBatch = { speedsMetersPerSecond, powers, count };
+    withPowerCurve(trainer, calculateBatch);
+}
 
-        float power = 0;
-        int i = 0;
-        for(auto &factor: powerCurve.coefficients) {
-            power += factor * qPow(convertedSpeed, i);
-            i += 1;
-        }
-        return power;
-    };
+std::vector<float> virtualPowerForSpeeds(VirtualPowerTrainer trainer, const std::vector<float> &speedsMetersPerSecond)
+{
+    std::vector<float> powers(speedsMetersPerSecond.size());
+    virtualPowerForSpeeds(trainer, speedsMetersPerSecond.data(), powers.data(), powers.size());
+    return powers;
 }
 }
@@ -20,9 +20,14 @@
 #ifndef VIRTUALPOWER_H
 #define VIRTUALPOWER_H
 
+#include <array>
+#include <cstddef>
 #include <functional>
+#include <vector>
 #include <QtCore/QMap>
 #include <QtCore/QString>
+
+#include "unitconverter.h"
 namespace indoorcycling {
 
 enum class VirtualPowerTrainer {
@@ -45,12 +50,69 @@ const QMap<VirtualPowerTrainer,QString> VIRTUAL_POWER_TRAINERS =
 
 typedef std::function<float(float)> VirtualPowerFunctionType;
 
+/** Factor to convert a speed in meters per second to unit. */
+constexpr float speedConversionFactor(UnitConverter::SpeedUnit unit)
+{
+    return (unit == UnitConverter::SpeedUnit::KilometersPerHour) ? 3.6f :
+           (unit == UnitConverter::SpeedUnit::MilesPerHour) ? static_cast<float>(3600 / 1609.344) : 1.0f;
+}
+
+/**
+ * Power curve of a trainer, a polynomial of DEGREE in the speed in UNIT. Speed unit and degree are template
+ * parameters, so the speed conversion and polynomial evaluation (Horner's method) are fixed at compile time and
+ * the batch version compiles to a tight loop that the compiler can vectorise.
+ */
+template <UnitConverter::SpeedUnit UNIT, int DEGREE>
+class TrainerPowerCurve
+{
+public:
+    /** coefficients, from the constant term up to the term of DEGREE */
+    explicit TrainerPowerCurve(const std::array<float, DEGREE + 1> &coefficients):
+        _coefficients(coefficients)
+    {
+        // empty
+    }
+
+    /** Power (W) for a speed in meters per second */
+    float operator()(const float speedMetersPerSecond) const
+    {
+        const float speed = speedMetersPerSecond * speedConversionFactor(UNIT);
+        float power = _coefficients[DEGREE];
+        for (int i = DEGREE - 1; i >= 0; --i) {
+            power = power * speed + _coefficients[i];
+        }
+        return power;
+    }
+
+    /** Power (W) for count speeds in meters per second */
+    void operator()(const float *speedsMetersPerSecond, float *powers, const std::size_t count) const
+    {
+        for (std::size_t i = 0; i < count; ++i) {
+            powers[i] = (*this)(speedsMetersPerSecond[i]);
+        }
+    }
+private:
+    std::array<float, DEGREE + 1> _coefficients;
+};
+
 /**
  * Get the power function for a trainer.
  * @param trainer the trainer to get the function for.
  * @return a function from speed (in mps) to power (W).
  */
 VirtualPowerFunctionType virtualPowerFunctionForTrainer(VirtualPowerTrainer trainer);
+
+/**
+ * Calculate the power for a batch of speeds, without calling through a std::function for every speed.
+ * @param trainer the trainer to calculate the power for.
+ * @param speedsMetersPerSecond count speeds in meters per second.
+ * @param powers output, will contain count powers (W).
+ */
+void virtualPowerForSpeeds(VirtualPowerTrainer trainer, const float *speedsMetersPerSecond, float *powers,
+                           std::size_t count);
+
+/** Calculate the power (W) for every speed (in mps) in speedsMetersPerSecond. */
+std::vector<float> virtualPowerForSpeeds(VirtualPowerTrainer trainer, const std::vector<float> &speedsMetersPerSecond);
 }
 
 #endif // VIRTUALPOWER_H
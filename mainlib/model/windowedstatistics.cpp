@@ -0,0 +1,190 @@
+/*
+ * Copyright (c) 2015 Ilja Booij (ibooij@gmail.com)
+ *
+ * This file is part of Big Ring Indoor Video Cycling
+ *
+ * Big Ring Indoor Video Cycling is free software: you can redistribute
+ * it and/or modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation, either version 3 of the
+ * License, or (at your option) any later version.
+ *
+ * Big Ring Indoor Video Cycling  is distributed in the hope that it will
+ * be useful, but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+
+ * You should have received a copy of the GNU General Public License
+ * along with Big Ring Indoor Video Cycling.  If not, see
+ * <http://www.gnu.org/licenses/>.
+ */
+#include "windowedstatistics.h"
+
+namespace {
+// initial size of the ring buffers, always a power of two.
+const int INITIAL_CAPACITY = 16;
+}
+
+WindowedStatistics::WindowedStatistics(qint64 durationMs):
+    _durationMs(durationMs), _sum(0)
+{
+    // empty
+}
+
+void WindowedStatistics::add(qint64 timestampMs, float value)
+{
+    const qint64 oldestValidTimestampMs = timestampMs - _durationMs;
+    while (!_measurements.isEmpty() && _measurements.front().timestampMs < oldestValidTimestampMs) {
+        _sum -= _measurements.front().value;
+        _measurements.popFront();
+    }
+    while (!_minimumCandidates.isEmpty() && _minimumCandidates.front().timestampMs < oldestValidTimestampMs) {
+        _minimumCandidates.popFront();
+    }
+    while (!_maximumCandidates.isEmpty() && _maximumCandidates.front().timestampMs < oldestValidTimestampMs) {
+        _maximumCandidates.popFront();
+    }
+
+    const Measurement measurement = { timestampMs, value };
+    _measurements.pushBack(measurement);
+    _sum += value;
+
+    // a candidate that is not smaller than the new value can never become the minimum, as the new value stays in the
+    // window longer. The same goes for the maximum.
+    while (!_minimumCandidates.isEmpty() && _minimumCandidates.back().value >= value) {
+        _minimumCandidates.popBack();
+    }
+    _minimumCandidates.pushBack(measurement);
+    while (!_maximumCandidates.isEmpty() && _maximumCandidates.back().value <= value) {
+        _maximumCandidates.popBack();
+    }
+    _maximumCandidates.pushBack(measurement);
+
+    // start from scratch when the window is empty, so rounding errors do not accumulate.
+    if (_measurements.size() == 1) {
+        _sum = value;
+    }
+}
+
+void WindowedStatistics::clear()
+{
+    _measurements.clear();
+    _minimumCandidates.clear();
+    _maximumCandidates.clear();
+    _sum = 0;
+}
+
+qint64 WindowedStatistics::durationMs() const
+{
+    return _durationMs;
+}
+
+int WindowedStatistics::count() const
+{
+    return _measurements.size();
+}
+
+bool WindowedStatistics::isEmpty() const
+{
+    return _measurements.isEmpty();
+}
+
+double WindowedStatistics::sum() const
+{
+    return _sum;
+}
+
+float WindowedStatistics::mean() const
+{
+    if (_measurements.isEmpty()) {
+        return 0.0f;
+    }
+    return static_cast<float>(_sum / _measurements.size());
+}
+
+float WindowedStatistics::minimum() const
+{
+    if (_minimumCandidates.isEmpty()) {
+        return 0.0f;
+    }
+    return _minimumCandidates.front().value;
+}
+
+float WindowedStatistics::maximum() const
+{
+    if (_maximumCandidates.isEmpty()) {
+        return 0.0f;
+    }
+    return _maximumCandidates.front().value;
+}
+
+qint64 WindowedStatistics::oldestTimestampMs() const
+{
+    return _measurements.front().timestampMs;
+}
+
+WindowedStatistics::MeasurementRing::MeasurementRing():
+    _buffer(INITIAL_CAPACITY), _first(0), _size(0)
+{
+    // empty
+}
+
+bool WindowedStatistics::MeasurementRing::isEmpty() const
+{
+    return _size == 0;
+}
+
+int WindowedStatistics::MeasurementRing::size() const
+{
+    return _size;
+}
+
+const WindowedStatistics::Measurement &WindowedStatistics::MeasurementRing::front() const
+{
+    return _buffer[static_cast<size_t>(_first)];
+}
+
+const WindowedStatistics::Measurement &WindowedStatistics::MeasurementRing::back() const
+{
+    const int mask = static_cast<int>(_buffer.size()) - 1;
+    return _buffer[static_cast<size_t>((_first + _size - 1) & mask)];
+}
+
+void WindowedStatistics::MeasurementRing::pushBack(const Measurement &measurement)
+{
+    if (_size == static_cast<int>(_buffer.size())) {
+        grow();
+    }
+    const int mask = static_cast<int>(_buffer.size()) - 1;
+    _buffer[static_cast<size_t>((_first + _size) & mask)] = measurement;
+    ++_size;
+}
+
+void WindowedStatistics::MeasurementRing::popFront()
+{
+    const int mask = static_cast<int>(_buffer.size()) - 1;
+    _first = (_first + 1) & mask;
+    --_size;
+}
+
+void WindowedStatistics::MeasurementRing::popBack()
+{
+    --_size;
+}
+
+void WindowedStatistics::MeasurementRing::clear()
+{
+    _first = 0;
+    _size = 0;
+}
+
+void WindowedStatistics::MeasurementRing::grow()
+{
+    // copy the measurements in order to the start of a buffer twice as big.
+    std::vector<Measurement> buffer(_buffer.size() * 2);
+    const int mask = static_cast<int>(_buffer.size()) - 1;
+    for (int i = 0; i < _size; ++i) {
+        buffer[static_cast<size_t>(i)] = _buffer[static_cast<size_t>((_first + i) & mask)];
+    }
+    _buffer.swap(buffer);
+    _first = 0;
+}
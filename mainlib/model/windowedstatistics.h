@@ -0,0 +1,102 @@
+/*
+ * Copyright (c) 2015 Ilja Booij (ibooij@gmail.com)
+ *
+ * This file is part of Big Ring Indoor Video Cycling
+ *
+ * Big Ring Indoor Video Cycling is free software: you can redistribute
+ * it and/or modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation, either version 3 of the
+ * License, or (at your option) any later version.
+ *
+ * Big Ring Indoor Video Cycling  is distributed in the hope that it will
+ * be useful, but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+
+ * You should have received a copy of the GNU General Public License
+ * along with Big Ring Indoor Video Cycling.  If not, see
+ * <http://www.gnu.org/licenses/>.
+ */
+#ifndef WINDOWEDSTATISTICS_H
+#define WINDOWEDSTATISTICS_H
+
+#include <QtCore/QtGlobal>
+
+#include <vector>
+
+/**
+ * Statistics (sum, mean, minimum and maximum) of the measurements in a sliding time window, like the power of the
+ * last 3 seconds.
+ *
+ * Timestamps are monotonic milliseconds, for instance from a QElapsedTimer. A measurement is in the window if it is
+ * not older than the window duration, relative to the last added measurement. Adding a measurement takes amortized
+ * constant time, all statistics are available in constant time. The sum is kept in double precision, so it does not
+ * drift, even over long rides.
+ */
+class WindowedStatistics
+{
+public:
+    explicit WindowedStatistics(qint64 durationMs);
+
+    /** Add a measurement. Timestamps should not decrease. */
+    void add(qint64 timestampMs, float value);
+    /** Remove all measurements. */
+    void clear();
+
+    /** duration of the window */
+    qint64 durationMs() const;
+    /** number of measurements in the window */
+    int count() const;
+    bool isEmpty() const;
+
+    double sum() const;
+    /** mean of all measurements in the window, or 0 if the window is empty. */
+    float mean() const;
+    /** minimum of all measurements in the window, or 0 if the window is empty. */
+    float minimum() const;
+    /** maximum of all measurements in the window, or 0 if the window is empty. */
+    float maximum() const;
+    /** timestamp of the oldest measurement in the window. Only valid if the window is not empty. */
+    qint64 oldestTimestampMs() const;
+private:
+    struct Measurement {
+        qint64 timestampMs;
+        float value;
+    };
+
+    /**
+     * Double ended queue of measurements in a ring buffer, which grows when it is full. Once the buffer is big enough
+     * for the window, no more memory is allocated.
+     */
+    class MeasurementRing
+    {
+    public:
+        MeasurementRing();
+
+        bool isEmpty() const;
+        int size() const;
+        const Measurement &front() const;
+        const Measurement &back() const;
+        void pushBack(const Measurement &measurement);
+        void popFront();
+        void popBack();
+        void clear();
+    private:
+        void grow();
+
+        std::vector<Measurement> _buffer;
+        int _first;
+        int _size;
+    };
+
+    const qint64 _durationMs;
+    double _sum;
+    /** all measurements in the window */
+    MeasurementRing _measurements;
+    /** measurements that may become the minimum, with increasing values. The front is the current minimum. */
+    MeasurementRing _minimumCandidates;
+    /** measurements that may become the maximum, with decreasing values. The front is the current maximum. */
+    MeasurementRing _maximumCandidates;
+};
+
+#endif // WINDOWEDSTATISTICS_H
@@ -0,0 +1,517 @@
+#include "fitfilewriter.h"
+
+#include <algorithm>
+#include <cmath>
+#include <initializer_list>
+#include <vector>
+
+#include <QtCore/QDir>
+#include <QtCore/QFile>
+#include <QtCore/QtDebug>
+
+#include "config/bigringsettings.h"
+#include "model/trainingmetrics.h"
+
+const qint64 FitFileWriter::FIT_EPOCH_MSECS_SINCE_EPOCH = 631065600000;
+
+namespace {
+const int BUFFER_BYTES = 64 * 1024;
+const quint8 HEADER_SIZE = 14;
+const quint8 PROTOCOL_VERSION = 0x10; // 1.0
+const quint16 PROFILE_VERSION = 2093; // 20.93
+
+const quint8 DEFINITION_MESSAGE_HEADER = 0x40;
+const quint8 LITTLE_ENDIAN_ARCHITECTURE = 0;
+
+// base types
+const quint8 ENUM = 0x00;
+const quint8 UINT8 = 0x02;
+const quint8 UINT16 = 0x84;
+const quint8 SINT32 = 0x85;
+const quint8 UINT32 = 0x86;
+
+// values of FIT enums
+const qint64 FILE_TYPE_ACTIVITY = 4;
+const qint64 MANUFACTURER_DEVELOPMENT = 255;
+const qint64 EVENT_TIMER = 0;
+const qint64 EVENT_SESSION = 8;
+const qint64 EVENT_LAP = 9;
+const qint64 EVENT_ACTIVITY = 26;
+const qint64 EVENT_TYPE_START = 0;
+const qint64 EVENT_TYPE_STOP = 1;
+const qint64 EVENT_TYPE_STOP_ALL = 4;
+const qint64 SPORT_CYCLING = 2;
+const qint64 SUB_SPORT_INDOOR_CYCLING = 6;
+const qint64 ACTIVITY_TYPE_MANUAL = 0;
+
+const qint64 INVALID_SINT32 = 0x7FFFFFFF;
+
+struct FitField
+{
+    quint8 number;
+    quint8 size;
+    quint8 baseType;
+};
+
+struct FitMessage
+{
+    quint8 localType;
+    quint16 globalNumber;
+    const FitField *fields;
+    int fieldCount;
+};
+
+const FitField FILE_ID_FIELDS[] = {
+    { 0, 1, ENUM },     // type
+    { 1, 2, UINT16 },   // manufacturer
+    { 2, 2, UINT16 },   // product
+    { 4, 4, UINT32 }    // time created
+};
+const FitField EVENT_FIELDS[] = {
+    { 253, 4, UINT32 }, // timestamp
+    { 0, 1, ENUM },     // event
+    { 1, 1, ENUM }      // event type
+};
+const FitField RECORD_FIELDS[] = {
+    { 253, 4, UINT32 }, // timestamp
+    { 0, 4, SINT32 },   // latitude (semicircles)
+    { 1, 4, SINT32 },   // longitude (semicircles)
+    { 2, 2, UINT16 },   // altitude (5 * m + 500)
+    { 3, 1, UINT8 },    // heart rate (bpm)
+    { 4, 1, UINT8 },    // cadence (rpm)
+    { 5, 4, UINT32 },   // distance (cm)
+    { 6, 2, UINT16 },   // speed (mm/s)
+    { 7, 2, UINT16 }    // power (W)
+};
+const FitField LAP_FIELDS[] = {
+    { 253, 4, UINT32 }, // timestamp
+    { 0, 1, ENUM },     // event
+    { 1, 1, ENUM },     // event type
+    { 2, 4, UINT32 },   // start time
+    { 7, 4, UINT32 },   // total elapsed time (ms)
+    { 8, 4, UINT32 },   // total timer time (ms)
+    { 9, 4, UINT32 },   // total distance (cm)
+    { 14, 2, UINT16 },  // maximum speed (mm/s)
+    { 15, 1, UINT8 },   // average heart rate (bpm)
+    { 16, 1, UINT8 },   // maximum heart rate (bpm)
+    { 17, 1, UINT8 },   // average cadence (rpm)
+    { 19, 2, UINT16 },  // average power (W)
+    { 20, 2, UINT16 },  // maximum power (W)
+    { 21, 2, UINT16 },  // total ascent (m)
+    { 25, 1, ENUM },    // sport
+    { 33, 2, UINT16 }   // normalized power (W)
+};
+const FitField SESSION_FIELDS[] = {
+    { 253, 4, UINT32 }, // timestamp
+    { 0, 1, ENUM },     // event
+    { 1, 1, ENUM },     // event type
+    { 2, 4, UINT32 },   // start time
+    { 5, 1, ENUM },     // sport
+    { 6, 1, ENUM },     // sub sport
+    { 7, 4, UINT32 },   // total elapsed time (ms)
+    { 8, 4, UINT32 },   // total timer time (ms)
+    { 9, 4, UINT32 },   // total distance (cm)
+    { 15, 2, UINT16 },  // maximum speed (mm/s)
+    { 16, 1, UINT8 },   // average heart rate (bpm)
+    { 17, 1, UINT8 },   // maximum heart rate (bpm)
+    { 18, 1, UINT8 },   // average cadence (rpm)
+    { 20, 2, UINT16 },  // average power (W)
+    { 21, 2, UINT16 },  // maximum power (W)
+    { 25, 2, UINT16 },  // first lap index
+    { 26, 2, UINT16 },  // number of laps
+    { 34, 2, UINT16 },  // normalized power (W)
+    { 35, 2, UINT16 },  // training stress score (10 * TSS)
+    { 36, 2, UINT16 },  // intensity factor (1000 * IF)
+    { 45, 2, UINT16 }   // threshold power (W)
+};
+const FitField ACTIVITY_FIELDS[] = {
+    { 253, 4, UINT32 }, // timestamp
+    { 0, 4, UINT32 },   // total timer time (ms)
+    { 1, 2, UINT16 },   // number of sessions
+    { 2, 1, ENUM },     // type
+    { 3, 1, ENUM },     // event
+    { 4, 1, ENUM },     // event type
+    { 5, 4, UINT32 }    // local timestamp
+};
+
+template <int N>
+FitMessage fitMessage(quint8 localType, quint16 globalNumber, const FitField (&fields)[N])
+{
+    return { localType, globalNumber, fields, N };
+}
+
+const FitMessage FILE_ID = fitMessage(0, 0, FILE_ID_FIELDS);
+const FitMessage EVENT = fitMessage(1, 21, EVENT_FIELDS);
+const FitMessage RECORD = fitMessage(2, 20, RECORD_FIELDS);
+const FitMessage LAP = fitMessage(3, 19, LAP_FIELDS);
+const FitMessage SESSION = fitMessage(4, 18, SESSION_FIELDS);
+const FitMessage ACTIVITY = fitMessage(5, 34, ACTIVITY_FIELDS);
+
+qint64 definitionSize(const FitMessage &message)
+{
+    return 1 + 5 + 3 * message.fieldCount;
+}
+
+qint64 dataSize(const FitMessage &message)
+{
+    qint64 size = 1;
+    for (int i = 0; i < message.fieldCount; ++i) {
+        size += message.fields[i].size;
+    }
+    return size;
+}
+
+/** the CRC of the FIT protocol, calculated per nibble. */
+quint16 updateCrc(quint16 crc, quint8 byte)
+{
+    static const quint16 CRC_TABLE[16] = {
+        0x0000, 0xCC01, 0xD801, 0x1400, 0xF001, 0x3C00, 0x2800, 0xE401,
+        0xA001, 0x6C00, 0x7800, 0xB401, 0x5000, 0x9C01, 0x8801, 0x4400
+    };
+    quint16 tmp = CRC_TABLE[crc & 0xF];
+    crc = (crc >> 4) & 0x0FFF;
+    crc = crc ^ tmp ^ CRC_TABLE[byte & 0xF];
+    tmp = CRC_TABLE[crc & 0xF];
+    crc = (crc >> 4) & 0x0FFF;
+    return crc ^ tmp ^ CRC_TABLE[(byte >> 4) & 0xF];
+}
+
+/**
+ * Output for a FIT file. Bytes are added to a buffer, which is written to the device when it is full. The CRC of the
+ * file is calculated while bytes are added.
+ */
+class FitOutput
+{
+public:
+    explicit FitOutput(QIODevice &device): _device(device), _buffer(BUFFER_BYTES), _used(0), _crc(0), _ok(true) {}
+
+    void writeHeader(quint32 dataSize);
+    void writeDefinition(const FitMessage &message);
+    /** write a data message, with a value for every field of the message. */
+    void writeData(const FitMessage &message, std::initializer_list<qint64> values);
+    /** write the CRC of the file and all remaining output. Returns false if any of the output could not be written. */
+    bool finish();
+private:
+    void appendValue(qint64 value, int size);
+    void flushBuffer();
+
+    QIODevice &_device;
+    std::vector<char> _buffer;
+    int _used;
+    quint16 _crc;
+    bool _ok;
+};
+
+void FitOutput::writeHeader(quint32 dataSize)
+{
+    appendValue(HEADER_SIZE, 1);
+    appendValue(PROTOCOL_VERSION, 1);
+    appendValue(PROFILE_VERSION, 2);
+    appendValue(dataSize, 4);
+    for (char c: { '.', 'F', 'I', 'T' }) {
+        appendValue(c, 1);
+    }
+    // the CRC of the header is calculated over the bytes before it, which is the CRC of the file up to now.
+    appendValue(_crc, 2);
+}
+
+void FitOutput::writeDefinition(const FitMessage &message)
+{
+    appendValue(DEFINITION_MESSAGE_HEADER | message.localType, 1);
+    appendValue(0, 1); // reserved
+    appendValue(LITTLE_ENDIAN_ARCHITECTURE, 1);
+    appendValue(message.globalNumber, 2);
+    appendValue(message.fieldCount, 1);
+    for (int i = 0; i < message.fieldCount; ++i) {
+        appendValue(message.fields[i].number, 1);
+        appendValue(message.fields[i].size, 1);
+        appendValue(message.fields[i].baseType, 1);
+    }
+}
+
+void FitOutput::writeData(const FitMessage &message, std::initializer_list<qint64> values)
+{
+    Q_ASSERT(static_cast<int>(values.size()) == message.fieldCount);
+    appendValue(message.localType, 1);
+    const FitField *field = message.fields;
+    for (const qint64 value: values) {
+        appendValue(value, field->size);
+        ++field;
+    }
+}
+
+bool FitOutput::finish()
+{
+    appendValue(_crc, 2);
+    flushBuffer();
+    return _ok;
+}
+
+void FitOutput::appendValue(qint64 value, int size)
+{
+    if (_used + size > BUFFER_BYTES) {
+        flushBuffer();
+    }
+    for (int i = 0; i < size; ++i) {
+        const quint8 byte = static_cast<quint8>(value >> (8 * i));
+        _buffer[_used++] = static_cast<char>(byte);
+        _crc = updateCrc(_crc, byte);
+    }
+}
+
+void FitOutput::flushBuffer()
+{
+    if (_used > 0 && _device.write(_buffer.data(), _used) != _used) {
+        _ok = false;
+    }
+    _used = 0;
+}
+
+qint64 bounded(double value, qint64 maximum)
+{
+    if (!std::isfinite(value)) {
+        return maximum + 1;
+    }
+    return qBound<qint64>(0, std::llround(value), maximum);
+}
+
+qint64 semicircles(double degrees)
+{
+    return std::llround(degrees * (2147483648.0 / 180.0));
+}
+
+/** Totals of a ride, for the lap and session messages. */
+struct RideSummary
+{
+    qint64 averageHeartRate;
+    qint64 maximumHeartRate;
+    qint64 averageCadence;
+    qint64 averagePower;
+    qint64 maximumPower;
+    qint64 maximumSpeed;
+    qint64 normalizedPower;
+    qint64 trainingStressScore;
+    qint64 intensityFactor;
+    qint64 thresholdPower;
+};
+
+RideSummary summarize(const TrainingMetrics &metrics)
+{
+    return { bounded(metrics.averageHeartRate(), 254), bounded(metrics.maximumHeartRate(), 254),
+                bounded(metrics.averageCadence(), 254), bounded(metrics.averagePower(), 0xFFFE),
+                bounded(metrics.maximumPower(), 0xFFFE), bounded(metrics.maximumSpeed() * 1000.0, 0xFFFE),
+                bounded(metrics.normalizedPower(), 0xFFFE), bounded(metrics.trainingStressScore() * 10.0, 0xFFFE),
+                bounded(metrics.intensityFactor() * 1000.0, 0xFFFE),
+                bounded(metrics.functionalThresholdPower(), 0xFFFE) };
+}
+
+/** timestamp of the record of a sample, relative to the start of the ride in whole seconds. */
+qint64 recordSecond(const RideFile::Sample &sample)
+{
+    return sample.time.msecsSinceStartOfDay() / 1000;
+}
+
+/**
+ * FIT timestamps are in whole seconds, so rides that are recorded at more than 1 Hz are written with a record for the
+ * first sample of every second. Returns true if sample should be written.
+ */
+bool isRecordSample(const std::vector<RideFile::Sample> &samples, std::size_t index)
+{
+    return index == 0 || recordSecond(samples[index]) > recordSecond(samples[index - 1]);
+}
+
+/** A lap of the ride, from sample firstSample up to, but not including, endSample. */
+struct Lap
+{
+    std::size_t firstSample;
+    std::size_t endSample;
+};
+
+/**
+ * Split the ride in laps at the climbs. Every climb, from its start up to and including its top, is a lap, and so
+ * is every part of the ride before, between and after the climbs. A ride without climbs has a single lap.
+ */
+std::vector<Lap> lapsForClimbs(const std::vector<TrainingMetrics::Climb> &climbs, std::size_t numberOfSamples)
+{
+    std::vector<std::size_t> boundaries = { 0 };
+    for (const TrainingMetrics::Climb &climb: climbs) {
+        boundaries.push_back(static_cast<std::size_t>(climb.startSample));
+        boundaries.push_back(static_cast<std::size_t>(climb.topSample) + 1);
+    }
+    boundaries.push_back(numberOfSamples);
+
+    std::vector<Lap> laps;
+    for (std::size_t i = 1; i < boundaries.size(); ++i) {
+        if (boundaries[i] > boundaries[i - 1]) {
+            laps.push_back({ boundaries[i - 1], boundaries[i] });
+        }
+    }
+    if (laps.empty()) {
+        laps.push_back({ 0, 0 });
+    }
+    return laps;
+}
+
+/** Sum of the altitude gained between the samples of a lap, and from the sample before the lap, in meters. */
+qint64 totalAscent(const std::vector<RideFile::Sample> &samples, const Lap &lap)
+{
+    double ascent = 0;
+    for (std::size_t i = qMax<std::size_t>(lap.firstSample, 1); i < lap.endSample; ++i) {
+        ascent += qMax(0.0f, samples[i].altitude - samples[i - 1].altitude);
+    }
+    return bounded(ascent, 0xFFFE);
+}
+}
+
+FitFileWriter::FitFileWriter(QObject *parent):
+    FitFileWriter(BigRingSettings().functionalThresholdPower(), BigRingSettings().anaerobicWorkCapacity(), parent)
+{
+    // empty
+}
+
+FitFileWriter::FitFileWriter(int functionalThresholdPower, int anaerobicWorkCapacity, QObject *parent):
+    QObject(parent), _functionalThresholdPower(functionalThresholdPower), _anaerobicWorkCapacity(anaerobicWorkCapacity)
+{
+    // empty
+}
+
+const QString FitFileWriter::writeRideFile(const RideFile &rideFile, std::function<void(int)> progressFunction)
+{
+    progressFunction(0);
+    const QString filePath = determineFilePath(rideFile);
+
+    QFile outputFile(filePath);
+    if (!outputFile.open(QFile::WriteOnly)) {
+        qWarning("Unable to open %s: %s", qPrintable(filePath), qPrintable(outputFile.errorString()));
+        return QString();
+    }
+    if (!writeFit(rideFile, outputFile, progressFunction)) {
+        qWarning("Unable to write %s: %s", qPrintable(filePath), qPrintable(outputFile.errorString()));
+        return QString();
+    }
+    return filePath;
+}
+
+bool FitFileWriter::writeFit(const RideFile &rideFile, QIODevice &output, std::function<void(int)> progressFunction) const
+{
+    const std::vector<RideFile::Sample> &samples = rideFile.samples();
+    const qint64 startTimeMsecs = rideFile.startTime().toMSecsSinceEpoch();
+    const qint64 startTime = (startTimeMsecs - FIT_EPOCH_MSECS_SINCE_EPOCH) / 1000;
+    const qint64 elapsedMsecs = rideFile.durationInMilliSeconds();
+    const qint64 endTime = startTime + elapsedMsecs / 1000;
+    const qint64 localEndTime = endTime + rideFile.startTime().toLocalTime().offsetFromUtc();
+    const qint64 totalDistance = bounded(rideFile.totalDistance() * 100.0, 0xFFFFFFFE);
+    const TrainingMetrics metrics = TrainingMetrics::forRideFile(rideFile, _functionalThresholdPower,
+                                                                 _anaerobicWorkCapacity);
+    const RideSummary summary = summarize(metrics);
+    const std::vector<Lap> laps = lapsForClimbs(metrics.climbs(), samples.size());
+    qint64 numberOfRecords = 0;
+    for (std::size_t i = 0; i < samples.size(); ++i) {
+        if (isRecordSample(samples, i)) {
+            ++numberOfRecords;
+        }
+    }
+
+    const qint64 size = definitionSize(FILE_ID) + dataSize(FILE_ID)
+            + definitionSize(EVENT) + 2 * dataSize(EVENT)
+            + definitionSize(RECORD) + numberOfRecords * dataSize(RECORD)
+            + definitionSize(LAP) + static_cast<qint64>(laps.size()) * dataSize(LAP)
+            + definitionSize(SESSION) + dataSize(SESSION)
+            + definitionSize(ACTIVITY) + dataSize(ACTIVITY);
+
+    FitOutput fitOutput(output);
+    fitOutput.writeHeader(static_cast<quint32>(size));
+
+    fitOutput.writeDefinition(FILE_ID);
+    fitOutput.writeData(FILE_ID, { FILE_TYPE_ACTIVITY, MANUFACTURER_DEVELOPMENT, 0, startTime });
+    fitOutput.writeDefinition(EVENT);
+    fitOutput.writeData(EVENT, { startTime, EVENT_TIMER, EVENT_TYPE_START });
+
+    fitOutput.writeDefinition(RECORD);
+    int percentage = 0;
+    for (std::size_t i = 0; i < samples.size(); ++i) {
+        if (!isRecordSample(samples, i)) {
+            continue;
+        }
+        const RideFile::Sample &sample = samples[i];
+        const bool validPosition = sample.position.isValid();
+        fitOutput.writeData(RECORD, {
+                                startTime + recordSecond(sample),
+                                validPosition ? semicircles(sample.position.latitude()) : INVALID_SINT32,
+                                validPosition ? semicircles(sample.position.longitude()) : INVALID_SINT32,
+                                bounded((sample.altitude + 500.0) * 5.0, 0xFFFE),
+                                bounded(sample.heartRate, 254),
+                                bounded(sample.cadence, 254),
+                                bounded(sample.distance * 100.0, 0xFFFFFFFE),
+                                bounded(sample.speed * 1000.0, 0xFFFE),
+                                bounded(sample.power, 0xFFFE) });
+        const int newPercentage = static_cast<int>(i * 100 / samples.size());
+        if (newPercentage != percentage) {
+            percentage = newPercentage;
+            progressFunction(percentage);
+        }
+    }
+    fitOutput.writeData(EVENT, { endTime, EVENT_TIMER, EVENT_TYPE_STOP_ALL });
+
+    fitOutput.writeDefinition(LAP);
+    // a lap starts at the time and distance of its first sample, the first lap at the start of the ride. It ends
+    // where the next lap starts, the last lap at the end of the ride.
+    auto lapBoundaryMsecs = [&samples, elapsedMsecs](std::size_t sampleIndex) -> qint64 {
+        if (sampleIndex == 0) {
+            return 0;
+        }
+        return (sampleIndex < samples.size()) ? samples[sampleIndex].time.msecsSinceStartOfDay() : elapsedMsecs;
+    };
+    auto lapBoundaryDistance = [&samples, &rideFile](std::size_t sampleIndex) -> double {
+        if (sampleIndex == 0) {
+            return 0;
+        }
+        return (sampleIndex < samples.size()) ? samples[sampleIndex].distance : rideFile.totalDistance();
+    };
+    for (const Lap &lap: laps) {
+        TrainingMetrics lapMetrics(_functionalThresholdPower, _anaerobicWorkCapacity);
+        for (std::size_t i = lap.firstSample; i < lap.endSample; ++i) {
+            lapMetrics.addSample(samples[i]);
+        }
+        const RideSummary lapSummary = summarize(lapMetrics);
+        const qint64 lapStartMsecs = lapBoundaryMsecs(lap.firstSample);
+        const qint64 lapEndMsecs = lapBoundaryMsecs(lap.endSample);
+        const qint64 lapElapsedMsecs = lapEndMsecs - lapStartMsecs;
+        const qint64 lapDistance = bounded((lapBoundaryDistance(lap.endSample) - lapBoundaryDistance(lap.firstSample))
+                                           * 100.0, 0xFFFFFFFE);
+        fitOutput.writeData(LAP, { startTime + lapEndMsecs / 1000, EVENT_LAP, EVENT_TYPE_STOP,
+                                   startTime + lapStartMsecs / 1000, lapElapsedMsecs, lapElapsedMsecs, lapDistance,
+                                   lapSummary.maximumSpeed, lapSummary.averageHeartRate, lapSummary.maximumHeartRate,
+                                   lapSummary.averageCadence, lapSummary.averagePower, lapSummary.maximumPower,
+                                   totalAscent(samples, lap), SPORT_CYCLING, lapSummary.normalizedPower });
+    }
+    fitOutput.writeDefinition(SESSION);
+    fitOutput.writeData(SESSION, { endTime, EVENT_SESSION, EVENT_TYPE_STOP, startTime, SPORT_CYCLING,
+                                   SUB_SPORT_INDOOR_CYCLING, elapsedMsecs, elapsedMsecs, totalDistance,
+                                   summary.maximumSpeed, summary.averageHeartRate, summary.maximumHeartRate,
+                                   summary.averageCadence, summary.averagePower, summary.maximumPower, 0,
+                                   static_cast<qint64>(laps.size()),
+                                   summary.normalizedPower, summary.trainingStressScore, summary.intensityFactor,
+                                   summary.thresholdPower });
+    fitOutput.writeDefinition(ACTIVITY);
+    fitOutput.writeData(ACTIVITY, { endTime, elapsedMsecs, 1, ACTIVITY_TYPE_MANUAL, EVENT_ACTIVITY, EVENT_TYPE_STOP,
+                                    localEndTime });
+
+    const bool written = fitOutput.finish();
+    progressFunction(100);
+    return written;
+}
+
+QString FitFileWriter::determineFilePath(const RideFile &rideFile) const
+{
+    QDir rideFileDir(BigRingSettings().tcxFolder());
+    if (!rideFileDir.exists()) {
+        if (!rideFileDir.mkpath(".")) {
+            qDebug() << "Unable to create directory" << rideFileDir.absolutePath();
+        }
+    }
+
+    const QString filename = QString("%1.fit").arg(rideFile.startTime().toString("yyyy_MM_dd_HH_mm_ss"));
+
+    return rideFileDir.filePath(filename);
+}
@@ -0,0 +1,60 @@
+#ifndef FITFILEWRITER_H
+#define FITFILEWRITER_H
+
+#include <functional>
+#include <QtCore/QIODevice>
+#include <QtCore/QObject>
+
+#include "model/ridefile.h"
+
+/**
+ * @brief The FitFileWriter class, used for writing a RideFile to a FIT file.
+ *
+ * FIT is the binary activity format of Garmin, which is a lot smaller, and faster to parse, than TCX. The file contains
+ * a file id, timer start and stop events, a record for every sample, and a single lap, session and activity.
+ *
+ * All messages have a fixed size, so the size of the file is known before it is written, and the file can be written
+ * in a single pass through a small buffer.
+ */
+class FitFileWriter: public QObject
+{
+    Q_OBJECT
+public:
+    /** Create a FitFileWriter, with the FTP and W' of the cyclist from the settings. */
+    explicit FitFileWriter(QObject *parent = 0);
+    /**
+     * Create a FitFileWriter.
+     * @param functionalThresholdPower FTP of the cyclist in watts, for intensity factor and TSS.
+     * @param anaerobicWorkCapacity W' of the cyclist in joules.
+     */
+    explicit FitFileWriter(int functionalThresholdPower, int anaerobicWorkCapacity, QObject *parent = 0);
+    virtual ~FitFileWriter() {}
+
+    /**
+     * Write the RideFile to disk, next to the TCX file.
+     * @param rideFile the RideFile to write.
+     * @param progressFunction a function which takes a percentage, to update a progress bar for instance.
+     * @return the path to the newly written file, or an empty string if the file could not be written.
+     */
+    const QString writeRideFile(const RideFile &rideFile, std::function<void(int)> progressFunction = [](int) {});
+    /**
+     * Write the RideFile as FIT to a device.
+     * @return true if the complete file was written.
+     */
+    bool writeFit(const RideFile &rideFile, QIODevice &output,
+                  std::function<void(int)> progressFunction = [](int) {}) const;
+    /**
+     * @brief determines the path to the RideFile.
+     * @param rideFile the RideFile.
+     * @return the path where the file will be written.
+     */
+    QString determineFilePath(const RideFile &rideFile) const;
+
+    /** FIT timestamps are seconds since 1989-12-31T00:00:00Z */
+    static const qint64 FIT_EPOCH_MSECS_SINCE_EPOCH;
+private:
+    const int _functionalThresholdPower;
+    const int _anaerobicWorkCapacity;
+};
+
+#endif // FITFILEWRITER_H
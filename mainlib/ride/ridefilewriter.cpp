@@ -1,144 +1,347 @@
 #include "ridefilewriter.h"
 
+#include <cmath>
+#include <cstring>
+#include <vector>
+
 #include <QtCore/QDir>
-#include <QtCore/QJsonDocument>
+#include <QtCore/QFile>
 #include <QtCore/QStandardPaths>
 #include <QtCore/QtDebug>
 
+#include <zlib.h>
+
 #include "config/bigringsettings.h"
 
 namespace {
-const QString DATE_TIME_FORMAT_WITH_MILLIS = "yyyy-MM-ddTHH:mm:ss.zzz";
-const QString DATE_TIME_FORMAT_WITHOUT_MILLIS = "yyyy-MM-ddTHH:mm:ss";
+const int BUFFER_BYTES = 64 * 1024;
+const qint64 MSECS_PER_DAY = 24 * 60 * 60 * 1000;
+const qint64 DECIMAL_SCALES[] = { 1, 10, 100, 1000, 10000, 100000, 1000000, 10000000, 100000000, 1000000000,
+                                  10000000000 };
+/** values that are larger than this can not be formatted with 10 decimals in a 64 bit integer. */
+const double MAXIMUM_DECIMAL_VALUE = 1e8;
+
+/**
+ * Output for a TCX file. Text is added to a buffer, which is written to the device, compressed with gzip if
+ * needed, when it is full.
+ */
+class TcxOutput
+{
+public:
+    TcxOutput(QIODevice &device, RideFileWriter::Compression compression);
+    ~TcxOutput();
+
+    template <int N>
+    void append(const char (&text)[N]) {
+        append(text, N - 1);
+    }
+    void append(const char *data, int size);
+    void appendInteger(qint64 value);
+    /** append a value with at most decimals decimals, without trailing zeros. */
+    void appendDecimal(double value, int decimals);
+    /** append a time as an ISO 8601 UTC date time, like 2015-03-08T12:00:01.250Z */
+    void appendTime(qint64 msecsSinceEpoch, bool withMillis);
+
+    /** write all remaining output. Returns false if any of the output could not be written. */
+    bool finish();
+private:
+    void appendPadded(qint64 value, int width);
+    void flushBuffer(int flush);
+
+    QIODevice &_device;
+    const bool _gzip;
+    z_stream _stream;
+    std::vector<char> _buffer;
+    int _used;
+    std::vector<char> _compressed;
+    bool _ok;
+};
+
+TcxOutput::TcxOutput(QIODevice &device, RideFileWriter::Compression compression):
+    _device(device), _gzip(compression == RideFileWriter::Compression::GZIP), _stream(), _buffer(BUFFER_BYTES),
+    _used(0), _ok(true)
+{
+    if (_gzip) {
+        _compressed.resize(BUFFER_BYTES);
+        // 16 added to the window bits makes zlib write a gzip header and trailer.
+        _ok = (deflateInit2(&_stream, Z_DEFAULT_COMPRESSION, Z_DEFLATED, 15 + 16, 8, Z_DEFAULT_STRATEGY) == Z_OK);
+    }
 }
-RideFileWriter::RideFileWriter(QObject *parent): QObject(parent)
+
+TcxOutput::~TcxOutput()
 {
-    // empty
+    if (_gzip) {
+        deflateEnd(&_stream);
+    }
 }
 
-const QString RideFileWriter::writeRideFile(const RideFile &rideFile, std::function<void(int)> progressFunction)
+void TcxOutput::append(const char *data, int size)
 {
-    progressFunction(0);
-    const QString filePath = determineFilePath(rideFile);
+    if (_used + size > BUFFER_BYTES) {
+        flushBuffer(Z_NO_FLUSH);
+    }
+    std::memcpy(_buffer.data() + _used, data, size);
+    _used += size;
+}
 
-    QFile outputFile(filePath);
-    outputFile.open(QFile::WriteOnly);
+void TcxOutput::appendInteger(qint64 value)
+{
+    char digits[20];
+    int index = sizeof(digits);
+    const bool negative = (value < 0);
+    quint64 remaining = negative ? -static_cast<quint64>(value) : static_cast<quint64>(value);
+    do {
+        digits[--index] = static_cast<char>('0' + remaining % 10);
+        remaining /= 10;
+    } while (remaining > 0);
+    if (negative) {
+        append("-");
+    }
+    append(digits + index, sizeof(digits) - index);
+}
 
-    writeTcx(rideFile, outputFile, progressFunction);
+void TcxOutput::appendDecimal(double value, int decimals)
+{
+    if (!std::isfinite(value) || std::fabs(value) >= MAXIMUM_DECIMAL_VALUE) {
+        append("0");
+        return;
+    }
+    const qint64 scale = DECIMAL_SCALES[decimals];
+    qint64 scaled = std::llround(value * scale);
+    if (scaled < 0) {
+        append("-");
+        scaled = -scaled;
+    }
+    appendInteger(scaled / scale);
+    qint64 fraction = scaled % scale;
+    if (fraction == 0) {
+        return;
+    }
+    int digits = decimals;
+    while (fraction % 10 == 0) {
+        fraction /= 10;
+        --digits;
+    }
+    append(".");
+    appendPadded(fraction, digits);
+}
 
-    return filePath;
+/**
+ * The date is calculated from the number of days since the epoch with the civil_from_days algorithm by Howard
+ * Hinnant, which avoids creating a QDateTime and formatting it for every track point.
+ */
+void TcxOutput::appendTime(qint64 msecsSinceEpoch, bool withMillis)
+{
+    qint64 days = msecsSinceEpoch / MSECS_PER_DAY;
+    qint64 msecsOfDay = msecsSinceEpoch % MSECS_PER_DAY;
+    if (msecsOfDay < 0) {
+        msecsOfDay += MSECS_PER_DAY;
+        days -= 1;
+    }
+    days += 719468;
+    const qint64 era = (days >= 0 ? days : days - 146096) / 146097;
+    const qint64 dayOfEra = days - era * 146097;
+    const qint64 yearOfEra = (dayOfEra - dayOfEra / 1460 + dayOfEra / 36524 - dayOfEra / 146096) / 365;
+    const qint64 dayOfYear = dayOfEra - (365 * yearOfEra + yearOfEra / 4 - yearOfEra / 100);
+    const qint64 monthFromMarch = (5 * dayOfYear + 2) / 153;
+    const qint64 day = dayOfYear - (153 * monthFromMarch + 2) / 5 + 1;
+    const qint64 month = (monthFromMarch < 10) ? monthFromMarch + 3 : monthFromMarch - 9;
+    const qint64 year = yearOfEra + era * 400 + ((month <= 2) ? 1 : 0);
+
+    appendPadded(year, 4);
+    append("-");
+    appendPadded(month, 2);
+    append("-");
+    appendPadded(day, 2);
+    append("T");
+    appendPadded(msecsOfDay / 3600000, 2);
+    append(":");
+    appendPadded((msecsOfDay / 60000) % 60, 2);
+    append(":");
+    appendPadded((msecsOfDay / 1000) % 60, 2);
+    if (withMillis) {
+        append(".");
+        appendPadded(msecsOfDay % 1000, 3);
+    }
+    append("Z");
 }
 
-QString RideFileWriter::dateTimeString(const QDateTime dateTime, bool withMillis) const
+bool TcxOutput::finish()
 {
-    const QString &format = (withMillis) ? DATE_TIME_FORMAT_WITH_MILLIS : DATE_TIME_FORMAT_WITHOUT_MILLIS;
+    flushBuffer(Z_FINISH);
+    return _ok;
+}
 
-    return dateTime.toString(format) + "Z";
+void TcxOutput::appendPadded(qint64 value, int width)
+{
+    char digits[20];
+    for (int i = width - 1; i >= 0; --i) {
+        digits[i] = static_cast<char>('0' + value % 10);
+        value /= 10;
+    }
+    append(digits, width);
 }
 
-QString RideFileWriter::determineFilePath(const RideFile &rideFile) const
+void TcxOutput::flushBuffer(int flush)
 {
-    QDir tcxDir(BigRingSettings().tcxFolder());
-    if (!tcxDir.exists()) {
-        if (!tcxDir.mkpath(".")) {
-            qDebug() << "Unable to create directory" << tcxDir.absolutePath();
+    if (!_gzip) {
+        if (_used > 0 && _device.write(_buffer.data(), _used) != _used) {
+            _ok = false;
         }
+        _used = 0;
+        return;
     }
-
-    const QString filename = QString("%1.tcx").arg(rideFile.startTime().toString("yyyy_MM_dd_HH_mm_ss"));
-
-    return tcxDir.filePath(filename);
+    _stream.next_in = reinterpret_cast<Bytef*>(_buffer.data());
+    _stream.avail_in = static_cast<uInt>(_used);
+    int result;
+    do {
+        _stream.next_out = reinterpret_cast<Bytef*>(_compressed.data());
+        _stream.avail_out = static_cast<uInt>(_compressed.size());
+        result = deflate(&_stream, flush);
+        const qint64 compressedBytes = static_cast<qint64>(_compressed.size() - _stream.avail_out);
+        if (result == Z_STREAM_ERROR
+                || (compressedBytes > 0 && _device.write(_compressed.data(), compressedBytes) != compressedBytes)) {
+            _ok = false;
+            break;
+        }
+    } while (_stream.avail_out == 0 || (flush == Z_FINISH && result != Z_STREAM_END));
+    _used = 0;
 }
 
-void RideFileWriter::writeTcx(const RideFile &rideFile, QFile &outputFile, std::function<void(int)> &progressFunction)
+void writeLapSummary(TcxOutput &output, const RideFile &rideFile)
 {
-    QXmlStreamWriter writer(&outputFile);
+    output.append("      <Lap StartTime=\"");
+    output.appendTime(rideFile.startTime().toMSecsSinceEpoch(), false);
+    output.append("\">\n        <TotalTimeSeconds>");
+    output.appendDecimal(rideFile.durationInMilliSeconds() / 1000.0, 3);
+    output.append("</TotalTimeSeconds>\n        <DistanceMeters>");
+    output.appendDecimal(rideFile.totalDistance(), 2);
+    output.append("</DistanceMeters>\n        <MaximumSpeed>");
+    output.appendDecimal(rideFile.maximumSpeedInMps(), 3);
+    output.append("</MaximumSpeed>\n        <MaximumHeartRateBpm>\n          <Value>");
+    output.appendInteger(rideFile.maximumHeartRate());
+    output.append("</Value>\n        </MaximumHeartRateBpm>\n");
+}
 
-    writer.setAutoFormatting(true);
-    writer.writeStartDocument();
+/**
+ * Write a single track point. Power and speed are put inside a TPX element, which is inside an Extensions element.
+ */
+void writeTrackPoint(TcxOutput &output, qint64 startTimeMsecsSinceEpoch, const RideFile::Sample &sample)
+{
+    output.append("          <Trackpoint>\n            <Time>");
+    output.appendTime(startTimeMsecsSinceEpoch + sample.time.msecsSinceStartOfDay(), true);
+    output.append("</Time>\n");
+    if (sample.position.isValid()) {
+        output.append("            <Position>\n              <LatitudeDegrees>");
+        output.appendDecimal(sample.position.latitude(), 10);
+        output.append("</LatitudeDegrees>\n              <LongitudeDegrees>");
+        output.appendDecimal(sample.position.longitude(), 10);
+        output.append("</LongitudeDegrees>\n            </Position>\n");
+    }
+    output.append("            <AltitudeMeters>");
+    output.appendDecimal(sample.altitude, 2);
+    output.append("</AltitudeMeters>\n            <DistanceMeters>");
+    output.appendDecimal(sample.distance, 2);
+    output.append("</DistanceMeters>\n            <Cadence>");
+    output.appendInteger(sample.cadence);
+    output.append("</Cadence>\n"
+                  "            <HeartRateBpm xsi:type=\"HeartRateInBeatsPerMinute_t\">\n"
+                  "              <Value>");
+    output.appendInteger(sample.heartRate);
+    output.append("</Value>\n"
+                  "            </HeartRateBpm>\n"
+                  "            <Extensions>\n"
+                  "              <TPX xmlns=\"http://www.garmin.com/xmlschemas/ActivityExtension/v2\">\n"
+                  "                <Speed>");
+    output.appendDecimal(sample.speed, 3);
+    output.append("</Speed>\n                <Watts>");
+    output.appendInteger(sample.power);
+    output.append("</Watts>\n"
+                  "              </TPX>\n"
+                  "            </Extensions>\n"
+                  "          </Trackpoint>\n");
+}
+}
 
-    writer.writeStartElement("TrainingCenterDatabase");
-    writer.writeAttribute("xmlns", "http://www.garmin.com/xmlschemas/TrainingCenterDatabase/v2");
-    writer.writeAttribute("xmlns:xsi", "http://www.w3.org/2001/XMLSchema-instance");
-    writer.writeAttribute("xsi:schemaLocation", "http://www.garmin.com/xmlschemas/TrainingCenterDatabase/v2 http://www.garmin.com/xmlschemas/TrainingCenterDatabasev2.xsd");
-    writer.writeStartElement("Activities");
-    writer.writeStartElement("Activity");
-    writer.writeAttribute("Sport", "Biking");
+RideFileWriter::RideFileWriter(QObject *parent):
+    RideFileWriter(BigRingSettings().compressRideFiles() ? Compression::GZIP : Compression::NONE, parent)
+{
+    // empty
+}
 
-    writer.writeTextElement("Id", dateTimeString(rideFile.startTime()));
-    writer.writeStartElement("Lap");
+RideFileWriter::RideFileWriter(Compression compression, QObject *parent): QObject(parent), _compression(compression)
+{
+    // empty
+}
 
-    writeLapSummary(writer, rideFile);
+const QString RideFileWriter::writeRideFile(const RideFile &rideFile, std::function<void(int)> progressFunction)
+{
+    progressFunction(0);
+    const QString filePath = determineFilePath(rideFile);
 
-    writer.writeStartElement("Track");
-    int nrOfSamples = rideFile.samples().size();
-    int i = 0;
-    for (const RideFile::Sample &sample: rideFile.samples()) {
-        writeTrackPoint(writer, rideFile.startTime(), sample);
-        progressFunction(i++ * 100 / nrOfSamples);
+    QFile outputFile(filePath);
+    if (!outputFile.open(QFile::WriteOnly)) {
+        qWarning("Unable to open %s: %s", qPrintable(filePath), qPrintable(outputFile.errorString()));
+        return QString();
     }
-    writer.writeEndElement(); // Track
-    writer.writeEndElement(); // Lap
-    writer.writeEndElement(); // Activity
-    writer.writeEndElement(); // Activities
-    writer.writeEndElement(); // TrainingCenterDatabase
-
-    writer.writeEndDocument();
+    if (!writeTcx(rideFile, outputFile, progressFunction)) {
+        qWarning("Unable to write %s: %s", qPrintable(filePath), qPrintable(outputFile.errorString()));
+        return QString();
+    }
+    return filePath;
 }
 
-/**
- * Write the summary for the lap. As we put everything in one lap, this will just use the values from the ride file.
- */
-void RideFileWriter::writeLapSummary(QXmlStreamWriter &writer, const RideFile &rideFile)
+bool RideFileWriter::writeTcx(const RideFile &rideFile, QIODevice &output,
+                              std::function<void(int)> progressFunction) const
 {
-    writer.writeAttribute("StartTime", dateTimeString(rideFile.startTime()));
-    const int msecs = rideFile.durationInMilliSeconds();
+    TcxOutput tcxOutput(output, _compression);
+    const qint64 startTime = rideFile.startTime().toMSecsSinceEpoch();
 
-    writer.writeTextElement("TotalTimeSeconds", QString("%1.%2").arg(msecs / 1000).arg(msecs / 10));
-    writer.writeTextElement("DistanceMeters", QString::number(rideFile.totalDistance()));
+    tcxOutput.append("<?xml version=\"1.0\" encoding=\"UTF-8\"?>\n"
+                     "<TrainingCenterDatabase xmlns=\"http://www.garmin.com/xmlschemas/TrainingCenterDatabase/v2\" "
+                     "xmlns:xsi=\"http://www.w3.org/2001/XMLSchema-instance\" "
+                     "xsi:schemaLocation=\"http://www.garmin.com/xmlschemas/TrainingCenterDatabase/v2 "
+                     "http://www.garmin.com/xmlschemas/TrainingCenterDatabasev2.xsd\">\n"
+                     "  <Activities>\n"
+                     "    <Activity Sport=\"Biking\">\n"
+                     "      <Id>");
+    tcxOutput.appendTime(startTime, false);
+    tcxOutput.append("</Id>\n");
 
-    writer.writeTextElement("MaximumSpeed", QString::number(rideFile.maximumSpeedInMps()));
+    writeLapSummary(tcxOutput, rideFile);
 
-    writer.writeStartElement("MaximumHeartRateBpm");
-    writer.writeTextElement("Value", QString::number(rideFile.maximumHeartRate()));
-    writer.writeEndElement();
+    tcxOutput.append("        <Track>\n");
+    const std::size_t nrOfSamples = rideFile.samples().size();
+    int percentage = 0;
+    for (std::size_t i = 0; i < nrOfSamples; ++i) {
+        writeTrackPoint(tcxOutput, startTime, rideFile.samples()[i]);
+        const int newPercentage = static_cast<int>(i * 100 / nrOfSamples);
+        if (newPercentage != percentage) {
+            percentage = newPercentage;
+            progressFunction(percentage);
+        }
+    }
+    tcxOutput.append("        </Track>\n"
+                     "      </Lap>\n"
+                     "    </Activity>\n"
+                     "  </Activities>\n"
+                     "</TrainingCenterDatabase>\n");
+    const bool written = tcxOutput.finish();
+    progressFunction(100);
+    return written;
 }
 
-/**
- * Write a single track point.
- */
-void RideFileWriter::writeTrackPoint(QXmlStreamWriter &writer, const QDateTime &startTime, const RideFile::Sample &sample)
+QString RideFileWriter::determineFilePath(const RideFile &rideFile) const
 {
-    writer.writeStartElement("Trackpoint");
+    QDir tcxDir(BigRingSettings().tcxFolder());
+    if (!tcxDir.exists()) {
+        if (!tcxDir.mkpath(".")) {
+            qDebug() << "Unable to create directory" << tcxDir.absolutePath();
+        }
+    }
 
-    // simple elements
-    writer.writeTextElement("Time", dateTimeString(startTime.addMSecs(sample.time.msecsSinceStartOfDay()), true));
+    const QString extension = (_compression == Compression::GZIP) ? "tcx.gz" : "tcx";
+    const QString filename = QString("%1.%2").arg(rideFile.startTime().toString("yyyy_MM_dd_HH_mm_ss")).arg(extension);
 
-    if (sample.position.isValid()) {
-        writer.writeStartElement("Position");
-        writer.writeTextElement("LatitudeDegrees", QString::number(sample.position.coordinate().latitude(), 'f', 10));
-        writer.writeTextElement("LongitudeDegrees", QString::number(sample.position.coordinate().longitude(), 'f', 10));
-        writer.writeEndElement();
-    }
-    writer.writeTextElement("AltitudeMeters", QString::number(sample.altitude));
-    writer.writeTextElement("DistanceMeters", QString::number(sample.distance));
-    writer.writeTextElement("Cadence", QString::number(sample.cadence));
-
-    // heart rate is put in a Value element inside a HeartRateBpm element.
-    writer.writeStartElement("HeartRateBpm");
-    writer.writeAttribute("xsi:type", "HeartRateInBeatsPerMinute_t");
-    writer.writeTextElement("Value", QString::number(sample.heartRate));
-    writer.writeEndElement(); // HeartRateBpm
-
-    // power and speed are put inside a TPX element, which is inside an Extensions element. All to make it more
-    // verbose I guess.
-    writer.writeStartElement("Extensions");
-    writer.writeStartElement("TPX");
-    writer.writeAttribute("xmlns", "http://www.garmin.com/xmlschemas/ActivityExtension/v2");
-    writer.writeTextElement("Speed", QString::number(sample.speed));
-    writer.writeTextElement("Watts", QString::number(sample.power));
-    writer.writeEndElement(); // TPX
-    writer.writeEndElement(); // Extensions
-
-    writer.writeEndElement(); // Track point
+    return tcxDir.filePath(filename);
 }
@@ -2,20 +2,29 @@
 #define RIDEFILEWRITER_H
 
 #include <functional>
-#include <QtCore/QFile>
+#include <QtCore/QIODevice>
 #include <QtCore/QObject>
-#include <QtCore/QXmlStreamWriter>
 
 #include "model/ridefile.h"
 
 /**
  * @brief The RideFileWriter class, used for writing a RideFile to a TCX file.
+ *
+ * The TCX is formatted directly into a fixed size buffer, which is written to the file, or compressed with gzip,
+ * whenever it is full. No strings are allocated per track point, so a long ride can be written quickly, and the
+ * writer can safely be used from a thread other than the GUI thread.
  */
 class RideFileWriter: public QObject
 {
     Q_OBJECT
 public:
+    enum class Compression {
+        NONE, GZIP
+    };
+
+    /** Create a writer, which compresses the files it writes if that is configured in the settings. */
     explicit RideFileWriter(QObject *parent = 0);
+    explicit RideFileWriter(Compression compression, QObject *parent = 0);
     virtual ~RideFileWriter() {}
 
     /**
@@ -23,9 +32,15 @@ public:
      * @param rideFile the RideFile to write.
      * @param progressFunction a function which takes a percentage. This can be used
      * to update a progress bar for instance, because writing the RideFile might take a while as TCX is a pretty verbose format.
-     * @return the path to the newly written file.
+     * @return the path to the newly written file, or an empty string if the file could not be written.
      */
     const QString writeRideFile(const RideFile &rideFile, std::function<void(int)> progressFunction = [](int) {});
+    /**
+     * Write the RideFile as TCX to a device.
+     * @return true if the complete file was written.
+     */
+    bool writeTcx(const RideFile &rideFile, QIODevice &output,
+                  std::function<void(int)> progressFunction = [](int) {}) const;
     /**
      * @brief determines the path to the RideFile.
      * @param rideFile the RideFile.
@@ -33,11 +48,7 @@ public:
      */
     QString determineFilePath(const RideFile &rideFile) const;
 private:
-    void writeTcx(const RideFile &rideFile, QFile &outputFile, std::function<void(int)> &progressFunction);
-    void writeLapSummary(QXmlStreamWriter &writer, const RideFile &rideFile);
-    void writeTrackPoint(QXmlStreamWriter &writer, const QDateTime &startTime, const RideFile::Sample &sample);
-
-    QString dateTimeString(const QDateTime dateTime, bool withMillis = false) const;
+    const Compression _compression;
 };
 
 #endif // RIDEFILEWRITER_H
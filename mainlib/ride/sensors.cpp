@@ -199,10 +199,6 @@ int Sensors::calculatePower(const float wheelSpeedRpm) const
 {
     float wheelCircumferenceInM = _sensorConfigurationGroup.wheelCircumferenceInMM() * 0.001;
     float wheelSpeedMps = wheelSpeedRpm * wheelCircumferenceInM / 60.0;
-    float virtualPower = _virtualPowerFunction(wheelSpeedMps);
-    qDebug() << QString("Virtual Power For %1 meters per second = %2W")
-                .arg(wheelSpeedMps, 2, 'f')
-                .arg(virtualPower, 2, 'f');
-    return static_cast<int>(virtualPower);
+    return static_cast<int>(_virtualPowerFunction(wheelSpeedMps));
 }
 }
@@ -23,45 +23,65 @@
 #include <QtGui/QFont>
 #include <QtCore/QTime>
 #include <QtGui/QPainter>
-#include <QtDebug>
 #include "model/simulation.h"
 
-ClockGraphicsItem::ClockGraphicsItem(QObject *parent) :
-    QObject(parent)
+namespace
+{
+/** same as the document margin of a QGraphicsTextItem, so the layout is the same as with a text item. */
+const int TEXT_MARGIN = 4; // px
+/** the frame starts above the item, so its top corners are hidden above the top of the scene. */
+const int FRAME_TOP = -10; // px
+const int FRAME_PEN_WIDTH = 2; // px
+
+QFont clockFont()
 {
     QFont font = QFont("Liberation Mono");
     font.setBold(true);
     font.setPointSize(30);
+    return font;
+}
+}
 
-    _textItem = new QGraphicsTextItem(this);
-    _textItem->setFont(font);
-    _textItem->setDefaultTextColor(Qt::white);
-
-    _textItem->setPlainText("00:00:00");
-
-    _textItem->setPos(10, 5);
-    _textItem->setOpacity(0.65);
+/**
+ * The clock is cached in device coordinates, so it is only rendered again when the displayed time changes. The rest
+ * of the time, the cached texture is composited on top of the video.
+ */
+ClockGraphicsItem::ClockGraphicsItem(QObject *parent) :
+    QObject(parent), _glyphAtlas(GlyphAtlas::atlas(clockFont(), Qt::white, QStringLiteral("0123456789:")))
+{
+    const QSize textSize = _glyphAtlas->textSize(QString("00:00:00"));
+    _textRect = QRectF(10, 5, textSize.width() + 2 * TEXT_MARGIN, textSize.height() + 2 * TEXT_MARGIN);
+    _frameRect = QRectF(0, FRAME_TOP, _textRect.width() + 20, _textRect.height() + 10);
+    setCacheMode(QGraphicsItem::DeviceCoordinateCache);
 }
 
 QRectF ClockGraphicsItem::boundingRect() const
 {
-    return QRectF(0, 0, _textItem->boundingRect().width() + 20, _textItem->boundingRect().height() + 10);
+    // everything that is painted must be inside the bounding rect, as the item is cached in device coordinates.
+    const qreal halfPenWidth = FRAME_PEN_WIDTH / 2.0;
+    return _frameRect.adjusted(-halfPenWidth, -halfPenWidth, halfPenWidth, halfPenWidth)
+            .united(_textRect);
 }
 
 void ClockGraphicsItem::paint(QPainter *painter, const QStyleOptionGraphicsItem *, QWidget *)
 {
     QPen pen(Qt::green);
-    pen.setWidth(2);
+    pen.setWidth(FRAME_PEN_WIDTH);
     painter->setPen(pen);
     painter->setBrush(Qt::black);
     painter->setOpacity(0.65);
-    painter->drawRoundedRect(0, -10, boundingRect().width(), boundingRect().height(), 3, 3);
+    painter->drawRoundedRect(_frameRect, 3, 3);
+
+    if (!_text.isEmpty()) {
+        _glyphAtlas->drawText(painter, _textRect.topLeft() + QPointF(TEXT_MARGIN, TEXT_MARGIN), _text);
+    }
 }
 
 void ClockGraphicsItem::setTime(const QTime &time)
 {
-    _textItem->setPlainText(time.toString("hh:mm:ss"));
-    if (!_textItem->isVisible()) {
-        _textItem->show();
+    const QString text = time.toString("hh:mm:ss");
+    if (text != _text) {
+        _text = text;
+        update(_textRect);
     }
 }
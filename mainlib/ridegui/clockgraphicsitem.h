@@ -24,6 +24,8 @@
 #include <QObject>
 #include <QtWidgets/QGraphicsItem>
 
+#include "glyphatlas.h"
+
 /**
  * @brief Graphics Item for displaying a clock.
  */
@@ -44,7 +46,10 @@ signals:
 public slots:
 
 private:
-    QGraphicsTextItem* _textItem;
+    const std::shared_ptr<const GlyphAtlas> _glyphAtlas;
+    QRectF _textRect;
+    QRectF _frameRect;
+    QString _text;
 };
 
 #endif // CLOCKGRAPHICSITEM_H
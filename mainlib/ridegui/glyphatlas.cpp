@@ -0,0 +1,91 @@
+/*
+ * Copyright (c) 2015 Ilja Booij (ibooij@gmail.com)
+ *
+ * This file is part of Big Ring Indoor Video Cycling
+ *
+ * Big Ring Indoor Video Cycling is free software: you can redistribute
+ * it and/or modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation, either version 3 of the
+ * License, or (at your option) any later version.
+ *
+ * Big Ring Indoor Video Cycling  is distributed in the hope that it will
+ * be useful, but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+
+ * You should have received a copy of the GNU General Public License
+ * along with Big Ring Indoor Video Cycling.  If not, see
+ * <http://www.gnu.org/licenses/>.
+ */
+
+#include "glyphatlas.h"
+
+#include <QtCore/QHash>
+#include <QtCore/QtMath>
+#include <QtGui/QFontMetrics>
+#include <QtGui/QGuiApplication>
+#include <QtGui/QPainter>
+
+GlyphAtlas::GlyphAtlas(const QFont &font, const QColor &color, const QString &characters,
+                       const qreal devicePixelRatio):
+    _font(font), _color(color), _characters(characters), _devicePixelRatio(devicePixelRatio)
+{
+    const QFontMetrics fontMetrics(font);
+    _cellWidth = fontMetrics.width(QChar('0'));
+    _cellHeight = fontMetrics.height();
+    _ascent = fontMetrics.ascent();
+
+    _pixmap = QPixmap(qCeil(_cellWidth * _characters.size() * _devicePixelRatio),
+                      qCeil(_cellHeight * _devicePixelRatio));
+    _pixmap.setDevicePixelRatio(_devicePixelRatio);
+    _pixmap.fill(Qt::transparent);
+
+    QPainter painter(&_pixmap);
+    painter.setRenderHint(QPainter::TextAntialiasing);
+    painter.setFont(_font);
+    painter.setPen(_color);
+    for (int i = 0; i < _characters.size(); ++i) {
+        painter.drawText(i * _cellWidth, _ascent, QString(_characters[i]));
+    }
+}
+
+std::shared_ptr<const GlyphAtlas> GlyphAtlas::atlas(const QFont &font, const QColor &color,
+                                                    const QString &characters)
+{
+    static QHash<QString,std::shared_ptr<const GlyphAtlas>> atlases;
+
+    const qreal devicePixelRatio = qGuiApp->devicePixelRatio();
+    const QString key = QString("%1|%2|%3|%4").arg(font.key()).arg(color.rgba()).arg(devicePixelRatio)
+            .arg(characters);
+    std::shared_ptr<const GlyphAtlas> &atlas = atlases[key];
+    if (!atlas) {
+        atlas = std::make_shared<const GlyphAtlas>(font, color, characters, devicePixelRatio);
+    }
+    return atlas;
+}
+
+QSize GlyphAtlas::textSize(const QString &text) const
+{
+    return QSize(_cellWidth * text.size(), _cellHeight);
+}
+
+void GlyphAtlas::drawText(QPainter *painter, const QPointF &topLeft, const QString &text) const
+{
+    QPointF position = topLeft;
+    for (const QChar character: text) {
+        const int index = _characters.indexOf(character);
+        if (index >= 0) {
+            // the source rectangle is in pixels of the pixmap, the target rectangle in logical coordinates.
+            painter->drawPixmap(QRectF(position, QSizeF(_cellWidth, _cellHeight)), _pixmap,
+                                QRectF(index * _cellWidth * _devicePixelRatio, 0, _cellWidth * _devicePixelRatio,
+                                       _cellHeight * _devicePixelRatio));
+        } else if (!character.isSpace()) {
+            painter->save();
+            painter->setFont(_font);
+            painter->setPen(_color);
+            painter->drawText(position + QPointF(0, _ascent), QString(character));
+            painter->restore();
+        }
+        position.rx() += _cellWidth;
+    }
+}
@@ -0,0 +1,73 @@
+/*
+ * Copyright (c) 2015 Ilja Booij (ibooij@gmail.com)
+ *
+ * This file is part of Big Ring Indoor Video Cycling
+ *
+ * Big Ring Indoor Video Cycling is free software: you can redistribute
+ * it and/or modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation, either version 3 of the
+ * License, or (at your option) any later version.
+ *
+ * Big Ring Indoor Video Cycling  is distributed in the hope that it will
+ * be useful, but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+
+ * You should have received a copy of the GNU General Public License
+ * along with Big Ring Indoor Video Cycling.  If not, see
+ * <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef GLYPHATLAS_H
+#define GLYPHATLAS_H
+
+#include <QtCore/QPointF>
+#include <QtCore/QString>
+#include <QtGui/QColor>
+#include <QtGui/QFont>
+#include <QtGui/QPixmap>
+
+#include <memory>
+
+class QPainter;
+
+/**
+ * Pre-rendered glyphs of a fixed set of characters of a monospaced font, stored in a single pixmap.
+ *
+ * Drawing a string with the atlas is just a blit per character, without any text layout. Characters that are not
+ * in the atlas are drawn with QPainter::drawText.
+ *
+ * The glyphs are rendered at the device pixel ratio of the screen, so text stays sharp on high dpi screens.
+ */
+class GlyphAtlas
+{
+public:
+    explicit GlyphAtlas(const QFont& font, const QColor& color, const QString& characters, qreal devicePixelRatio);
+
+    /**
+     * Get the atlas for a font, color and set of characters, rendered at the device pixel ratio of the application.
+     * Atlases are created once and shared by all callers. Only call this from the GUI thread.
+     */
+    static std::shared_ptr<const GlyphAtlas> atlas(const QFont& font, const QColor& color, const QString& characters);
+
+    /** width of a single character cell. */
+    int cellWidth() const { return _cellWidth; }
+    /** height of a single character cell. */
+    int cellHeight() const { return _cellHeight; }
+    /** size of text when drawn with the atlas. */
+    QSize textSize(const QString& text) const;
+
+    /** draw text with its top left corner at topLeft. */
+    void drawText(QPainter* painter, const QPointF& topLeft, const QString& text) const;
+private:
+    const QFont _font;
+    const QColor _color;
+    const QString _characters;
+    const qreal _devicePixelRatio;
+    int _cellWidth;
+    int _cellHeight;
+    int _ascent;
+    QPixmap _pixmap;
+};
+
+#endif // GLYPHATLAS_H
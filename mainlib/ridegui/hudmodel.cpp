@@ -0,0 +1,55 @@
+/*
+ * Copyright (c) 2015 Ilja Booij (ibooij@gmail.com)
+ *
+ * This file is part of Big Ring Indoor Video Cycling
+ *
+ * Big Ring Indoor Video Cycling is free software: you can redistribute
+ * it and/or modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation, either version 3 of the
+ * License, or (at your option) any later version.
+ *
+ * Big Ring Indoor Video Cycling  is distributed in the hope that it will
+ * be useful, but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+
+ * You should have received a copy of the GNU General Public License
+ * along with Big Ring Indoor Video Cycling.  If not, see
+ * <http://www.gnu.org/licenses/>.
+ */
+
+#include "hudmodel.h"
+
+#include "sensoritem.h"
+
+namespace
+{
+/** update interval when no video frames are displayed */
+const int IDLE_UPDATE_INTERVAL_MS = 250;
+}
+
+HudModel::HudModel(QObject *parent):
+    QObject(parent)
+{
+    _sinceLastApply.start();
+    _idleTimer.setInterval(IDLE_UPDATE_INTERVAL_MS);
+    connect(&_idleTimer, &QTimer::timeout, this, [this]() {
+        if (_sinceLastApply.elapsed() >= IDLE_UPDATE_INTERVAL_MS) {
+            applyPendingValues();
+        }
+    });
+    _idleTimer.start();
+}
+
+void HudModel::addItem(SensorItem *item)
+{
+    _items.append(item);
+}
+
+void HudModel::applyPendingValues()
+{
+    for (SensorItem* item: _items) {
+        item->applyPendingValue();
+    }
+    _sinceLastApply.restart();
+}
@@ -0,0 +1,55 @@
+/*
+ * Copyright (c) 2015 Ilja Booij (ibooij@gmail.com)
+ *
+ * This file is part of Big Ring Indoor Video Cycling
+ *
+ * Big Ring Indoor Video Cycling is free software: you can redistribute
+ * it and/or modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation, either version 3 of the
+ * License, or (at your option) any later version.
+ *
+ * Big Ring Indoor Video Cycling  is distributed in the hope that it will
+ * be useful, but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+
+ * You should have received a copy of the GNU General Public License
+ * along with Big Ring Indoor Video Cycling.  If not, see
+ * <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef HUDMODEL_H
+#define HUDMODEL_H
+
+#include <QtCore/QElapsedTimer>
+#include <QtCore/QList>
+#include <QtCore/QObject>
+#include <QtCore/QTimer>
+
+class SensorItem;
+
+/**
+ * The values of the heads up display during a ride.
+ *
+ * Sensor values arrive many times per second. The sensor items only store the last value they were given, and the
+ * model applies the stored values of all items together, once per displayed video frame, so the cost of the overlay
+ * does not depend on the sensor rate. When no video frames are displayed, for instance before the ride is started,
+ * the values are applied a few times per second.
+ */
+class HudModel : public QObject
+{
+    Q_OBJECT
+public:
+    explicit HudModel(QObject* parent = 0);
+
+    void addItem(SensorItem* item);
+public slots:
+    /** apply the last values of all items. Call this just before a video frame is displayed. */
+    void applyPendingValues();
+private:
+    QList<SensorItem*> _items;
+    QElapsedTimer _sinceLastApply;
+    QTimer _idleTimer;
+};
+
+#endif // HUDMODEL_H
@@ -23,6 +23,11 @@ InformationBoxGraphicsItem::InformationBoxGraphicsItem(QObject *parent) :
     _pixmapItem->setOpacity(0.65);
     _pixmapItem->setPos(10, 0);
     _pixmapItem->hide();
+
+    // the box slides over the screen without changing, so render it once and let the view move the cached textures.
+    setCacheMode(QGraphicsItem::DeviceCoordinateCache);
+    _textItem->setCacheMode(QGraphicsItem::DeviceCoordinateCache);
+    _pixmapItem->setCacheMode(QGraphicsItem::DeviceCoordinateCache);
 }
 
 QRectF InformationBoxGraphicsItem::boundingRect() const
@@ -34,7 +39,8 @@ QRectF InformationBoxGraphicsItem::boundingRect() const
         internalRect = _pixmapItem->boundingRect();
     }
 
-    return QRectF(0, 0, internalRect.width() + 20, internalRect.height() + 20);
+    // the box extends 10 pixels above the origin of the item.
+    return QRectF(0, -10, internalRect.width() + 20, internalRect.height() + 20);
 }
 
 void InformationBoxGraphicsItem::paint(QPainter *painter, const QStyleOptionGraphicsItem *, QWidget *)
@@ -43,8 +49,9 @@ void InformationBoxGraphicsItem::paint(QPainter *painter, const QStyleOptionGrap
     pen.setWidth(2);
     painter->setPen(pen);
     painter->setBrush(Qt::black);
-    painter->setOpacity(0.65 * opacity());
-    painter->drawRoundedRect(0, -10, boundingRect().width(), boundingRect().height(), 3, 3);
+    // the opacity of the item itself is applied when the cached item is drawn.
+    painter->setOpacity(0.65);
+    painter->drawRoundedRect(boundingRect(), 3, 3);
 }
 
 void InformationBoxGraphicsItem::setInformationBox(const InformationBox &informationBox)
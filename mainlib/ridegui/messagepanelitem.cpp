@@ -37,13 +37,18 @@ MessagePanelItem::MessagePanelItem(QObject *parent) :
     _textItem->setPlainText("Empty");
     _textItem->setPos(10, 5);
     _textItem->setOpacity(0.65);
+
+    // the panel is faded in and out, render it once and only change the opacity of the cached textures.
+    setCacheMode(QGraphicsItem::DeviceCoordinateCache);
+    _textItem->setCacheMode(QGraphicsItem::DeviceCoordinateCache);
 }
 
 QRectF MessagePanelItem::boundingRect() const
 {
     QRectF internalRect = _textItem->boundingRect();
 
-    return QRectF(0, 0, internalRect.width() + 20, internalRect.height() + 20);
+    // the box extends 10 pixels above the origin of the item.
+    return QRectF(0, -10, internalRect.width() + 20, internalRect.height() + 20);
 }
 
 void MessagePanelItem::paint(QPainter *painter, const QStyleOptionGraphicsItem *, QWidget *)
@@ -52,8 +57,9 @@ void MessagePanelItem::paint(QPainter *painter, const QStyleOptionGraphicsItem *
     pen.setWidth(2);
     painter->setPen(pen);
     painter->setBrush(Qt::black);
-    painter->setOpacity(0.65 * opacity());
-    painter->drawRoundedRect(0, -10, boundingRect().width(), boundingRect().height(), 3, 3);
+    // the opacity of the item itself is applied when the cached item is drawn.
+    painter->setOpacity(0.65);
+    painter->drawRoundedRect(boundingRect(), 3, 3);
 }
 
 void MessagePanelItem::setMessage(const QString &text)
@@ -29,11 +29,13 @@
 #include <QtOpenGL/QGLWidget>
 #include <QtWidgets/QApplication>
 #include <QtWidgets/QGraphicsDropShadowEffect>
+#include <QtWidgets/QGraphicsSimpleTextItem>
 #include <QtGui/QResizeEvent>
 
 
 #include "config/bigringsettings.h"
 #include "clockgraphicsitem.h"
+#include "hudmodel.h"
 #include "informationboxgraphicsitem.h"
 #include "messagepanelitem.h"
 #include "profileitem.h"
@@ -41,11 +43,13 @@
 #include "sensoritem.h"
 #include "model/simulation.h"
 #include "util/screensaverblocker.h"
+#include "video/readaheadfile.h"
 #include "video/videoplayer.h"
 
 
 NewVideoWidget::NewVideoWidget(bool showDebugOutput, QWidget *parent) :
     QGraphicsView(parent),
+    _hudModel(new HudModel(this)),
     _screenSaverBlocker(new indoorcycling::ScreenSaverBlocker(this)),
     _mouseIdleTimer(new QTimer(this))
 {
@@ -76,6 +80,12 @@ NewVideoWidget::NewVideoWidget(bool showDebugOutput, QWidget *parent) :
     _frameRateItem->setValue(QVariant::fromValue(0));
     _frameRateItem->setVisible(showDebugOutput);
     scene->addItem(_frameRateItem);
+    _hudModel->addItem(_frameRateItem);
+
+    _readAheadItem = new QGraphicsSimpleTextItem;
+    _readAheadItem->setBrush(Qt::white);
+    _readAheadItem->setVisible(showDebugOutput);
+    scene->addItem(_readAheadItem);
 
     setupVideoPlayer(viewPortWidget);
 
@@ -94,6 +104,8 @@ void NewVideoWidget::setupVideoPlayer(QGLWidget* paintWidget)
     connect(_videoPlayer, &VideoPlayer::videoLoaded, this, [this](qint64 numberOfFrames) {
         qDebug() << "total number of frames" << numberOfFrames;
         this->_rlv.setNumberOfFrames(numberOfFrames);
+        // this copy is queried for every frame that is shown, so it's worth building the lookup table.
+        this->_rlv.enableLookupTable();
         if (this->_course.isValid()) {
             this->seekToStart(_course);
         }
@@ -102,11 +114,22 @@ void NewVideoWidget::setupVideoPlayer(QGLWidget* paintWidget)
         emit readyToPlay(true);
     });
     connect(_videoPlayer, &VideoPlayer::updateVideo, this, [this]() {
+        _hudModel->applyPendingValues();
         this->viewport()->update(rect());
     });
     connect(_videoPlayer, &VideoPlayer::frameRateChanged, this, [this](const int frameRate) {
         this->_frameRateItem->setValue(frameRate);
     });
+    connect(_videoPlayer, &VideoPlayer::readAheadStatisticsChanged, this, [this](const ReadAheadStatistics& statistics) {
+        const qreal mebibyte = 1024 * 1024;
+        this->_readAheadItem->setText(QString("read-ahead: %1/%2 MiB (%3%), %4 MiB/s, %5 stalls (%6 ms)")
+                                      .arg(statistics.bufferedBytes / mebibyte, 0, 'f', 1)
+                                      .arg(statistics.windowBytes / mebibyte, 0, 'f', 1)
+                                      .arg(statistics.fillPercentage(), 0, 'f', 0)
+                                      .arg(statistics.bytesPerSecond / mebibyte, 0, 'f', 2)
+                                      .arg(statistics.stalls)
+                                      .arg(statistics.totalStallNs / 1000000));
+    });
 }
 
 void NewVideoWidget::addClock(QGraphicsScene* scene)
@@ -137,6 +160,7 @@ bool NewVideoWidget::handleKeyPress(QKeyEvent *event)
     switch(event->key()) {
     case Qt::Key_D:
         _frameRateItem->setVisible(!_frameRateItem->isVisible());
+        _readAheadItem->setVisible(_frameRateItem->isVisible());
         return true;
     }
     return false;
@@ -220,6 +244,16 @@ void NewVideoWidget::displayInformationBox(const InformationBox &informationBox)
     informationBoxItem->show();
 }
 
+void NewVideoWidget::setTrainingMetrics(const TrainingMetrics &trainingMetrics)
+{
+    _normalizedPowerItem->setValue(QVariant::fromValue(trainingMetrics.normalizedPower()));
+    _wPrimeBalanceItem->setValue(QVariant::fromValue(trainingMetrics.wPrimeBalance()));
+    // the elevation gain of the climb the cyclist is on. After a climb, the item keeps showing its gain.
+    if (trainingMetrics.isClimbing()) {
+        _climbItem->setValue(QVariant::fromValue(trainingMetrics.currentClimb().elevationGain));
+    }
+}
+
 void NewVideoWidget::setSimulation(const Simulation& simulation)
 {
     connect(&simulation, &Simulation::runTimeChanged, _clockItem, &ClockGraphicsItem::setTime);
@@ -232,17 +266,17 @@ void NewVideoWidget::setSimulation(const Simulation& simulation)
     connect(&cyclist, &Cyclist::cadenceChanged, this, [this](int cadence) {
         _cadenceItem->setValue(QVariant::fromValue(cadence));
     });
-    connect(&cyclist, &Cyclist::speedChanged, this, [this](float speed) {
-        _speedItem->setValue(QVariant::fromValue(speed));
-    });
     connect(&simulation, &Simulation::slopeChanged, this, [this](float grade) {
         _gradeItem->setValue(QVariant::fromValue(grade));
     });
     connect(&cyclist, &Cyclist::heartRateChanged, this, [this](int heartRate) {
         _heartRateItem->setValue(QVariant::fromValue(heartRate));
     });
-    connect(&cyclist, &Cyclist::distanceChanged, this, [this](float distance) {
-        float distanceDifference = _course.end() - distance;
+    connect(&cyclist, &Cyclist::stateUpdated, this, [this, &cyclist]() {
+        const CyclistState &state = cyclist.state();
+        setDistance(state.distance);
+        _speedItem->setValue(QVariant::fromValue(state.speed));
+        float distanceDifference = _course.end() - state.distance;
         _distanceItem->setValue(QVariant::fromValue(std::fabs(distanceDifference)));
     });
 
@@ -265,6 +299,9 @@ void NewVideoWidget::resizeEvent(QResizeEvent *resizeEvent)
     _cadenceItem->setPos(0, bottom - _cadenceItem->boundingRect().height());
     _heartRateItem->setPos(0, _cadenceItem->scenePos().y() - _heartRateItem->boundingRect().height());
     _powerItem->setPos(0, _heartRateItem->scenePos().y() - _powerItem->boundingRect().height());
+    _normalizedPowerItem->setPos(0, _powerItem->scenePos().y() - _normalizedPowerItem->boundingRect().height());
+    _wPrimeBalanceItem->setPos(0, _normalizedPowerItem->scenePos().y() - _wPrimeBalanceItem->boundingRect().height());
+    _climbItem->setPos(0, _wPrimeBalanceItem->scenePos().y() - _climbItem->boundingRect().height());
 
     QPointF leftOfRightItems = mapToScene(width(), height());
     leftOfRightItems = QPointF(leftOfRightItems.x() - _speedItem->boundingRect().width(), leftOfRightItems.y());
@@ -279,6 +316,7 @@ void NewVideoWidget::resizeEvent(QResizeEvent *resizeEvent)
     _profileItem->setGeometry(QRectF(profileItemLeft, profileItemTop, profileItemWidth, bottom - profileItemTop));
 
     _frameRateItem->setPos(mapToScene(0, 0));
+    _readAheadItem->setPos(mapToScene(0, _frameRateItem->boundingRect().height()));
 
     resizeEvent->accept();
 }
@@ -343,5 +381,21 @@ void NewVideoWidget::addSensorItems(QGraphicsScene *scene)
     scene->addItem(_distanceItem);
     _gradeItem = new SensorItem(QuantityPrinter::Quantity::Grade);
     scene->addItem(_gradeItem);
+    _normalizedPowerItem = new SensorItem(QuantityPrinter::Quantity::NormalizedPower);
+    scene->addItem(_normalizedPowerItem);
+    _wPrimeBalanceItem = new SensorItem(QuantityPrinter::Quantity::WPrimeBalance);
+    scene->addItem(_wPrimeBalanceItem);
+    _climbItem = new SensorItem(QuantityPrinter::Quantity::ClimbElevationGain);
+    scene->addItem(_climbItem);
+
+    _hudModel->addItem(_powerItem);
+    _hudModel->addItem(_heartRateItem);
+    _hudModel->addItem(_cadenceItem);
+    _hudModel->addItem(_speedItem);
+    _hudModel->addItem(_distanceItem);
+    _hudModel->addItem(_gradeItem);
+    _hudModel->addItem(_normalizedPowerItem);
+    _hudModel->addItem(_wPrimeBalanceItem);
+    _hudModel->addItem(_climbItem);
 }
 
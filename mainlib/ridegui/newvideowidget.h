@@ -27,6 +27,7 @@
 #include <QtWidgets/QGraphicsView>
 
 #include "model/reallifevideo.h"
+#include "model/trainingmetrics.h"
 #include "profileitem.h"
 
 class Simulation;
@@ -41,6 +42,8 @@ class MessagePanelItem;
 class RollingAverageSensorItem;
 class SensorItem;
 class ClockGraphicsItem;
+class HudModel;
+class QGraphicsSimpleTextItem;
 
 class NewVideoWidget : public QGraphicsView
 {
@@ -68,6 +71,7 @@ public slots:
     void displayMessage(const QString &message);
     void displayInformationBox(const InformationBox &informationBox);
     void setSimulation(const Simulation &cyclist);
+    void setTrainingMetrics(const TrainingMetrics &trainingMetrics);
 
     void goToFullscreen();
 protected:
@@ -92,6 +96,7 @@ private:
     RealLifeVideo _rlv;
     Course _course;
     VideoPlayer* _videoPlayer;
+    HudModel* _hudModel;
 
     ClockGraphicsItem* _clockItem;
     MessagePanelItem *_messagePanelItem;
@@ -103,8 +108,12 @@ private:
     RollingAverageSensorItem* _speedItem;
     SensorItem* _distanceItem;
     SensorItem* _gradeItem;
+    SensorItem* _normalizedPowerItem;
+    SensorItem* _wPrimeBalanceItem;
+    SensorItem* _climbItem;
     ProfileItem* _profileItem;
     SensorItem *_frameRateItem;
+    QGraphicsSimpleTextItem* _readAheadItem;
     indoorcycling::ScreenSaverBlocker* _screenSaverBlocker;
     QTimer* _mouseIdleTimer;
     Qt::AspectRatioMode _aspectRatioMode;
@@ -25,14 +25,17 @@
 
 #include <QtCore/QtDebug>
 #include <QtGui/QPainter>
+#include <QtGui/QPixmapCache>
 
 ProfileItem::ProfileItem(QGraphicsItem *parent):
-    QGraphicsWidget(parent), _profilePainter(new ProfilePainter(this)), _dirty(false), _cyclist(nullptr)
+    QGraphicsWidget(parent), _profilePainter(new ProfilePainter(this)), _cyclist(nullptr), _distance(0),
+    _cyclistColumn(0)
 {
-    setOpacity(0.75);
     QFont font("Sans");
     font.setBold(false);
     font.setPointSize(16);
+    // the item is only rendered again when the cyclist position moves to another pixel column, or for a new course or size.
+    setCacheMode(QGraphicsItem::DeviceCoordinateCache);
 }
 
 /**
@@ -45,61 +48,122 @@ ProfileItem::ProfileItem(QGraphicsItem *parent):
  */
 void ProfileItem::paint(QPainter *painter, const QStyleOptionGraphicsItem *, QWidget *)
 {
-    QPen pen = QColor(Qt::green);
-    pen.setStyle(Qt::SolidLine);
-    pen.setWidth(2);
-    painter->setOpacity(0.5);
-    painter->setRenderHint(QPainter::Antialiasing, true);
-    painter->setPen(pen);
-    painter->setBrush(Qt::lightGray);
-    painter->drawRoundedRect(boundingRect(), 5, 5);
-
-    // make sure we don't paint outside the internal rectangle used for the profile.
-    painter->setClipRect(_internalRect);
-    if (_rlv.isValid()) {
-        if (_dirty && _course.isValid()) {
-            _profilePixmap = _profilePainter->paintProfile(_rlv, _internalRect, _course.start(), _course.end(), true);
-            _dirty = false;
-        }
-        if (!_profilePixmap.isNull()) {
-            painter->drawPixmap(_internalRect, _profilePixmap);
-            if (_cyclist) {
-                paintArea(painter, _course.start(), std::min(_cyclist->distance(), _course.end()), _course.end() - _course.start(), Qt::green);
-            }
-        }
-    }
+    painter->drawPixmap(0, 0, basePixmap());
 
+    if (_rlv.isValid() && _course.isValid() && _cyclist) {
+        // make sure we don't paint outside the internal rectangle used for the profile.
+        painter->setClipRect(_internalRect);
+        paintArea(painter, _cyclistColumn, Qt::green);
+    }
 }
 
 void ProfileItem::setGeometry(const QRectF &rect)
 {
-    _dirty = true;
     prepareGeometryChange();
     QGraphicsWidget::setGeometry(rect);
     _internalRect = QRect(1, 1, rect.width() - 2, rect.height() - 2);
-    _dirty = true;
+    _cyclistColumn = cyclistColumn();
+    update();
 }
 
 void ProfileItem::setRlv(const RealLifeVideo &rlv)
 {
     _rlv = rlv;
-    _dirty = true;
     update();
 }
 
 void ProfileItem::setCourse(const Course &course)
 {
     _course = course;
-    _dirty = true;
+    _cyclistColumn = cyclistColumn();
     update();
 }
 
 void ProfileItem::setCyclist(const Cyclist *cylist)
 {
+    if (_cyclist) {
+        disconnect(_cyclist, &Cyclist::stateUpdated, this, &ProfileItem::cyclistStateUpdated);
+    }
     _cyclist = cylist;
+    if (_cyclist) {
+        connect(_cyclist, &Cyclist::stateUpdated, this, &ProfileItem::cyclistStateUpdated);
+        setDistance(_cyclist->distance());
+    }
+}
+
+void ProfileItem::cyclistStateUpdated()
+{
+    setDistance(_cyclist->distance());
+}
+
+void ProfileItem::setDistance(float distance)
+{
+    _distance = distance;
+    updateCyclistColumn();
+}
+
+/**
+ * The border and the profile only change with the size of the item and the course, so they're rendered once into a
+ * pixmap, which is kept in the QPixmapCache.
+ */
+QPixmap ProfileItem::basePixmap() const
+{
+    const QSize size = boundingRect().size().toSize();
+    const QString pixmapName = QString("profileitem_%1_%2_%3_%4x%5").arg(_rlv.name()).arg(_course.start())
+            .arg(_course.end()).arg(size.width()).arg(size.height());
+    QPixmap pixmap;
+    if (!QPixmapCache::find(pixmapName, &pixmap)) {
+        pixmap = QPixmap(size);
+        pixmap.fill(Qt::transparent);
+
+        QPainter painter(&pixmap);
+        QPen pen = QColor(Qt::green);
+        pen.setStyle(Qt::SolidLine);
+        pen.setWidth(2);
+        painter.setOpacity(0.5);
+        painter.setRenderHint(QPainter::Antialiasing, true);
+        painter.setPen(pen);
+        painter.setBrush(Qt::lightGray);
+        painter.drawRoundedRect(boundingRect(), 5, 5);
+
+        if (_rlv.isValid() && _course.isValid()) {
+            painter.setClipRect(_internalRect);
+            painter.drawPixmap(_internalRect,
+                               _profilePainter->paintProfile(_rlv, _internalRect, _course.start(), _course.end(), true));
+        }
+        painter.end();
+        QPixmapCache::insert(pixmapName, pixmap);
+    }
+    return pixmap;
+}
+
+int ProfileItem::cyclistColumn() const
+{
+    if (!_course.isValid() || _course.distance() <= 0) {
+        return 0;
+    }
+    const float distance = qBound(_course.start(), _distance, _course.end());
+    return static_cast<int>(((distance - _course.start()) / _course.distance()) * _internalRect.width());
+}
+
+/**
+ * Only invalidate the part of the item between the old and the new position, and only if the cyclist moved to
+ * another pixel column.
+ */
+void ProfileItem::updateCyclistColumn()
+{
+    const int column = cyclistColumn();
+    if (column == _cyclistColumn) {
+        return;
+    }
+    const int left = qMin(column, _cyclistColumn);
+    const int right = qMax(column, _cyclistColumn);
+    _cyclistColumn = column;
+    // the pen of the area is 2 pixels wide, so the edge extends a pixel on both sides.
+    update(QRectF(left - 2, 0, right - left + 4, boundingRect().height()));
 }
 
-void ProfileItem::paintArea(QPainter *painter, const float startDistance, const float endDistance, const float totalDistance, const QColor &color) const
+void ProfileItem::paintArea(QPainter *painter, const int width, const QColor &color) const
 {
     QBrush brush(color);
     QPen pen = color;
@@ -109,6 +173,5 @@ void ProfileItem::paintArea(QPainter *painter, const float startDistance, const
     painter->setPen(pen);
     painter->setBrush(brush);
     int left = 0;
-    int width = ((endDistance - startDistance) / totalDistance) * _internalRect.width();
     painter->drawRect(left, _internalRect.top(), width, _internalRect.bottom());
 }
@@ -43,15 +43,22 @@ public slots:
     void setRlv(const RealLifeVideo& rlv);
     void setCourse(const Course &course);
     void setCyclist(const Cyclist* cylist);
+    void setDistance(float distance);
+private slots:
+    void cyclistStateUpdated();
 private:
-    void paintArea(QPainter *painter, const float startDistance, const float endDistance, const float totalDistance, const QColor &color) const;
+    QPixmap basePixmap() const;
+    int cyclistColumn() const;
+    void updateCyclistColumn();
+    void paintArea(QPainter *painter, const int width, const QColor &color) const;
     ProfilePainter* _profilePainter;
     QRect _internalRect;
-    bool _dirty;
     RealLifeVideo _rlv;
     Course _course;
     const Cyclist* _cyclist;
-    QPixmap _profilePixmap;
+    float _distance;
+    /** the pixel column up to which the cyclist position is drawn */
+    int _cyclistColumn;
 };
 
 #endif // PROFILEITEM_H
@@ -2,24 +2,25 @@
 
 #include <QtCore/QtDebug>
 
-#include "model/rollingaveragecalculator.h"
+#include <limits>
 
 RollingAverageSensorItem::RollingAverageSensorItem(const QuantityPrinter::Quantity quantity, const int averageTimeMilliseconds, const int displayUpdateTimeMilliseconds, QObject *parent):
-    SensorItem(quantity, parent), _displayUpdateTimeMilliseconds(displayUpdateTimeMilliseconds), _lastDisplayedTime(QDateTime::fromMSecsSinceEpoch(0))
+    SensorItem(quantity, parent), _displayUpdateTimeMilliseconds(displayUpdateTimeMilliseconds),
+    _lastDisplayedMilliseconds(std::numeric_limits<qint64>::min()), _rollingAverage(averageTimeMilliseconds)
 {
-    _rollingAverageCalculator.reset(new RollingAverageCalculator(averageTimeMilliseconds));
+    _clock.start();
 }
 
 void RollingAverageSensorItem::setValue(const QVariant &powerValue)
 {
-    QDateTime now(QDateTime::currentDateTime());
-    _rollingAverageCalculator->addValue(now, powerValue.toFloat());
+    const qint64 now = _clock.elapsed();
+    _rollingAverage.add(now, powerValue.toFloat());
 
     // Only display anything if the last time that the value was updated in
     // the display was more than _displayTimeMilliseconds ago.
-    if (now > _lastDisplayedTime.addMSecs(_displayUpdateTimeMilliseconds)) {
+    if (now - _displayUpdateTimeMilliseconds > _lastDisplayedMilliseconds) {
         SensorItem::setValue(
-                    QVariant::fromValue(_rollingAverageCalculator->currentAverage()));
-        _lastDisplayedTime = now;
+                    QVariant::fromValue(_rollingAverage.mean()));
+        _lastDisplayedMilliseconds = now;
     }
 }
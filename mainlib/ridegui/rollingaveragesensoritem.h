@@ -3,10 +3,9 @@
 
 #include "sensoritem.h"
 
-#include <memory>
-#include <QtCore/QDateTime>
+#include <QtCore/QElapsedTimer>
 
-#include "model/rollingaveragecalculator.h"
+#include "model/windowedstatistics.h"
 
 /**
  * A Sensor item that displays it's value using a rolling average.
@@ -30,8 +29,9 @@ public slots:
     virtual void setValue(const QVariant &value) override;
 private:
     const int _displayUpdateTimeMilliseconds;
-    QDateTime _lastDisplayedTime;
-    std::unique_ptr<RollingAverageCalculator> _rollingAverageCalculator;
+    QElapsedTimer _clock;
+    qint64 _lastDisplayedMilliseconds;
+    WindowedStatistics _rollingAverage;
 };
 
 #endif // POWERSENSORITEM_H
@@ -25,9 +25,13 @@
 #include "config/sensorconfiguration.h"
 #include "model/ridesampler.h"
 #include "ride/actuators.h"
+#include "ride/fitfilewriter.h"
 #include "ride/ridefilewriter.h"
 #include "ride/sensors.h"
 
+#include <QtConcurrent/QtConcurrentRun>
+#include <QtCore/QFile>
+#include <QtCore/QFutureWatcher>
 #include <QtCore/QTimer>
 #include <QtCore/QtDebug>
 #include <QtWidgets/QMessageBox>
@@ -44,18 +48,24 @@ Run::Run(indoorcycling::AntCentralDispatch *antCentralDispatch, RealLifeVideo& r
     BigRingSettings settings;
    _cyclist = new Cyclist(settings.userWeight(), settings.bikeWeight(), this);
 
-   connect(_cyclist, &Cyclist::distanceChanged, this, &Run::distanceChanged);
-   connect(_cyclist, &Cyclist::speedChanged, this, &Run::speedChanged);
+   connect(_cyclist, &Cyclist::stateUpdated, this, &Run::cyclistStateUpdated);
 
     NamedSensorConfigurationGroup sensorConfigurationGroup =
             NamedSensorConfigurationGroup::selectedConfigurationGroup();
 
     const int powerForElevationCorrectionPercentage = settings.powerForElevationCorrection();
-   _simulation = new Simulation(sensorConfigurationGroup.simulationSetting(), *_cyclist, powerForElevationCorrectionPercentage * 0.01, this);
+   _simulation = new Simulation(sensorConfigurationGroup.simulationSetting(), *_cyclist, powerForElevationCorrectionPercentage * 0.01,
+                                settings.simulationStepsPerSecond(), this);
 
     _simulation->rlvSelected(rlv);
     _simulation->courseSelected(course);
 
+    _rideFileSampler = new RideSampler(_rlv.name(), _course.name(), *_simulation, settings.rideRecordingRateHz(),
+                                       settings.rideSampleBufferKilobytes() * 1024,
+                                       TrainingMetrics(settings.functionalThresholdPower(),
+                                                       settings.anaerobicWorkCapacity()), this);
+    connect(_rideFileSampler, &RideSampler::trainingMetricsUpdated, this, &Run::trainingMetricsUpdated);
+
     indoorcycling::Sensors* sensors = new indoorcycling::Sensors(_antCentralDispatch,
                                                                  sensorConfigurationGroup,
                                                                  this);
@@ -64,6 +74,9 @@ Run::Run(indoorcycling::AntCentralDispatch *antCentralDispatch, RealLifeVideo& r
     connect(sensors, &Sensors::cadenceRpmMeasured, _simulation, &Simulation::setCadence);
     connect(sensors, &Sensors::powerWattsMeasured, _simulation, &Simulation::setPower);
     connect(sensors, &Sensors::wheelSpeedMpsMeasured, _simulation, &Simulation::setWheelSpeed);
+    connect(sensors, &Sensors::heartRateBpmMeasured, _rideFileSampler, &RideSampler::addHeartRate);
+    connect(sensors, &Sensors::cadenceRpmMeasured, _rideFileSampler, &RideSampler::addCadence);
+    connect(sensors, &Sensors::powerWattsMeasured, _rideFileSampler, &RideSampler::addPower);
     sensors->initialize();
 
     _actuators = new indoorcycling::Actuators(_cyclist, _antCentralDispatch, this);
@@ -80,8 +93,6 @@ Run::Run(indoorcycling::AntCentralDispatch *antCentralDispatch, RealLifeVideo& r
         }
     });
     _informationMessageTimer.start();
-
-    _rideFileSampler = new RideSampler(_rlv.name(), _course.name(), *_simulation, this);
 }
 
 Run::~Run()
@@ -129,7 +140,8 @@ bool Run::handleStopRun(QWidget *parent)
 {
     pause();
 
-    const QString savePath = RideFileWriter().determineFilePath(_rideFileSampler->rideFile());
+    const RideFile rideFile = _rideFileSampler->rideFile();
+    const QString savePath = RideFileWriter().determineFilePath(rideFile);
 
     QMessageBox stopRunMessageBox(parent);
     stopRunMessageBox.setText(tr("Save ride?"));
@@ -140,9 +152,11 @@ bool Run::handleStopRun(QWidget *parent)
 
     switch(stopRunMessageBox.exec()) {
     case QMessageBox::Save:
-        saveRideFile(parent);
-        // fallthrough
+        saveRideFile(rideFile);
+        stop();
+        return true;
     case QMessageBox::Discard:
+        _rideFileSampler->removeJournal();
         stop();
         return true;
     default:
@@ -151,34 +165,63 @@ bool Run::handleStopRun(QWidget *parent)
     }
 }
 
-void Run::distanceChanged(float distance)
+void Run::cyclistStateUpdated()
 {
-    if (_state == State::RIDING && distance > _course.end()) {
+    const CyclistState &cyclistState = _cyclist->state();
+    if ((_state == State::STARTING || _state == State::PAUSED) && cyclistState.speed > 0) {
+        setState(State::RIDING);
+    } else if (_state == State::RIDING && cyclistState.speed < 0.01) {
+        setState(State::PAUSED);
+    }
+
+    if (_state == State::RIDING && cyclistState.distance > _course.end()) {
         setState(State::FINISHED);
     }
 }
 
-void Run::speedChanged(float speed)
+void Run::waitUntilSaved()
 {
-    if ((_state == State::STARTING || _state == State::PAUSED) && speed > 0) {
-        setState(State::RIDING);
-    } else if (_state == State::RIDING && speed < 0.01) {
-        setState(State::PAUSED);
-    }
+    _saveFuture.waitForFinished();
 }
 
-QString Run::saveRideFile(QWidget *parent)
+/**
+ * Write the ride file on a worker thread, so the GUI stays responsive while a long ride is written. The run can be
+ * deleted before writing is finished, so everything the worker needs is copied. The journal of the ride is only
+ * removed when the ride file is written, so the ride can still be recovered if writing fails.
+ *
+ * The progress dialog has no parent, so it is not deleted with the main window while the worker still reports
+ * progress to it. It is only deleted when the worker is done.
+ */
+void Run::saveRideFile(const RideFile &rideFile)
 {
-    RideFileWriter writer;
-
-    QProgressDialog progressDialog("Saving...", QString(), 0, 100, parent);
-    progressDialog.setWindowModality(Qt::WindowModal);
-
-    // write the file. We'll use a lambda function to let the progress dialog update it's progress bar if there's
-    // a need for it (if the operation takes too long.
-    return writer.writeRideFile(_rideFileSampler->rideFile(), [&progressDialog](int percent) {
-        progressDialog.setValue(percent);
+    const QString journalPath = _rideFileSampler->closeJournal();
+    const RideFileWriter::Compression compression = BigRingSettings().compressRideFiles() ?
+                RideFileWriter::Compression::GZIP : RideFileWriter::Compression::NONE;
+    const bool writeFit = BigRingSettings().writeFitFiles();
+    const int functionalThresholdPower = BigRingSettings().functionalThresholdPower();
+    const int anaerobicWorkCapacity = BigRingSettings().anaerobicWorkCapacity();
+
+    QProgressDialog *progressDialog = new QProgressDialog(tr("Saving..."), QString(), 0, 100);
+    progressDialog->setWindowModality(Qt::ApplicationModal);
+    QFutureWatcher<QString> *futureWatcher = new QFutureWatcher<QString>();
+    connect(futureWatcher, &QFutureWatcher<QString>::finished, futureWatcher, [=]() {
+        progressDialog->deleteLater();
+        futureWatcher->deleteLater();
+    });
+    _saveFuture = QtConcurrent::run([rideFile, compression, writeFit, functionalThresholdPower,
+                                    anaerobicWorkCapacity, progressDialog, journalPath]() {
+        const QString filePath = RideFileWriter(compression).writeRideFile(rideFile, [progressDialog](int percent) {
+            QMetaObject::invokeMethod(progressDialog, "setValue", Qt::QueuedConnection, Q_ARG(int, percent));
+        });
+        if (writeFit) {
+            FitFileWriter(functionalThresholdPower, anaerobicWorkCapacity).writeRideFile(rideFile);
+        }
+        if (!filePath.isEmpty() && !journalPath.isEmpty()) {
+            QFile::remove(journalPath);
+        }
+        return filePath;
     });
+    futureWatcher->setFuture(_saveFuture);
 }
 
 void Run::setState(State newState)
@@ -21,12 +21,14 @@
 #ifndef RUN_H
 #define RUN_H
 
+#include <QtCore/QFuture>
 #include <QtCore/QObject>
 #include <QtCore/QSettings>
 
 #include "model/reallifevideo.h"
 #include "model/cyclist.h"
 #include "model/simulation.h"
+#include "model/trainingmetrics.h"
 
 namespace indoorcycling {
 class Actuators;
@@ -34,6 +36,7 @@ class AntCentralDispatch;
 }
 
 class NewVideoWidget;
+class RideFile;
 class RideSampler;
 
 class Run : public QObject
@@ -56,6 +59,8 @@ signals:
     void paused();
     void finished();
     void newInformationMessage(const InformationBox &message);
+    /** emitted for every sample of the ride */
+    void trainingMetricsUpdated(const TrainingMetrics &trainingMetrics);
 public slots:
     void start();
     void play();
@@ -66,11 +71,13 @@ public slots:
      * Handler for stopping run
      */
     bool handleStopRun(QWidget* parent);
+
+    /** Block until the ride file, if it is being saved, is written. Used when the application is closed. */
+    void waitUntilSaved();
 private slots:
-    void distanceChanged(float distance);
-    void speedChanged(float speed);
+    void cyclistStateUpdated();
 private:
-    QString saveRideFile(QWidget *parent);
+    void saveRideFile(const RideFile &rideFile);
     enum State {
         BEFORE_START, STARTING, RIDING, PAUSED, FINISHED
     };
@@ -86,6 +93,7 @@ private:
     QTimer _informationMessageTimer;
     InformationBox _lastInformationMessage;
     RideSampler *_rideFileSampler;
+    QFuture<QString> _saveFuture;
 };
 
 #endif // RUN_H
@@ -23,39 +23,55 @@
 #include <QtGui/QFontMetrics>
 #include <QtGui/QPainter>
 
-SensorItem::SensorItem(const QuantityPrinter::Quantity quantity, QObject *parent) :
-    QObject(parent), _quantityPrinter(new QuantityPrinter(this)), _quantity(quantity)
+namespace
+{
+/** the value can be drawn from the glyph atlas if it only contains these characters. */
+const QString VALUE_CHARACTERS = QStringLiteral("0123456789.-");
+/** same as the document margin of a QGraphicsTextItem, so the layout is the same as with a text item. */
+const int TEXT_MARGIN = 4; // px
+const qreal TEXT_OPACITY = 0.6;
+
+QFont valueFont()
 {
     QFont font = QFont("Liberation Mono");
     font.setBold(true);
     font.setPointSize(24);
+    return font;
+}
 
-    _textItem = new QGraphicsTextItem(this);
-    _textItem->setFont(font);
-    _textItem->setDefaultTextColor(Qt::white);
-    _textItem->setOpacity(0.6);
+QFont unitFont()
+{
+    QFont font = QFont("Liberation Mono");
+    font.setBold(true);
+    font.setPointSize(16);
+    return font;
+}
+}
 
-    _textItem->hide();
-    _textItem->setPlainText(QString("00000"));
-    _textItemWidth = _textItem->boundingRect().width();
-    _textItem->setPos(10, 5);
+/**
+ * The item is cached in device coordinates. With the OpenGL viewport, the cache is a texture that is composited on
+ * top of the video frame, and only the value part is rendered again when the value changes.
+ */
+SensorItem::SensorItem(const QuantityPrinter::Quantity quantity, QObject *parent) :
+    QObject(parent), _quantityPrinter(new QuantityPrinter(this)), _quantity(quantity),
+    _glyphAtlas(GlyphAtlas::atlas(valueFont(), Qt::white, VALUE_CHARACTERS)), _unitFont(unitFont()),
+    _hasPendingValue(false),
+    _unit(QString("%1").arg(_quantityPrinter->unitString(quantity, QuantityPrinter::Precision::Precise), 3))
+{
+    const QSize textSize = _glyphAtlas->textSize(QString("00000"));
+    _textRect = QRectF(10, 5, textSize.width() + 2 * TEXT_MARGIN, textSize.height() + 2 * TEXT_MARGIN);
+
+    const QFontMetrics unitFontMetrics(_unitFont);
+    const qreal unitHeight = unitFontMetrics.height() + 2 * TEXT_MARGIN;
+    _unitRect = QRectF(_textRect.width() + 5, _textRect.height() - unitHeight - 3,
+                       unitFontMetrics.width(QString("WWW")) + 2 * TEXT_MARGIN, unitHeight);
 
-    QFont unitFont = QFont("Liberation Mono");
-    unitFont.setBold(true);
-    unitFont.setPointSize(16);
-    _unitItem = new QGraphicsTextItem(this);
-    _unitItem->setFont(unitFont);
-    _unitItem->setDefaultTextColor(Qt::white);
-    _unitItem->setOpacity(0.6);
-    _unitItem->setPlainText("WWW");
-    _unitItemWidth = _unitItem->boundingRect().width();
-    _unitItem->setPos(_textItem->boundingRect().width() + 5, _textItem->boundingRect().bottom() - _unitItem->boundingRect().height() - 3);
-    _unitItem->setPlainText(QString("%1").arg(_quantityPrinter->unitString(quantity, QuantityPrinter::Precision::Precise), 3));
+    setCacheMode(QGraphicsItem::DeviceCoordinateCache);
 }
 
 QRectF SensorItem::boundingRect() const
 {
-    return QRectF(0, 0, _textItemWidth + 5 + _unitItemWidth + 20, _textItem->boundingRect().height());
+    return QRectF(0, 0, _textRect.width() + 5 + _unitRect.width() + 20, _textRect.height());
 }
 
 void SensorItem::paint(QPainter *painter, const QStyleOptionGraphicsItem *, QWidget *)
@@ -66,14 +82,37 @@ void SensorItem::paint(QPainter *painter, const QStyleOptionGraphicsItem *, QWid
     painter->setBrush(Qt::black);
     painter->setOpacity(0.65);
     painter->drawRoundedRect(boundingRect(), 5, 5);
+
+    painter->setOpacity(TEXT_OPACITY);
+    painter->setPen(Qt::white);
+    painter->setFont(_unitFont);
+    painter->drawText(_unitRect.adjusted(TEXT_MARGIN, TEXT_MARGIN, 0, 0), Qt::AlignLeft | Qt::AlignTop, _unit);
+    if (!_text.isEmpty()) {
+        _glyphAtlas->drawText(painter, _textRect.topLeft() + QPointF(TEXT_MARGIN, TEXT_MARGIN), _text);
+    }
 }
 
+void SensorItem::applyPendingValue()
+{
+    if (!_hasPendingValue) {
+        return;
+    }
+    _hasPendingValue = false;
+
+    const QString unit = _quantityPrinter->unitString(_quantity, QuantityPrinter::Precision::Precise, _pendingValue);
+    if (unit != _unit) {
+        _unit = unit;
+        update(_unitRect.adjusted(0, 0, 20, 0));
+    }
+    const QString text = _quantityPrinter->print(_pendingValue, _quantity, QuantityPrinter::Precision::Precise);
+    if (text != _text) {
+        _text = text;
+        update(_textRect);
+    }
+}
 
 void SensorItem::setValue(const QVariant &value)
 {
-    _unitItem->setPlainText(_quantityPrinter->unitString(_quantity, QuantityPrinter::Precision::Precise, value));
-    _textItem->setPlainText(_quantityPrinter->print(value, _quantity, QuantityPrinter::Precision::Precise));
-    _textItem->show();
+    _pendingValue = value;
+    _hasPendingValue = true;
 }
-
-
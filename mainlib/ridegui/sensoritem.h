@@ -27,6 +27,7 @@
 
 #include "generalgui/quantityprinter.h"
 #include "model/simulation.h"
+#include "glyphatlas.h"
 
 class SensorItem : public QObject, public QGraphicsItem
 {
@@ -38,16 +39,26 @@ public:
 
     virtual QRectF boundingRect() const;
     void paint(QPainter *painter, const QStyleOptionGraphicsItem *option, QWidget *widget);
+
+    /**
+     * Show the last value that was set. Setting a value only stores it, the (relatively expensive) update of the
+     * display is done here, at most once per displayed video frame.
+     */
+    void applyPendingValue();
 public slots:
     virtual void setValue(const QVariant &value);
 private:
     const QuantityPrinter* _quantityPrinter;
     const QuantityPrinter::Quantity _quantity;
-    int _textItemWidth;
-    int _unitItemWidth;
+    const std::shared_ptr<const GlyphAtlas> _glyphAtlas;
+    const QFont _unitFont;
+    QRectF _textRect;
+    QRectF _unitRect;
 
-    QGraphicsTextItem* _textItem;
-    QGraphicsTextItem* _unitItem;
+    QVariant _pendingValue;
+    bool _hasPendingValue;
+    QString _text;
+    QString _unit;
 };
 
 #endif // SENSORITEM_H
@@ -13,6 +13,7 @@ extern "C" {
 #include <libavformat/avformat.h>
 }
 
+#include "config/bigringsettings.h"
 #include "model/reallifevideo.h"
 
 namespace {
@@ -61,7 +62,7 @@ public:
 FrameCopyingVideoReader::FrameCopyingVideoReader(QObject *parent) :
     GenericVideoReader(parent), _currentFrameNumber(0)
 {
-    // empty
+    setReadAheadBytes(qint64(BigRingSettings().videoReadAheadMegabytes()) * 1024 * 1024);
 }
 
 FrameCopyingVideoReader::~FrameCopyingVideoReader()
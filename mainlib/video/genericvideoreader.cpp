@@ -1,6 +1,7 @@
 #include "genericvideoreader.h"
 
 #include <array>
+#include <cerrno>
 
 #include <QtCore/QSize>
 #include <QtCore/QtDebug>
@@ -12,6 +13,46 @@ extern "C" {
 
 namespace {
 const int ERROR_STR_BUF_SIZE = 128;
+const int IO_BUFFER_SIZE = 64 * 1024; // bytes
+
+int readPacket(void* opaque, uint8_t* buffer, int size)
+{
+    ReadAheadFile* file = static_cast<ReadAheadFile*>(opaque);
+    const int bytesRead = file->read(buffer, size);
+    if (bytesRead < 0) {
+        return AVERROR(EIO);
+    }
+    if (bytesRead == 0) {
+        return AVERROR_EOF;
+    }
+    return bytesRead;
+}
+
+int64_t seekFile(void* opaque, int64_t offset, int whence)
+{
+    ReadAheadFile* file = static_cast<ReadAheadFile*>(opaque);
+    whence &= ~AVSEEK_FORCE;
+    qint64 position;
+    switch (whence) {
+    case AVSEEK_SIZE:
+        return file->size();
+    case SEEK_SET:
+        position = offset;
+        break;
+    case SEEK_CUR:
+        position = file->position() + offset;
+        break;
+    case SEEK_END:
+        position = file->size() + offset;
+        break;
+    default:
+        return AVERROR(EINVAL);
+    }
+    if (!file->seek(position)) {
+        return AVERROR(EINVAL);
+    }
+    return position;
+}
 }
 GenericVideoReader::GenericVideoReader(QObject *parent) :
     QObject(parent)
@@ -42,6 +83,43 @@ void GenericVideoReader::close()
     if (_formatContext) {
         avformat_close_input(&_formatContext);
     }
+    if (_ioContext) {
+        av_freep(&_ioContext->buffer);
+        av_freep(&_ioContext);
+    }
+    std::atomic_store(&_readAheadFile, std::shared_ptr<ReadAheadFile>());
+}
+
+void GenericVideoReader::setReadAheadBytes(qint64 readAheadBytes)
+{
+    _readAheadBytes = readAheadBytes;
+}
+
+ReadAheadStatistics GenericVideoReader::readAheadStatistics() const
+{
+    const std::shared_ptr<ReadAheadFile> file = std::atomic_load(&_readAheadFile);
+    return (file) ? file->statistics() : ReadAheadStatistics();
+}
+
+/**
+ * Let libav read the video file through a ReadAheadFile, so the demuxer does not have to wait for slow storage.
+ */
+bool GenericVideoReader::openReadAheadFile(const QString &videoFilename)
+{
+    std::shared_ptr<ReadAheadFile> file = std::make_shared<ReadAheadFile>(videoFilename, _readAheadBytes);
+    if (!file->open()) {
+        return false;
+    }
+    uint8_t* buffer = static_cast<uint8_t*>(av_malloc(IO_BUFFER_SIZE));
+    _ioContext = avio_alloc_context(buffer, IO_BUFFER_SIZE, 0, file.get(), &readPacket, nullptr, &seekFile);
+    if (!_ioContext) {
+        av_free(buffer);
+        return false;
+    }
+    _formatContext = avformat_alloc_context();
+    _formatContext->pb = _ioContext;
+    std::atomic_store(&_readAheadFile, file);
+    return true;
 }
 
 /**
@@ -140,6 +218,9 @@ void GenericVideoReader::openVideoFileInternal(const QString &videoFilename)
         return;
     }
     close();
+    if (_readAheadBytes > 0 && !openReadAheadFile(videoFilename)) {
+        qWarning("Unable to read ahead in %s, reading it directly", qPrintable(videoFilename));
+    }
     int errorNr = avformat_open_input(&_formatContext, videoFilename.toStdString().c_str(),
                                                                               NULL, NULL);
     if (errorNr != 0) {
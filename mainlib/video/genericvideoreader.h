@@ -4,10 +4,13 @@
 #include <memory>
 #include <QtCore/QObject>
 
+#include "readaheadfile.h"
+
 struct AVCodec;
 struct AVCodecContext;
 struct AVFormatContext;
 struct AVFrame;
+struct AVIOContext;
 struct AVPicture;
 struct AVStream;
 
@@ -32,6 +35,9 @@ public:
     explicit GenericVideoReader(QObject *parent = 0);
     virtual ~GenericVideoReader();
 
+    /** Fill level of the read-ahead buffer. Can be called from any thread. */
+    ReadAheadStatistics readAheadStatistics() const;
+
 signals:
     void error(const QString& errorMessage);
     void seekReady(qint64 frameNumber);
@@ -40,6 +46,11 @@ public slots:
 
 protected:
     virtual void openVideoFileInternal(const QString &videoFilename);
+    /**
+     * Read video files through a ReadAheadFile with a read-ahead window of at least readAheadBytes. Set to 0 to let
+     * libav read the file directly. Takes effect when the next file is opened.
+     */
+    void setReadAheadBytes(qint64 readAheadBytes);
     void performSeek(qint64 targetFrameNumber);
     void loadFramesUntilTargetFrame(qint64 targetFrameNumber);
     qint64 loadNextFrame();
@@ -54,6 +65,7 @@ private:
     void close();
     void printError(int errorNumber, const QString& message);
     void printError(const QString &message);
+    bool openReadAheadFile(const QString& videoFilename);
     int findVideoStream(AVFormatContext* formatContext) const;
     qint64 frameNumberToTimestamp(const qint64 frameNumber) const;
     qint64 timestampToFrameNumber(const qint64 timestamp) const;
@@ -66,6 +78,10 @@ private:
     std::unique_ptr<AVFrameWrapper> _frameYuv;
     int _currentVideoStream;
     AVStream* _videoStream = nullptr;
+    AVIOContext* _ioContext = nullptr;
+
+    qint64 _readAheadBytes = 0;
+    std::shared_ptr<ReadAheadFile> _readAheadFile;
 };
 
 #endif // GENERICVIDEOREADER_H
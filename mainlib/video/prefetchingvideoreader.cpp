@@ -0,0 +1,159 @@
+/*
+ * Copyright (c) 2015 Ilja Booij (ibooij@gmail.com)
+ *
+ * This file is part of Big Ring Indoor Video Cycling
+ *
+ * Big Ring Indoor Video Cycling is free software: you can redistribute
+ * it and/or modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation, either version 3 of the
+ * License, or (at your option) any later version.
+ *
+ * Big Ring Indoor Video Cycling  is distributed in the hope that it will
+ * be useful, but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+
+ * You should have received a copy of the GNU General Public License
+ * along with Big Ring Indoor Video Cycling.  If not, see
+ * <http://www.gnu.org/licenses/>.
+ */
+
+#include "prefetchingvideoreader.h"
+
+#include <QtCore/QCoreApplication>
+#include <QtCore/QElapsedTimer>
+#include <QtCore/QFile>
+#include <QtCore/QtDebug>
+
+#ifdef Q_OS_LINUX
+#include <fcntl.h>
+#endif
+
+extern "C" {
+#include <libavcodec/avcodec.h>
+#include <libavformat/avformat.h>
+}
+
+namespace {
+QEvent::Type PrefetchEventType = static_cast<QEvent::Type>(QEvent::User + 106);
+
+/** number of bytes from the start frame on that are read ahead */
+const qint64 PREFETCH_BYTES = 64 * 1024 * 1024;
+#ifndef Q_OS_LINUX
+/** size of the reads when the file range is read to get it into the page cache */
+const qint64 READ_CHUNK_BYTES = 1024 * 1024;
+#endif
+
+class PrefetchEvent: public QEvent
+{
+public:
+    PrefetchEvent(int requestNumber, const QString& videoFilename, qint64 frameNumber):
+        QEvent(PrefetchEventType), _requestNumber(requestNumber), _videoFilename(videoFilename),
+        _frameNumber(frameNumber)
+    {
+        // empty
+    }
+
+    const int _requestNumber;
+    const QString _videoFilename;
+    const qint64 _frameNumber;
+};
+}
+
+PrefetchingVideoReader::PrefetchingVideoReader(QObject *parent) :
+    GenericVideoReader(parent), _latestRequestNumber(0)
+{
+    // empty
+}
+
+PrefetchingVideoReader::~PrefetchingVideoReader()
+{
+    qDebug() << "closing PrefetchingVideoReader";
+}
+
+void PrefetchingVideoReader::prefetch(const QString &videoFilename, qint64 frameNumber)
+{
+    const int requestNumber = ++_latestRequestNumber;
+    QCoreApplication::postEvent(this, new PrefetchEvent(requestNumber, videoFilename, frameNumber));
+}
+
+bool PrefetchingVideoReader::event(QEvent *event)
+{
+    if (event->type() == PrefetchEventType) {
+        PrefetchEvent* prefetchEvent = dynamic_cast<PrefetchEvent*>(event);
+        // when someone is clicking through the courses, only prefetch for the last one.
+        if (prefetchEvent->_requestNumber == _latestRequestNumber.load()) {
+            prefetchInternal(prefetchEvent->_videoFilename, prefetchEvent->_frameNumber);
+        }
+        return true;
+    }
+    return GenericVideoReader::event(event);
+}
+
+/**
+ * The demuxer is kept open after the prefetch, so prefetching another course of the same video only needs a seek.
+ */
+void PrefetchingVideoReader::prefetchInternal(const QString &videoFilename, qint64 frameNumber)
+{
+    QElapsedTimer timer;
+    timer.start();
+
+    if (!QFile::exists(videoFilename)) {
+        return;
+    }
+    openVideoFileInternal(videoFilename);
+    if (!formatContext()) {
+        return;
+    }
+    performSeek(frameNumber);
+    const qint64 position = bytePositionOfNextPacket();
+    if (position >= 0) {
+        warmPageCache(videoFilename, position, PREFETCH_BYTES);
+    }
+    qDebug() << "prefetched" << videoFilename << "from frame" << frameNumber << "byte position" << position
+             << "in" << timer.elapsed() << "ms";
+    emit prefetched(videoFilename, frameNumber);
+}
+
+/**
+ * The byte position in the file of the packet that will be read next. After a seek, this is the key frame the
+ * decoder has to start from.
+ */
+qint64 PrefetchingVideoReader::bytePositionOfNextPacket()
+{
+    AVPacket packet;
+    if (av_read_frame(formatContext(), &packet) < 0) {
+        return -1;
+    }
+    const qint64 position = packet.pos;
+    av_free_packet(&packet);
+    return (position >= 0) ? position : avio_tell(formatContext()->pb);
+}
+
+/**
+ * On Linux, we let the kernel read the range in the background. On other systems we just read the range, the
+ * operating system will keep the pages in its cache.
+ */
+void PrefetchingVideoReader::warmPageCache(const QString &videoFilename, qint64 offset, qint64 length)
+{
+    QFile file(videoFilename);
+    if (!file.open(QIODevice::ReadOnly)) {
+        qWarning("Unable to open %s for prefetching", qPrintable(videoFilename));
+        return;
+    }
+#ifdef Q_OS_LINUX
+    posix_fadvise(file.handle(), offset, length, POSIX_FADV_WILLNEED);
+#else
+    if (!file.seek(offset)) {
+        return;
+    }
+    QByteArray buffer(READ_CHUNK_BYTES, Qt::Uninitialized);
+    for (qint64 bytesRead = 0; bytesRead < length; ) {
+        const qint64 read = file.read(buffer.data(), qMin(READ_CHUNK_BYTES, length - bytesRead));
+        if (read <= 0) {
+            break;
+        }
+        bytesRead += read;
+    }
+#endif
+}
@@ -0,0 +1,65 @@
+/*
+ * Copyright (c) 2015 Ilja Booij (ibooij@gmail.com)
+ *
+ * This file is part of Big Ring Indoor Video Cycling
+ *
+ * Big Ring Indoor Video Cycling is free software: you can redistribute
+ * it and/or modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation, either version 3 of the
+ * License, or (at your option) any later version.
+ *
+ * Big Ring Indoor Video Cycling  is distributed in the hope that it will
+ * be useful, but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+
+ * You should have received a copy of the GNU General Public License
+ * along with Big Ring Indoor Video Cycling.  If not, see
+ * <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef PREFETCHINGVIDEOREADER_H
+#define PREFETCHINGVIDEOREADER_H
+
+#include <atomic>
+
+#include <QtCore/QEvent>
+#include <QtCore/QObject>
+
+#include "genericvideoreader.h"
+
+/**
+ * Video reader that prepares a video for playback from a certain frame, without decoding anything.
+ *
+ * Opening the video reads the container headers and index, seeking finds the byte position of the key frame before
+ * the start frame. The file range from that position on is then read into the page cache of the operating system.
+ * When the video player opens the same file a little later, these reads come from memory instead of from (slow or
+ * network) storage.
+ *
+ * Like the other video readers, this reader should run in its own thread.
+ */
+class PrefetchingVideoReader : public GenericVideoReader
+{
+    Q_OBJECT
+public:
+    explicit PrefetchingVideoReader(QObject *parent = 0);
+    virtual ~PrefetchingVideoReader();
+
+    /**
+     * Prefetch a video from a frame. Can be called from any thread. When a new prefetch is requested before an
+     * older one was started, the older one is skipped.
+     */
+    void prefetch(const QString& videoFilename, qint64 frameNumber);
+signals:
+    void prefetched(const QString& videoFilename, qint64 frameNumber);
+protected:
+    virtual bool event(QEvent *) override;
+private:
+    void prefetchInternal(const QString& videoFilename, qint64 frameNumber);
+    qint64 bytePositionOfNextPacket();
+    void warmPageCache(const QString& videoFilename, qint64 offset, qint64 length);
+
+    std::atomic<int> _latestRequestNumber;
+};
+
+#endif // PREFETCHINGVIDEOREADER_H
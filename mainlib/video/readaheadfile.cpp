@@ -0,0 +1,251 @@
+/*
+ * Copyright (c) 2015 Ilja Booij (ibooij@gmail.com)
+ *
+ * This file is part of Big Ring Indoor Video Cycling
+ *
+ * Big Ring Indoor Video Cycling is free software: you can redistribute
+ * it and/or modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation, either version 3 of the
+ * License, or (at your option) any later version.
+ *
+ * Big Ring Indoor Video Cycling  is distributed in the hope that it will
+ * be useful, but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+
+ * You should have received a copy of the GNU General Public License
+ * along with Big Ring Indoor Video Cycling.  If not, see
+ * <http://www.gnu.org/licenses/>.
+ */
+
+#include "readaheadfile.h"
+
+#include <cstring>
+
+#include <QtCore/QtDebug>
+
+namespace
+{
+const qint64 BLOCK_BYTES = 1024 * 1024;
+/** blocks kept before the read position */
+const qint64 BLOCKS_BEHIND = 4;
+/** the window holds about this many seconds of video at the current read rate */
+const qint64 READ_AHEAD_SECONDS = 20;
+const qint64 RATE_INTERVAL_MS = 1000;
+/** a block that cannot be read is tried this many times before the read fails */
+const int MAXIMUM_READ_ATTEMPTS = 5;
+const unsigned long RETRY_DELAY_MS = 200;
+}
+
+qreal ReadAheadStatistics::fillPercentage() const
+{
+    return (windowBytes == 0) ? 0 : qMin(100.0, 100.0 * bufferedBytes / windowBytes);
+}
+
+ReadAheadFile::ReadAheadFile(const QString &filename, qint64 readAheadBytes, QObject *parent):
+    QThread(parent), _filename(filename), _minimumWindowBytes(qMax(BLOCK_BYTES, readAheadBytes)),
+    _maximumWindowBytes(4 * _minimumWindowBytes), _file(filename), _size(0), _stopping(false), _ioError(false),
+    _position(0), _bytesReadForRate(0), _bytesPerSecond(0), _stalls(0), _totalStallNs(0)
+{
+    // empty
+}
+
+ReadAheadFile::~ReadAheadFile()
+{
+    {
+        QMutexLocker locker(&_mutex);
+        _stopping = true;
+        _positionChanged.wakeAll();
+    }
+    wait();
+}
+
+bool ReadAheadFile::open()
+{
+    if (!_file.open(QIODevice::ReadOnly)) {
+        qWarning("Unable to open %s: %s", qPrintable(_filename), qPrintable(_file.errorString()));
+        return false;
+    }
+    _size = _file.size();
+    _rateTimer.start();
+    start();
+    return true;
+}
+
+qint64 ReadAheadFile::size() const
+{
+    return _size;
+}
+
+int ReadAheadFile::read(quint8 *data, int size)
+{
+    QMutexLocker locker(&_mutex);
+    int bytesRead = 0;
+    bool stalled = false;
+    QElapsedTimer stallTimer;
+    while (bytesRead < size && _position < _size) {
+        const auto it = _blocks.find(_position / BLOCK_BYTES);
+        if (it == _blocks.end()) {
+            if (_ioError) {
+                break;
+            }
+            if (!stalled) {
+                stalled = true;
+                stallTimer.start();
+            }
+            _positionChanged.wakeAll();
+            _blockLoaded.wait(&_mutex);
+            continue;
+        }
+        const qint64 offsetInBlock = _position % BLOCK_BYTES;
+        const int count = static_cast<int>(qMin<qint64>(size - bytesRead, it->second.size() - offsetInBlock));
+        if (count <= 0) {
+            break;
+        }
+        std::memcpy(data + bytesRead, it->second.constData() + offsetInBlock, count);
+        bytesRead += count;
+        _position += count;
+    }
+    if (stalled) {
+        _stalls += 1;
+        _totalStallNs += stallTimer.nsecsElapsed();
+    }
+    updateRate(bytesRead);
+    _positionChanged.wakeAll();
+
+    if (bytesRead == 0 && _ioError) {
+        return -1;
+    }
+    return bytesRead;
+}
+
+bool ReadAheadFile::seek(qint64 position)
+{
+    if (position < 0 || position > _size) {
+        return false;
+    }
+    QMutexLocker locker(&_mutex);
+    _position = position;
+    // a new position might be readable, even if the previous one wasn't.
+    _ioError = false;
+    _positionChanged.wakeAll();
+    return true;
+}
+
+qint64 ReadAheadFile::position() const
+{
+    QMutexLocker locker(&_mutex);
+    return _position;
+}
+
+ReadAheadStatistics ReadAheadFile::statistics() const
+{
+    QMutexLocker locker(&_mutex);
+    ReadAheadStatistics statistics;
+    statistics.windowBytes = windowBytes();
+    for (qint64 block = _position / BLOCK_BYTES; _blocks.count(block) > 0; ++block) {
+        statistics.bufferedBytes += _blocks.at(block).size();
+    }
+    statistics.bufferedBytes = qMax<qint64>(0, statistics.bufferedBytes - _position % BLOCK_BYTES);
+    statistics.bytesPerSecond = _bytesPerSecond;
+    statistics.stalls = _stalls;
+    statistics.totalStallNs = _totalStallNs;
+    return statistics;
+}
+
+/**
+ * The I/O thread. The file is read without holding the mutex, so the reader can take loaded blocks while the next
+ * block is being read.
+ */
+void ReadAheadFile::run()
+{
+    QMutexLocker locker(&_mutex);
+    while (!_stopping) {
+        const qint64 block = nextBlockToLoad();
+        if (block < 0) {
+            _positionChanged.wait(&_mutex);
+            continue;
+        }
+        locker.unlock();
+        QByteArray data = readBlock(block);
+        locker.relock();
+        if (data.isNull()) {
+            qWarning("Unable to read block %lld of %s", block, qPrintable(_filename));
+            _ioError = true;
+            _blockLoaded.wakeAll();
+            // wait until the reader moves somewhere else before trying again.
+            _positionChanged.wait(&_mutex);
+            continue;
+        }
+        _blocks[block] = data;
+        dropBlocksOutsideWindow();
+        _blockLoaded.wakeAll();
+    }
+}
+
+/**
+ * Read a block from the file. Network storage may fail for a short while, so a failed read is tried again a few
+ * times before giving up.
+ */
+QByteArray ReadAheadFile::readBlock(qint64 block)
+{
+    for (int attempt = 0; attempt < MAXIMUM_READ_ATTEMPTS; ++attempt) {
+        if (attempt > 0) {
+            msleep(RETRY_DELAY_MS);
+        }
+        if (_file.seek(block * BLOCK_BYTES)) {
+            QByteArray data = _file.read(BLOCK_BYTES);
+            if (!data.isEmpty()) {
+                return data;
+            }
+        }
+    }
+    return QByteArray();
+}
+
+qint64 ReadAheadFile::windowBytes() const
+{
+    return qBound(_minimumWindowBytes, _bytesPerSecond * READ_AHEAD_SECONDS, _maximumWindowBytes);
+}
+
+/**
+ * The block at the read position is loaded first, after that the window is filled from front to back.
+ */
+qint64 ReadAheadFile::nextBlockToLoad() const
+{
+    if (_ioError || _size == 0) {
+        return -1;
+    }
+    const qint64 firstBlock = _position / BLOCK_BYTES;
+    const qint64 lastBlock = qMin((_position + windowBytes()) / BLOCK_BYTES, (_size - 1) / BLOCK_BYTES);
+    for (qint64 block = firstBlock; block <= lastBlock; ++block) {
+        if (_blocks.count(block) == 0) {
+            return block;
+        }
+    }
+    return -1;
+}
+
+void ReadAheadFile::dropBlocksOutsideWindow()
+{
+    const qint64 firstBlock = _position / BLOCK_BYTES - BLOCKS_BEHIND;
+    const qint64 lastBlock = (_position + windowBytes()) / BLOCK_BYTES;
+    for (auto it = _blocks.begin(); it != _blocks.end(); ) {
+        if (it->first < firstBlock || it->first > lastBlock) {
+            it = _blocks.erase(it);
+        } else {
+            ++it;
+        }
+    }
+}
+
+void ReadAheadFile::updateRate(qint64 bytesRead)
+{
+    _bytesReadForRate += bytesRead;
+    const qint64 elapsedMs = _rateTimer.elapsed();
+    if (elapsedMs >= RATE_INTERVAL_MS) {
+        _bytesPerSecond = _bytesReadForRate * 1000 / elapsedMs;
+        _bytesReadForRate = 0;
+        _rateTimer.restart();
+    }
+}
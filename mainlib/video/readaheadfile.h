@@ -0,0 +1,116 @@
+/*
+ * Copyright (c) 2015 Ilja Booij (ibooij@gmail.com)
+ *
+ * This file is part of Big Ring Indoor Video Cycling
+ *
+ * Big Ring Indoor Video Cycling is free software: you can redistribute
+ * it and/or modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation, either version 3 of the
+ * License, or (at your option) any later version.
+ *
+ * Big Ring Indoor Video Cycling  is distributed in the hope that it will
+ * be useful, but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+
+ * You should have received a copy of the GNU General Public License
+ * along with Big Ring Indoor Video Cycling.  If not, see
+ * <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef READAHEADFILE_H
+#define READAHEADFILE_H
+
+#include <map>
+
+#include <QtCore/QByteArray>
+#include <QtCore/QElapsedTimer>
+#include <QtCore/QFile>
+#include <QtCore/QMutex>
+#include <QtCore/QThread>
+#include <QtCore/QWaitCondition>
+
+/**
+ * Fill level and timing of a ReadAheadFile.
+ */
+struct ReadAheadStatistics
+{
+    /** bytes that are loaded from the read position on */
+    qint64 bufferedBytes = 0;
+    /** size of the read-ahead window */
+    qint64 windowBytes = 0;
+    /** rate at which the reader consumes bytes */
+    qint64 bytesPerSecond = 0;
+    /** number of reads that had to wait for the I/O thread */
+    quint64 stalls = 0;
+    qint64 totalStallNs = 0;
+
+    qreal fillPercentage() const;
+};
+
+/**
+ * A read only file that is read ahead of the read position by a separate I/O thread.
+ *
+ * The file is loaded in blocks. The I/O thread keeps the blocks from the read position up to the end of the read-ahead
+ * window loaded, and a few blocks before the read position, for the short backward seeks a demuxer does to get to a
+ * key frame. Blocks outside this range are dropped.
+ *
+ * The window grows with the rate at which the file is read, which follows the speed of the rider, so there's always
+ * about the same number of seconds of video loaded. It never gets smaller than the configured size, or larger than
+ * four times that size.
+ *
+ * read() and seek() should be called from a single thread, the thread of the demuxer.
+ */
+class ReadAheadFile : public QThread
+{
+    Q_OBJECT
+public:
+    explicit ReadAheadFile(const QString& filename, qint64 readAheadBytes, QObject* parent = 0);
+    virtual ~ReadAheadFile();
+
+    /** open the file and start the I/O thread. */
+    bool open();
+
+    qint64 size() const;
+    /**
+     * Read up to size bytes. Blocks until the data is loaded.
+     * @return the number of bytes read, 0 at the end of the file or -1 if the file could not be read.
+     */
+    int read(quint8* data, int size);
+    /** set the read position */
+    bool seek(qint64 position);
+    qint64 position() const;
+
+    /** Can be called from any thread. */
+    ReadAheadStatistics statistics() const;
+protected:
+    void run() override;
+private:
+    QByteArray readBlock(qint64 block);
+    qint64 windowBytes() const;
+    qint64 nextBlockToLoad() const;
+    void dropBlocksOutsideWindow();
+    void updateRate(qint64 bytesRead);
+
+    const QString _filename;
+    const qint64 _minimumWindowBytes;
+    const qint64 _maximumWindowBytes;
+    QFile _file;
+    qint64 _size;
+
+    mutable QMutex _mutex;
+    QWaitCondition _blockLoaded;
+    QWaitCondition _positionChanged;
+    bool _stopping;
+    bool _ioError;
+    qint64 _position;
+    std::map<qint64,QByteArray> _blocks;
+
+    QElapsedTimer _rateTimer;
+    qint64 _bytesReadForRate;
+    qint64 _bytesPerSecond;
+    quint64 _stalls;
+    qint64 _totalStallNs;
+};
+
+#endif // READAHEADFILE_H
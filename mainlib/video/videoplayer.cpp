@@ -153,6 +153,7 @@ void VideoPlayer::determineFrameRate()
 {
     int numberOfFrames = _currentFrameNumber - _lastFrameNumber;
     emit frameRateChanged(qMax(numberOfFrames, 0));
+    emit readAheadStatisticsChanged(_videoReader->readAheadStatistics());
     _lastFrameNumber = _currentFrameNumber;
 }
 
@@ -29,6 +29,7 @@
 class FrameBuffer;
 class OpenGLPainter2;
 class FrameCopyingVideoReader;
+struct ReadAheadStatistics;
 
 /*!
  * \brief Video player for cycling videos. This is a frame based player, so clients can seek to
@@ -81,6 +82,11 @@ signals:
      */
     void frameRateChanged(int frameRate);
 
+    /**
+     * emitted together with frameRateChanged, with the fill level of the read-ahead buffer of the video file.
+     */
+    void readAheadStatisticsChanged(const ReadAheadStatistics& statistics);
+
 public slots:
     /*! stop the video */
     void stop();
@@ -0,0 +1,49 @@
+/*
+ * Copyright (c) 2015 Ilja Booij (ibooij@gmail.com)
+ *
+ * This file is part of Big Ring Indoor Video Cycling
+ *
+ * Big Ring Indoor Video Cycling is free software: you can redistribute
+ * it and/or modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation, either version 3 of the
+ * License, or (at your option) any later version.
+ *
+ * Big Ring Indoor Video Cycling  is distributed in the hope that it will
+ * be useful, but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+
+ * You should have received a copy of the GNU General Public License
+ * along with Big Ring Indoor Video Cycling.  If not, see
+ * <http://www.gnu.org/licenses/>.
+ */
+
+#include "videoprefetcher.h"
+
+#include <QtCore/QThread>
+
+#include "prefetchingvideoreader.h"
+
+VideoPrefetcher::VideoPrefetcher(QObject *parent):
+    QObject(parent), _videoReader(new PrefetchingVideoReader), _videoReaderThread(new QThread)
+{
+    // prefetching does blocking I/O, keep it away from the UI thread.
+    _videoReader->moveToThread(_videoReaderThread);
+
+    // Make sure that when the videoReaderThread is stopped and it is deleted
+    connect(_videoReaderThread, &QThread::finished, _videoReaderThread, &QThread::deleteLater);
+    connect(_videoReaderThread, &QThread::finished, _videoReader, &PrefetchingVideoReader::deleteLater);
+    _videoReaderThread->start(QThread::LowPriority);
+}
+
+VideoPrefetcher::~VideoPrefetcher()
+{
+    _videoReaderThread->quit();
+}
+
+void VideoPrefetcher::prefetch(const RealLifeVideo &rlv, const qreal distance)
+{
+    if (rlv.isValid()) {
+        _videoReader->prefetch(rlv.videoFilename(), rlv.frameForDistance(distance));
+    }
+}
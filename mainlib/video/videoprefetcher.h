@@ -0,0 +1,51 @@
+/*
+ * Copyright (c) 2015 Ilja Booij (ibooij@gmail.com)
+ *
+ * This file is part of Big Ring Indoor Video Cycling
+ *
+ * Big Ring Indoor Video Cycling is free software: you can redistribute
+ * it and/or modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation, either version 3 of the
+ * License, or (at your option) any later version.
+ *
+ * Big Ring Indoor Video Cycling  is distributed in the hope that it will
+ * be useful, but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+
+ * You should have received a copy of the GNU General Public License
+ * along with Big Ring Indoor Video Cycling.  If not, see
+ * <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef VIDEOPREFETCHER_H
+#define VIDEOPREFETCHER_H
+
+#include <QtCore/QObject>
+
+#include "model/reallifevideo.h"
+
+class PrefetchingVideoReader;
+class QThread;
+
+/**
+ * @brief Prepares a video for playback as soon as a course is selected, so the ride starts without waiting for
+ * the video file to be read from slow storage.
+ *
+ * The actual work is done by a PrefetchingVideoReader in a seperate thread.
+ */
+class VideoPrefetcher : public QObject
+{
+    Q_OBJECT
+public:
+    explicit VideoPrefetcher(QObject* parent = 0);
+    virtual ~VideoPrefetcher();
+
+    /** Prefetch the video of rlv from distance on. */
+    void prefetch(const RealLifeVideo& rlv, const qreal distance);
+private:
+    PrefetchingVideoReader* const _videoReader;
+    QThread* const _videoReaderThread;
+};
+
+#endif // VIDEOPREFETCHER_H
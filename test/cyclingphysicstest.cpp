@@ -0,0 +1,138 @@
+#include "cyclingphysicstest.h"
+
+#include <cmath>
+
+#include <QtTest/QTest>
+
+#include "model/cyclingphysics.h"
+
+namespace
+{
+const qreal TOTAL_WEIGHT = 80; // kg
+const qint64 NS_PER_MS = 1000000;
+const qint64 NS_PER_S = 1000000000;
+
+PhysicsParameters physicsParameters()
+{
+    PhysicsParameters parameters;
+    parameters.totalWeight = TOTAL_WEIGHT;
+    return parameters;
+}
+
+Profile profileWithSlope(float slope)
+{
+    return Profile(ProfileType::SLOPE, 0, { ProfileEntry(0, slope, 0) });
+}
+
+/**
+ * At steady state, power equals (0.5 * rho * Cd * A * v^2 + m * g * (Crr + slope)) * v. That is a depressed cubic in
+ * v, which is solved with Cardano's formula.
+ */
+double closedFormSteadyStateSpeed(double power, double slope)
+{
+    const double a = 0.5 * 1.226 * 0.63 * 0.58;
+    const double b = TOTAL_WEIGHT * 9.81 * (0.004 + slope * 0.01);
+    const double q = power / (2 * a);
+    const double r = b / (3 * a);
+    const double d = std::sqrt(q * q + r * r * r);
+    return std::cbrt(q + d) + std::cbrt(q - d);
+}
+
+PhysicsState ride(const CyclingPhysics &physics, const Profile &profile, int power, qint64 stepNs, qint64 durationNs)
+{
+    PhysicsState state;
+    for (qint64 time = 0; time < durationNs; time += stepNs) {
+        state = physics.step(state, profile, power, stepNs);
+    }
+    return state;
+}
+}
+
+CyclingPhysicsTest::CyclingPhysicsTest(QObject *parent) :
+    QObject(parent)
+{
+    // empty
+}
+
+void CyclingPhysicsTest::testSteadyStateSpeedMatchesClosedForm()
+{
+    const CyclingPhysics physics(physicsParameters());
+    for (const float slope: { -2.0f, 0.0f, 5.0f, 10.0f }) {
+        const Profile profile = profileWithSlope(slope);
+        for (const int power: { 100, 250, 400 }) {
+            for (const qint64 stepNs: { NS_PER_MS, 33 * NS_PER_MS, 250 * NS_PER_MS, NS_PER_S }) {
+                const PhysicsState state = ride(physics, profile, power, stepNs, 600 * NS_PER_S);
+                QVERIFY(std::abs(state.speed - closedFormSteadyStateSpeed(power, slope)) < 0.001);
+            }
+        }
+    }
+}
+
+void CyclingPhysicsTest::testIndependentOfStepLength()
+{
+    const CyclingPhysics physics(physicsParameters());
+    const Profile profile = profileWithSlope(3);
+
+    const PhysicsState reference = ride(physics, profile, 250, 10 * NS_PER_MS, 120 * NS_PER_S);
+    for (const qint64 stepNs: { 40 * NS_PER_MS, 100 * NS_PER_MS, 500 * NS_PER_MS, NS_PER_S }) {
+        const PhysicsState state = ride(physics, profile, 250, stepNs, 120 * NS_PER_S);
+        QVERIFY(std::abs(state.speed - reference.speed) < 0.01);
+        QVERIFY(std::abs(state.distance - reference.distance) < 0.5);
+        // the first step starts standing still, so it does not count as run time.
+        QCOMPARE(state.runTimeNs, 120 * NS_PER_S - stepNs);
+    }
+}
+
+void CyclingPhysicsTest::testSlopeIntegratedOverStep()
+{
+    const CyclingPhysics physics(physicsParameters());
+    // flat for the first 10 meters, then steep.
+    const Profile profile(ProfileType::SLOPE, 0, { ProfileEntry(0, 0, 0), ProfileEntry(10, 15, 0) });
+
+    PhysicsState start;
+    start.speed = 10;
+    start.distance = 5;
+
+    // one long step, starting on the flat, should slow down about as much as many small steps.
+    const PhysicsState longStep = physics.step(start, profile, 200, NS_PER_S);
+    PhysicsState smallSteps = start;
+    for (int i = 0; i < 1000; ++i) {
+        smallSteps = physics.step(smallSteps, profile, 200, NS_PER_MS);
+    }
+    QVERIFY(std::abs(longStep.speed - smallSteps.speed) < 0.01);
+    QVERIFY(longStep.speed < 9.5);
+}
+
+void CyclingPhysicsTest::testStopsWithoutPower()
+{
+    const CyclingPhysics physics(physicsParameters());
+    const Profile profile = profileWithSlope(0);
+
+    PhysicsState state = ride(physics, profile, 200, 33 * NS_PER_MS, 60 * NS_PER_S);
+    QVERIFY(state.speed > 0);
+    for (int i = 0; i < 6; ++i) {
+        state = physics.step(state, profile, 0, NS_PER_S);
+    }
+    QCOMPARE(state.speed, 0.0);
+    QVERIFY(state.idleTimeNs > 5 * NS_PER_S);
+}
+
+void CyclingPhysicsTest::testInterpolate()
+{
+    PhysicsState from;
+    from.speed = 10;
+    from.distance = 100;
+    from.distanceTravelled = 50;
+    from.runTimeNs = 10 * NS_PER_S;
+    PhysicsState to;
+    to.speed = 12;
+    to.distance = 110;
+    to.distanceTravelled = 60;
+    to.runTimeNs = 11 * NS_PER_S;
+
+    const PhysicsState state = CyclingPhysics::interpolate(from, to, 0.25);
+    QCOMPARE(state.speed, 10.5);
+    QCOMPARE(state.distance, 102.5);
+    QCOMPARE(state.distanceTravelled, 52.5);
+    QCOMPARE(state.runTimeNs, 10 * NS_PER_S + NS_PER_S / 4);
+}
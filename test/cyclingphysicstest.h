@@ -0,0 +1,20 @@
+#ifndef CYCLINGPHYSICSTEST_H
+#define CYCLINGPHYSICSTEST_H
+
+#include <QtCore/QObject>
+
+class CyclingPhysicsTest : public QObject
+{
+    Q_OBJECT
+public:
+    explicit CyclingPhysicsTest(QObject *parent = 0);
+
+private slots:
+    void testSteadyStateSpeedMatchesClosedForm();
+    void testIndependentOfStepLength();
+    void testSlopeIntegratedOverStep();
+    void testStopsWithoutPower();
+    void testInterpolate();
+};
+
+#endif // CYCLINGPHYSICSTEST_H
@@ -20,6 +20,11 @@
 
 #include "distanceentrycollectiontest.h"
 
+#include <algorithm>
+#include <cmath>
+
+#include <QtTest/QTest>
+
 namespace {
 class SimpleEntry {
 public:
@@ -37,11 +42,19 @@ private:
     qreal _height;
 };
 
-std::function<qreal(const SimpleEntry&)> indexFunction = [](const SimpleEntry& entry) {
-    return entry.distance();
-};
+/** a route with an entry every meter or so, like a long GPX route */
+std::vector<SimpleEntry> createLongRoute()
+{
+    std::vector<SimpleEntry> entries;
+    qreal distance = 0;
+    for (int i = 0; i < 200000; ++i) {
+        entries.push_back(SimpleEntry(distance, i));
+        distance += 0.5 + (i % 7) * 0.25;
+    }
+    return entries;
 }
-#include <QtTest/QTest>
+}
+
 DistanceEntryCollectionTest::DistanceEntryCollectionTest(QObject *parent) :
     QObject(parent)
 {
@@ -50,7 +63,7 @@ DistanceEntryCollectionTest::DistanceEntryCollectionTest(QObject *parent) :
 void DistanceEntryCollectionTest::testWithEmptyEntries()
 {
     std::vector<SimpleEntry> entries = {};
-    DistanceEntryCollection<SimpleEntry> indexed(entries, indexFunction);
+    DistanceEntryCollection<SimpleEntry> indexed(entries);
 
     const SimpleEntry *entry = indexed.entryForDistance(10.0);
 
@@ -60,7 +73,7 @@ void DistanceEntryCollectionTest::testWithEmptyEntries()
 void DistanceEntryCollectionTest::testWithSingleEntry()
 {
     std::vector<SimpleEntry> entries = { SimpleEntry(10.0, 0.0) };
-    DistanceEntryCollection<SimpleEntry> indexed(entries, indexFunction);
+    DistanceEntryCollection<SimpleEntry> indexed(entries);
 
     const SimpleEntry *entry = indexed.entryForDistance(1.0);
 
@@ -71,7 +84,7 @@ void DistanceEntryCollectionTest::testWithSingleEntry()
 void DistanceEntryCollectionTest::testWithFourEntries()
 {
     std::vector<SimpleEntry> entries = { SimpleEntry(0.0, 0.0), SimpleEntry(10.0, 1.0), SimpleEntry(20.0, 3.0), SimpleEntry(30.0, 4.0) };
-    DistanceEntryCollection<SimpleEntry> indexed(entries, indexFunction);
+    DistanceEntryCollection<SimpleEntry> indexed(entries);
 
     const SimpleEntry *entry = indexed.entryForDistance(1.0);
 
@@ -95,3 +108,71 @@ void DistanceEntryCollectionTest::testWithFourEntries()
         QVERIFY2(entry, "Entry should not be null");
     }
 }
+
+void DistanceEntryCollectionTest::testBranchlessLowerBound()
+{
+    const std::vector<float> keys = { 0.0f, 1.5f, 1.5f, 3.0f, 10.0f, 10.25f, 100.0f };
+    QCOMPARE(branchlessLowerBound(keys.data(), 0, 1.0f), std::size_t(0));
+    for (int i = -10; i < 1100; ++i) {
+        const float value = i / 10.0f;
+        for (std::size_t size = 1; size <= keys.size(); ++size) {
+            const std::size_t expected = std::lower_bound(keys.begin(), keys.begin() + size, value) - keys.begin();
+            QCOMPARE(branchlessLowerBound(keys.data(), size, value), expected);
+        }
+    }
+}
+
+void DistanceEntryCollectionTest::testCopiesShareEntries()
+{
+    std::vector<SimpleEntry> entries = { SimpleEntry(0.0, 0.0), SimpleEntry(10.0, 1.0), SimpleEntry(20.0, 3.0) };
+    DistanceEntryCollection<SimpleEntry> indexed(entries);
+    DistanceEntryCollection<SimpleEntry> copy(indexed);
+
+    QVERIFY(&indexed.entries() == &copy.entries());
+    QVERIFY(*indexed.entryForDistance(25.0) == entries[2]);
+    QVERIFY(*copy.entryForDistance(5.0) == entries[0]);
+}
+
+void DistanceEntryCollectionTest::testSearchWithHint()
+{
+    const DistanceEntryCollection<SimpleEntry> indexed(createLongRoute());
+    const qreal totalDistance = indexed.entries().back().distance();
+    std::size_t hint = 0;
+    for (qreal distance = -1; distance < totalDistance + 10; distance += 3.3) {
+        QVERIFY(indexed.iteratorForDistance(distance, hint) == indexed.iteratorForDistance(distance));
+    }
+    // going back, or with a hint that is out of range, must find the same entries.
+    for (int i = 0; i < 1000; ++i) {
+        const qreal distance = std::fmod(i * 7919.0, totalDistance);
+        QVERIFY(indexed.iteratorForDistance(distance, hint) == indexed.iteratorForDistance(distance));
+    }
+    hint = indexed.entries().size() + 10;
+    QVERIFY(indexed.iteratorForDistance(20.0, hint) == indexed.iteratorForDistance(20.0));
+}
+
+void DistanceEntryCollectionTest::benchmarkIteratorForDistanceSequential()
+{
+    DistanceEntryCollection<SimpleEntry> indexed(createLongRoute());
+    const qreal totalDistance = indexed.entries().back().distance();
+    std::size_t hint = 0;
+    QBENCHMARK {
+        for (qreal distance = 0; distance < totalDistance; distance += 0.1) {
+            indexed.iteratorForDistance(distance, hint);
+        }
+    }
+}
+
+void DistanceEntryCollectionTest::benchmarkIteratorForDistanceRandom()
+{
+    DistanceEntryCollection<SimpleEntry> indexed(createLongRoute());
+    const qreal totalDistance = indexed.entries().back().distance();
+    std::vector<qreal> distances;
+    for (int i = 0; i < 100000; ++i) {
+        distances.push_back(std::fmod(i * 7919.0, totalDistance));
+    }
+    QBENCHMARK {
+        for (const qreal distance: distances) {
+            indexed.iteratorForDistance(distance);
+        }
+    }
+}
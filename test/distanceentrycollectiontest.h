@@ -33,6 +33,12 @@ private slots:
     void testWithEmptyEntries();
     void testWithSingleEntry();
     void testWithFourEntries();
+    void testBranchlessLowerBound();
+    void testCopiesShareEntries();
+    void testSearchWithHint();
+
+    void benchmarkIteratorForDistanceSequential();
+    void benchmarkIteratorForDistanceRandom();
 };
 
 #endif // DISTANCEENTRYCOLLECTIONTEST_H
@@ -0,0 +1,147 @@
+/*
+ * Copyright (c) 2015 Ilja Booij (ibooij@gmail.com)
+ *
+ * This file is part of Big Ring Indoor Video Cycling
+ *
+ * Big Ring Indoor Video Cycling is free software: you can redistribute
+ * it and/or modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation, either version 3 of the
+ * License, or (at your option) any later version.
+ *
+ * Big Ring Indoor Video Cycling  is distributed in the hope that it will
+ * be useful, but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+
+ * You should have received a copy of the GNU General Public License
+ * along with Big Ring Indoor Video Cycling.  If not, see
+ * <http://www.gnu.org/licenses/>.
+ */
+
+#include "distancelookuptabletest.h"
+
+#include "importer/rlvfileparser.h"
+#include "model/distancelookuptable.h"
+#include <QtCore/QFile>
+#include <QtCore/QFileInfo>
+#include <QtTest/QTest>
+
+namespace {
+const QFileInfo BAVELLA_VIDEO_FILE = QFileInfo("/media/video/RLV/FR_Bavella.avi");
+const QFileInfo BAVELLA_PGMF_FILE = QFileInfo(":///resources/FR_Bavella.pgmf");
+QList<QFileInfo> VIDEO_FILES = { BAVELLA_VIDEO_FILE };
+const quint64 BAVELLA_NUMBER_OF_FRAMES = 100000;
+/** distance covered in a simulation step at 36 km/h and 100 steps per second */
+const float DISTANCE_PER_TICK = 0.1f; // meters
+
+RealLifeVideo parseBavella()
+{
+    QFile fTacx(":///resources/FR_Bavella.rlv");
+    RlvFileParser rlvFileParser({BAVELLA_PGMF_FILE}, VIDEO_FILES);
+    return rlvFileParser.parseRlvFile(fTacx);
+}
+
+/** ride the whole video, one simulation step at a time, like NewVideoWidget and the profile do */
+void rideRealLifeVideo(const RealLifeVideo& rlv)
+{
+    float sum = 0;
+    for (float distance = 0; distance < rlv.totalDistance(); distance += DISTANCE_PER_TICK) {
+        sum += rlv.frameForDistance(distance) + rlv.slopeForDistance(distance) + rlv.altitudeForDistance(distance);
+    }
+    QVERIFY(sum > 0);
+}
+}
+
+DistanceLookupTableTest::DistanceLookupTableTest(QObject *parent) :
+    QObject(parent)
+{
+}
+
+void DistanceLookupTableTest::testInterpolation()
+{
+    DistanceLookupTable table(100, 0.5f, [](float distance) {
+        return 3 * distance;
+    }, [](float distance) {
+        return (distance < 50) ? 1.0f : 2.0f;
+    }, [](float distance) {
+        return 10 + 0.01f * distance;
+    });
+
+    QCOMPARE(table.frameForDistance(0), 0.0f);
+    QCOMPARE(table.frameForDistance(10.25f), 30.75f);
+    QCOMPARE(table.frameForDistance(100), 300.0f);
+    QCOMPARE(table.slopeForDistance(49.9f), 1.0f);
+    QCOMPARE(table.slopeForDistance(50.0f), 2.0f);
+    QCOMPARE(table.altitudeForDistance(75.25f), 10.7525f);
+    QCOMPARE(table.resolution(), 0.5f);
+    QVERIFY(table.memoryUsage() >= 201 * 3 * sizeof(float));
+}
+
+void DistanceLookupTableTest::testOutsideOfTable()
+{
+    DistanceLookupTable table(10, 0.1f, [](float distance) {
+        return distance;
+    }, [](float) {
+        return 5.0f;
+    }, [](float distance) {
+        return distance;
+    });
+
+    QVERIFY(!table.contains(-1));
+    QVERIFY(table.contains(0));
+    QVERIFY(table.contains(10));
+    QVERIFY(!table.contains(10.5f));
+    QCOMPARE(table.frameForDistance(-1), 0.0f);
+    QCOMPARE(table.frameForDistance(20), 10.0f);
+    QCOMPARE(table.slopeForDistance(20), 5.0f);
+}
+
+void DistanceLookupTableTest::testRealLifeVideoWithTable()
+{
+    RealLifeVideo exact = parseBavella();
+    RealLifeVideo withTable = parseBavella();
+    withTable.setNumberOfFrames(BAVELLA_NUMBER_OF_FRAMES);
+    withTable.enableLookupTable();
+    // setting the number of frames changes the frames for the distances, so only slope and altitude can be
+    // compared with the video without a table.
+    for (float distance = 0; distance < exact.totalDistance(); distance += 7.3f) {
+        QVERIFY(qAbs(exact.altitudeForDistance(distance) - withTable.altitudeForDistance(distance)) < 0.05f);
+    }
+    for (int distance = 0; distance < exact.totalDistance(); distance += 100) {
+        QCOMPARE(withTable.slopeForDistance(distance), exact.slopeForDistance(distance));
+    }
+}
+
+void DistanceLookupTableTest::testTableOnlyBuiltWhenEnabled()
+{
+    RealLifeVideo rlv = parseBavella();
+    rlv.setNumberOfFrames(BAVELLA_NUMBER_OF_FRAMES);
+    const std::size_t memoryUsageWithoutTable = rlv.memoryUsage();
+    const quint32 frameWithoutTable = rlv.frameForDistance(1000);
+    QCOMPARE(rlv.memoryUsage(), memoryUsageWithoutTable);
+
+    rlv.enableLookupTable();
+    const quint32 frameWithTable = rlv.frameForDistance(1000);
+    QVERIFY(rlv.memoryUsage() > memoryUsageWithoutTable);
+    QVERIFY(qAbs(static_cast<int>(frameWithTable) - static_cast<int>(frameWithoutTable)) <= 1);
+}
+
+void DistanceLookupTableTest::benchmarkTickWithoutTable()
+{
+    const RealLifeVideo rlv = parseBavella();
+    QBENCHMARK {
+        rideRealLifeVideo(rlv);
+    }
+}
+
+void DistanceLookupTableTest::benchmarkTickWithTable()
+{
+    RealLifeVideo rlv = parseBavella();
+    rlv.setNumberOfFrames(BAVELLA_NUMBER_OF_FRAMES);
+    rlv.enableLookupTable();
+    // build the table before measuring.
+    rlv.frameForDistance(0);
+    QBENCHMARK {
+        rideRealLifeVideo(rlv);
+    }
+}
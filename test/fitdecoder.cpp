@@ -0,0 +1,136 @@
+#include "fitdecoder.h"
+
+#include <QtCore/QtEndian>
+
+namespace
+{
+const int HEADER_SIZE = 14;
+
+struct FieldDefinition
+{
+    int number;
+    int size;
+    quint8 baseType;
+};
+
+struct MessageDefinition
+{
+    quint16 globalNumber;
+    QList<FieldDefinition> fields;
+};
+
+qint64 readValue(const uchar *data, const FieldDefinition &field)
+{
+    quint64 value = 0;
+    for (int i = field.size - 1; i >= 0; --i) {
+        value = (value << 8) | data[i];
+    }
+    // sint8, sint16 and sint32
+    const bool isSigned = (field.baseType == 0x01 || field.baseType == 0x83 || field.baseType == 0x85);
+    if (isSigned && field.size < 8 && (value & (Q_UINT64_C(1) << (8 * field.size - 1)))) {
+        value |= ~((Q_UINT64_C(1) << (8 * field.size)) - 1);
+    }
+    return static_cast<qint64>(value);
+}
+}
+
+FitDecoder::FitDecoder(const QByteArray &data): _dataSize(0), _valid(false)
+{
+    _valid = decode(data);
+}
+
+bool FitDecoder::isValid() const
+{
+    return _valid;
+}
+
+quint32 FitDecoder::dataSize() const
+{
+    return _dataSize;
+}
+
+const QList<FitDecoder::Message> &FitDecoder::messages() const
+{
+    return _messages;
+}
+
+QList<FitDecoder::Message> FitDecoder::messages(quint16 globalNumber) const
+{
+    QList<Message> result;
+    for (const Message &message: _messages) {
+        if (message.globalNumber == globalNumber) {
+            result.append(message);
+        }
+    }
+    return result;
+}
+
+quint16 FitDecoder::crc(const char *data, int size)
+{
+    quint16 crc = 0;
+    for (int i = 0; i < size; ++i) {
+        crc ^= static_cast<quint8>(data[i]);
+        for (int bit = 0; bit < 8; ++bit) {
+            crc = (crc & 1) ? static_cast<quint16>((crc >> 1) ^ 0xA001) : static_cast<quint16>(crc >> 1);
+        }
+    }
+    return crc;
+}
+
+bool FitDecoder::decode(const QByteArray &data)
+{
+    const uchar *bytes = reinterpret_cast<const uchar*>(data.constData());
+    if (data.size() < HEADER_SIZE + 2 || bytes[0] != HEADER_SIZE || data.mid(8, 4) != ".FIT") {
+        return false;
+    }
+    if (qFromLittleEndian<quint16>(bytes + 12) != crc(data.constData(), 12)) {
+        return false;
+    }
+    _dataSize = qFromLittleEndian<quint32>(bytes + 4);
+    if (static_cast<qint64>(HEADER_SIZE) + _dataSize + 2 != data.size()) {
+        return false;
+    }
+    const int end = HEADER_SIZE + static_cast<int>(_dataSize);
+    if (qFromLittleEndian<quint16>(bytes + end) != crc(data.constData(), end)) {
+        return false;
+    }
+
+    QMap<int,MessageDefinition> definitions;
+    int position = HEADER_SIZE;
+    while (position < end) {
+        const quint8 header = bytes[position++];
+        const int localType = header & 0x0F;
+        if (header & 0x80) {
+            // compressed timestamp headers are not used by the writer.
+            return false;
+        }
+        if (header & 0x40) {
+            if (bytes[position + 1] != 0) {
+                // only little endian is supported
+                return false;
+            }
+            MessageDefinition definition;
+            definition.globalNumber = qFromLittleEndian<quint16>(bytes + position + 2);
+            const int fieldCount = bytes[position + 4];
+            position += 5;
+            for (int i = 0; i < fieldCount; ++i) {
+                definition.fields.append({ bytes[position], bytes[position + 1], bytes[position + 2] });
+                position += 3;
+            }
+            definitions[localType] = definition;
+        } else {
+            if (!definitions.contains(localType)) {
+                return false;
+            }
+            const MessageDefinition &definition = definitions[localType];
+            Message message;
+            message.globalNumber = definition.globalNumber;
+            for (const FieldDefinition &field: definition.fields) {
+                message.fields[field.number] = readValue(bytes + position, field);
+                position += field.size;
+            }
+            _messages.append(message);
+        }
+    }
+    return position == end;
+}
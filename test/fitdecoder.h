@@ -0,0 +1,42 @@
+#ifndef FITDECODER_H
+#define FITDECODER_H
+
+#include <QtCore/QByteArray>
+#include <QtCore/QList>
+#include <QtCore/QMap>
+
+/**
+ * A minimal decoder for FIT files, used to test the FitFileWriter. It only supports the features that the writer
+ * uses: normal record headers, little endian messages and a 14 byte file header.
+ */
+class FitDecoder
+{
+public:
+    struct Message
+    {
+        quint16 globalNumber;
+        /** values by field number, not scaled */
+        QMap<int,qint64> fields;
+    };
+
+    explicit FitDecoder(const QByteArray &data);
+
+    /** true if the header, the size and both CRCs are correct and all messages could be decoded. */
+    bool isValid() const;
+    quint32 dataSize() const;
+    /** all data messages in the file */
+    const QList<Message> &messages() const;
+    /** all data messages with a global message number */
+    QList<Message> messages(quint16 globalNumber) const;
+
+    /** CRC-16 as used by FIT, calculated bit by bit, independently of the writer. */
+    static quint16 crc(const char *data, int size);
+private:
+    bool decode(const QByteArray &data);
+
+    quint32 _dataSize;
+    bool _valid;
+    QList<Message> _messages;
+};
+
+#endif // FITDECODER_H
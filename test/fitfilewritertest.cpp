@@ -0,0 +1,225 @@
+#include "fitfilewritertest.h"
+
+#include <QtCore/QBuffer>
+#include <QtCore/QDateTime>
+#include <QtTest/QTest>
+
+#include "fitdecoder.h"
+#include "model/ridefile.h"
+#include "ride/fitfilewriter.h"
+
+namespace
+{
+const QDateTime START_TIME = QDateTime::fromMSecsSinceEpoch(1400000000000, Qt::UTC);
+const quint16 FILE_ID = 0;
+const quint16 SESSION = 18;
+const quint16 LAP = 19;
+const quint16 RECORD = 20;
+const quint16 EVENT = 21;
+const quint16 ACTIVITY = 34;
+
+RideFile::Sample sampleAt(int second)
+{
+    RideFile::Sample sample;
+    sample.time = QTime::fromMSecsSinceStartOfDay(second * 1000);
+    sample.altitude = 100.0f + second;
+    sample.cadence = 80 + second;
+    sample.distance = 8.5f * second;
+    sample.heartRate = 140 + second;
+    sample.power = 200 + 10 * second;
+    sample.speed = 8.5f;
+    sample.position = GeoPosition(8.5 * second, QGeoCoordinate(45.5 + second * 0.0001, 6.25, 100.0 + second));
+    return sample;
+}
+
+RideFile createRide(int seconds)
+{
+    RideFile rideFile("rlv", "course", START_TIME);
+    for (int i = 0; i < seconds; ++i) {
+        rideFile.addSample(sampleAt(i));
+    }
+    return rideFile;
+}
+
+QByteArray writeFit(const RideFile &rideFile)
+{
+    QBuffer buffer;
+    buffer.open(QIODevice::WriteOnly);
+    if (!FitFileWriter().writeFit(rideFile, buffer)) {
+        return QByteArray();
+    }
+    return buffer.data();
+}
+
+qint64 fitTime(qint64 msecsSinceEpoch)
+{
+    return (msecsSinceEpoch - FitFileWriter::FIT_EPOCH_MSECS_SINCE_EPOCH) / 1000;
+}
+
+double degrees(qint64 semicircles)
+{
+    return semicircles * (180.0 / 2147483648.0);
+}
+}
+
+FitFileWriterTest::FitFileWriterTest(QObject *parent) :
+    QObject(parent)
+{
+    // empty
+}
+
+void FitFileWriterTest::testHeaderAndCrc()
+{
+    const QByteArray data = writeFit(createRide(100));
+    const FitDecoder decoder(data);
+
+    QVERIFY(decoder.isValid());
+    QCOMPARE(static_cast<int>(decoder.dataSize()), data.size() - 16);
+
+    // a changed byte should be detected by the CRC.
+    QByteArray damaged(data);
+    damaged[100] = static_cast<char>(damaged[100] ^ 0x01);
+    QVERIFY(!FitDecoder(damaged).isValid());
+}
+
+void FitFileWriterTest::testRecords()
+{
+    const FitDecoder decoder(writeFit(createRide(10)));
+    QVERIFY(decoder.isValid());
+
+    const QList<FitDecoder::Message> records = decoder.messages(RECORD);
+    QCOMPARE(records.size(), 10);
+
+    const RideFile::Sample expected = sampleAt(3);
+    const QMap<int,qint64> &record = records[3].fields;
+    QCOMPARE(record[253], fitTime(START_TIME.toMSecsSinceEpoch()) + 3);
+    QVERIFY(qAbs(degrees(record[0]) - expected.position.latitude()) < 1e-6);
+    QVERIFY(qAbs(degrees(record[1]) - expected.position.longitude()) < 1e-6);
+    QCOMPARE(record[2], static_cast<qint64>((expected.altitude + 500) * 5));
+    QCOMPARE(record[3], static_cast<qint64>(expected.heartRate));
+    QCOMPARE(record[4], static_cast<qint64>(expected.cadence));
+    QCOMPARE(record[5], static_cast<qint64>(expected.distance * 100));
+    QCOMPARE(record[6], static_cast<qint64>(expected.speed * 1000));
+    QCOMPARE(record[7], static_cast<qint64>(expected.power));
+}
+
+void FitFileWriterTest::testRecordWithoutPosition()
+{
+    RideFile rideFile("rlv", "course", START_TIME);
+    RideFile::Sample sample = sampleAt(1);
+    sample.position = GeoPosition();
+    rideFile.addSample(sample);
+
+    const FitDecoder decoder(writeFit(rideFile));
+    QVERIFY(decoder.isValid());
+    const QList<FitDecoder::Message> records = decoder.messages(RECORD);
+    QCOMPARE(records.size(), 1);
+    QCOMPARE(records[0].fields[0], Q_INT64_C(0x7FFFFFFF));
+    QCOMPARE(records[0].fields[1], Q_INT64_C(0x7FFFFFFF));
+    QCOMPARE(records[0].fields[7], static_cast<qint64>(sample.power));
+}
+
+void FitFileWriterTest::testRecordsAreWrittenAtOneHertz()
+{
+    // FIT timestamps are whole seconds, so a ride recorded at 4 Hz gets a record for every second.
+    RideFile rideFile("rlv", "course", START_TIME);
+    for (int i = 0; i < 12; ++i) {
+        RideFile::Sample sample = sampleAt(0);
+        sample.time = QTime::fromMSecsSinceStartOfDay(i * 250);
+        sample.power = 200 + i;
+        rideFile.addSample(sample);
+    }
+    const FitDecoder decoder(writeFit(rideFile));
+    QVERIFY(decoder.isValid());
+
+    const QList<FitDecoder::Message> records = decoder.messages(RECORD);
+    QCOMPARE(records.size(), 3);
+    for (int second = 0; second < 3; ++second) {
+        QCOMPARE(records[second].fields[253], fitTime(START_TIME.toMSecsSinceEpoch()) + second);
+        QCOMPARE(records[second].fields[7], Q_INT64_C(200) + 4 * second); // power of the first sample of the second
+    }
+}
+
+void FitFileWriterTest::testSummaryMessages()
+{
+    const RideFile rideFile = createRide(10);
+    const FitDecoder decoder(writeFit(rideFile));
+    QVERIFY(decoder.isValid());
+
+    QCOMPARE(decoder.messages(FILE_ID).size(), 1);
+    QCOMPARE(decoder.messages(FILE_ID)[0].fields[0], Q_INT64_C(4)); // activity
+    QCOMPARE(decoder.messages(EVENT).size(), 2);
+    QCOMPARE(decoder.messages(LAP).size(), 1);
+    QCOMPARE(decoder.messages(ACTIVITY).size(), 1);
+
+    QCOMPARE(decoder.messages(SESSION).size(), 1);
+    const QMap<int,qint64> &session = decoder.messages(SESSION)[0].fields;
+    QCOMPARE(session[2], fitTime(START_TIME.toMSecsSinceEpoch()));
+    QCOMPARE(session[5], Q_INT64_C(2)); // cycling
+    QCOMPARE(session[7], static_cast<qint64>(rideFile.durationInMilliSeconds()));
+    QCOMPARE(session[9], static_cast<qint64>(rideFile.totalDistance() * 100));
+    QCOMPARE(session[17], Q_INT64_C(149)); // maximum heart rate
+    QCOMPARE(session[20], Q_INT64_C(245)); // average power
+    QCOMPARE(session[21], Q_INT64_C(290)); // maximum power
+
+    // the messages are in the order that FIT readers expect.
+    const QList<FitDecoder::Message> &messages = decoder.messages();
+    QCOMPARE(messages.first().globalNumber, FILE_ID);
+    QCOMPARE(messages.last().globalNumber, ACTIVITY);
+}
+
+void FitFileWriterTest::testTrainingMetricsInSession()
+{
+    // an hour at FTP is a TSS of 100.
+    RideFile rideFile("rlv", "course", START_TIME);
+    for (int i = 0; i <= 3600; ++i) {
+        RideFile::Sample sample = sampleAt(i);
+        sample.power = 250;
+        rideFile.addSample(sample);
+    }
+    QBuffer buffer;
+    buffer.open(QIODevice::WriteOnly);
+    QVERIFY(FitFileWriter(250, 20000).writeFit(rideFile, buffer));
+    const FitDecoder decoder(buffer.data());
+    QVERIFY(decoder.isValid());
+
+    const QMap<int,qint64> &session = decoder.messages(SESSION)[0].fields;
+    QCOMPARE(session[34], Q_INT64_C(250)); // normalized power
+    QCOMPARE(session[35], Q_INT64_C(1000)); // 10 * TSS
+    QCOMPARE(session[36], Q_INT64_C(1000)); // 1000 * intensity factor
+    QCOMPARE(session[45], Q_INT64_C(250)); // threshold power
+    QCOMPARE(decoder.messages(LAP)[0].fields[33], Q_INT64_C(250)); // normalized power
+}
+
+void FitFileWriterTest::testClimbLaps()
+{
+    // flat, a climb of 50 meters and a descent.
+    RideFile rideFile("rlv", "course", START_TIME);
+    for (int i = 0; i < 120; ++i) {
+        RideFile::Sample sample = sampleAt(i);
+        sample.altitude = (i < 30) ? 100.0f : (i < 80) ? 100.0f + (i - 29) : 150.0f - (i - 79);
+        rideFile.addSample(sample);
+    }
+    const FitDecoder decoder(writeFit(rideFile));
+    QVERIFY(decoder.isValid());
+
+    // the climb starts at the last flat sample and ends at the top.
+    const QList<FitDecoder::Message> &laps = decoder.messages(LAP);
+    QCOMPARE(laps.size(), 3);
+    const QMap<int,qint64> &climb = laps[1].fields;
+    QCOMPARE(climb[2], fitTime(START_TIME.toMSecsSinceEpoch()) + 29); // start time
+    QCOMPARE(climb[7], Q_INT64_C(51000)); // elapsed time (ms)
+    QCOMPARE(climb[9], Q_INT64_C(43350)); // distance (cm)
+    QCOMPARE(climb[21], Q_INT64_C(50)); // total ascent (m)
+
+    // the laps cover the whole ride.
+    qint64 elapsed = 0;
+    qint64 distance = 0;
+    for (const FitDecoder::Message &lap: laps) {
+        elapsed += lap.fields[7];
+        distance += lap.fields[9];
+    }
+    QCOMPARE(elapsed, static_cast<qint64>(rideFile.durationInMilliSeconds()));
+    QCOMPARE(distance, static_cast<qint64>(rideFile.totalDistance() * 100));
+    QCOMPARE(decoder.messages(SESSION)[0].fields[26], Q_INT64_C(3)); // number of laps
+}
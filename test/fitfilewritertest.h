@@ -0,0 +1,22 @@
+#ifndef FITFILEWRITERTEST_H
+#define FITFILEWRITERTEST_H
+
+#include <QtCore/QObject>
+
+class FitFileWriterTest : public QObject
+{
+    Q_OBJECT
+public:
+    explicit FitFileWriterTest(QObject *parent = 0);
+
+private slots:
+    void testHeaderAndCrc();
+    void testRecords();
+    void testRecordWithoutPosition();
+    void testRecordsAreWrittenAtOneHertz();
+    void testSummaryMessages();
+    void testTrainingMetricsInSession();
+    void testClimbLaps();
+};
+
+#endif // FITFILEWRITERTEST_H
@@ -1,11 +1,18 @@
 #include "antmessage2test.h"
+#include "cyclingphysicstest.h"
 #include "distanceentrycollectiontest.h"
+#include "distancelookuptabletest.h"
+#include "fitfilewritertest.h"
 #include "profiletest.h"
 #include "reallifevideocachetest.h"
 #include "ridefilewritertest.h"
-#include "rollingaveragecalculatortest.h"
+#include "ridejournaltest.h"
+#include "ridesimulatortest.h"
+#include "sensorchanneltest.h"
+#include "trainingmetricstest.h"
 #include "virtualtrainingfileparsertest.h"
 #include "virtualpowertest.h"
+#include "windowedstatisticstest.h"
 
 #include <QTest>
 
@@ -22,9 +29,16 @@ int main(int, char**) {
     execTest<AntMessage2Test>();
     execTest<VirtualPowerTest>();
     execTest<ProfileTest>();
-    execTest<RollingAverageCalculatorTest>();
+    execTest<CyclingPhysicsTest>();
+    execTest<WindowedStatisticsTest>();
+    execTest<SensorChannelTest>();
+    execTest<TrainingMetricsTest>();
     execTest<RideFileWriterTest>();
+    execTest<RideJournalTest>();
+    execTest<RideSimulatorTest>();
+    execTest<FitFileWriterTest>();
     execTest<RealLifeVideoCacheTest>();
     execTest<DistanceEntryCollectionTest>();
+    execTest<DistanceLookupTableTest>();
     execTest<VirtualTrainingFileParserTest>();
 }
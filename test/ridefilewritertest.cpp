@@ -1,10 +1,37 @@
 #include "ridefilewritertest.h"
 
+#include <QtCore/QBuffer>
 #include <QtCore/QDateTime>
+#include <QtCore/QXmlStreamReader>
+#include <QtTest/QTest>
 
 #include "model/ridefile.h"
 #include "ride/ridefilewriter.h"
 
+namespace
+{
+const QDateTime START_TIME = QDateTime::fromMSecsSinceEpoch(1400000000000, Qt::UTC);
+
+/** a ride with a sample every second. */
+RideFile createRide(int seconds)
+{
+    RideFile rideFile("rlv", "course", START_TIME);
+    for (int i = 0; i < seconds; ++i) {
+        RideFile::Sample sample;
+        sample.time = QTime::fromMSecsSinceStartOfDay((i * 1000 + 250) % (24 * 60 * 60 * 1000));
+        sample.altitude = 100.0f + (i % 1000) * 0.25f;
+        sample.cadence = 90;
+        sample.distance = i * 8.5f;
+        sample.heartRate = 150;
+        sample.power = 250 + i % 50;
+        sample.speed = 8.5f;
+        sample.position = GeoPosition(i * 8.5, QGeoCoordinate(45.5 + i * 0.00001, 6.25, 100.0));
+        rideFile.addSample(sample);
+    }
+    return rideFile;
+}
+}
+
 RideFileWriterTest::RideFileWriterTest(QObject *parent) :
     QObject(parent)
 {
@@ -38,3 +65,64 @@ void RideFileWriterTest::testWriteSimpleRideFile()
     rideFile.addSample(sample);
     writer.writeRideFile(rideFile);
 }
+
+void RideFileWriterTest::testWriteTcx()
+{
+    const RideFile rideFile = createRide(10);
+    QBuffer buffer;
+    buffer.open(QIODevice::WriteOnly);
+    QVERIFY(RideFileWriter(RideFileWriter::Compression::NONE).writeTcx(rideFile, buffer));
+
+    QXmlStreamReader reader(buffer.data());
+    int trackPoints = 0;
+    QStringList times;
+    QStringList latitudes;
+    while (!reader.atEnd()) {
+        reader.readNext();
+        if (reader.isStartElement() && reader.name() == "Trackpoint") {
+            trackPoints += 1;
+        } else if (reader.isStartElement() && reader.name() == "Time") {
+            times.append(reader.readElementText());
+        } else if (reader.isStartElement() && reader.name() == "LatitudeDegrees") {
+            latitudes.append(reader.readElementText());
+        }
+    }
+    QVERIFY(!reader.hasError());
+    QCOMPARE(trackPoints, 10);
+    QCOMPARE(times[0], QString("2014-05-13T16:53:20.250Z"));
+    QCOMPARE(times[9], QString("2014-05-13T16:53:29.250Z"));
+    QCOMPARE(latitudes[1], QString("45.50001"));
+}
+
+void RideFileWriterTest::testWriteGzippedTcx()
+{
+    const RideFile rideFile = createRide(10);
+    QBuffer buffer;
+    buffer.open(QIODevice::WriteOnly);
+    QVERIFY(RideFileWriter(RideFileWriter::Compression::GZIP).writeTcx(rideFile, buffer));
+
+    // gzip magic number
+    QVERIFY(buffer.data().startsWith("\x1f\x8b"));
+}
+
+void RideFileWriterTest::benchmarkWriteDayLongRide()
+{
+    const RideFile rideFile = createRide(24 * 60 * 60);
+    const RideFileWriter writer(RideFileWriter::Compression::NONE);
+    QBENCHMARK {
+        QBuffer buffer;
+        buffer.open(QIODevice::WriteOnly);
+        writer.writeTcx(rideFile, buffer);
+    }
+}
+
+void RideFileWriterTest::benchmarkWriteDayLongRideGzipped()
+{
+    const RideFile rideFile = createRide(24 * 60 * 60);
+    const RideFileWriter writer(RideFileWriter::Compression::GZIP);
+    QBENCHMARK {
+        QBuffer buffer;
+        buffer.open(QIODevice::WriteOnly);
+        writer.writeTcx(rideFile, buffer);
+    }
+}
@@ -11,6 +11,10 @@ public:
 
 private slots:
     void testWriteSimpleRideFile();
+    void testWriteTcx();
+    void testWriteGzippedTcx();
+    void benchmarkWriteDayLongRide();
+    void benchmarkWriteDayLongRideGzipped();
 };
 
 #endif // RIDEFILEWRITERTEST_H
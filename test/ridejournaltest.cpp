@@ -0,0 +1,87 @@
+#include "ridejournaltest.h"
+
+#include <QtCore/QDateTime>
+#include <QtCore/QFile>
+#include <QtCore/QTemporaryDir>
+#include <QtTest/QTest>
+
+#include "model/ridejournal.h"
+
+namespace
+{
+RideFile::Sample sampleAt(int second)
+{
+    RideFile::Sample sample;
+    sample.time = QTime::fromMSecsSinceStartOfDay(second * 1000);
+    sample.altitude = 100.0f + second;
+    sample.cadence = 90;
+    sample.distance = 8.5f * second;
+    sample.heartRate = 150;
+    sample.power = 250 + second;
+    sample.speed = 8.5f;
+    sample.position = GeoPosition(8.5 * second, QGeoCoordinate(45.5 + second * 0.0001, 6.25, 100.0 + second));
+    return sample;
+}
+}
+
+RideJournalTest::RideJournalTest(QObject *parent) :
+    QObject(parent)
+{
+    // empty
+}
+
+void RideJournalTest::testReadJournal()
+{
+    QTemporaryDir dir;
+    const QString filePath = dir.path() + "/ride.journal";
+    const QDateTime startTime = QDateTime::fromMSecsSinceEpoch(1400000000000, Qt::UTC);
+    {
+        RideJournal journal(filePath);
+        QVERIFY(journal.open(startTime, "rlv", "course"));
+        for (int i = 0; i < 100; ++i) {
+            journal.append(sampleAt(i));
+        }
+        journal.flush();
+    }
+
+    const std::unique_ptr<RideFile> rideFile = RideJournal::readRideFile(filePath);
+    QVERIFY(rideFile.get());
+    QCOMPARE(rideFile->rlvName(), QString("rlv"));
+    QCOMPARE(rideFile->courseName(), QString("course"));
+    QCOMPARE(rideFile->startTime(), startTime);
+    QCOMPARE(rideFile->samples().size(), static_cast<std::size_t>(100));
+
+    const RideFile::Sample &sample = rideFile->samples()[42];
+    const RideFile::Sample expected = sampleAt(42);
+    QCOMPARE(sample.time, expected.time);
+    QCOMPARE(sample.altitude, expected.altitude);
+    QCOMPARE(sample.distance, expected.distance);
+    QCOMPARE(sample.power, expected.power);
+    QCOMPARE(sample.position.latitude(), expected.position.latitude());
+    QCOMPARE(sample.position.distance(), expected.position.distance());
+}
+
+void RideJournalTest::testReadInterruptedJournal()
+{
+    QTemporaryDir dir;
+    const QString filePath = dir.path() + "/ride.journal";
+    {
+        RideJournal journal(filePath);
+        QVERIFY(journal.open(QDateTime::currentDateTimeUtc(), "rlv", "course"));
+        for (int i = 0; i < 10; ++i) {
+            journal.append(sampleAt(i));
+        }
+    }
+    // simulate a record that was only partly written, and one that was damaged.
+    QFile file(filePath);
+    QVERIFY(file.open(QIODevice::ReadWrite));
+    const qint64 size = file.size();
+    QVERIFY(file.resize(size - 10));
+    QVERIFY(file.seek(size - 90));
+    file.write("garbage");
+    file.close();
+
+    const std::unique_ptr<RideFile> rideFile = RideJournal::readRideFile(filePath);
+    QVERIFY(rideFile.get());
+    QCOMPARE(rideFile->samples().size(), static_cast<std::size_t>(8));
+}
@@ -0,0 +1,17 @@
+#ifndef RIDEJOURNALTEST_H
+#define RIDEJOURNALTEST_H
+
+#include <QtCore/QObject>
+
+class RideJournalTest : public QObject
+{
+    Q_OBJECT
+public:
+    explicit RideJournalTest(QObject *parent = 0);
+
+private slots:
+    void testReadJournal();
+    void testReadInterruptedJournal();
+};
+
+#endif // RIDEJOURNALTEST_H
@@ -0,0 +1,151 @@
+#include "ridesimulatortest.h"
+
+#include <cmath>
+
+#include <QtTest/QTest>
+
+#include "model/ridesimulator.h"
+
+namespace
+{
+const qreal TOTAL_WEIGHT = 80; // kg
+const int STEPS_PER_SECOND = 30;
+
+PhysicsParameters physicsParameters()
+{
+    PhysicsParameters parameters;
+    parameters.totalWeight = TOTAL_WEIGHT;
+    return parameters;
+}
+
+RideSimulationRoute routeWithSlope(float slope, float startDistance, float endDistance)
+{
+    return { Profile(ProfileType::SLOPE, 0, { ProfileEntry(0, slope, 0) }), startDistance, endDistance };
+}
+
+std::vector<PowerSample> constantPower(int power, int seconds)
+{
+    std::vector<PowerSample> powerTrace;
+    for (int second = 0; second <= seconds; ++second) {
+        powerTrace.push_back({ second * 1000, power });
+    }
+    return powerTrace;
+}
+
+/** speed at which power is in balance with drag and rolling resistance on a flat road, found by bisection */
+double steadyStateSpeedOnFlat(double power)
+{
+    double low = 0;
+    double high = 30;
+    for (int i = 0; i < 60; ++i) {
+        const double speed = (low + high) / 2;
+        const double resistance = 0.5 * 0.58 * 0.63 * 1.226 * speed * speed + TOTAL_WEIGHT * 9.81 * 0.004;
+        if (speed * resistance < power) {
+            low = speed;
+        } else {
+            high = speed;
+        }
+    }
+    return low;
+}
+}
+
+RideSimulatorTest::RideSimulatorTest(QObject *parent) :
+    QObject(parent)
+{
+    // empty
+}
+
+void RideSimulatorTest::testConstantPowerOnFlatRoute()
+{
+    const RideSimulator simulator(physicsParameters(), STEPS_PER_SECOND);
+    const RideSimulationResult result = simulator.simulate(routeWithSlope(0, 0, 10000), constantPower(200, 7200));
+
+    QVERIFY(result.finished);
+    QVERIFY(std::abs(result.distanceTravelled - 10000) < 1);
+    // the cyclist has to get up to speed first, so the ride takes a bit longer than at steady state.
+    const double steadyStateDurationMs = 10000 / steadyStateSpeedOnFlat(200) * 1000;
+    QVERIFY(result.durationMs > steadyStateDurationMs);
+    QVERIFY(result.durationMs < steadyStateDurationMs * 1.02);
+}
+
+void RideSimulatorTest::testUphillIsSlower()
+{
+    const RideSimulator simulator(physicsParameters(), STEPS_PER_SECOND);
+    const std::vector<PowerSample> powerTrace = constantPower(250, 7200);
+
+    const RideSimulationResult flat = simulator.simulate(routeWithSlope(0, 0, 5000), powerTrace);
+    const RideSimulationResult uphill = simulator.simulate(routeWithSlope(5, 0, 5000), powerTrace);
+
+    QVERIFY(flat.finished);
+    QVERIFY(uphill.finished);
+    QVERIFY(uphill.durationMs > flat.durationMs * 1.5);
+}
+
+void RideSimulatorTest::testStopsAfterEndOfPowerTrace()
+{
+    const RideSimulator simulator(physicsParameters(), STEPS_PER_SECOND);
+    const RideSimulationResult result = simulator.simulate(routeWithSlope(0, 0, 10000), constantPower(200, 60));
+
+    QVERIFY(!result.finished);
+    QVERIFY(result.distanceTravelled > 400);
+    QVERIFY(result.distanceTravelled < 10000);
+    // after the power trace, the cyclist rolls on for a while before stopping.
+    QVERIFY(result.durationMs > 60000);
+    QVERIFY(result.durationMs < 70000);
+}
+
+void RideSimulatorTest::testWithoutPowerTrace()
+{
+    const RideSimulator simulator(physicsParameters(), STEPS_PER_SECOND);
+    const RideSimulationResult result = simulator.simulate(routeWithSlope(0, 0, 10000), std::vector<PowerSample>());
+
+    QVERIFY(!result.finished);
+    QCOMPARE(result.distanceTravelled, 0.0f);
+}
+
+void RideSimulatorTest::testPowerTraceForRideFile()
+{
+    RideFile rideFile("rlv", "course");
+    for (int second = 0; second < 3; ++second) {
+        RideFile::Sample sample = RideFile::Sample();
+        sample.time = QTime::fromMSecsSinceStartOfDay(second * 1000);
+        sample.power = 100 + second;
+        rideFile.addSample(sample);
+    }
+
+    const std::vector<PowerSample> powerTrace = RideSimulator::powerTraceForRideFile(rideFile);
+    QCOMPARE(powerTrace.size(), static_cast<std::size_t>(3));
+    QCOMPARE(powerTrace[2].timeMs, Q_INT64_C(2000));
+    QCOMPARE(powerTrace[2].power, 102);
+}
+
+void RideSimulatorTest::testRoutesInParallel()
+{
+    const RideSimulator simulator(physicsParameters(), STEPS_PER_SECOND);
+    const std::vector<PowerSample> powerTrace = constantPower(220, 7200);
+
+    QList<RideSimulationRoute> routes;
+    for (int i = 0; i < 16; ++i) {
+        routes << routeWithSlope(i * 0.5f - 2, i * 100, 5000 + i * 100);
+    }
+
+    const QList<RideSimulationResult> results = simulator.simulate(routes, powerTrace);
+    QCOMPARE(results.size(), routes.size());
+    for (int i = 0; i < routes.size(); ++i) {
+        const RideSimulationResult result = simulator.simulate(routes[i], powerTrace);
+        QCOMPARE(results[i].finished, result.finished);
+        QCOMPARE(results[i].durationMs, result.durationMs);
+    }
+}
+
+void RideSimulatorTest::benchmarkOneHourRide()
+{
+    const RideSimulator simulator(physicsParameters(), STEPS_PER_SECOND);
+    const std::vector<PowerSample> powerTrace = constantPower(200, 3600);
+    const RideSimulationRoute route = routeWithSlope(0, 0, 30000);
+
+    QBENCHMARK {
+        simulator.simulate(route, powerTrace);
+    }
+}
@@ -0,0 +1,22 @@
+#ifndef RIDESIMULATORTEST_H
+#define RIDESIMULATORTEST_H
+
+#include <QtCore/QObject>
+
+class RideSimulatorTest : public QObject
+{
+    Q_OBJECT
+public:
+    explicit RideSimulatorTest(QObject *parent = 0);
+
+private slots:
+    void testConstantPowerOnFlatRoute();
+    void testUphillIsSlower();
+    void testStopsAfterEndOfPowerTrace();
+    void testWithoutPowerTrace();
+    void testPowerTraceForRideFile();
+    void testRoutesInParallel();
+    void benchmarkOneHourRide();
+};
+
+#endif // RIDESIMULATORTEST_H
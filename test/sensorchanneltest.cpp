@@ -0,0 +1,55 @@
+#include "sensorchanneltest.h"
+
+#include "model/sensorchannel.h"
+
+#include <QtTest/QTest>
+
+SensorChannelTest::SensorChannelTest(QObject *parent) :
+    QObject(parent)
+{
+    // empty
+}
+
+void SensorChannelTest::testWithoutMeasurements()
+{
+    SensorChannel channel(10);
+
+    QCOMPARE(channel.decimate(0, 1000, Decimation::MEAN), 0.0f);
+}
+
+void SensorChannelTest::testMean()
+{
+    SensorChannel channel(10);
+    channel.add(250, 100);
+    channel.add(500, 400);
+    channel.add(1000, 250);
+    channel.add(1250, 1000);
+
+    // window is (0, 1000], so the last measurement is not included
+    QCOMPARE(channel.decimate(0, 1000, Decimation::MEAN), 250.0f);
+    QCOMPARE(channel.decimate(1000, 2000, Decimation::MEAN), 1000.0f);
+}
+
+void SensorChannelTest::testWindowWithoutMeasurements()
+{
+    SensorChannel channel(10);
+    channel.add(250, 100);
+    channel.add(500, 200);
+
+    // sensors only send changes, so the last value before the window is still valid.
+    QCOMPARE(channel.decimate(1000, 2000, Decimation::MEAN), 200.0f);
+    // measurements after the window are not used.
+    QCOMPARE(channel.decimate(0, 100, Decimation::MEAN), 0.0f);
+}
+
+void SensorChannelTest::testOverwriteOldestWhenFull()
+{
+    SensorChannel channel(3);
+    for (int i = 1; i <= 5; ++i) {
+        channel.add(i * 100, i * 10);
+    }
+
+    QCOMPARE(channel.size(), 3);
+    QCOMPARE(channel.capacity(), 3);
+    QCOMPARE(channel.decimate(0, 500, Decimation::MEAN), 40.0f);
+}
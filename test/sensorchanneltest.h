@@ -0,0 +1,19 @@
+#ifndef SENSORCHANNELTEST_H
+#define SENSORCHANNELTEST_H
+
+#include <QtCore/QObject>
+
+class SensorChannelTest : public QObject
+{
+    Q_OBJECT
+public:
+    explicit SensorChannelTest(QObject *parent = 0);
+
+private slots:
+    void testWithoutMeasurements();
+    void testMean();
+    void testWindowWithoutMeasurements();
+    void testOverwriteOldestWhenFull();
+};
+
+#endif // SENSORCHANNELTEST_H
@@ -6,25 +6,41 @@ TARGET = tests
 
 SOURCES += \
     antmessage2test.cpp \
+    cyclingphysicstest.cpp \
+    fitdecoder.cpp \
+    fitfilewritertest.cpp \
     main.cpp \
     virtualpowertest.cpp \
     virtualtrainingfileparsertest.cpp \
     profiletest.cpp \
-    rollingaveragecalculatortest.cpp \
     reallifevideocachetest.cpp \
     ridefilewritertest.cpp \
-    distanceentrycollectiontest.cpp
+    ridejournaltest.cpp \
+    ridesimulatortest.cpp \
+    sensorchanneltest.cpp \
+    trainingmetricstest.cpp \
+    distanceentrycollectiontest.cpp \
+    distancelookuptabletest.cpp \
+    windowedstatisticstest.cpp
 
 HEADERS += \
     antmessage2test.h \
     common.h \
+    cyclingphysicstest.h \
+    fitdecoder.h \
+    fitfilewritertest.h \
     virtualpowertest.h \
     virtualtrainingfileparsertest.h \
     profiletest.h \
-    rollingaveragecalculatortest.h \
     reallifevideocachetest.h \
     ridefilewritertest.h \
-    distanceentrycollectiontest.h
+    ridejournaltest.h \
+    ridesimulatortest.h \
+    sensorchanneltest.h \
+    trainingmetricstest.h \
+    distanceentrycollectiontest.h \
+    distancelookuptabletest.h \
+    windowedstatisticstest.h
 
 
 RESOURCES += \
@@ -0,0 +1,128 @@
+#include "trainingmetricstest.h"
+
+#include <QtTest/QTest>
+
+#include "model/trainingmetrics.h"
+
+namespace
+{
+const int FTP = 250; // W
+const int W_PRIME = 20000; // J
+
+RideFile::Sample sampleAt(int second, int power, float altitude = 0.0f)
+{
+    RideFile::Sample sample;
+    sample.time = QTime::fromMSecsSinceStartOfDay(second * 1000);
+    sample.altitude = altitude;
+    sample.cadence = 90;
+    sample.distance = 10.0f * second;
+    sample.heartRate = 120 + second % 40;
+    sample.power = power;
+    sample.speed = 10.0f;
+    return sample;
+}
+}
+
+TrainingMetricsTest::TrainingMetricsTest(QObject *parent) :
+    QObject(parent)
+{
+    // empty
+}
+
+void TrainingMetricsTest::testWithoutSamples()
+{
+    const TrainingMetrics metrics(FTP, W_PRIME);
+
+    QCOMPARE(metrics.averagePower(), 0.0f);
+    QCOMPARE(metrics.normalizedPower(), 0.0f);
+    QCOMPARE(metrics.trainingStressScore(), 0.0f);
+    QCOMPARE(metrics.wPrimeBalance(), static_cast<float>(W_PRIME));
+    QVERIFY(metrics.climbs().empty());
+    QVERIFY(!metrics.isClimbing());
+}
+
+void TrainingMetricsTest::testAveragesAndMaximums()
+{
+    TrainingMetrics metrics(FTP, W_PRIME);
+    metrics.addSample(sampleAt(0, 100));
+    metrics.addSample(sampleAt(1, 300));
+    metrics.addSample(sampleAt(2, 200));
+
+    QCOMPARE(metrics.numberOfSamples(), 3);
+    QCOMPARE(metrics.durationMs(), Q_INT64_C(2000));
+    QCOMPARE(metrics.averagePower(), 200.0f);
+    QCOMPARE(metrics.maximumPower(), 300);
+    QCOMPARE(metrics.averageCadence(), 90.0f);
+    QCOMPARE(metrics.averageHeartRate(), 121.0f);
+    QCOMPARE(metrics.maximumHeartRate(), 122);
+    QCOMPARE(metrics.maximumSpeed(), 10.0f);
+}
+
+void TrainingMetricsTest::testOneHourAtFunctionalThresholdPower()
+{
+    TrainingMetrics metrics(FTP, W_PRIME);
+    for (int second = 0; second <= 3600; ++second) {
+        metrics.addSample(sampleAt(second, FTP));
+    }
+
+    QCOMPARE(metrics.normalizedPower(), static_cast<float>(FTP));
+    QCOMPARE(metrics.intensityFactor(), 1.0f);
+    QCOMPARE(metrics.trainingStressScore(), 100.0f);
+    // W' is not used when riding at critical power.
+    QCOMPARE(metrics.wPrimeBalance(), static_cast<float>(W_PRIME));
+}
+
+void TrainingMetricsTest::testWPrimeBalance()
+{
+    TrainingMetrics metrics(FTP, W_PRIME);
+    // 100 seconds at 100 W above FTP uses half of W'.
+    for (int second = 0; second <= 100; ++second) {
+        metrics.addSample(sampleAt(second, FTP + 100));
+    }
+    QCOMPARE(metrics.wPrimeBalance(), 10000.0f);
+
+    // recovery below FTP is slower when W' is almost full, it never recovers more than W'.
+    for (int second = 101; second <= 1000; ++second) {
+        metrics.addSample(sampleAt(second, FTP - 100));
+    }
+    QVERIFY(metrics.wPrimeBalance() > 19000.0f);
+    QVERIFY(metrics.wPrimeBalance() < static_cast<float>(W_PRIME));
+    QCOMPARE(metrics.minimumWPrimeBalance(), 10000.0f);
+}
+
+void TrainingMetricsTest::testClimbs()
+{
+    TrainingMetrics metrics(FTP, W_PRIME);
+    int second = 0;
+    // flat, then a climb of 50 meters at 300 W.
+    for (; second < 10; ++second) {
+        metrics.addSample(sampleAt(second, 150, 100.0f));
+    }
+    for (int i = 1; i <= 50; ++i, ++second) {
+        metrics.addSample(sampleAt(second, 300, 100.0f + i));
+    }
+    // the climb is not finished until the cyclist descends, but it is reported.
+    QCOMPARE(metrics.climbs().size(), static_cast<size_t>(1));
+    QVERIFY(metrics.isClimbing());
+    QCOMPARE(metrics.currentClimb().elevationGain, 50.0f);
+
+    // descend 30 meters, then a bump that is too small to be a climb.
+    for (int i = 1; i <= 30; ++i, ++second) {
+        metrics.addSample(sampleAt(second, 100, 150.0f - i));
+    }
+    for (int i = 1; i <= 5; ++i, ++second) {
+        metrics.addSample(sampleAt(second, 200, 120.0f + i));
+    }
+
+    QVERIFY(!metrics.isClimbing());
+    const std::vector<TrainingMetrics::Climb> climbs = metrics.climbs();
+    QCOMPARE(climbs.size(), static_cast<size_t>(1));
+    const TrainingMetrics::Climb &climb = climbs[0];
+    QCOMPARE(climb.startDistance, 90.0f);
+    QCOMPARE(climb.distance, 500.0f);
+    QCOMPARE(climb.elevationGain, 50.0f);
+    QCOMPARE(climb.durationMs, Q_INT64_C(50000));
+    QCOMPARE(climb.averagePower, 300.0f);
+    QCOMPARE(climb.startSample, 9);
+    QCOMPARE(climb.topSample, 59);
+}
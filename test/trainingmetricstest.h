@@ -0,0 +1,20 @@
+#ifndef TRAININGMETRICSTEST_H
+#define TRAININGMETRICSTEST_H
+
+#include <QtCore/QObject>
+
+class TrainingMetricsTest : public QObject
+{
+    Q_OBJECT
+public:
+    explicit TrainingMetricsTest(QObject *parent = 0);
+
+private slots:
+    void testWithoutSamples();
+    void testAveragesAndMaximums();
+    void testOneHourAtFunctionalThresholdPower();
+    void testWPrimeBalance();
+    void testClimbs();
+};
+
+#endif // TRAININGMETRICSTEST_H
@@ -50,6 +50,45 @@ void VirtualPowerTest::testEliteTurboMuin13()
 
 }
 
+void VirtualPowerTest::testUnknownTrainer()
+{
+    // unknown trainers get a constant power.
+    const VirtualPowerTrainer unknownTrainer = static_cast<VirtualPowerTrainer>(0);
+    auto unknownTrainerFunction = virtualPowerFunctionForTrainer(unknownTrainer);
+    QCOMPARE(unknownTrainerFunction(0.0f), 1.0f);
+    QCOMPARE(unknownTrainerFunction(10.0f), 1.0f);
+    QCOMPARE(virtualPowerForSpeeds(unknownTrainer, std::vector<float>({ 5.0f, 15.0f })), std::vector<float>({ 1.0f, 1.0f }));
+}
+
+void VirtualPowerTest::testBatchMatchesSingleSpeeds()
+{
+    std::vector<float> speeds;
+    for (float speed = 0; speed < 20; speed += 0.25) {
+        speeds.push_back(speed);
+    }
+    for (VirtualPowerTrainer trainer: VIRTUAL_POWER_TRAINERS.keys()) {
+        VirtualPowerFunctionType function = virtualPowerFunctionForTrainer(trainer);
+        std::vector<float> powers = virtualPowerForSpeeds(trainer, speeds);
+        QCOMPARE(powers.size(), speeds.size());
+        for (std::size_t i = 0; i < speeds.size(); ++i) {
+            QCOMPARE(powers[i], function(speeds[i]));
+        }
+    }
+}
+
+void VirtualPowerTest::benchmarkBatch()
+{
+    std::vector<float> speeds(3600 * 4);
+    for (std::size_t i = 0; i < speeds.size(); ++i) {
+        speeds[i] = (i % 80) * 0.25;
+    }
+    std::vector<float> powers(speeds.size());
+    QBENCHMARK {
+        virtualPowerForSpeeds(VirtualPowerTrainer::CYCLEOPS_JET_FLUID_PRO, speeds.data(), powers.data(),
+                              speeds.size());
+    }
+}
+
 void VirtualPowerTest::compareWithPowerTable(std::function<float(float)> virtualPowerFunction, const std::vector<PowerTableLine>& powerTable, SpeedUnit speedUnit)
 {
     for (auto line: powerTable) {
@@ -27,6 +27,9 @@ private slots:
     void testCycleopsFluid2();
     void testEliteQuboFluid();
     void testEliteTurboMuin13();
+    void testUnknownTrainer();
+    void testBatchMatchesSingleSpeeds();
+    void benchmarkBatch();
 private:
     void compareWithPowerTable(std::function<float(float)> virtualPowerFunction,const std::vector<PowerTableLine>& powerTable, SpeedUnit speedUnit);
 };
@@ -0,0 +1,139 @@
+#include "windowedstatisticstest.h"
+
+#include "model/normalizedpower.h"
+#include "model/windowedstatistics.h"
+
+#include <QtTest/QTest>
+
+namespace
+{
+const int DURATION = 3000; // ms
+}
+
+WindowedStatisticsTest::WindowedStatisticsTest(QObject *parent) :
+    QObject(parent)
+{
+    // empty
+}
+
+void WindowedStatisticsTest::testWithoutMeasurements()
+{
+    WindowedStatistics statistics(DURATION);
+
+    QVERIFY(statistics.isEmpty());
+    QCOMPARE(statistics.mean(), 0.0f);
+    QCOMPARE(statistics.minimum(), 0.0f);
+    QCOMPARE(statistics.maximum(), 0.0f);
+}
+
+void WindowedStatisticsTest::testWithOneMeasurement()
+{
+    WindowedStatistics statistics(DURATION);
+    statistics.add(0, 10.0);
+
+    QCOMPARE(statistics.mean(), 10.0f);
+}
+
+void WindowedStatisticsTest::testWithTwoMeasurementsWithinDuration()
+{
+    WindowedStatistics statistics(DURATION);
+    statistics.add(0, 10.0);
+    statistics.add(0, 20.0);
+
+    QCOMPARE(statistics.mean(), 15.0f);
+}
+
+void WindowedStatisticsTest::testWithTwoMeasurementsJustInsideDuration()
+{
+    WindowedStatistics statistics(DURATION);
+    statistics.add(1000, 10.0);
+    statistics.add(4000, 20.0);
+
+    QCOMPARE(statistics.mean(), 15.0f);
+}
+
+void WindowedStatisticsTest::testWithTwoMeasurementsJustOutsideDuration()
+{
+    WindowedStatistics statistics(DURATION);
+    statistics.add(1000, 10.0);
+    statistics.add(4001, 20.0);
+
+    QCOMPARE(statistics.count(), 1);
+    QCOMPARE(statistics.mean(), 20.0f);
+}
+
+void WindowedStatisticsTest::testMinimumAndMaximum()
+{
+    WindowedStatistics statistics(DURATION);
+    statistics.add(0, 300.0);
+    statistics.add(1000, 100.0);
+    statistics.add(2000, 200.0);
+
+    QCOMPARE(statistics.minimum(), 100.0f);
+    QCOMPARE(statistics.maximum(), 300.0f);
+
+    // the maximum of 300 leaves the window.
+    statistics.add(3500, 150.0);
+    QCOMPARE(statistics.minimum(), 100.0f);
+    QCOMPARE(statistics.maximum(), 200.0f);
+
+    // the minimum of 100 leaves the window.
+    statistics.add(4500, 180.0);
+    QCOMPARE(statistics.minimum(), 150.0f);
+    QCOMPARE(statistics.maximum(), 200.0f);
+}
+
+void WindowedStatisticsTest::testGrowBuffer()
+{
+    WindowedStatistics statistics(DURATION);
+    for (int i = 0; i < 1000; ++i) {
+        statistics.add(i, static_cast<float>(i % 100));
+    }
+
+    QCOMPARE(statistics.count(), 1000);
+    QCOMPARE(statistics.mean(), 49.5f);
+    QCOMPARE(statistics.minimum(), 0.0f);
+    QCOMPARE(statistics.maximum(), 99.0f);
+    QCOMPARE(statistics.oldestTimestampMs(), Q_INT64_C(0));
+}
+
+void WindowedStatisticsTest::testNormalizedPowerOfConstantPower()
+{
+    NormalizedPower normalizedPower;
+    for (int i = 0; i <= 60 * 4; ++i) {
+        normalizedPower.addPower(i * 250, 200.0);
+    }
+
+    QCOMPARE(normalizedPower.thirtySecondPower(), 200.0f);
+    QCOMPARE(normalizedPower.normalizedPower(), 200.0f);
+}
+
+void WindowedStatisticsTest::testNormalizedPowerOfIntervals()
+{
+    // five minutes of 30 second intervals of 400 and 100 watts.
+    NormalizedPower normalizedPower;
+    for (int second = 0; second <= 300; ++second) {
+        normalizedPower.addPower(second * 1000, ((second / 30) % 2 == 0) ? 400.0 : 100.0);
+    }
+
+    // normalized power is higher than the average power of 250 watts, but lower than the peak power.
+    QVERIFY(normalizedPower.normalizedPower() > 250.0f);
+    QVERIFY(normalizedPower.normalizedPower() < 400.0f);
+}
+
+void WindowedStatisticsTest::benchmarkOneHourAt100Hz()
+{
+    QBENCHMARK {
+        WindowedStatistics threeSecondPower(3000);
+        NormalizedPower normalizedPower;
+        float sum = 0;
+        for (int i = 0; i < 60 * 60 * 100; ++i) {
+            const qint64 timestampMs = i * 10;
+            const float power = static_cast<float>(200 + (i % 700) / 10);
+            threeSecondPower.add(timestampMs, power);
+            normalizedPower.addPower(timestampMs, power);
+            sum += threeSecondPower.mean() + threeSecondPower.maximum() + normalizedPower.normalizedPower();
+        }
+        QVERIFY(sum > 0);
+    }
+}
@@ -0,0 +1,26 @@
+#ifndef WINDOWEDSTATISTICSTEST_H
+#define WINDOWEDSTATISTICSTEST_H
+
+#include <QtCore/QObject>
+
+class WindowedStatisticsTest : public QObject
+{
+    Q_OBJECT
+public:
+    explicit WindowedStatisticsTest(QObject *parent = 0);
+
+private slots:
+    void testWithoutMeasurements();
+    void testWithOneMeasurement();
+    void testWithTwoMeasurementsWithinDuration();
+    void testWithTwoMeasurementsJustInsideDuration();
+    void testWithTwoMeasurementsJustOutsideDuration();
+    void testMinimumAndMaximum();
+    void testGrowBuffer();
+    void testNormalizedPowerOfConstantPower();
+    void testNormalizedPowerOfIntervals();
+
+    void benchmarkOneHourAt100Hz();
+};
+
+#endif // WINDOWEDSTATISTICSTEST_H